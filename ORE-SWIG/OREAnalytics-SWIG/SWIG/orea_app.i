@@ -101,6 +101,7 @@ public:
     const QuantLib::Date& asof();
     const ext::shared_ptr<Portfolio>& portfolio();
     Size nThreads();
+    Size nBatchesPerThread();
     CurveConfigurationsManager& curveConfigs();
     const ext::shared_ptr<TodaysMarketParameters>& todaysMarketParams() const;
     const std::string& marketDataLoaderOutput();
@@ -167,6 +168,7 @@ public:
     void setPortfolio(const ext::shared_ptr<Portfolio>& portfolio);
     void setMarketConfigs(const std::map<std::string, std::string>& m);
     void setThreads(int i);
+    void setBatchesPerThread(int i);
     void setEntireMarket(bool b);
     void setAllFixings(bool b);
     void setEomInflationFixings(bool b);
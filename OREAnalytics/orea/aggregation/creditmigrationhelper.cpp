@@ -25,6 +25,7 @@
 
 #include <ored/portfolio/creditdefaultswap.hpp>
 #include <ored/utilities/indexparser.hpp>
+#include <ored/utilities/parallel.hpp>
 
 #include <qle/math/matrixfunctions.hpp>
 #include <qle/models/transitionmatrix.hpp>
@@ -45,10 +46,10 @@ CreditMigrationHelper::CreditMigrationHelper(const QuantLib::ext::shared_ptr<Cre
                                              const Size cubeIndexCashflows, const Size cubeIndexStateNpvs,
                                              const Real distributionLowerBound, const Real distributionUpperBound,
                                              const Size buckets, const Matrix& globalFactorCorrelation,
-                                             const string& baseCurrency)
+                                             const string& baseCurrency, const Size nThreads)
     : parameters_(parameters), cube_(cube), nettedCube_(nettedCube), aggData_(aggData),
       cubeIndexCashflows_(cubeIndexCashflows), cubeIndexStateNpvs_(cubeIndexStateNpvs),
-      globalFactorCorrelation_(globalFactorCorrelation), baseCurrency_(baseCurrency),
+      globalFactorCorrelation_(globalFactorCorrelation), baseCurrency_(baseCurrency), nThreads_(nThreads),
       creditMode_(parseCreditMode(parameters_->creditMode())),
       loanExposureMode_(parseLoanExposureMode(parameters_->loanExposureMode())),
       evaluation_(parseEvaluation(parameters_->evaluation())),
@@ -56,12 +57,14 @@ CreditMigrationHelper::CreditMigrationHelper(const QuantLib::ext::shared_ptr<Cre
 
     rescaledTransitionMatrices_.resize(cube_->numDates());
     init();
-    if (evaluation_ == Evaluation::TerminalSimulation)
-        initEntityStateSimulation();
 } // CreditMigrationHelper()
 
 namespace {
 
+// number of paths processed in one block in pnlDistribution(), independent of the number of threads so that the
+// summation order of the path contributions is fixed
+constexpr Size pathBlockSize = 64;
+
 Real conditionalProb(const Real p, const Real m, const Real v) {
     QuantLib::CumulativeNormalDistribution nd;
     QuantLib::InverseCumulativeNormal icn;
@@ -182,13 +185,17 @@ void CreditMigrationHelper::init() {
         num << i;
         numStr[i] = num.str();
     }
+    std::vector<Size> globalFactorHandles(f);
+    for (Size ii = 0; ii < f; ++ii)
+        globalFactorHandles[ii] = aggData_->handle(AggregationScenarioDataType::CreditState, numStr[ii]);
     for (Size d = 0; d < cube_->numDates(); ++d) {
-        for (Size i = 0; i < parameters_->entities().size(); ++i) {
-            for (Size j = 0; j < cube_->samples(); ++j) {
-                for (Size ii = 0; ii < f; ++ii) {
-                    globalFactors[ii] = aggData_->get(d, j, AggregationScenarioDataType::CreditState, numStr[ii]);
-                }
-                globalStates_[d][i][j] = DotProduct(loadings[i], globalFactors / std::sqrt(cubeTimes_[d]));
+        for (Size j = 0; j < cube_->samples(); ++j) {
+            for (Size ii = 0; ii < f; ++ii) {
+                globalFactors[ii] = aggData_->get(d, j, globalFactorHandles[ii]);
+            }
+            globalFactors /= std::sqrt(cubeTimes_[d]);
+            for (Size i = 0; i < parameters_->entities().size(); ++i) {
+                globalStates_[d][i][j] = DotProduct(loadings[i], globalFactors);
             }
         }
     }
@@ -197,25 +204,14 @@ void CreditMigrationHelper::init() {
 
 } // init
 
-void CreditMigrationHelper::initEntityStateSimulation() {
-
-    LOG("Init entity state simulation");
-
-    simulatedEntityState_ =
-        std::vector<std::vector<Size>>(parameters_->entities().size(), std::vector<Size>(cube_->samples()));
-
-    LOG("Init entity state simulation done.");
-
-} // initEntityStatesSimulation
-
-std::vector<Matrix> CreditMigrationHelper::initEntityStateSimulation(const Size date, const Size path) {
+std::vector<Matrix> CreditMigrationHelper::initEntityStateSimulation(const Size date, const Size path,
+                                                                     const std::map<string, Matrix>& transMat) const {
     std::vector<Matrix> res = std::vector<Matrix>(parameters_->entities().size(), Matrix(n_, n_, 0.0));
 
     const std::vector<string>& matrixNames = parameters_->transitionMatrices();
 
     // build terminal matrices conditional on global states
     Size numWarnings = 0;
-    auto transMat = rescaledTransitionMatrices(date);
     for (Size i = 0; i < parameters_->entities().size(); ++i) {
         const Matrix& m = transMat.at(matrixNames[i]);
         for (Size ii = 0; ii < m.rows(); ++ii) {
@@ -253,32 +249,116 @@ std::vector<Matrix> CreditMigrationHelper::initEntityStateSimulation(const Size
     return res;
 }
 
-void CreditMigrationHelper::simulateEntityStates(const std::vector<Matrix>& cond, const Size path,
-                                                 const MersenneTwisterUniformRng& mt) {
+void CreditMigrationHelper::simulateEntityStates(const std::vector<Matrix>& cond, const MersenneTwisterUniformRng& mt,
+                                                 std::vector<Size>& entityStates) const {
 
     QL_REQUIRE(evaluation_ != Evaluation::Analytic,
                "CreditMigrationHelper::simulateEntityStates() unexpected call, not in simulation mode");
 
     for (Size i = 0; i < parameters_->entities().size(); ++i) {
         Size initialState = parameters_->initialStates()[i];
-            Real tmp = mt.next().value;
-            Size entityState =
-                std::lower_bound(cond[i].row_begin(initialState), cond[i].row_end(initialState), tmp) -
-                cond[i].row_begin(initialState);
-            entityState = std::min(entityState, cond[i].columns() - 1); // play safe
-            simulatedEntityState_[i][path] = entityState;
-            initialState = entityState;
+        Real tmp = mt.next().value;
+        Size entityState = std::lower_bound(cond[i].row_begin(initialState), cond[i].row_end(initialState), tmp) -
+                           cond[i].row_begin(initialState);
+        entityState = std::min(entityState, cond[i].columns() - 1); // play safe
+        entityStates[i] = entityState;
     }
 
 } // simulateEntityStates
 
-Size CreditMigrationHelper::simulatedEntityState(const Size i, const Size path) const {
-    QL_REQUIRE(evaluation_ != Evaluation::Analytic,
-               "CreditMigrationHelper::simulatedEntityState() unexpected call, not in simulation mode");
-    return simulatedEntityState_[i][path];
-} // simulatedEntityState
+CreditMigrationHelper::DateData CreditMigrationHelper::dateData(const Size date) const {
+
+    DateData data;
+
+    // trades in the cube and survival weights of their credit curves
+
+    std::map<std::string, Size> creditCurves;
+    for (auto const& tradeId : cube_->ids()) {
+        data.tradeIndex.push_back(cube_->getTradeIndex(tradeId));
+        Size c = Null<Size>();
+        if (auto cc = tradeCreditCurves_.find(tradeId); cc != tradeCreditCurves_.end())
+            c = creditCurves.insert(std::make_pair(cc->second, creditCurves.size())).first->second;
+        data.tradeCreditCurve.push_back(c);
+    }
+
+    if (parameters_->marketRisk() && parameters_->zeroMarketPnl()) {
+        data.survivalWeights.resize(creditCurves.size(),
+                                    std::vector<std::vector<Real>>(date + 1, std::vector<Real>(cube_->samples())));
+        for (auto const& [creditCurve, c] : creditCurves) {
+            Size h = aggData_->handle(AggregationScenarioDataType::SurvivalWeight, creditCurve);
+            for (Size d = 0; d <= date; ++d) {
+                auto sw = aggData_->samples(d, h);
+                QL_REQUIRE(sw.size() >= cube_->samples(), "CreditMigrationHelper: aggregation scenario data has "
+                                                              << sw.size() << " samples, expected at least "
+                                                              << cube_->samples());
+                std::copy_n(sw.begin(), cube_->samples(), data.survivalWeights[c][d].begin());
+            }
+        }
+    }
+
+    if (!parameters_->creditRisk())
+        return data;
+
+    // trades with issuer risk and netting sets with derivative exposure
+
+    std::map<std::string, Size> currencies = {{baseCurrency_, 0}};
+    bool needNumeraire = false;
+    data.issuerTrades.resize(parameters_->entities().size());
+    data.nettingSets.resize(parameters_->entities().size());
+    for (Size i = 0; i < parameters_->entities().size(); ++i) {
+        for (auto const& tradeId : issuerTradeIds_[i]) {
+            try {
+                IssuerTrade t;
+                t.id = tradeId;
+                t.cubeIndex = cube_->getTradeIndex(tradeId);
+                t.isBond = tradeNotionals_.find(tradeId) != tradeNotionals_.end();
+                t.isCds = tradeCdsCptyIdx_.find(tradeId) != tradeCdsCptyIdx_.end();
+                t.notional = t.isBond ? tradeNotionals_.at(tradeId) : 0.0;
+                t.fxIndex = 0;
+                if (loanExposureMode_ == LoanExposureMode::Notional && t.isBond) {
+                    string tradeCcy = tradeCurrencies_.at(tradeId);
+                    if (tradeCcy != baseCurrency_) {
+                        QL_REQUIRE(aggData_->has(AggregationScenarioDataType::FXSpot, tradeCcy + baseCurrency_),
+                                   "FX spot data not found in aggregation data for currency pair " << tradeCcy
+                                                                                                  << baseCurrency_);
+                    }
+                    t.fxIndex = currencies.insert(std::make_pair(tradeCcy, currencies.size())).first->second;
+                }
+                needNumeraire = needNumeraire || (loanExposureMode_ == LoanExposureMode::Notional && t.isCds);
+                data.issuerTrades[i].push_back(t);
+            } catch (const std::exception& e) {
+                ALOG("can not get state npv for trade " << tradeId << " (reason:" << e.what()
+                                                        << "), assume zero credit migration pnl");
+            }
+        }
+        for (auto const& nettingSetId : cptyNettingSetIds_[i]) {
+            QL_REQUIRE(nettedCube_, "empty netted cube");
+            data.nettingSets[i].push_back(nettedCube_->getTradeIndex(nettingSetId));
+        }
+    }
+
+    QL_REQUIRE(aggData_->dimSamples() >= cube_->samples(), "CreditMigrationHelper: aggregation scenario data has "
+                                                               << aggData_->dimSamples()
+                                                               << " samples, expected at least " << cube_->samples());
+
+    data.fxSpots.resize(currencies.size());
+    for (auto const& [ccy, c] : currencies) {
+        if (c == 0)
+            continue;
+        auto fx = aggData_->samples(date, aggData_->handle(AggregationScenarioDataType::FXSpot, ccy + baseCurrency_));
+        data.fxSpots[c].assign(fx.begin(), fx.begin() + cube_->samples());
+    }
+
+    if (needNumeraire) {
+        auto numeraire = aggData_->samples(date, aggData_->handle(AggregationScenarioDataType::Numeraire));
+        data.numeraire.assign(numeraire.begin(), numeraire.begin() + cube_->samples());
+    }
+
+    return data;
+} // dateData
 
-Real CreditMigrationHelper::generateMigrationPnl(const Size date, const Size path, const Size n) const {
+Real CreditMigrationHelper::generateMigrationPnl(const Size date, const Size path,
+                                                 const std::vector<Size>& entityStates, const DateData& data) const {
 
     QL_REQUIRE(!parameters_->doubleDefault(),
                "CreditMigrationHelper::generateMigrationPnl() does not support double default");
@@ -289,54 +369,44 @@ Real CreditMigrationHelper::generateMigrationPnl(const Size date, const Size pat
     for (Size i = 0; i < entities.size(); ++i) {
         // compute credit state of entitiy
         // issuer migration risk
-        Size simEntityState = simulatedEntityState(i, path);
-        for (auto const& tradeId : issuerTradeIds_[i]) {
+        Size simEntityState = entityStates[i];
+        for (auto const& t : data.issuerTrades[i]) {
             try {
-                Size tid = cube_->getTradeIndex(tradeId);
-                Real baseValue = cube_->get(tid, date, path, 0);
-                Real stateValue = cube_->get(tid, date, path, cubeIndexStateNpvs_ + simEntityState);
+                Real baseValue = cube_->get(t.cubeIndex, date, path, 0);
+                Real stateValue = cube_->get(t.cubeIndex, date, path, cubeIndexStateNpvs_ + simEntityState);
                 if (loanExposureMode_ == LoanExposureMode::Notional) {
-                    if (tradeNotionals_.find(tradeId) != tradeNotionals_.end()) {
+                    if (t.isBond) {
                         // this is a bond
-                        string tradeCcy = tradeCurrencies_.at(tradeId);
-                        string ccypair = tradeCcy + baseCurrency_;
-                        Real fx = 1.0;
-                        if (tradeCcy != baseCurrency_) {
-                            QL_REQUIRE(aggData_->has(AggregationScenarioDataType::FXSpot, ccypair),
-                                       "FX spot data not found in aggregation data for currency pair " << ccypair);
-                            fx = aggData_->get(date, path, AggregationScenarioDataType::FXSpot, ccypair);
-                        }
+                        Real fx = t.fxIndex == 0 ? 1.0 : data.fxSpots[t.fxIndex][path];
                         // FIXME: We actually need the correct current notional as of the future horizon date,
                         // but we have the current notional as of today
-                        baseValue = tradeNotionals_.at(tradeId) * fx;
+                        baseValue = t.notional * fx;
                         // FIXME: get the bond's recovery rate
                         Real rr = 0.0;
-                        stateValue = simEntityState == n - 1 ? rr * baseValue : baseValue;
+                        stateValue = simEntityState == n_ - 1 ? rr * baseValue : baseValue;
                     }
-                    if (tradeCdsCptyIdx_.find(tradeId) != tradeCdsCptyIdx_.end()) {
+                    if (t.isCds) {
                         // this is a cds
                         baseValue = 0.0;
-                        if (simEntityState < n - 1)
+                        if (simEntityState < n_ - 1)
                             stateValue = 0.0;
                         else
-                            stateValue *= aggData_->get(date, path, AggregationScenarioDataType::Numeraire);
+                            stateValue *= data.numeraire[path];
                     }
                 }
-                if (creditMode_ == CreditMode::Default && simEntityState < n - 1) {
+                if (creditMode_ == CreditMode::Default && simEntityState < n_ - 1) {
                     stateValue = baseValue;
                 }
                 pnl += stateValue - baseValue;
             } catch (const std::exception& e) {
-                ALOG("can not get state npv for trade " << tradeId << " (reason:" << e.what() << "), state "
+                ALOG("can not get state npv for trade " << t.id << " (reason:" << e.what() << "), state "
                                                         << simEntityState << ", assume zero credit migration pnl");
             }
         }
         // default risk for derivative exposure
         // TODO, assuming a zero recovery here...
-        for (auto const& nettingSetId : cptyNettingSetIds_[i]) {
-            Size nid = nettedCube_->getTradeIndex(nettingSetId);
-            QL_REQUIRE(nettedCube_, "empty netted cube");
-            if (simEntityState == n - 1)
+        for (auto const nid : data.nettingSets[i]) {
+            if (simEntityState == n_ - 1)
                 pnl -= std::max(nettedCube_->get(nid, date, path), 0.0);
         }
     }
@@ -345,7 +415,7 @@ Real CreditMigrationHelper::generateMigrationPnl(const Size date, const Size pat
 
 void CreditMigrationHelper::generateConditionalMigrationPnl(const Size date, const Size path,
                                                             const std::map<string, Matrix>& transMat,
-                                                            std::vector<Array>& condProbs,
+                                                            const DateData& data, std::vector<Array>& condProbs,
                                                             std::vector<Array>& pnl) const {
 
     Real t = cubeTimes_[date];
@@ -366,37 +436,29 @@ void CreditMigrationHelper::generateConditionalMigrationPnl(const Size date, con
         }
         // issuer migration risk
         Size cdsCptyIdx = Null<Size>();
-        for (auto const& tradeId : issuerTradeIds_[i]) {
+        for (auto const& t0 : data.issuerTrades[i]) {
+            Real fx = t0.fxIndex == 0 ? 1.0 : data.fxSpots[t0.fxIndex][path];
             for (Size j = 0; j < n_; ++j) {
                 try {
-                    Size tid = cube_->getTradeIndex(tradeId);
-                    Real baseValue = cube_->get(tid, date, path, 0);
-                    Real stateValue = cube_->get(tid, date, path, cubeIndexStateNpvs_ + j);
+                    Real baseValue = cube_->get(t0.cubeIndex, date, path, 0);
+                    Real stateValue = cube_->get(t0.cubeIndex, date, path, cubeIndexStateNpvs_ + j);
                     if (loanExposureMode_ == LoanExposureMode::Notional) {
-                        if (tradeNotionals_.find(tradeId) != tradeNotionals_.end()) {
+                        if (t0.isBond) {
                             // this is a bond
-                            string tradeCcy = tradeCurrencies_.at(tradeId);
-                            string ccypair = tradeCcy + baseCurrency_;
-                            Real fx = 1.0;
-                            if (tradeCcy != baseCurrency_) {
-                                QL_REQUIRE(aggData_->has(AggregationScenarioDataType::FXSpot, ccypair),
-                                           "FX spot data not found in aggregation data for currency pair " << ccypair);
-                                fx = aggData_->get(date, path, AggregationScenarioDataType::FXSpot, ccypair);
-                            }
                             // FIXME: We actually need the correct current notional as of the future horizon date,
                             // but we have the current notional as of today
-                            baseValue = tradeNotionals_.at(tradeId) * fx;
+                            baseValue = t0.notional * fx;
                             // FIXME: get the bond's recovery rate
                             Real rr = 0.0;
                             stateValue = j == n_ - 1 ? rr * baseValue : baseValue;
                         }
-                        if (tradeCdsCptyIdx_.find(tradeId) != tradeCdsCptyIdx_.end()) {
+                        if (t0.isCds) {
                             // this is a cds
                             baseValue = 0.0;
                             if (j < n_ - 1)
                                 stateValue = 0.0;
                             else
-                                stateValue *= aggData_->get(date, path, AggregationScenarioDataType::Numeraire);
+                                stateValue *= data.numeraire[path];
                         }
                     }
                     if (creditMode_ == CreditMode::Default && j < n_ - 1) {
@@ -407,38 +469,35 @@ void CreditMigrationHelper::generateConditionalMigrationPnl(const Size date, con
                     if (j == n_ - 1)
                         pnl[i][n_] += stateValue - baseValue;
                     // for a CDS we have to subdivide the default migration event into two events (see above)
-                    if (parameters_->doubleDefault() && j == n_ - 1 &&
-                        tradeCdsCptyIdx_.find(tradeId) != tradeCdsCptyIdx_.end()) {
+                    if (parameters_->doubleDefault() && j == n_ - 1 && t0.isCds) {
                         // FIXME currently we can not handle two CDS cptys for same underlying issuer
-                        QL_REQUIRE(cdsCptyIdx == Null<Size>() || cdsCptyIdx == tradeCdsCptyIdx_.at(tradeId),
+                        QL_REQUIRE(cdsCptyIdx == Null<Size>() || cdsCptyIdx == tradeCdsCptyIdx_.at(t0.id),
                                    "CreditMigrationHelper: Two different CDS cptys found for same issuer "
                                        << entities[i]);
                         // only adjust probability once
                         if (cdsCptyIdx == Null<Size>()) {
                             Real cptyDefaultPd =
-                                transMat.at(matrixNames[tradeCdsCptyIdx_.at(tradeId)])[initialState][n_ - 1];
+                                transMat.at(matrixNames[tradeCdsCptyIdx_.at(t0.id)])[initialState][n_ - 1];
                             Real pd = prob_tauA_lt_tauB_lt_T(cptyDefaultPd, condProbs[i][n_ - 1], t);
                             QL_REQUIRE(pd <= condProbs[i][n_ - 1],
                                        "CreditMigrationHelper: unexpected probability for double default event "
                                            << pd << " > " << condProbs[i][n_ - 1]);
                             condProbs[i][n_ - 1] -= pd;
                             condProbs[i][n_] = pd;
-                            cdsCptyIdx = tradeCdsCptyIdx_.at(tradeId);
+                            cdsCptyIdx = tradeCdsCptyIdx_.at(t0.id);
                             // pnl for new state is zero
                             pnl[i][n_] -= stateValue - baseValue;
                         }
                     }
                 } catch (const std::exception& e) {
-                    ALOG("can not get state npv for trade " << tradeId << " (reason:" << e.what() << "), state " << j
+                    ALOG("can not get state npv for trade " << t0.id << " (reason:" << e.what() << "), state " << j
                                                             << ", assume zero credit migration pnl");
                 }
             }
         }
         // default risk for derivative exposure
         // TODO, assuming a zero recovery here...
-        for (auto const& nettingSetId : cptyNettingSetIds_[i]) {
-            auto nid = nettedCube_->getTradeIndex(nettingSetId);
-            QL_REQUIRE(nettedCube_, "empty netted cube");
+        for (auto const nid : data.nettingSets[i]) {
             pnl[i][n_ - 1] -= std::max(nettedCube_->get(nid, date, path), 0.0);
         }
     }
@@ -464,118 +523,147 @@ Array CreditMigrationHelper::pnlDistribution(const Size date) {
         transMat = rescaledTransitionMatrices(date);
     }
 
-    // 2 compute conditional pnl distributions and average over paths
+    // collect the cube indices and aggregation scenario data needed on the paths
 
-    const std::set<std::string>& tradeIds = cube_->ids();
-    Array res(bucketing_.buckets(), 0.0);
+    const DateData data = dateData(date);
+
+    // 2 compute conditional pnl distributions and average over paths
 
     Size numPaths = cube_->samples();
-    Real avgCash = 0.0;
+    Size numBlocks = (numPaths + pathBlockSize - 1) / pathBlockSize;
+
+    std::vector<Array> blockRes(numBlocks, Array(bucketing_.buckets(), 0.0));
+    std::vector<Real> blockCash(numBlocks, 0.0);
+
+    // In simulation mode every path draws parameters_->paths() x entities uniforms from a single Mersenne Twister
+    // stream seeded with the seed from the parameters. The blocks are split into contiguous ranges, one per thread, and
+    // the generator of each range is skipped ahead to the first path of the range, so that each path uses the same
+    // random numbers as in a single threaded run. The skip ahead is linear in the number of skipped draws, which is
+    // cheap compared to the simulation of the skipped paths.
+    bool simulation = parameters_->creditRisk() && evaluation_ != Evaluation::Analytic;
+    Size drawsPerPath = simulation ? parameters_->paths() * entities.size() : 0;
+    Size numRanges = std::max<Size>(1, std::min(nThreads_, numBlocks));
+
+    ore::data::parallelFor(numRanges, numRanges, [&](const Size range) {
+
+        HullWhiteBucketing hwBucketing(bucketing_.upperBucketBound().begin(), bucketing_.upperBucketBound().end());
+        std::vector<Size> entityStates(entities.size());
+
+        Size firstBlock = range * numBlocks / numRanges;
+        Size lastBlock = (range + 1) * numBlocks / numRanges;
+        MersenneTwisterUniformRng mt(parameters_->seed());
+        for (Size d = 0, n = firstBlock * pathBlockSize * drawsPerPath; d < n; ++d)
+            mt.nextInt32();
+
+        for (Size block = firstBlock; block < lastBlock; ++block) {
+            for (Size path = block * pathBlockSize; path < std::min(numPaths, (block + 1) * pathBlockSize); ++path) {
+
+                // 2a market pnl (t0 to horizon date, over whole cube)
+
+                Real cash = 0.0;
+
+                if (parameters_->marketRisk()) {
+                    for (Size j = 0; j <= date + 1; ++j) {
+                        for (Size k = 0; k < data.tradeIndex.size(); ++k) {
+                            Size i = data.tradeIndex[k];
+                            // get cumulative survival probability on the path
+                            Real sp = 1.0;
+                            // FIXME 1
+                            // Methodology question: Do we need/want to multiply with the stochastic discount factor
+                            // here if we do an explicit credit default simulation at horizon?
+                            // FIXME 2
+                            // make CDS PnL neutral bei weighting flows with surv prob and generating protection flow
+                            // with default prob
+                            if (parameters_->zeroMarketPnl() && j > 0 && data.tradeCreditCurve[k] != Null<Size>()) {
+                                sp = data.survivalWeights[data.tradeCreditCurve[k]][j - 1][path];
+                            }
+                            if (j == 0) {
+                                // at t0 we flip the sign of the npvs to get the initial cash balance
+                                cash -= cube_->getT0(i, 0);
+                                // collect intermediate cashflows
+                                if (cubeIndexCashflows_ != Null<Size>())
+                                    cash += cube_->getT0(i, cubeIndexCashflows_);
+                            } else if (j <= date) {
+                                // collect intermediate cashflows
+                                if (cubeIndexCashflows_ != Null<Size>())
+                                    cash += sp * cube_->get(i, j - 1, path, cubeIndexCashflows_);
+                            } else {
+                                // at the horizon date we realise the npv
+                                cash += sp * cube_->get(i, j - 1, path, 0);
+                            }
+                        }
+                    } // for data
+                }     // if market risk
+
+                if (!parameters_->creditRisk()) {
+                    // if we just add scalar market pnl realisations, we don't really need
+                    // the bucketing algorithm to do that, we just update the result
+                    // distribution directly
+                    blockRes[block][hwBucketing.index(cash)] += 1.0 / static_cast<Real>(numPaths);
+                    blockCash[block] += cash / static_cast<Real>(numPaths);
+                    continue;
+                }
 
-    HullWhiteBucketing hwBucketing(bucketing_.upperBucketBound().begin(), bucketing_.upperBucketBound().end());
-
-    MersenneTwisterUniformRng mt(parameters_->seed());
-
-    for (Size path = 0; path < numPaths; ++path) {
-
-        // 2a market pnl (t0 to horizon date, over whole cube)
-
-        Real cash = 0.0;
-
-        if (parameters_->marketRisk()) {
-            for (Size j = 0; j <= date + 1; ++j) {
-                for (auto const& tradeId : tradeIds) {
-                    Size i = cube_->getTradeIndex(tradeId);
-                    // get cumulative survival probability on the path
-                    Real sp = 1.0;
-                    //Real rr = 0.0;
-                    // FIXME 1
-                    // Methodology question: Do we need/want to multiply with the stochastic discount factor
-                    // here if we do an explicit credit default simulation at horizon?
-                    // FIXME 2
-                    // make CDS PnL neutral bei weighting flows with surv prob and generating protection flow
-                    // with default prob
-                    if (parameters_->zeroMarketPnl() && j > 0 &&
-                        tradeCreditCurves_.find(tradeId) != tradeCreditCurves_.end()) {
-                        string creditCurve = tradeCreditCurves_.at(tradeId);
-                        sp = aggData_->get(j - 1, path, AggregationScenarioDataType::SurvivalWeight, creditCurve);
-                        //rr = aggData_->get(j - 1, path, AggregationScenarioDataType::RecoveryRate, creditCurve);
-                    }
-                    if (j == 0) {
-                        // at t0 we flip the sign of the npvs to get the initial cash balance
-                        cash -= cube_->getT0(i, 0);
-                        // collect intermediate cashflows
-                        if (cubeIndexCashflows_ != Null<Size>())
-                            cash += cube_->getT0(i, cubeIndexCashflows_);
-                    } else if (j <= date) {
-                        // collect intermediate cashflows
-                        if (cubeIndexCashflows_ != Null<Size>())
-                            cash += sp * cube_->get(i, j - 1, path, cubeIndexCashflows_);
-                    } else {
-                        // at the horizon date we realise the npv
-                        cash += sp * cube_->get(i, j - 1, path, 0);
+                // 2b credit migration pnl (at horizon date, over entities specified in credit simulation parameters)
+
+                std::vector<Array> condProbs, pnl;
+
+                if (evaluation_ != Evaluation::Analytic) {
+                    // 2b-1 generate pnl on the path using simulated idiosyncratic factors
+                    condProbs.resize(1, Array(parameters_->paths(), 1.0 / static_cast<Real>(parameters_->paths())));
+                    // we could build the distribution more efficiently here, but later in 2c we add the market pnl
+                    // maybe extend the hw bucketing so that we can feed precomputed distributions and just update
+                    // these with additional data?
+                    pnl.resize(1, Array(parameters_->paths(), 0.0));
+                    auto cond = initEntityStateSimulation(date, path, transMat);
+                    for (Size path2 = 0; path2 < parameters_->paths(); ++path2) {
+                        simulateEntityStates(cond, mt, entityStates);
+                        pnl[0][path2] = generateMigrationPnl(date, path, entityStates, data);
                     }
+                } else {
+                    // 2b-2 generate pnl distribution without simulation of idiosyncratic factors using the conditional
+                    // independence of migration on the path / systemic factors
+
+                    // n+1 states, since for CDS we have to subdivide the issuer default into
+                    // i) default of issuer and non-default of CDS cpty
+                    // ii) default of issuer, default of CDS cpty (but after the issuer default)
+                    // iii) default of issuer, default of CDS cpty (before the issuer default)
+                    // for non-CDS trades for all sub-states the pnl will be set to the same value
+                    // for CDS trades i)+ii) will have the same pnl, but iii) will have a zero pnl
+                    // in total, we only have to distinguish i)+ii) and iii), i.e. we need one
+                    // additional state
+
+                    condProbs.resize(entities.size(), Array(n_ + 1, 0.0));
+                    pnl.resize(entities.size(), Array(n_ + 1, 0.0));
+                    generateConditionalMigrationPnl(date, path, transMat, data, condProbs, pnl);
                 }
-            } // for data
-        }     // if market risk
-
-        if (!parameters_->creditRisk()) {
-            // if we just add scalar market pnl realisations, we don't really need
-            // the bucketing algorithm to do that, we just update the result
-            // distribution directly
-            res[hwBucketing.index(cash)] += 1.0 / static_cast<Real>(numPaths);
-            continue;
-        }
 
-        // 2b credit migration pnl (at horizon date, over entities specified in credit simulation parameters)
-
-        std::vector<Array> condProbs, pnl;
-
-        if (evaluation_ != Evaluation::Analytic) {
-            // 2b-1 generate pnl on the path using simulated idiosyncratic factors
-            condProbs.resize(1, Array(parameters_->paths(), 1.0 / static_cast<Real>(parameters_->paths())));
-            // we could build the distribution more efficiently here, but later in 2c we add the market pnl
-            // maybe extend the hw bucketing so that we can feed precomputed distributions and just update
-            // these with additional data?
-            pnl.resize(1, Array(parameters_->paths(), 0.0));
-            auto cond = initEntityStateSimulation(date, path);
-            for (Size path2 = 0; path2 < parameters_->paths(); ++path2) {
-                simulateEntityStates(cond, path, mt);
-                pnl[0][path2] = generateMigrationPnl(date, path, n_);
-            }
-        } else {
-            // 2b-2 generate pnl distribution without simulation of idiosyncratic factors using the conditional
-            // independence of migration on the path / systemic factors
-
-            // n+1 states, since for CDS we have to subdivide the issuer default into
-            // i) default of issuer and non-default of CDS cpty
-            // ii) default of issuer, default of CDS cpty (but after the issuer default)
-            // iii) default of issuer, default of CDS cpty (before the issuer default)
-            // for non-CDS trades for all sub-states the pnl will be set to the same value
-            // for CDS trades i)+ii) will have the same pnl, but iii) will have a zero pnl
-            // in total, we only have to distinguish i)+ii) and iii), i.e. we need one
-            // additional state
-
-            condProbs.resize(entities.size(), Array(n_ + 1, 0.0));
-            pnl.resize(entities.size(), Array(n_ + 1, 0.0));
-            generateConditionalMigrationPnl(date, path, transMat, condProbs, pnl);
-        }
+                // 2c aggregate market pnl and credit migration pnl
 
-        // 2c aggregate market pnl and credit migration pnl
+                if (parameters_->marketRisk()) {
+                    condProbs.push_back(Array(1, 1.0));
+                    pnl.push_back(Array(1, cash));
+                }
 
-        if (parameters_->marketRisk()) {
-            condProbs.push_back(Array(1, 1.0));
-            pnl.push_back(Array(1, cash));
-        }
+                hwBucketing.computeMultiState(condProbs.begin(), condProbs.end(), pnl.begin());
 
-        hwBucketing.computeMultiState(condProbs.begin(), condProbs.end(), pnl.begin());
+                // 2d add pnl contribution of path to result distribution
+                blockRes[block] += hwBucketing.probability() / static_cast<Real>(numPaths);
+                // average market risk pnl
+                blockCash[block] += cash / static_cast<Real>(numPaths);
 
-        // 2d add pnl contribution of path to result distribution
-        res += hwBucketing.probability() / static_cast<Real>(numPaths);
-        // average market risk pnl
-        avgCash += cash / static_cast<Real>(numPaths);
+            } // for path
+        }     // for block
+    });
 
-    } // for path
+    // 3 add up the block results in a fixed order
+
+    Array res(bucketing_.buckets(), 0.0);
+    Real avgCash = 0.0;
+    for (Size block = 0; block < numBlocks; ++block) {
+        res += blockRes[block];
+        avgCash += blockCash[block];
+    }
 
     DLOG("Expected Market Risk PnL at date " << date << ": " << avgCash);
     return res;
@@ -59,13 +59,17 @@ public:
                           const QuantLib::ext::shared_ptr<AggregationScenarioData> aggData, const Size cubeIndexCashflows,
                           const Size cubeIndexStateNpvs, const Real distributionLowerBound,
                           const Real distributionUpperBound, const Size buckets, const Matrix& globalFactorCorrelation,
-                          const std::string& baseCurrency);
+                          const std::string& baseCurrency, const Size nThreads = 1);
 
     //! builds the helper for a specific subset of trades stored in the cube
     void build(const std::map<std::string, QuantLib::ext::shared_ptr<Trade>>& trades);
 
     const std::vector<Real>& upperBucketBound() const { return bucketing_.upperBucketBound(); }
-    //
+
+    /*! Returns the pnl distribution for the given date index. The paths are processed in blocks of fixed size on up to
+        nThreads threads. In simulation mode the idiosyncratic factors are drawn from one random number stream
+        seeded with the seed from the parameters, each thread skips ahead to its first path, so that the result does
+        not depend on the number of threads. */
     Array pnlDistribution(const Size date);
 
 private:
@@ -81,30 +85,56 @@ private:
         using the simulated global state paths stored in the aggregation scenario data object */
     void init();
 
-    //! Allocate 3d storage for the simulated idiosyncratic factors by entity, date and sample
-    void initEntityStateSimulation();
+    //! A trade with issuer risk, see DateData
+    struct IssuerTrade {
+        std::string id;
+        Size cubeIndex;
+        bool isBond, isCds;
+        Real notional;
+        Size fxIndex;
+    };
+
+    /*! The cube indices and the aggregation scenario data required on the paths for a given date, extracted once
+        so that the paths can be processed in parallel without look ups by name */
+    struct DateData {
+        // cube indices and credit curve indices (or null) of all trades in the cube
+        std::vector<Size> tradeIndex, tradeCreditCurve;
+        // survival weights by credit curve, date index (up to the given date) and path
+        std::vector<std::vector<std::vector<Real>>> survivalWeights;
+        // trades with issuer risk and netted cube indices of netting sets with derivative exposure by entity
+        std::vector<std::vector<IssuerTrade>> issuerTrades;
+        std::vector<std::vector<Size>> nettingSets;
+        // fx spots to base ccy by currency index and path at the given date, index 0 is the base ccy
+        std::vector<std::vector<Real>> fxSpots;
+        // numeraire by path at the given date, only populated if required
+        std::vector<Real> numeraire;
+    };
+
+    //! Extract the data required on the paths for the given date
+    DateData dateData(const Size date) const;
 
     /*! Initialise the entity state simulationn for a given date for
         Evaluation = TerminalSimulation:
         Return transition matrix for each entity for the given date,
         conditional on the global terminal state on the given path */
-    std::vector<Matrix> initEntityStateSimulation(const Size date, const Size path);
-
-    /*! Generate one entity state sample path for all entities given the global state path
-        and given the conditional transition matrices for all entities at the terminal date. */
-    void simulateEntityStates(const std::vector<Matrix>& cond, const Size path, const MersenneTwisterUniformRng& mt);
+    std::vector<Matrix> initEntityStateSimulation(const Size date, const Size path,
+                                                  const std::map<string, Matrix>& transMat) const;
 
-    //! Look up the simulated entity credit state for the given entity, date and path
-    Size simulatedEntityState(const Size i, const Size path) const;
+    /*! Generate one entity state sample for all entities given the conditional transition matrices for all entities
+        at the terminal date. */
+    void simulateEntityStates(const std::vector<Matrix>& cond, const MersenneTwisterUniformRng& mt,
+                              std::vector<Size>& entityStates) const;
 
     /*! Return a single PnL impact due to credit migration or default of Bond/CDS issuers and default of
-      netting set counterparties on the given global path */
-    Real generateMigrationPnl(const Size date, const Size path, const Size n) const;
+      netting set counterparties on the given global path and simulated entity states */
+    Real generateMigrationPnl(const Size date, const Size path, const std::vector<Size>& entityStates,
+                              const DateData& data) const;
 
     /*! Return a vector of PnL impacts and associated conditional probabilities for the specified global path,
       due to credit migration or default of Bond/CDS issuers and default of netting set counterparties */
     void generateConditionalMigrationPnl(const Size date, const Size path, const std::map<string, Matrix>& transMat,
-                                         std::vector<Array>& condProbs, std::vector<Array>& pnl) const;
+                                         const DateData& data, std::vector<Array>& condProbs,
+                                         std::vector<Array>& pnl) const;
 
     QuantLib::ext::shared_ptr<CreditSimulationParameters> parameters_;
     QuantLib::ext::shared_ptr<NPVCube> cube_, nettedCube_;
@@ -112,6 +142,7 @@ private:
     Size cubeIndexCashflows_, cubeIndexStateNpvs_;
     Matrix globalFactorCorrelation_;
     std::string baseCurrency_;
+    Size nThreads_;
 
     CreditMode creditMode_;
     LoanExposureMode loanExposureMode_;
@@ -133,10 +164,6 @@ private:
     std::vector<std::map<string, Matrix>> rescaledTransitionMatrices_;
     // Variance of the systemic part (Y_i) of entity state X_i
     std::vector<Real> globalVar_;
-    // Storage for the simulated idiosyncratic factors Z by entity, sample number
-    std::vector<std::vector<Size>> simulatedEntityState_;
-
-    std::vector<std::vector<Matrix>> entityStateSimulationMatrices_;
     // Systemic part (Y_i) of entity state X_i by date index, entity index, sample number
     std::vector<std::vector<std::vector<Real>>> globalStates_;
 };
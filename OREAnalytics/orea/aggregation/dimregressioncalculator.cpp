@@ -18,6 +18,7 @@
 
 #include <orea/aggregation/dimregressioncalculator.hpp>
 #include <ored/utilities/log.hpp>
+#include <ored/utilities/parallel.hpp>
 #include <ored/utilities/vectorutils.hpp>
 #include <ql/errors.hpp>
 #include <ql/time/calendars/weekendsonly.hpp>
@@ -36,6 +37,8 @@
 #include <boost/accumulators/statistics/mean.hpp>
 #include <boost/accumulators/statistics/stats.hpp>
 
+#include <algorithm>
+
 using namespace std;
 using namespace QuantLib;
 
@@ -44,6 +47,11 @@ using namespace boost::accumulators;
 namespace ore {
 namespace analytics {
 
+namespace {
+// above this number of samples the local regression uses a binned estimator with this number of grid points
+constexpr Size localRegressionBins = 2000;
+} // namespace
+
 RegressionDynamicInitialMarginCalculator::RegressionDynamicInitialMarginCalculator(
     const QuantLib::ext::shared_ptr<InputParameters>& inputs,
     const QuantLib::ext::shared_ptr<Portfolio>& portfolio, const QuantLib::ext::shared_ptr<NPVCube>& cube,
@@ -148,6 +156,28 @@ void RegressionDynamicInitialMarginCalculator::build() {
     Size simple_dim_index_h = Size(floor(quantile_ * (cube_->samples() - 1) + 0.5));
     Size simple_dim_index_p = Size(floor((1.0 - quantile_) * (samples - 1) + 0.5));
 
+    // resolve the numeraire and regressor data once
+
+    QL_REQUIRE(scenarioData_->dimSamples() >= samples, "scenario data has fewer samples ("
+                                                           << scenarioData_->dimSamples() << ") than the cube ("
+                                                           << samples << ")");
+    Size numeraireHandle = scenarioData_->handle(AggregationScenarioDataType::Numeraire);
+
+    regressorHandles_.clear();
+    for (auto const& variable : regressors_) {
+        if (boost::to_upper_copy(variable) ==
+            "NPV") // this allows possibility to include NPV as a regressor alongside more fundamental risk factors
+            regressorHandles_.push_back(Null<Size>());
+        else if (scenarioData_->has(AggregationScenarioDataType::IndexFixing, variable))
+            regressorHandles_.push_back(scenarioData_->handle(AggregationScenarioDataType::IndexFixing, variable));
+        else if (scenarioData_->has(AggregationScenarioDataType::FXSpot, variable))
+            regressorHandles_.push_back(scenarioData_->handle(AggregationScenarioDataType::FXSpot, variable));
+        else if (scenarioData_->has(AggregationScenarioDataType::Generic, variable))
+            regressorHandles_.push_back(scenarioData_->handle(AggregationScenarioDataType::Generic, variable));
+        else
+            QL_FAIL("scenario data does not provide data for " << variable);
+    }
+
     for (auto it_map = nettingSetNPV_.begin(); it_map != nettingSetNPV_.end(); ++it_map) {
         string key = it_map->first;
         vector<Real> t0_dist = it_map->second[relevantDateIdx];
@@ -159,8 +189,9 @@ void RegressionDynamicInitialMarginCalculator::build() {
         vector<Real> t0_delMtM_dist(dist_size, 0.0);
         accumulator_set<double, stats<boost::accumulators::tag::mean, boost::accumulators::tag::variance>> acc_delMtm;
         accumulator_set<double, stats<boost::accumulators::tag::mean>> acc_OneOverNum;
+        auto numeraires = scenarioData_->samples(relevantDateIdx, numeraireHandle);
         for (Size i = 0; i < dist_size; ++i) {
-            Real numeraire = scenarioData_->get(relevantDateIdx, i, AggregationScenarioDataType::Numeraire);
+            Real numeraire = numeraires[i];
             Real deltaMtmFromMean = numeraire * (t0_dist[i] - mean_t0_dist) * sqrtTimeScaling;
             t0_delMtM_dist[i] = deltaMtmFromMean;
             acc_delMtm(deltaMtmFromMean);
@@ -170,7 +201,7 @@ void RegressionDynamicInitialMarginCalculator::build() {
         Real variance_t0 = boost::accumulators::variance(acc_delMtm);
         Real sqrt_t0 = std::sqrt(variance_t0);
         currentDIM_[key] = (sqrt_t0 * confidenceLevel * E_OneOverNumeraire);
-        std::sort(t0_delMtM_dist.begin(), t0_delMtM_dist.end());
+        std::nth_element(t0_delMtM_dist.begin(), t0_delMtM_dist.begin() + simple_dim_index_h, t0_delMtM_dist.end());
         // just for logging
         Real t0dimSimple = (t0_delMtM_dist[simple_dim_index_h] * E_OneOverNumeraire);
 
@@ -188,10 +219,20 @@ void RegressionDynamicInitialMarginCalculator::build() {
     std::vector<std::function<Real(Array)>> v(
         LsmBasisSystem::multiPathBasisSystem(regressionDimension, polynomOrder, polynomType));
 
-    Size nettingSetCount = 0;
+    // netting sets for which the DIM is estimated by regression, with their index in the DIM cube and scaling
+
+    struct RegressionNettingSet {
+        string id;
+        Size dimCubeIndex;
+        Real scaling;
+    };
+    vector<RegressionNettingSet> regressionNettingSets;
+
     for (auto n : nettingSetIds_) {
         DLOG("Process netting set " << n);
 
+        Size nettingSetIndex = dimCube_->idsAndIndexes().at(n);
+
         if (inputs_) {
             // Check whether a deterministic IM evolution was provided for this netting set
             // If found then we use this external data to overwrite the following
@@ -214,7 +255,7 @@ void RegressionDynamicInitialMarginCalculator::build() {
                         nettingSetSimpleDIMh_[n][j] = value;
                         nettingSetSimpleDIMp_[n][j] = value;
                         for (Size k = 0; k < samples; ++k) {
-                            dimCube_->set(value, nettingSetCount, j, k);
+                            dimCube_->set(value, nettingSetIndex, j, k);
                             nettingSetDIM_[n][j][k] = value;
                         }
                     } catch(std::exception& ) {
@@ -242,147 +283,161 @@ void RegressionDynamicInitialMarginCalculator::build() {
             nettingSetScaling_.find(n) == nettingSetScaling_.end() ? 1.0 : nettingSetScaling_[n];
         DLOG("Netting set DIM scaling factor: " << nettingSetDimScaling);
 
-        for (Size j = 0; j < stopDatesLoop; ++j) {
-            accumulator_set<double, stats<boost::accumulators::tag::mean, boost::accumulators::tag::variance>> accDiff;
-            accumulator_set<double, stats<boost::accumulators::tag::mean>> accOneOverNumeraire;
-            for (Size k = 0; k < samples; ++k) {
-                Real numDefault = cubeInterpretation_->getDefaultAggregationScenarioData(
-                    scenarioData_, AggregationScenarioDataType::Numeraire, j, k);
-                Real numCloseOut = cubeInterpretation_->getCloseOutAggregationScenarioData(
-                    scenarioData_, AggregationScenarioDataType::Numeraire, j, k);
-                Real npvDefault = nettingSetNPV_[n][j][k];
-                Real flow = nettingSetFLOW_[n][j][k];
-                Real npvCloseOut = nettingSetCloseOutNPV_[n][j][k];
-                accDiff((npvCloseOut * numCloseOut) + (flow * numDefault) - (npvDefault * numDefault));
-                accOneOverNumeraire(1.0 / numDefault);
-            }
+        regressionNettingSets.push_back({n, nettingSetIndex, nettingSetDimScaling});
+    }
 
-            Size mporCalendarDays = cubeInterpretation_->getMporCalendarDays(cube_, j);
-            Real horizonScaling = std::sqrt(1.0 * horizonCalendarDays_ / mporCalendarDays);
-
-            Real stdevDiff = std::sqrt(boost::accumulators::variance(accDiff));
-            Real E_OneOverNumeraire =
-                mean(accOneOverNumeraire); // "re-discount" (the stdev is calculated on non-discounted deltaNPVs)
-
-            nettingSetZeroOrderDIM_[n][j] = stdevDiff * horizonScaling * confidenceLevel;
-            nettingSetZeroOrderDIM_[n][j] *= E_OneOverNumeraire;
-
-            vector<Real> rx0(samples, 0.0);
-            vector<Array> rx(samples, Array());
-            vector<Real> ry1(samples, 0.0);
-            vector<Real> ry2(samples, 0.0);
-            for (Size k = 0; k < samples; ++k) {
-                Real numDefault = cubeInterpretation_->getDefaultAggregationScenarioData(
-                    scenarioData_, AggregationScenarioDataType::Numeraire, j, k);
-                Real numCloseOut = cubeInterpretation_->getCloseOutAggregationScenarioData(
-                    scenarioData_, AggregationScenarioDataType::Numeraire, j, k);
-                Real x = nettingSetNPV_[n][j][k] * numDefault;
-                Real f = nettingSetFLOW_[n][j][k] * numDefault;
-                Real y = nettingSetCloseOutNPV_[n][j][k] * numCloseOut;
-                Real z = (y + f - x);
-                rx[k] = regressors_.empty() ? Array(1, nettingSetNPV_[n][j][k]) : regressorArray(n, j, k);
-                rx0[k] = rx[k][0];
-                ry1[k] = z;     // for local regression
-                ry2[k] = z * z; // for least squares regression
-                nettingSetDeltaNPV_[n][j][k] = z;
-                regressorArray_[n][j][k] = rx[k];
-            }
-            vector<Real> delNpvVec_copy = nettingSetDeltaNPV_[n][j];
-            sort(delNpvVec_copy.begin(), delNpvVec_copy.end());
-            Real simpleDim_h = delNpvVec_copy[simple_dim_index_h];
-            Real simpleDim_p = delNpvVec_copy[simple_dim_index_p];
-            simpleDim_h *= horizonScaling;                                  // the usual scaling factors
-            simpleDim_p *= horizonScaling;                                  // the usual scaling factors
-            nettingSetSimpleDIMh_[n][j] = simpleDim_h * E_OneOverNumeraire; // discounted DIM
-            nettingSetSimpleDIMp_[n][j] = simpleDim_p * E_OneOverNumeraire; // discounted DIM
-
-            QL_REQUIRE(rx.size() > v.size(), "not enough points for regression with polynom order " << polynomOrder);
-            if (close_enough(stdevDiff, 0.0)) {
-                DLOG("DIM: Zero std dev estimation at step " << j);
-                // Skip IM calculation if all samples have zero NPV (e.g. after latest maturity)
-                for (Size k = 0; k < samples; ++k) {
-                    nettingSetDIM_[n][j][k] = 0.0;
-                    nettingSetLocalDIM_[n][j][k] = 0.0;
-                }
+    // The regressions for different netting sets and dates are independent, each (netting set, date) pair only writes
+    // its own date slice of the result containers, which are looked up with at() to avoid concurrent modification of
+    // the maps
+
+    Size nThreads = inputs_ ? inputs_->nThreads() : 1;
+    DLOG("Run DIM regression for " << regressionNettingSets.size() << " netting sets and " << stopDatesLoop
+                                   << " dates on up to " << nThreads << " threads");
+
+    ore::data::parallelFor(regressionNettingSets.size() * stopDatesLoop, nThreads, [&](const Size item) {
+        const RegressionNettingSet& ns = regressionNettingSets[item / stopDatesLoop];
+        const string& n = ns.id;
+        Size j = item % stopDatesLoop;
+
+        const vector<Real>& npv = nettingSetNPV_.at(n)[j];
+        const vector<Real>& closeOutNpv = nettingSetCloseOutNPV_.at(n)[j];
+        const vector<Real>& flow = nettingSetFLOW_.at(n)[j];
+        vector<Real>& deltaNpv = nettingSetDeltaNPV_.at(n)[j];
+        auto numDefault = cubeInterpretation_->getDefaultAggregationScenarioSamples(scenarioData_, numeraireHandle, j);
+        auto numCloseOut =
+            cubeInterpretation_->getCloseOutAggregationScenarioSamples(scenarioData_, numeraireHandle, j);
+
+        accumulator_set<double, stats<boost::accumulators::tag::mean, boost::accumulators::tag::variance>> accDiff;
+        accumulator_set<double, stats<boost::accumulators::tag::mean>> accOneOverNumeraire;
+        vector<Real> rx0(samples, 0.0);
+        vector<Array> rx(samples, Array());
+        vector<Real> ry1(samples, 0.0);
+        vector<Real> ry2(samples, 0.0);
+        for (Size k = 0; k < samples; ++k) {
+            Real x = npv[k] * numDefault[k];
+            Real f = flow[k] * numDefault[k];
+            Real y = closeOutNpv[k] * numCloseOut[k];
+            Real z = (y + f - x);
+            accDiff(z);
+            accOneOverNumeraire(1.0 / numDefault[k]);
+            rx[k] = regressors_.empty() ? Array(1, npv[k]) : regressorArray(npv, j, k);
+            rx0[k] = rx[k][0];
+            ry1[k] = z;     // for local regression
+            ry2[k] = z * z; // for least squares regression
+            deltaNpv[k] = z;
+        }
+        regressorArray_.at(n)[j] = rx;
+
+        Size mporCalendarDays = cubeInterpretation_->getMporCalendarDays(cube_, j);
+        Real horizonScaling = std::sqrt(1.0 * horizonCalendarDays_ / mporCalendarDays);
+
+        Real stdevDiff = std::sqrt(boost::accumulators::variance(accDiff));
+        Real E_OneOverNumeraire =
+            mean(accOneOverNumeraire); // "re-discount" (the stdev is calculated on non-discounted deltaNPVs)
+
+        nettingSetZeroOrderDIM_.at(n)[j] = stdevDiff * horizonScaling * confidenceLevel;
+        nettingSetZeroOrderDIM_.at(n)[j] *= E_OneOverNumeraire;
+
+        // the simple DIM only needs two order statistics, so we select them instead of sorting the distribution
+        vector<Real> delNpvVec_copy = deltaNpv;
+        Size lowerIndex = std::min(simple_dim_index_h, simple_dim_index_p);
+        Size upperIndex = std::max(simple_dim_index_h, simple_dim_index_p);
+        std::nth_element(delNpvVec_copy.begin(), delNpvVec_copy.begin() + upperIndex, delNpvVec_copy.end());
+        std::nth_element(delNpvVec_copy.begin(), delNpvVec_copy.begin() + lowerIndex,
+                         delNpvVec_copy.begin() + upperIndex);
+        Real simpleDim_h = delNpvVec_copy[simple_dim_index_h];
+        Real simpleDim_p = delNpvVec_copy[simple_dim_index_p];
+        simpleDim_h *= horizonScaling;                                  // the usual scaling factors
+        simpleDim_p *= horizonScaling;                                  // the usual scaling factors
+        nettingSetSimpleDIMh_.at(n)[j] = simpleDim_h * E_OneOverNumeraire; // discounted DIM
+        nettingSetSimpleDIMp_.at(n)[j] = simpleDim_p * E_OneOverNumeraire; // discounted DIM
+
+        vector<Real>& dim = nettingSetDIM_.at(n)[j];
+        vector<Real>& localDim = nettingSetLocalDIM_.at(n)[j];
+
+        QL_REQUIRE(rx.size() > v.size(), "not enough points for regression with polynom order " << polynomOrder);
+        if (close_enough(stdevDiff, 0.0)) {
+            DLOG("DIM: Zero std dev estimation at step " << j);
+            // Skip IM calculation if all samples have zero NPV (e.g. after latest maturity)
+            std::fill(dim.begin(), dim.end(), 0.0);
+            std::fill(localDim.begin(), localDim.end(), 0.0);
+            return;
+        }
+
+        // Least squares polynomial regression with specified polynom order
+        QuantExt::StabilisedGLLS ls(rx, ry2, v, QuantExt::StabilisedGLLS::MeanStdDev);
+        DLOG("DIM data normalisation at time step "
+            << j << ": " << scientific << setprecision(6) << " x-shift = " << ls.xShift() << " x-multiplier = "
+            << ls.xMultiplier() << " y-shift = " << ls.yShift() << " y-multiplier = " << ls.yMultiplier());
+        DLOG("DIM regression coefficients at time step " << j << ": " << fixed << setprecision(6)
+                                                        << ls.transformedCoefficients());
+
+        // Local regression versus first regression variable (i.e. we do not perform a
+        // multidimensional local regression):
+        // We evaluate this at a limited number of samples only for validation purposes.
+        // For large numbers of samples we use the binned estimator, so that the effort is linear in the number of
+        // samples, the exact estimator scales quadratically. If the range of the regressor is too wide for the grid
+        // spacing to be small compared to the bandwidth, the binned estimator falls back to the exact evaluation.
+        // NadarayaWatson needs a large number of samples for good results.
+        std::function<Real(Real)> localStdDev;
+        if (localRegressionEvaluations_ > 0) {
+            GaussianKernel kernel(0.0, localRegressionBandWidth_);
+            if (samples <= localRegressionBins) {
+                auto lr = QuantLib::ext::make_shared<QuantExt::NadarayaWatson>(rx0.begin(), rx0.end(), ry1.begin(),
+                                                                               kernel);
+                localStdDev = [lr](const Real x) { return lr->standardDeviation(x); };
             } else {
-                // Least squares polynomial regression with specified polynom order
-                QuantExt::StabilisedGLLS ls(rx, ry2, v, QuantExt::StabilisedGLLS::MeanStdDev);
-                DLOG("DIM data normalisation at time step "
-                    << j << ": " << scientific << setprecision(6) << " x-shift = " << ls.xShift() << " x-multiplier = "
-                    << ls.xMultiplier() << " y-shift = " << ls.yShift() << " y-multiplier = " << ls.yMultiplier());
-                DLOG("DIM regression coefficients at time step " << j << ": " << fixed << setprecision(6)
-                                                                << ls.transformedCoefficients());
-
-                // Local regression versus first regression variable (i.e. we do not perform a
-                // multidimensional local regression):
-                // We evaluate this at a limited number of samples only for validation purposes.
-                // Note that computational effort scales quadratically with number of samples.
-                // NadarayaWatson needs a large number of samples for good results.
-                QuantExt::NadarayaWatson lr(rx0.begin(), rx0.end(), ry1.begin(),
-                                            GaussianKernel(0.0, localRegressionBandWidth_));
-                Size localRegressionSamples = samples;
-                if (localRegressionEvaluations_ > 0)
-                    localRegressionSamples = Size(floor(1.0 * samples / localRegressionEvaluations_ + .5));
-
-                // Evaluate regression function to compute DIM for each scenario
-                for (Size k = 0; k < samples; ++k) {
-                    // Real num1 = scenarioData_->get(j, k, AggregationScenarioDataType::Numeraire);
-                    Real numDefault = cubeInterpretation_->getDefaultAggregationScenarioData(
-                        scenarioData_, AggregationScenarioDataType::Numeraire, j, k);
-                    Array regressor = regressors_.empty() ? Array(1, nettingSetNPV_[n][j][k]) : regressorArray(n, j, k);
-                    Real e = ls.eval(regressor, v);
-                    if (e < 0.0)
-                        DLOG("Negative variance regression for date " << j << ", sample " << k
-                                                                     << ", regressor = " << regressor);
-
-                    // Note:
-                    // 1) We assume vanishing mean of "z", because the drift over a MPOR is usually small,
-                    //    and to avoid a second regression for the conditional mean
-                    // 2) In particular the linear regression function can yield negative variance values in
-                    //    extreme scenarios where an exact analytical or delta VaR calculation would yield a
-                    //    variance approaching zero. We correct this here by taking the positive part.
-                    Real std = std::sqrt(std::max(e, 0.0));
-                    Real scalingFactor = horizonScaling * confidenceLevel * nettingSetDimScaling;
-                    // Real dim = std * scalingFactor / num1;
-                    Real dim = std * scalingFactor / numDefault;
-                    dimCube_->set(dim, nettingSetCount, j, k);
-                    nettingSetDIM_[n][j][k] = dim;
-                    nettingSetExpectedDIM_[n][j] += dim / samples;
-
-                    // Evaluate the Kernel regression for a subset of the samples only (performance)
-                    if (localRegressionEvaluations_ > 0 && (k % localRegressionSamples == 0))
-                        // nettingSetLocalDIM_[n][j][k] = lr.standardDeviation(regressor[0]) * scalingFactor / num1;
-                        nettingSetLocalDIM_[n][j][k] = lr.standardDeviation(regressor[0]) * scalingFactor / numDefault;
-                    else
-                        nettingSetLocalDIM_[n][j][k] = 0.0;
-                }
+                auto lr = QuantLib::ext::make_shared<QuantExt::BinnedNadarayaWatson>(
+                    rx0.begin(), rx0.end(), ry1.begin(), kernel, localRegressionBandWidth_, localRegressionBins);
+                localStdDev = [lr](const Real x) { return lr->standardDeviation(x); };
             }
         }
+        Size localRegressionSamples = samples;
+        if (localRegressionEvaluations_ > 0)
+            localRegressionSamples = std::max<Size>(Size(floor(1.0 * samples / localRegressionEvaluations_ + .5)), 1);
+
+        // Evaluate regression function to compute DIM for each scenario
+        Real expectedDim = 0.0;
+        for (Size k = 0; k < samples; ++k) {
+            const Array& regressor = rx[k];
+            Real e = ls.eval(regressor, v);
+            if (e < 0.0)
+                DLOG("Negative variance regression for date " << j << ", sample " << k
+                                                             << ", regressor = " << regressor);
+
+            // Note:
+            // 1) We assume vanishing mean of "z", because the drift over a MPOR is usually small,
+            //    and to avoid a second regression for the conditional mean
+            // 2) In particular the linear regression function can yield negative variance values in
+            //    extreme scenarios where an exact analytical or delta VaR calculation would yield a
+            //    variance approaching zero. We correct this here by taking the positive part.
+            Real std = std::sqrt(std::max(e, 0.0));
+            Real scalingFactor = horizonScaling * confidenceLevel * ns.scaling;
+            dim[k] = std * scalingFactor / numDefault[k];
+            expectedDim += dim[k] / samples;
+
+            // Evaluate the Kernel regression for a subset of the samples only (performance)
+            if (localRegressionEvaluations_ > 0 && (k % localRegressionSamples == 0))
+                localDim[k] = localStdDev(regressor[0]) * scalingFactor / numDefault[k];
+            else
+                localDim[k] = 0.0;
+        }
+        nettingSetExpectedDIM_.at(n)[j] += expectedDim;
+        dimCube_->setSamples(dim, ns.dimCubeIndex, j, 0);
+    });
 
-        nettingSetCount++;
-    }
     DLOG("DIM by polynomial regression done");
 }
 
-Array RegressionDynamicInitialMarginCalculator::regressorArray(string nettingSet, Size dateIndex,
-                                                                           Size sampleIndex) {
+Array RegressionDynamicInitialMarginCalculator::regressorArray(const vector<Real>& npv, Size dateIndex,
+                                                               Size sampleIndex) const {
     Array a(regressors_.size());
     for (Size i = 0; i < regressors_.size(); ++i) {
-        string variable = regressors_[i];
-        if (boost::to_upper_copy(variable) ==
-            "NPV") // this allows possibility to include NPV as a regressor alongside more fundamental risk factors
-            a[i] = nettingSetNPV_[nettingSet][dateIndex][sampleIndex];
-        else if (scenarioData_->has(AggregationScenarioDataType::IndexFixing, variable))
-            a[i] = cubeInterpretation_->getDefaultAggregationScenarioData(
-                scenarioData_, AggregationScenarioDataType::IndexFixing, dateIndex, sampleIndex, variable);
-        else if (scenarioData_->has(AggregationScenarioDataType::FXSpot, variable))
-            a[i] = cubeInterpretation_->getDefaultAggregationScenarioData(
-                scenarioData_, AggregationScenarioDataType::FXSpot, dateIndex, sampleIndex, variable);
-        else if (scenarioData_->has(AggregationScenarioDataType::Generic, variable))
-            a[i] = cubeInterpretation_->getDefaultAggregationScenarioData(
-                scenarioData_, AggregationScenarioDataType::Generic, dateIndex, sampleIndex, variable);
+        if (regressorHandles_[i] == Null<Size>())
+            a[i] = npv[sampleIndex];
         else
-            QL_FAIL("scenario data does not provide data for " << variable);
+            a[i] = cubeInterpretation_->getDefaultAggregationScenarioSamples(scenarioData_, regressorHandles_[i],
+                                                                             dateIndex)[sampleIndex];
     }
     return a;
 }
@@ -454,11 +509,9 @@ void RegressionDynamicInitialMarginCalculator::exportDimRegression(
         QL_REQUIRE(timeStep < dates - 1, "selected time step " << timeStep << " out of range [0, " << dates - 1 << "]");
 
         Size samples = cube_->samples();
-        vector<Real> numeraires(samples, 0.0);
-        for (Size k = 0; k < samples; ++k)
-            // numeraires[k] = scenarioData_->get(timeStep, k, AggregationScenarioDataType::Numeraire);
-            numeraires[k] = cubeInterpretation_->getDefaultAggregationScenarioData(
-                scenarioData_, AggregationScenarioDataType::Numeraire, timeStep, k);
+        auto numeraireSamples = cubeInterpretation_->getDefaultAggregationScenarioSamples(
+            scenarioData_, scenarioData_->handle(AggregationScenarioDataType::Numeraire), timeStep);
+        vector<Real> numeraires(numeraireSamples.begin(), numeraireSamples.begin() + samples);
 
         auto p = sort_permutation(regressorArray_[nettingSet][timeStep], lessThan);
         vector<Array> reg = apply_permutation(regressorArray_[nettingSet][timeStep], p);
@@ -78,13 +78,15 @@ public:
     const vector<Real>& simpleResultsLower(const string& nettingSet);
 
 private:
-    //! Compile the array of DIM regressors for the specified netting set, date and sample index
-    Array regressorArray(string nettingSet, Size dateIndex, Size sampleIndex);
+    //! Compile the array of DIM regressors for the specified date and sample index given the netting set NPVs
+    Array regressorArray(const vector<Real>& npv, Size dateIndex, Size sampleIndex) const;
 
     Size regressionOrder_;
     vector<string> regressors_;
     Size localRegressionEvaluations_;
     Real localRegressionBandWidth_;
+    // Scenario data handles of the regressors, Null<Size>() for the netting set NPV
+    vector<Size> regressorHandles_;
 
     // For each netting set: Array of regressor values by date and sample
     map<string, vector<vector<Array>>> regressorArray_;
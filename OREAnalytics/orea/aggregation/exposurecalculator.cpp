@@ -21,10 +21,13 @@
 
 #include <ored/portfolio/structuredtradeerror.hpp>
 #include <ored/portfolio/trade.hpp>
+#include <ored/utilities/parallel.hpp>
 
 #include <ql/time/date.hpp>
 #include <ql/time/calendars/weekendsonly.hpp>
 
+#include <numeric>
+
 using namespace std;
 using namespace QuantLib;
 
@@ -38,13 +41,13 @@ ExposureCalculator::ExposureCalculator(
     const QuantLib::ext::shared_ptr<Market>& market, bool exerciseNextBreak, const string& baseCurrency,
     const string& configuration, const Real quantile, const CollateralExposureHelper::CalculationType calcType,
     const bool multiPath, const bool flipViewXVA, const bool exposureProfilesUseCloseOutValues, bool continueOnError,
-    bool useDoublePrecisionCubes)
+    bool useDoublePrecisionCubes, Size nThreads)
     : portfolio_(portfolio), cube_(cube), cubeInterpretation_(cubeInterpretation),
       aggregationScenarioData_(aggregationScenarioData), market_(market), exerciseNextBreak_(exerciseNextBreak),
       baseCurrency_(baseCurrency), configuration_(configuration), quantile_(quantile), calcType_(calcType),
       multiPath_(multiPath), dates_(cube->dates()), today_(market_->asofDate()), dc_(ActualActual(ActualActual::ISDA)),
       flipViewXVA_(flipViewXVA), exposureProfilesUseCloseOutValues_(exposureProfilesUseCloseOutValues),
-      continueOnError_(continueOnError) {
+      continueOnError_(continueOnError), nThreads_(nThreads) {
 
     QL_REQUIRE(portfolio_, "portfolio is null");
 
@@ -86,10 +89,22 @@ void ExposureCalculator::build() {
         included.
         This may effect DateGrids with daily data points*/
     const Date baselMaxEEPDate = WeekendsOnly().adjust(today + 1 * Years + 4 * Days);
+
+    // Step 1: collect the trade data needed for the aggregation, this requires the market and is done on this thread
+
+    struct TradeData {
+        string tradeId;
+        QuantLib::ext::shared_ptr<Trade> trade;
+        Size cubeIdx, exposureCubeIdx;
+        Date nextBreakDate;
+        vector<vector<Real>> *defaultValue, *closeOutValue, *mporPositiveFlow, *mporNegativeFlow;
+        vector<Real> epe, ene, pfe;
+    };
+    vector<TradeData> tradeData;
+    tradeData.reserve(portfolio_->size());
+
     for (auto const& [tradeId, trade] : portfolio_->trades()) {
         string nettingSetId = trade->envelope().nettingSetId();
-        std::size_t i = cube_->getTradeIndex(tradeId);
-        LOG("Aggregate exposure for trade " << tradeId);
         if (nettingSetDefaultValue_.find(nettingSetId) == nettingSetDefaultValue_.end()) {
             nettingSetDefaultValue_[nettingSetId] = vector<vector<Real>>(dates_.size(), vector<Real>(cube_->samples(), 0.0));
             nettingSetCloseOutValue_[nettingSetId] = vector<vector<Real>>(dates_.size(), vector<Real>(cube_->samples(), 0.0));
@@ -146,20 +161,100 @@ void ExposureCalculator::build() {
             }
         }
 
-        Handle<YieldTermStructure> curve = market_->discountCurve(baseCurrency_, configuration_);
+        tradeData.push_back({tradeId, trade, cube_->getTradeIndex(tradeId), exposureCube_->getTradeIndex(tradeId),
+                             nextBreakDate, &nettingSetDefaultValue_[nettingSetId],
+                             &nettingSetCloseOutValue_[nettingSetId], &nettingSetMporPositiveFlow_[nettingSetId],
+                             &nettingSetMporNegativeFlow_[nettingSetId], vector<Real>(dates_.size() + 1, 0.0),
+                             vector<Real>(dates_.size() + 1, 0.0), vector<Real>(dates_.size() + 1, 0.0)});
+    }
+
+    /* Step 2: aggregate the cube data over the samples, the dates are independent of each other, so we process them
+       in parallel. Each date only touches its own slice of the netting set buffers, the exposure cube and the trade
+       profiles, and the trades are aggregated in a fixed order, so the result does not depend on the number of
+       threads. */
+
+    LOG("Aggregate exposure for " << tradeData.size() << " trades and " << dates_.size() << " dates using "
+                                  << std::min<Size>(nThreads_, dates_.size()) << " threads");
+
+    const Size samples = cube_->samples();
+    const Size pfeIndex = Size(floor(quantile_ * (samples - 1) + 0.5));
+
+    ore::data::parallelFor(dates_.size(), nThreads_, [this, &tradeData, samples, pfeIndex](const Size j) {
+        const Date d = dates_[j];
+        vector<Real> defaultValues(samples), closeOutValues(samples), positiveCashFlows(samples),
+            negativeCashFlows(samples), distribution(samples), positiveExposures(samples), negativeExposures(samples);
+        for (auto& t : tradeData) {
+            // RL 2020-07-17
+            // 1) If the calculation type is set to NoLag:
+            //    Collateral balances are NOT delayed by the MPoR, but we use the close-out NPV.
+            // 2) Otherwise:
+            //    Collateral balances are delayed by the MPoR (if possible, i.e. the valuation
+            //    grid has MPoR spacing), and we use the default date NPV.
+            //    This is the treatment in the ORE releases up to June 2020).
+            bool terminated = d > t.nextBreakDate && exerciseNextBreak_;
+            if (terminated)
+                std::fill(defaultValues.begin(), defaultValues.end(), 0.0);
+            else
+                cubeInterpretation_->getDefaultNpvs(cube_, t.cubeIdx, j, defaultValues);
+            if (isRegularCubeStorage_ && j == dates_.size() - 1)
+                closeOutValues = defaultValues;
+            else if (terminated)
+                std::fill(closeOutValues.begin(), closeOutValues.end(), 0.0);
+            else
+                cubeInterpretation_->getCloseOutNpvs(cube_, t.cubeIdx, j, aggregationScenarioData_, closeOutValues);
+            cubeInterpretation_->getMporPositiveFlows(cube_, t.cubeIdx, j, positiveCashFlows);
+            cubeInterpretation_->getMporNegativeFlows(cube_, t.cubeIdx, j, negativeCashFlows);
+            // for single trade exposures, the default value is relevant, unless we force
+            // using the close out value instead
+            const vector<Real>& npvs = exposureProfilesUseCloseOutValues_ ? closeOutValues : defaultValues;
+            vector<Real>& nsDefaultValue = (*t.defaultValue)[j];
+            vector<Real>& nsCloseOutValue = (*t.closeOutValue)[j];
+            vector<Real>& nsMporPositiveFlow = (*t.mporPositiveFlow)[j];
+            vector<Real>& nsMporNegativeFlow = (*t.mporNegativeFlow)[j];
+            Real epe = 0.0, ene = 0.0;
+            for (Size k = 0; k < samples; ++k) {
+                positiveExposures[k] = std::max(npvs[k], 0.0);
+                negativeExposures[k] = std::max(-npvs[k], 0.0);
+                epe += positiveExposures[k] / samples;
+                ene += negativeExposures[k] / samples;
+                nsDefaultValue[k] += defaultValues[k];
+                nsCloseOutValue[k] += closeOutValues[k];
+                nsMporPositiveFlow[k] += positiveCashFlows[k];
+                nsMporNegativeFlow[k] += negativeCashFlows[k];
+            }
+            t.epe[j + 1] = epe;
+            t.ene[j + 1] = ene;
+            if (multiPath_) {
+                exposureCube_->setSamples(positiveExposures, t.exposureCubeIdx, j, ExposureIndex::EPE);
+                exposureCube_->setSamples(negativeExposures, t.exposureCubeIdx, j, ExposureIndex::ENE);
+            } else {
+                exposureCube_->set(epe, t.exposureCubeIdx, j, 0, ExposureIndex::EPE);
+                exposureCube_->set(ene, t.exposureCubeIdx, j, 0, ExposureIndex::ENE);
+            }
+            // we only need one order statistic, so a selection is sufficient here
+            distribution = npvs;
+            std::nth_element(distribution.begin(), distribution.begin() + pfeIndex, distribution.end());
+            t.pfe[j + 1] = std::max(distribution[pfeIndex], 0.0);
+        }
+    });
+
+    // Step 3: t0 values and discounted, time averaged profiles, this requires the market again
+
+    Handle<YieldTermStructure> curve = market_->discountCurve(baseCurrency_, configuration_);
+    for (auto& t : tradeData) {
         Real npv0;
         if (flipViewXVA_) {
-            npv0 = -cube_->getT0(i);
+            npv0 = -cube_->getT0(t.cubeIdx);
         } else {
-            npv0 = cube_->getT0(i);
+            npv0 = cube_->getT0(t.cubeIdx);
         }
         Real epe_b_runningSum = 0.0;
         Real eepe_b_runningSum = 0.0;
-        vector<Real> epe(dates_.size() + 1, 0.0);
-        vector<Real> ene(dates_.size() + 1, 0.0);
+        vector<Real>& epe = t.epe;
+        vector<Real>& ene = t.ene;
+        vector<Real>& pfe = t.pfe;
         vector<Real> ee_b(dates_.size() + 1, 0.0);
         vector<Real> eee_b(dates_.size() + 1, 0.0);
-        vector<Real> pfe(dates_.size() + 1, 0.0);
         vector<Real> epe_b(dates_.size() + 1, 0.0);
         vector<Real> eepe_b(dates_.size() + 1, 0.0);
         epe[0] = std::max(npv0, 0.0);
@@ -169,71 +264,28 @@ void ExposureCalculator::build() {
         epe_b[0] = ee_b[0];
         eepe_b[0] = eee_b[0];
         pfe[0] = std::max(npv0, 0.0);
-        exposureCube_->setT0(epe[0], tradeId, ExposureIndex::EPE);
-        exposureCube_->setT0(ene[0], tradeId, ExposureIndex::ENE);
+        exposureCube_->setT0(epe[0], t.exposureCubeIdx, ExposureIndex::EPE);
+        exposureCube_->setT0(ene[0], t.exposureCubeIdx, ExposureIndex::ENE);
         for (Size j = 0; j < dates_.size(); ++j) {
             Date d = cube_->dates()[j];
-            vector<Real> distribution(cube_->samples(), 0.0);
-            for (Size k = 0; k < cube_->samples(); ++k) {
-                // RL 2020-07-17
-                // 1) If the calculation type is set to NoLag:
-                //    Collateral balances are NOT delayed by the MPoR, but we use the close-out NPV.
-                // 2) Otherwise:
-                //    Collateral balances are delayed by the MPoR (if possible, i.e. the valuation
-                //    grid has MPoR spacing), and we use the default date NPV.
-                //    This is the treatment in the ORE releases up to June 2020).
-                Real defaultValue =
-                    d > nextBreakDate && exerciseNextBreak_ ? 0.0 : cubeInterpretation_->getDefaultNpv(cube_, i, j, k);
-                Real closeOutValue;
-                if (isRegularCubeStorage_ && j == dates_.size() - 1)
-                    closeOutValue = defaultValue;
-                else
-                    closeOutValue = d > nextBreakDate && exerciseNextBreak_
-                                        ? 0.0
-                                        : cubeInterpretation_->getCloseOutNpv(cube_, i, j, k, aggregationScenarioData_);
-
-                Real positiveCashFlow = cubeInterpretation_->getMporPositiveFlows(cube_, i, j, k);
-                Real negativeCashFlow = cubeInterpretation_->getMporNegativeFlows(cube_, i, j, k);
-                // for single trade exposures, the default value is relevant, unless we force
-		// using the close out value instead
-                Real npv = exposureProfilesUseCloseOutValues_ ? closeOutValue : defaultValue;
-                epe[j + 1] += std::max(npv, 0.0) / cube_->samples();
-                ene[j + 1] += std::max(-npv, 0.0) / cube_->samples();
-                nettingSetDefaultValue_[nettingSetId][j][k] += defaultValue;
-                nettingSetCloseOutValue_[nettingSetId][j][k] += closeOutValue;
-                nettingSetMporPositiveFlow_[nettingSetId][j][k] += positiveCashFlow;
-                nettingSetMporNegativeFlow_[nettingSetId][j][k] += negativeCashFlow;
-                distribution[k] = npv;
-                if (multiPath_) {
-                    exposureCube_->set(std::max(npv, 0.0), tradeId, d, k, ExposureIndex::EPE);
-                    exposureCube_->set(std::max(-npv, 0.0), tradeId, d, k, ExposureIndex::ENE);
-                }
-            }
-            if (!multiPath_) {
-                exposureCube_->set(epe[j + 1], tradeId, d, 0, ExposureIndex::EPE);
-                exposureCube_->set(ene[j + 1], tradeId, d, 0, ExposureIndex::ENE);
-            }
             ee_b[j + 1] = epe[j + 1] / curve->discount(cube_->dates()[j]);
             eee_b[j + 1] = std::max(eee_b[j], ee_b[j + 1]);
-            if (d <= trade->maturity()) {
+            if (d <= t.trade->maturity()) {
                 epe_b_runningSum += ee_b[j + 1] * timeDeltas[j];
                 eepe_b_runningSum += eee_b[j + 1] * timeDeltas[j];
                 epe_b[j + 1] = epe_b_runningSum / times[j];
                 eepe_b[j + 1] = eepe_b_runningSum / times[j];
                 if(d <= baselMaxEEPDate){
-                    epe_b_[tradeId] = epe_b[j + 1];
-                    eepe_b_[tradeId] = eepe_b[j + 1];
+                    epe_b_[t.tradeId] = epe_b[j + 1];
+                    eepe_b_[t.tradeId] = eepe_b[j + 1];
                 }
             }
-            std::sort(distribution.begin(), distribution.end());
-            Size index = Size(floor(quantile_ * (cube_->samples() - 1) + 0.5));
-            pfe[j + 1] = std::max(distribution[index], 0.0);
         }
-        ee_b_[tradeId] = ee_b;
-        eee_b_[tradeId] = eee_b;
-        pfe_[tradeId] = pfe;
-        epe_bTimeWeighted_[tradeId] = epe_b;
-        eepe_bTimeWeighted_[tradeId] = eepe_b;
+        ee_b_[t.tradeId] = ee_b;
+        eee_b_[t.tradeId] = eee_b;
+        pfe_[t.tradeId] = pfe;
+        epe_bTimeWeighted_[t.tradeId] = epe_b;
+        eepe_bTimeWeighted_[t.tradeId] = eepe_b;
     }
 }
 
@@ -241,11 +293,10 @@ vector<Real> ExposureCalculator::getMeanExposure(const string& tid, ExposureInde
     Size tidx = exposureCube_->getTradeIndex(tid);
     vector<Real> exp(dates_.size() + 1, 0.0);
     exp[0] = exposureCube_->getT0(tidx, index);
+    vector<Real> values;
     for (Size i = 0; i < dates_.size(); i++) {
-        for (Size k = 0; k < exposureCube_->samples(); k++) {
-            exp[i + 1] += exposureCube_->get(tidx, i, k, index);
-        }
-        exp[i + 1] /= exposureCube_->samples();
+        exposureCube_->getSamples(tidx, i, index, values);
+        exp[i + 1] = std::accumulate(values.begin(), values.end(), 0.0) / exposureCube_->samples();
     }
     return exp;
 }
@@ -73,7 +73,9 @@ public:
         //! Continue with the calculation if possible when there is an error
         bool continueOnError = false,
         //! use double precision cube
-        bool useDoublePrecisionCubes = false);
+        bool useDoublePrecisionCubes = false,
+        //! Number of threads used to aggregate the cube over the simulation dates
+        Size nThreads = 1);
 
     virtual ~ExposureCalculator() {}
 
@@ -163,6 +165,7 @@ protected:
     bool flipViewXVA_;
     bool exposureProfilesUseCloseOutValues_ = false;
     bool continueOnError_;
+    Size nThreads_;
 };
 
 } // namespace analytics
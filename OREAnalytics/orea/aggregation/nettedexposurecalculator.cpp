@@ -137,9 +137,8 @@ void NettedExposureCalculator::build() {
     const Date baselMaxEEPDate = WeekendsOnly().adjust(today + 1 * Years + 4 * Days);
 
     Size nettingSetCount = 0;
-    for (auto n : nettingSetDefaultValue_) {
+    for (auto const& n : nettingSetDefaultValue_) {
         string nettingSetId = n.first;
-        vector<vector<Real>> data = n.second;
         QuantLib::ext::shared_ptr<NettingSetDefinition> netting = nettingSetManager_->get(nettingSetId);
 
         // retrieve collateral balances object, if possible
@@ -151,12 +150,13 @@ void NettedExposureCalculator::build() {
 
 	// Only for active CSA and calcType == NoLag close-out value is relevant, unless we force
 	// using close-out values in the absence of an active CSA
-        if ((netting->activeCsaFlag() || exposureProfilesUseCloseOutValues_) &&
-	    calcType_ == CollateralExposureHelper::CalculationType::NoLag) 
-            data = nettingSetCloseOutValue_[nettingSetId];
-        
-        vector<vector<Real>> nettingSetMporPositiveFlow = nettingSetMporPositiveFlow_[nettingSetId];
-        vector<vector<Real>> nettingSetMporNegativeFlow = nettingSetMporNegativeFlow_[nettingSetId];
+        const vector<vector<Real>>& data = (netting->activeCsaFlag() || exposureProfilesUseCloseOutValues_) &&
+                                                   calcType_ == CollateralExposureHelper::CalculationType::NoLag
+                                               ? nettingSetCloseOutValue_.at(nettingSetId)
+                                               : n.second;
+
+        const vector<vector<Real>>& nettingSetMporPositiveFlow = nettingSetMporPositiveFlow_.at(nettingSetId);
+        const vector<vector<Real>>& nettingSetMporNegativeFlow = nettingSetMporNegativeFlow_.at(nettingSetId);
 
         LOG("Aggregate exposure for netting set " << nettingSetId);
         // Get the collateral account balance paths for the netting set.
@@ -425,8 +425,8 @@ void NettedExposureCalculator::build() {
                     eepe_b_[nettingSetId] = eepe_b[j + 1];
                 }
             }
-            std::sort(distribution.begin(), distribution.end());
             Size index = Size(floor(quantile_ * (cube_->samples() - 1) + 0.5));
+            std::nth_element(distribution.begin(), distribution.begin() + index, distribution.end());
             pfe[j + 1] = std::max(distribution[index], 0.0);
         }
         ee_b_[nettingSetId] = ee_b;
@@ -508,17 +508,25 @@ NettedExposureCalculator::collateralPaths(const string& nettingSetId, const Real
         QL_REQUIRE(scenarioData_->has(AggregationScenarioDataType::IndexFixing, csaIndexName),
                    "scenario data does not provide index values for " << csaIndexName);
     }
+    Size fxHandle = netting->csaDetails()->csaCurrency() != baseCurrency_
+                        ? scenarioData_->handle(AggregationScenarioDataType::FXSpot,
+                                                netting->csaDetails()->csaCurrency())
+                        : Null<Size>();
+    Size indexHandle =
+        csaIndexName != "" ? scenarioData_->handle(AggregationScenarioDataType::IndexFixing, csaIndexName) : Null<Size>();
+    QL_REQUIRE(scenarioData_->dimSamples() >= cube_->samples(), "scenario data has fewer samples ("
+                                                                    << scenarioData_->dimSamples() << ") than the cube ("
+                                                                    << cube_->samples() << ")");
     for (Size j = 0; j < cube_->dates().size(); ++j) {
-        for (Size k = 0; k < cube_->samples(); ++k) {
-	  if (netting->csaDetails()->csaCurrency() != baseCurrency_)
-              csaScenFxRates[j][k] = cubeInterpretation_->getDefaultAggregationScenarioData(
-                  scenarioData_, AggregationScenarioDataType::FXSpot, j, k, netting->csaDetails()->csaCurrency());
-            else
-                csaScenFxRates[j][k] = 1.0;
-            if (csaIndexName != "") {
-                csaScenRates[j][k] = cubeInterpretation_->getDefaultAggregationScenarioData(
-                    scenarioData_, AggregationScenarioDataType::IndexFixing, j, k, csaIndexName);
-            }
+        if (fxHandle != Null<Size>()) {
+            auto fx = cubeInterpretation_->getDefaultAggregationScenarioSamples(scenarioData_, fxHandle, j);
+            std::copy_n(fx.begin(), cube_->samples(), csaScenFxRates[j].begin());
+        } else {
+            std::fill(csaScenFxRates[j].begin(), csaScenFxRates[j].end(), 1.0);
+        }
+        if (indexHandle != Null<Size>()) {
+            auto rates = cubeInterpretation_->getDefaultAggregationScenarioSamples(scenarioData_, indexHandle, j);
+            std::copy_n(rates.begin(), cube_->samples(), csaScenRates[j].begin());
         }
     }
 
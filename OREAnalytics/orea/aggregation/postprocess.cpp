@@ -72,7 +72,8 @@ PostProcess::PostProcess(const QuantLib::ext::shared_ptr<Portfolio>& portfolio,
                          const std::vector<Real>& creditMigrationDistributionGrid,
                          const std::vector<Size>& creditMigrationTimeSteps, const Matrix& creditStateCorrelationMatrix,
                          bool withMporStickyDate, MporCashFlowMode mporCashFlowMode,
-                         const bool firstMporCollateralAdjustment, bool continueOnError, bool useDoublePrecisionCubes)
+                         const bool firstMporCollateralAdjustment, bool continueOnError, bool useDoublePrecisionCubes,
+                         Size nThreads)
     : portfolio_(portfolio), nettingSetManager_(nettingSetManager), collateralBalances_(collateralBalances),
       market_(market), configuration_(configuration), cube_(cube), cptyCube_(cptyCube), scenarioData_(scenarioData),
       analytics_(analytics), baseCurrency_(baseCurrency), quantile_(quantile),
@@ -88,7 +89,7 @@ PostProcess::PostProcess(const QuantLib::ext::shared_ptr<Portfolio>& portfolio,
       creditMigrationTimeSteps_(creditMigrationTimeSteps), creditStateCorrelationMatrix_(creditStateCorrelationMatrix),
       withMporStickyDate_(withMporStickyDate), mporCashFlowMode_(mporCashFlowMode),
       firstMporCollateralAdjustment_(firstMporCollateralAdjustment), continueOnError_(continueOnError),
-      useDoublePrecisionCubes_(useDoublePrecisionCubes) {
+      useDoublePrecisionCubes_(useDoublePrecisionCubes), nThreads_(nThreads) {
 
     LOG("PostProcess: started.");
 
@@ -142,7 +143,7 @@ PostProcess::PostProcess(const QuantLib::ext::shared_ptr<Portfolio>& portfolio,
     exposureCalculator_ = QuantLib::ext::make_shared<ExposureCalculator>(
         portfolio, cube_, cubeInterpretation_, scenarioData_, market_, analytics_["exerciseNextBreak"], baseCurrency_,
         configuration_, quantile_, calcType_, analytics_["dynamicCredit"], analytics_["flipViewXVA"],
-        analytics_["exposureProfilesUseCloseOutValues"], continueOnError_, useDoublePrecisionCubes_);
+        analytics_["exposureProfilesUseCloseOutValues"], continueOnError_, useDoublePrecisionCubes_, nThreads_);
     exposureCalculator_->build();
 
     /******************************************************************
@@ -293,7 +294,7 @@ PostProcess::PostProcess(const QuantLib::ext::shared_ptr<Portfolio>& portfolio,
         creditMigrationCalculator_ = QuantLib::ext::make_shared<CreditMigrationCalculator>(
             portfolio_, creditSimulationParameters_, cube_, cubeInterpretation_,
             nettedExposureCalculator_->nettedCube(), scenarioData_, creditMigrationDistributionGrid_,
-            creditMigrationTimeSteps_, creditStateCorrelationMatrix_, baseCurrency_);
+            creditMigrationTimeSteps_, creditStateCorrelationMatrix_, baseCurrency_, nThreads_);
         creditMigrationCalculator_->build();
         creditMigrationUpperBucketBounds_ = creditMigrationCalculator_->upperBucketBounds();
         creditMigrationCdf_ = creditMigrationCalculator_->cdf();
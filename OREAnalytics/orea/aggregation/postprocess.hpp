@@ -179,7 +179,9 @@ public:
         //! Continue with the calculation if possible when there is an error
         bool continueOnError = false,
         //! use double precision cubes
-        bool useDoublePrecisionCubes = false);
+        bool useDoublePrecisionCubes = false,
+        //! Number of threads used in the trade exposure aggregation
+        Size nThreads = 1);
 
     void setDimCalculator(QuantLib::ext::shared_ptr<DynamicInitialMarginCalculator> dimCalculator) {
         dimCalculator_ = dimCalculator;
@@ -412,6 +414,7 @@ protected:
     bool firstMporCollateralAdjustment_;
     bool continueOnError_;
     bool useDoublePrecisionCubes_;
+    Size nThreads_;
 };
 
 } // namespace analytics
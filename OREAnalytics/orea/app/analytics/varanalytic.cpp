@@ -69,6 +69,7 @@ void VarAnalyticImpl::runAnalytic(const QuantLib::ext::shared_ptr<ore::data::InM
 
     addAdditionalReports(reports);
 
+    varReport_->setAggregationThreads(inputs_->nThreads());
     varReport_->calculate(reports);
     CONSOLE("OK");
     
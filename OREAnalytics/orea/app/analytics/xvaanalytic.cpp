@@ -46,6 +46,9 @@
 
 #include <ored/model/crossassetmodelbuilder.hpp>
 #include <ored/portfolio/structuredtradeerror.hpp>
+#include <ored/utilities/parallel.hpp>
+
+#include <mutex>
 
 using namespace ore::data;
 using namespace boost::filesystem;
@@ -604,6 +607,7 @@ void XvaAnalyticImpl::buildClassicCube(const QuantLib::ext::shared_ptr<Portfolio
             inputs_->useAtParCouponsTrades());
 
         engine.setAggregationScenarioData(scenarioData_);
+        engine.setBatchesPerThread(inputs_->nBatchesPerThread());
         engine.registerProgressIndicator(progressBar);
         engine.registerProgressIndicator(progressLog);
 
@@ -776,6 +780,7 @@ void XvaAnalyticImpl::amcRun(bool doClassicRun, bool continueOnCalibrationError,
             amcEngine.registerProgressIndicator(progressBar);
             amcEngine.registerProgressIndicator(progressLog);
             amcEngine.aggregationScenarioData() = scenarioData_;
+            amcEngine.setUsePathCache(inputs_->amcPathCache());
             amcEngine.buildCube(amcPortfolio_, amcCube_);
         } else {
             auto cubeFactory = [this](const QuantLib::Date& asof, const std::set<std::string>& ids,
@@ -810,6 +815,7 @@ void XvaAnalyticImpl::amcRun(bool doClassicRun, bool continueOnCalibrationError,
             amcEngine.registerProgressIndicator(progressBar);
             amcEngine.registerProgressIndicator(progressLog);
             amcEngine.aggregationScenarioData() = scenarioData_;
+            amcEngine.setUsePathCache(inputs_->amcPathCache());
             amcEngine.buildCube(amcPortfolio_);
             amcCube_ = QuantLib::ext::make_shared<JointNPVCube>(amcEngine.outputCubes());
         }
@@ -952,7 +958,8 @@ void XvaAnalyticImpl::runPostProcessor() {
         flipViewLendingCurvePostfix, inputs_->creditSimulationParameters(), inputs_->creditMigrationDistributionGrid(),
         inputs_->creditMigrationTimeSteps(), creditStateCorrelationMatrix(),
         analytic()->configurations().scenarioGeneratorData->withMporStickyDate(), inputs_->mporCashFlowMode(),
-        firstMporCollateralAdjustment, inputs_->continueOnError(), inputs_->xvaUseDoublePrecisionCubes());
+        firstMporCollateralAdjustment, inputs_->continueOnError(), inputs_->xvaUseDoublePrecisionCubes(),
+        inputs_->nThreads());
     LOG("post done");
 }
 
@@ -1451,5 +1458,69 @@ Matrix XvaAnalyticImpl::creditStateCorrelationMatrix() const {
     return cmb.correlationMatrix(processInfo);
 }
 
+void runXvaAnalyticUnderScenarios(
+    const QuantLib::ext::shared_ptr<InputParameters>& inputs,
+    const QuantLib::ext::weak_ptr<ore::analytics::AnalyticsManager>& analyticsManager,
+    const QuantLib::ext::shared_ptr<ore::data::InMemoryLoader>& loader,
+    const QuantLib::ext::shared_ptr<ScenarioSimMarketParameters>& offsetSimMarketParams,
+    const std::vector<QuantLib::ext::shared_ptr<Scenario>>& scenarios, Size nThreads, const std::string& label,
+    const std::string& errorContext,
+    const std::function<void(Size, const QuantLib::ext::shared_ptr<Analytic>&)>& processResults) {
+
+#ifndef QL_ENABLE_SESSIONS
+    if (nThreads > 1) {
+        WLOG(label << ": concurrent scenario runs require a build with QL_ENABLE_SESSIONS = ON, run " << scenarios.size()
+                   << " scenarios sequentially.");
+        nThreads = 1;
+    }
+#endif
+
+    nThreads = std::max<Size>(1, std::min<Size>(nThreads, scenarios.size()));
+
+    // concurrent runs build their own copy of the portfolio and share the valuation threads
+
+    std::string portfolioXml;
+    Size valuationThreads = inputs->nThreads();
+    if (nThreads > 1) {
+        QL_REQUIRE(inputs->portfolio(), "runXvaAnalyticUnderScenarios(): no portfolio loaded.");
+        portfolioXml = inputs->portfolio()->toXMLString();
+        valuationThreads = std::max<Size>(1, inputs->nThreads() / nThreads);
+        LOG(label << ": run " << scenarios.size() << " scenarios on " << nThreads << " threads using "
+                  << valuationThreads << " valuation threads each");
+    }
+
+    ObservationMode::Mode obsMode = ObservationMode::instance().mode();
+    std::mutex resultsMutex;
+
+    ore::data::parallelFor(scenarios.size(), nThreads, [&](Size i) {
+        const std::string scenarioLabel = scenarios[i] != nullptr ? scenarios[i]->label() : std::string();
+        try {
+            auto scenarioInputs = inputs;
+            if (nThreads > 1) {
+                // set thread local singletons
+                Settings::instance().evaluationDate() = inputs->asof();
+                ObservationMode::instance().setMode(obsMode);
+                scenarioInputs = inputs->copyWithPortfolio(portfolioXml);
+                scenarioInputs->setThreads(valuationThreads);
+            }
+            DLOG("Calculate XVA for scenario " << scenarioLabel);
+            CONSOLE(label << ": Apply scenario " << scenarioLabel);
+            auto xvaAnalytic = AnalyticFactory::instance().build("XVA", scenarioInputs, analyticsManager, false).second;
+            auto xvaImpl = static_cast<XvaAnalyticImpl*>(xvaAnalytic->impl().get());
+            xvaImpl->setOffsetScenario(scenarios[i]);
+            xvaImpl->setOffsetSimMarketParams(offsetSimMarketParams);
+            CONSOLE(label << ": Calculate Exposure and XVA");
+            xvaAnalytic->runAnalytic(loader, {"EXPOSURE", "XVA"});
+            std::lock_guard<std::mutex> lock(resultsMutex);
+            processResults(i, xvaAnalytic);
+        } catch (const std::exception& e) {
+            StructuredAnalyticsErrorMessage(errorContext, "XVACalc",
+                                            "Error during XVA calc under scenario " + scenarioLabel + ", got " +
+                                                e.what() + ". Skip it")
+                .log();
+        }
+    });
+}
+
 } // namespace analytics
 } // namespace ore
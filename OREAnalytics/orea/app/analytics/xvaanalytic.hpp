@@ -122,5 +122,22 @@ public:
                    xvaAnalyticSubAnalytics, inputs, analyticsManager, false, false, false, false) {}
 };
 
+//! Runs an XVA analytic (EXPOSURE and XVA) under each of the given offset scenarios
+/*! Up to nThreads scenarios are run concurrently. Each concurrent run uses its own copy of the inputs holding its own
+    portfolio, the valuation threads given by InputParameters::nThreads() are split between the concurrent runs.
+    Concurrent runs require a build with QL_ENABLE_SESSIONS = ON, otherwise the scenarios are run sequentially.
+
+    The finished analytic of each run is passed to processResults together with the scenario index as soon as the run
+    has finished. The calls to processResults are serialised, but may happen on different threads and in any order.
+    If a run fails, a structured error is logged for errorContext and the scenario is skipped. */
+void runXvaAnalyticUnderScenarios(
+    const QuantLib::ext::shared_ptr<InputParameters>& inputs,
+    const QuantLib::ext::weak_ptr<ore::analytics::AnalyticsManager>& analyticsManager,
+    const QuantLib::ext::shared_ptr<ore::data::InMemoryLoader>& loader,
+    const QuantLib::ext::shared_ptr<ScenarioSimMarketParameters>& offsetSimMarketParams,
+    const std::vector<QuantLib::ext::shared_ptr<Scenario>>& scenarios, QuantLib::Size nThreads,
+    const std::string& label, const std::string& errorContext,
+    const std::function<void(QuantLib::Size, const QuantLib::ext::shared_ptr<Analytic>&)>& processResults);
+
 } // namespace analytics
 } // namespace ore
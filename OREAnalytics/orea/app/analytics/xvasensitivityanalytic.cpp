@@ -328,44 +328,33 @@ void XvaSensitivityAnalyticImpl::computeXvaUnderScenarios(std::map<size_t, ext::
     // Used for the raw report
     QL_REQUIRE(scenarioGenerator != nullptr,
                "Internal error: Can not compute XVA sensi without valid scenario generator.");
-    std::map<std::string, std::vector<ext::shared_ptr<InMemoryReport>>> xvaReports;
-    auto simMarketParams = analytic()->configurations().simMarketParams;
-
-    for (size_t i = 0; i < scenarioGenerator->samples(); ++i) {
-        auto scenario = scenarioGenerator->next(inputs_->asof());
-        auto desc = scenarioGenerator->scenarioDescriptions()[i];
-        const auto label = scenario->label();
-        try {
-            DLOG("Calculate XVA for scenario " << label);
-            CONSOLE("XVA_SENSITIVITY: Apply scenario " << label);
-            auto xvaAnalytic = AnalyticFactory::instance().build("XVA", inputs_, analytic()->analyticsManager(), false).second;
-            XvaAnalyticImpl* xvaImpl = static_cast<XvaAnalyticImpl*>(xvaAnalytic->impl().get());
-            xvaImpl->setOffsetScenario(scenario);
-            xvaImpl->setOffsetSimMarketParams(simMarketParams);
-	    
-	        CONSOLE("XVA_SENSITIVITY: Calculate Exposure and XVA")
-            xvaAnalytic->runAnalytic(loader, {"EXPOSURE", "XVA"});
+    std::map<std::string, std::map<size_t, ext::shared_ptr<InMemoryReport>>> xvaReports;
+
+    std::vector<QuantLib::ext::shared_ptr<Scenario>> scenarios;
+    for (size_t i = 0; i < scenarioGenerator->samples(); ++i)
+        scenarios.push_back(scenarioGenerator->next(inputs_->asof()));
+
+    // the results of each scenario are extracted as soon as its run has finished, so that the xva analytic and its
+    // cubes can be released
+    runXvaAnalyticUnderScenarios(
+        inputs_, analytic()->analyticsManager(), loader, analytic()->configurations().simMarketParams, scenarios,
+        inputs_->xvaSensiScenarioThreads(), "XVA_SENSITIVITY", "XvaSensitivity",
+        [&xvaResults, &xvaReports](size_t i, const QuantLib::ext::shared_ptr<Analytic>& xvaAnalytic) {
             // Collect exposure and xva reports
             auto rpts = xvaAnalytic->reports();
             auto it = rpts.find("XVA");
             QL_REQUIRE(it != rpts.end(), "XVA report not found in XVA analytic reports");
             for (auto [name, rpt] : it->second) {
-                // add scenario column to report and copy it, concat it later
                 if (boost::starts_with(name, "exposure") || boost::starts_with(name, "xva")) {
-                    xvaReports[name].push_back(rpt);
+                    xvaReports[name][i] = rpt;
                     if (name == "xva") {
                         xvaResults[i] = ext::make_shared<XvaResults>(rpt);
                     }
                 }
             }
-            createDetailReport(scenarioGenerator, xvaReports);
-        } catch (const std::exception& e) {
-            StructuredAnalyticsErrorMessage("XvaSensitivity", "XVACalc",
-                                            "Error during XVA calc under scenario " + label + ", got " + e.what() +
-                                                ". Skip it")
-                .log();
-        }
-    }
+        });
+
+    createDetailReport(scenarioGenerator, xvaReports);
 }
 
 void XvaSensitivityAnalyticImpl::createZeroReports(ZeroSensiResults& xvaZeroSeniCubes){
@@ -457,10 +446,10 @@ void XvaSensitivityAnalyticImpl::createParReports(ParSensiResults& xvaParSensiCu
 
 void XvaSensitivityAnalyticImpl::createDetailReport(
     const QuantLib::ext::shared_ptr<SensitivityScenarioGenerator>& scenarioGenerator,
-    const std::map<std::string, std::vector<ext::shared_ptr<InMemoryReport>>>& xvaReports) {
+    const std::map<std::string, std::map<size_t, ext::shared_ptr<InMemoryReport>>>& xvaReports) {
     for (auto& [reportName, reports] : xvaReports) {
         std::vector<ext::shared_ptr<InMemoryReport>> extendedReports;
-        for (size_t idx = 0; idx < reports.size(); idx++) {
+        for (const auto& [idx, rpt] : reports) {
             QuantLib::ext::shared_ptr<ore::data::InMemoryReport> descReport =
                 QuantLib::ext::make_shared<ore::data::InMemoryReport>(inputs_->reportBufferSize());
             auto desc = scenarioGenerator->scenarioDescriptions()[idx];
@@ -490,7 +479,7 @@ void XvaSensitivityAnalyticImpl::createDetailReport(
             descReport->add(shiftSize2);
             descReport->add(inputs_->baseCurrency());
             descReport->end();
-            extendedReports.push_back(addColumnsToExisitingReport(descReport, reports[idx]));
+            extendedReports.push_back(addColumnsToExisitingReport(descReport, rpt));
         }
         auto report = concatenateReports(extendedReports);
         if (report != nullptr) {
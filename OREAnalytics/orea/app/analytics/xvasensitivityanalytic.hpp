@@ -112,10 +112,10 @@ private:
     ParSensiResults parConversion(ZeroSensiResults& zeroResults);
     void createParReports(ParSensiResults& xvaParSensiCubes, const std::map<std::string, std::string>& tadeNettingSetMap);
 
-    //! Create a report containing all value adjustment values for each scenario
+    //! Create a report containing all value adjustment values for each scenario, the reports are keyed by scenario index
     void createDetailReport(
     const QuantLib::ext::shared_ptr<SensitivityScenarioGenerator>& scenarioGenerator,
-    const std::map<std::string, std::vector<ext::shared_ptr<InMemoryReport>>>& xvaReports);
+    const std::map<std::string, std::map<size_t, ext::shared_ptr<InMemoryReport>>>& xvaReports);
 
     QuantLib::ext::shared_ptr<ParSensitivityCubeStream> parCvaSensiCubeStream_;
 };
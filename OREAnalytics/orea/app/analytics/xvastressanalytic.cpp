@@ -164,20 +164,17 @@ void XvaStressAnalyticImpl::runAnalytic(const QuantLib::ext::shared_ptr<ore::dat
 void XvaStressAnalyticImpl::runStressTest(const QuantLib::ext::shared_ptr<StressScenarioGenerator>& scenarioGenerator,
                                           const QuantLib::ext::shared_ptr<ore::data::InMemoryLoader>& loader) {
 
-    std::map<std::string, std::vector<QuantLib::ext::shared_ptr<ore::data::InMemoryReport>>> xvaReports;
-    for (size_t i = 0; i < scenarioGenerator->samples(); ++i) {
-        auto scenario = scenarioGenerator->next(inputs_->asof());
-        const std::string& label = scenario != nullptr ? scenario->label() : std::string();
-        try {
-            DLOG("Calculate XVA for scenario " << label);
-            CONSOLE("XVA_STRESS: Apply scenario " << label);
-            auto newAnalytic = AnalyticFactory::instance().build("XVA", inputs_, analytic()->analyticsManager(), false).second;
-            auto xvaImpl = static_cast<XvaAnalyticImpl*>(newAnalytic->impl().get());
-            xvaImpl->setOffsetScenario(scenario);
-            xvaImpl->setOffsetSimMarketParams(analytic()->configurations().simMarketParams);
-
-            CONSOLE("XVA_STRESS: Calculate Exposure and XVA")
-            newAnalytic->runAnalytic(loader, {"EXPOSURE", "XVA"});
+    std::vector<QuantLib::ext::shared_ptr<Scenario>> scenarios;
+    for (size_t i = 0; i < scenarioGenerator->samples(); ++i)
+        scenarios.push_back(scenarioGenerator->next(inputs_->asof()));
+
+    // reports by name and scenario index, the scenarios might finish in any order
+    std::map<std::string, std::map<size_t, QuantLib::ext::shared_ptr<ore::data::InMemoryReport>>> scenarioReports;
+    runXvaAnalyticUnderScenarios(
+        inputs_, analytic()->analyticsManager(), loader, analytic()->configurations().simMarketParams, scenarios,
+        inputs_->xvaStressScenarioThreads(), "XVA_STRESS", "XvaStress",
+        [this, &scenarios, &scenarioReports](size_t i, const QuantLib::ext::shared_ptr<Analytic>& newAnalytic) {
+            const std::string& label = scenarios[i] != nullptr ? scenarios[i]->label() : std::string();
             // Collect exposure and xva reports
             auto rpts = newAnalytic->reports();
             auto it = rpts.find("XVA");
@@ -186,19 +183,19 @@ void XvaStressAnalyticImpl::runStressTest(const QuantLib::ext::shared_ptr<Stress
                 // add scenario column to report and copy it, concat it later
                 if (boost::starts_with(name, "exposure") || boost::starts_with(name, "xva")) {
                     DLOG("Save and extend report " << name);
-                    xvaReports[name].push_back(addColumnToExisitingReport("Scenario", label, rpt));
+                    scenarioReports[name][i] = addColumnToExisitingReport("Scenario", label, rpt);
                 }
             }
             writeCubes(label, newAnalytic);
             // FIXME: If the XVA analytic above is a dependent analytic, then we do not have to add this timer,
             // otherwise we have to manually add the XvaAnalytic::timer
             analytic()->addTimer("XVA analytic", newAnalytic->getTimer());
-        } catch (const std::exception& e) {
-            StructuredAnalyticsErrorMessage("XvaStress", "XVACalc",
-                                            "Error during XVA calc under scenario " + label + ", got " + e.what() +
-                                                ". Skip it")
-                .log();
-        }
+        });
+
+    std::map<std::string, std::vector<QuantLib::ext::shared_ptr<ore::data::InMemoryReport>>> xvaReports;
+    for (auto const& [name, reports] : scenarioReports) {
+        for (auto const& [i, rpt] : reports)
+            xvaReports[name].push_back(rpt);
     }
     concatReports(xvaReports);
 }
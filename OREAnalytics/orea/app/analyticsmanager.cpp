@@ -20,11 +20,20 @@
 #include <orea/app/analyticsmanager.hpp>
 #include <orea/app/reportwriter.hpp>
 #include <orea/app/structuredanalyticserror.hpp>
+#include <orea/engine/observationmode.hpp>
 
+#include <ored/marketdata/fixings.hpp>
 #include <ored/utilities/log.hpp>
+#include <ored/utilities/parallel.hpp>
 #include <ored/utilities/to_string.hpp>
 
+#include <qle/indexes/dividendmanager.hpp>
+
 #include <ql/errors.hpp>
+#include <ql/settings.hpp>
+
+#include <mutex>
+#include <numeric>
 
 using namespace std;
 using namespace boost::filesystem;
@@ -34,8 +43,26 @@ namespace ore {
 namespace analytics {
     
 void AnalyticsManager::initialise() {
-    for (const auto& a : inputs_->analytics()) 
-        auto ap = AnalyticFactory::instance().build(a, inputs_, shared_from_this(), true);
+    // analytics that are run concurrently must not share the inputs they modify, i.e. the portfolio whose trades they
+    // build, the netting set manager and the model data, so we give each top level analytic after the first its own
+    // copy of the inputs, see InputParameters::copyWithPortfolio()
+    bool copyInputs = false;
+#ifdef QL_ENABLE_SESSIONS
+    copyInputs = inputs_->analyticsThreads() > 1 && inputs_->analytics().size() > 1 && inputs_->portfolio();
+#endif
+    std::string portfolioXml = copyInputs ? inputs_->portfolio()->toXMLString() : std::string();
+    for (const auto& a : inputs_->analytics()) {
+        auto inputs = inputs_;
+        if (copyInputs && !analytics_.empty()) {
+            const std::string label = AnalyticFactory::instance().getBuilder(a).first;
+            if (std::none_of(analytics_.begin(), analytics_.end(),
+                             [&label](const std::pair<std::string, QuantLib::ext::shared_ptr<Analytic>>& ac) {
+                                 return ac.first == label;
+                             }))
+                inputs = inputs_->copyWithPortfolio(portfolioXml);
+        }
+        auto ap = AnalyticFactory::instance().build(a, inputs, shared_from_this(), true);
+    }
     initialised_ = true;
 }
 
@@ -82,6 +109,38 @@ const QuantLib::ext::shared_ptr<Analytic>& AnalyticsManager::getAnalytic(const s
     QL_FAIL("analytic type " << type << " not found, check validAnalytics()");
 }
 
+std::vector<std::vector<Size>> AnalyticsManager::analyticChains() const {
+    // union find on the analytics, two analytics are in the same chain if they or their dependent analytics share an
+    // analytic object
+    std::vector<Size> parent(analytics_.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto root = [&parent](Size i) {
+        while (parent[i] != i)
+            i = parent[i] = parent[parent[i]];
+        return i;
+    };
+    std::map<Analytic*, Size> owner;
+    for (Size i = 0; i < analytics_.size(); ++i) {
+        std::vector<QuantLib::ext::shared_ptr<Analytic>> related = analytics_[i].second->allDependentAnalytics();
+        related.push_back(analytics_[i].second);
+        for (const auto& a : related) {
+            auto o = owner.insert(std::make_pair(a.get(), i));
+            if (!o.second)
+                parent[root(i)] = root(o.first->second);
+        }
+    }
+    // chains are ordered by their first analytic, each chain keeps the original order of its analytics
+    std::vector<std::vector<Size>> chains;
+    std::map<Size, Size> chainIndex;
+    for (Size i = 0; i < analytics_.size(); ++i) {
+        auto c = chainIndex.insert(std::make_pair(root(i), chains.size()));
+        if (c.second)
+            chains.push_back({});
+        chains[c.first->second].push_back(i);
+    }
+    return chains;
+}
+
 std::vector<QuantLib::ext::shared_ptr<ore::data::TodaysMarketParameters>> AnalyticsManager::todaysMarketParams() {
     std::vector<QuantLib::ext::shared_ptr<ore::data::TodaysMarketParameters>> tmps;
     for (const auto& a : analytics_) {
@@ -144,22 +203,73 @@ void AnalyticsManager::runAnalytics(
         reports_["DIVIDENDS"]["dividends"] = dividendReport;
     }
 
-    // run requested analytics
-    for (auto a : analytics_) {
-        LOG("run analytic with label '" << a.first << "'");
-        a.second->startTimer("Run " + a.second->label() + "Analytic");
-        try {
-            a.second->runAnalytic(marketDataLoader_->loader(), inputs_->analytics());
-        } catch (const exception& e) {
-            failedAnalytics_.push_back(a.first);
-            StructuredAnalyticsErrorMessage(a.first, "Failed Analytic", e.what());
+    // run requested analytics, analytics sharing a dependent analytic are run one after another in the same chain,
+    // independent chains are run concurrently if analyticsThreads > 1
+
+    std::vector<std::vector<Size>> chains = analyticChains();
+    Size nThreads = std::min<Size>(std::max<Size>(inputs_->analyticsThreads(), 1), chains.size());
+#ifndef QL_ENABLE_SESSIONS
+    if (nThreads > 1) {
+        WLOG("AnalyticsManager::runAnalytics: concurrent analytics require a build with QL_ENABLE_SESSIONS = ON, run "
+             << analytics_.size() << " analytics sequentially.");
+        nThreads = 1;
+    }
+#endif
+
+    // the concurrent chains share the valuation threads
+    std::map<QuantLib::ext::shared_ptr<InputParameters>, Size> valuationThreads;
+    if (nThreads > 1) {
+        for (const auto& a : analytics_) {
+            valuationThreads.insert(std::make_pair(a.second->inputs(), a.second->inputs()->nThreads()));
+            for (const auto& d : a.second->allDependentAnalytics())
+                valuationThreads.insert(std::make_pair(d->inputs(), d->inputs()->nThreads()));
         }
-        a.second->stopTimer("Run " + a.second->label() + "Analytic");
-        LOG("run analytic with label '" << a.first << "' finished.");
-        // then populate the market calibration report if required
-        a.second->marketCalibration(marketCalibrationReport);
+        Size share = std::max<Size>(1, inputs_->nThreads() / nThreads);
+        for (auto const& [inputs, _] : valuationThreads)
+            inputs->setThreads(share);
+        LOG("AnalyticsManager::runAnalytics: run " << analytics_.size() << " analytics in " << chains.size()
+                                                   << " independent chains on " << nThreads << " threads using "
+                                                   << share << " valuation threads each");
     }
 
+    Date evaluationDate = Settings::instance().evaluationDate();
+    auto includeTodaysCashFlows = Settings::instance().includeTodaysCashFlows();
+    bool includeReferenceDateEvents = Settings::instance().includeReferenceDateEvents();
+    ObservationMode::Mode obsMode = ObservationMode::instance().mode();
+    std::mutex mutex;
+
+    ore::data::parallelFor(chains.size(), nThreads, [&](Size c) {
+        if (nThreads > 1) {
+            // set thread local singletons
+            Settings::instance().evaluationDate() = evaluationDate;
+            Settings::instance().includeTodaysCashFlows() = includeTodaysCashFlows;
+            Settings::instance().includeReferenceDateEvents() = includeReferenceDateEvents;
+            ObservationMode::instance().setMode(obsMode);
+            ore::data::applyFixings(marketDataLoader_->loader()->loadFixings());
+            QuantExt::applyDividends(marketDataLoader_->loader()->loadDividends());
+        }
+        for (Size i : chains[c]) {
+            const auto& a = analytics_[i];
+            LOG("run analytic with label '" << a.first << "'");
+            a.second->startTimer("Run " + a.second->label() + "Analytic");
+            try {
+                a.second->runAnalytic(marketDataLoader_->loader(), inputs_->analytics());
+            } catch (const exception& e) {
+                std::lock_guard<std::mutex> lock(mutex);
+                failedAnalytics_.push_back(a.first);
+                StructuredAnalyticsErrorMessage(a.first, "Failed Analytic", e.what());
+            }
+            a.second->stopTimer("Run " + a.second->label() + "Analytic");
+            LOG("run analytic with label '" << a.first << "' finished.");
+            // then populate the market calibration report if required
+            std::lock_guard<std::mutex> lock(mutex);
+            a.second->marketCalibration(marketCalibrationReport);
+        }
+    });
+
+    for (auto const& [inputs, n] : valuationThreads)
+        inputs->setThreads(n);
+
     if (inputs_->portfolio()) {
         auto pricingStatsReport = QuantLib::ext::make_shared<InMemoryReport>(inputs_->reportBufferSize());
         ReportWriter(inputs_->reportNaString()).writePricingStats(*pricingStatsReport, inputs_->portfolio());
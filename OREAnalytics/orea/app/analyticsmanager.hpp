@@ -79,6 +79,10 @@ public:
                 const std::set<std::string>& lowerHeaderReportNames = {});
 
 private:
+    /*! Groups the analytics into chains of analytics that share (dependent) analytics, returns the indices into
+        analytics_ for each chain. Different chains can be run concurrently. */
+    std::vector<std::vector<Size>> analyticChains() const;
+
     std::vector<std::pair<std::string, QuantLib::ext::shared_ptr<Analytic>>> analytics_;
     QuantLib::ext::shared_ptr<InputParameters> inputs_;
     QuantLib::ext::shared_ptr<MarketDataLoader> marketDataLoader_;
@@ -30,6 +30,7 @@
 
 #include <qle/math/computeenvironment.hpp>
 #include <qle/math/randomvariable.hpp>
+#include <qle/methods/mcpathcache.hpp>
 #include <qle/pricingengines/mcmultilegbaseengine.hpp>
 #include <qle/utilities/savedobservablesettings.hpp>
 
@@ -42,6 +43,7 @@ CleanUpThreadLocalSingletons::~CleanUpThreadLocalSingletons() {
     QuantExt::ComputeEnvironment::instance().reset();
     QuantExt::RandomVariableStats::instance().reset();
     QuantExt::McEngineStats::instance().reset();
+    QuantExt::McPathCache::instance().enable(false);
 }
 
 CleanUpThreadGlobalSingletons::~CleanUpThreadGlobalSingletons() {
@@ -22,6 +22,7 @@
 #include <orea/engine/observationmode.hpp>
 #include <orea/engine/sensitivityfilestream.hpp>
 #include <orea/engine/sacvasensitivityloader.hpp>
+#include <orea/scenario/scenariobinaryreader.hpp>
 #include <orea/scenario/scenariofilereader.hpp>
 #include <orea/scenario/shiftscenariogenerator.hpp>
 #include <orea/scenario/simplescenariofactory.hpp>
@@ -282,6 +283,21 @@ void InputParameters::setPortfolioFromFile(const std::string& fileNameString, co
     scaleUpPortfolio(portfolio_);
 }
 
+QuantLib::ext::shared_ptr<InputParameters> InputParameters::clone() const {
+    return QuantLib::ext::make_shared<InputParameters>(*this);
+}
+
+QuantLib::ext::shared_ptr<InputParameters> InputParameters::copyWithPortfolio(const std::string& portfolioXml) const {
+    auto inputs = clone();
+    inputs->portfolio_ = QuantLib::ext::make_shared<Portfolio>(buildFailedTrades_);
+    inputs->portfolio_->fromXMLString(portfolioXml);
+    if (nettingSetManager_)
+        inputs->nettingSetManager_ = QuantLib::ext::make_shared<NettingSetManager>(*nettingSetManager_);
+    if (crossAssetModelData_)
+        inputs->crossAssetModelData_ = QuantLib::ext::make_shared<CrossAssetModelData>(*crossAssetModelData_);
+    return inputs;
+}
+
 void InputParameters::setMporPortfolio(const std::string& xml) {
     mporPortfolio_ = QuantLib::ext::make_shared<Portfolio>(buildFailedTrades_);
     mporPortfolio_->fromXMLString(xml);
@@ -771,8 +787,11 @@ void InputParameters::setScenarioReader(const std::string& fileName) {
     try {
         boost::filesystem::path baseScenarioPath(fileName);
         if (exists(baseScenarioPath) && is_regular_file(baseScenarioPath)) {
-            scenarioReader_ = QuantLib::ext::make_shared<ScenarioFileReader>(
-                fileName, QuantLib::ext::make_shared<SimpleScenarioFactory>(false));
+            if (isBinaryScenarioFile(fileName))
+                scenarioReader_ = QuantLib::ext::make_shared<ScenarioBinaryReader>(fileName);
+            else
+                scenarioReader_ = QuantLib::ext::make_shared<ScenarioFileReader>(
+                    fileName, QuantLib::ext::make_shared<SimpleScenarioFactory>(false));
         }
     } catch (const std::exception&) {
         // If the file does not exist or fails, assume it is a scenario string
@@ -175,6 +175,8 @@ public:
     void setMporPortfolioFromFile(const std::string& fileNameString, const std::filesystem::path& inputPath); 
     void setMarketConfigs(const std::map<std::string, std::string>& m);
     void setThreads(int i) { nThreads_ = i; }
+    void setBatchesPerThread(int i) { nBatchesPerThread_ = i; }
+    void setAnalyticsThreads(int i) { analyticsThreads_ = i; }
     void setEntireMarket(bool b) { entireMarket_ = b; }
     void setAllFixings(bool b) { allFixings_ = b; }
     void setEomInflationFixings(bool b) { eomInflationFixings_ = b; }
@@ -220,6 +222,7 @@ public:
     void setUseSensiSpreadedTermStructures(bool b) { useSensiSpreadedTermStructures_ = b; }
     void setSensiThreshold(Real r) { sensiThreshold_ = r; }
     void setSensiRecalibrateModels(bool b) { sensiRecalibrateModels_ = b; }
+    void setSensiSkipUnaffectedTrades(bool b) { sensiSkipUnaffectedTrades_ = b; }
     void setSensiLaxFxConversion(bool b) { sensiLaxFxConversion_ = b; }
     void setSensiDecomposition(bool b) { sensiDecomposition_ = b; }
     void setSensiSimMarketParams(const std::string& xml);
@@ -320,6 +323,7 @@ public:
     void setAmcPathDataOutput(const std::string& s);
     void setAmcIndividualTrainingInput(bool b) { amcIndividualTrainingInput_ = b; }
     void setAmcIndividualTrainingOutput(bool b) { amcIndividualTrainingOutput_ = b; }
+    void setAmcPathCache(bool b) { amcPathCache_ = b; }
     void setExposureBaseCurrency(const std::string& s) { exposureBaseCurrency_ = s; } 
     void setExposureObservationModel(const std::string& s) { exposureObservationModel_ = s; }
     void setNettingSetId(const std::string& s) { nettingSetId_ = s; }
@@ -479,6 +483,7 @@ public:
     void setXvaStressSensitivityScenarioData(const std::string& xml);
     void setXvaStressSensitivityScenarioDataFromFile(const std::string& fileName);
     void setXvaStressWriteCubes(const bool writeCubes) { xvaStressWriteCubes_ = writeCubes; }
+    void setXvaStressScenarioThreads(Size n) { xvaStressScenarioThreads_ = n; }
 
     // Setters for sensitivityStress
     void setSensitivityStressSimMarketParams(const std::string& xml);
@@ -503,6 +508,7 @@ public:
     void setXvaSensiOutputJacobi(const bool outputJacobi) { xvaSensiOutputJacobi_ = outputJacobi; };
     void setXvaSensiThreshold(const Real threshold) { xvaSensiThreshold_ = threshold; }
     void setXvaSensiOutputPrecision(Size p) { xvaSensiOutputPrecision_ = p; }
+    void setXvaSensiScenarioThreads(Size n) { xvaSensiScenarioThreads_ = n; }
 
     // Setters for SA-CVA
     // input file matches the required format for SA-CVA calcs, aggregated per CvaRiskFactorKey
@@ -647,6 +653,8 @@ public:
 
     QuantLib::Size maxRetries() const { return maxRetries_; }
     QuantLib::Size nThreads() const { return nThreads_; }
+    QuantLib::Size nBatchesPerThread() const { return nBatchesPerThread_; }
+    QuantLib::Size analyticsThreads() const { return analyticsThreads_; }
     bool entireMarket() const { return entireMarket_; }
     bool allFixings() const { return allFixings_; }
     bool eomInflationFixings() const { return eomInflationFixings_; }
@@ -707,6 +715,7 @@ public:
     bool useSensiSpreadedTermStructures() const { return useSensiSpreadedTermStructures_; }
     QuantLib::Real sensiThreshold() const { return sensiThreshold_; }
     bool sensiRecalibrateModels() const { return sensiRecalibrateModels_; }
+    bool sensiSkipUnaffectedTrades() const { return sensiSkipUnaffectedTrades_; }
     bool sensiLaxFxConversion() const { return sensiLaxFxConversion_; }
     bool sensiDecomposition() const { return sensiDecomposition_; }
     const QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarketParameters>& sensiSimMarketParams() const { return sensiSimMarketParams_; }
@@ -809,6 +818,7 @@ public:
     const std::string amcPathDataOutput() const { return amcPathDataOutput_; }
     bool amcIndividualTrainingInput() const { return amcIndividualTrainingInput_; }
     bool amcIndividualTrainingOutput() const { return amcIndividualTrainingOutput_; }
+    bool amcPathCache() const { return amcPathCache_; }
     const std::string& exposureBaseCurrency() const { return exposureBaseCurrency_; }
     const std::string& exposureObservationModel() const { return exposureObservationModel_; }
     const std::string& nettingSetId() const { return nettingSetId_; }
@@ -952,6 +962,7 @@ public:
     }
     bool sensitivityStressCalcBaseScenario() const { return sensitivityStressCalcBaseScenario_; }
     bool xvaStressWriteCubes() const { return xvaStressWriteCubes_; }
+    QuantLib::Size xvaStressScenarioThreads() const { return xvaStressScenarioThreads_; }
 
     // Getters for XVA Explain
     const QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarketParameters>& xvaExplainSimMarketParams() const {
@@ -1050,6 +1061,7 @@ public:
     bool xvaSensiOutputJacobi() const { return xvaSensiOutputJacobi_; };
     Real xvaSensiThreshold() const { return xvaSensiThreshold_;}
     QuantLib::Size xvaSensiOutputPrecision() const { return xvaSensiOutputPrecision_; }
+    QuantLib::Size xvaSensiScenarioThreads() const { return xvaSensiScenarioThreads_; }
 
     /*************************************
      * SA-CVA 
@@ -1088,6 +1100,15 @@ public:
     virtual void loadParameters();
     virtual void writeOutParameters(){}
 
+    //! Returns a copy of these parameters, derived classes override this to return a copy of their own type
+    virtual QuantLib::ext::shared_ptr<InputParameters> clone() const;
+
+    /*! Returns a copy of these parameters holding its own portfolio built from the given xml. This is used to run
+        analytics concurrently, since each analytic builds the trades of the input portfolio. The portfolio is not
+        scaled up again. The copy also gets its own netting set manager and cross asset model data, since the
+        analytics add fallback netting set definitions resp. set the model correlations. */
+    QuantLib::ext::shared_ptr<InputParameters> copyWithPortfolio(const std::string& portfolioXml) const;
+
 protected:
 
     // List of analytics that shall be run, including
@@ -1141,6 +1162,8 @@ protected:
     QuantLib::ext::shared_ptr<ore::data::Portfolio> portfolio_, useCounterpartyOriginalPortfolio_, mporPortfolio_;
     QuantLib::Size maxRetries_ = 7;
     QuantLib::Size nThreads_ = 1;
+    QuantLib::Size nBatchesPerThread_ = 1;
+    QuantLib::Size analyticsThreads_ = 1;
    
     bool entireMarket_ = false; 
     bool allFixings_ = false; 
@@ -1194,6 +1217,7 @@ protected:
     bool useSensiSpreadedTermStructures_ = true;
     QuantLib::Real sensiThreshold_ = 1e-6;
     bool sensiRecalibrateModels_ = true;
+    bool sensiSkipUnaffectedTrades_ = false;
     bool sensiLaxFxConversion_ = false;
     bool sensiDecomposition_ = false;
     QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarketParameters> sensiSimMarketParams_;
@@ -1303,6 +1327,7 @@ protected:
     std::set<std::string> amcTradeTypes_;
     std::string amcPathDataInput_, amcPathDataOutput_;
     bool amcIndividualTrainingInput_ = false, amcIndividualTrainingOutput_ = false;
+    bool amcPathCache_ = false;
     std::string exposureBaseCurrency_ = "";
     std::string exposureObservationModel_ = "Disable";
     std::string nettingSetId_ = "";
@@ -1414,6 +1439,7 @@ protected:
     QuantLib::ext::shared_ptr<ore::analytics::SensitivityScenarioData> sensitivityStressSensitivityScenarioData_;
     bool sensitivityStressCalcBaseScenario_ = false;
     bool xvaStressWriteCubes_ = false;
+    QuantLib::Size xvaStressScenarioThreads_ = 1;
     bool firstMporCollateralAdjustment_ = false;
     bool writeIndividualExposureReports_ = true;
 
@@ -1487,6 +1513,7 @@ protected:
     bool xvaSensiOutputJacobi_ = false;
     QuantLib::Real xvaSensiThreshold_ = 1e-6;
     QuantLib::Size xvaSensiOutputPrecision_ = 4;
+    QuantLib::Size xvaSensiScenarioThreads_ = 1;
 
     /*****************
      * SA-CVA 
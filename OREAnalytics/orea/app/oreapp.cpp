@@ -721,6 +721,14 @@ void OREAppInputParameters::loadParameters() {
     if (tmp != "")
         setThreads(parseInteger(tmp));
 
+    tmp = params_->get("setup", "nBatchesPerThread", false);
+    if (tmp != "")
+        setBatchesPerThread(parseInteger(tmp));
+
+    tmp = params_->get("setup", "analyticsThreads", false);
+    if (tmp != "")
+        setAnalyticsThreads(parseInteger(tmp));
+
     tmp = params_->get("setup", "entireMarket", false);
     if (tmp != "")
         setEntireMarket(parseBool(tmp));
@@ -1033,6 +1041,10 @@ void OREAppInputParameters::loadParameters() {
         if (tmp != "")
             setSensiRecalibrateModels(parseBool(tmp));
 
+        tmp = params_->get("sensitivity", "skipUnaffectedTrades", false);
+        if (tmp != "")
+            setSensiSkipUnaffectedTrades(parseBool(tmp));
+
         tmp = params_->get("sensitivity", "laxFxConversion", false);
         if (tmp != "")
             setSensiLaxFxConversion(parseBool(tmp));
@@ -1996,6 +2008,10 @@ void OREAppInputParameters::loadParameters() {
     if (tmp != "")
         setAmcIndividualTrainingOutput(parseBool(tmp));
 
+    tmp = params_->get("simulation", "amcPathCache", false);
+    if (tmp != "")
+        setAmcPathCache(parseBool(tmp));
+
     tmp = params_->get("simulation", "scenarioFile", false);
     if (tmp != "")
         setScenarioReader((inputPath_ / tmp).generic_string());
@@ -2917,6 +2933,10 @@ void OREAppInputParameters::loadParameters() {
             }
         }
 
+        tmp = params_->get("xvaStress", "scenarioThreads", false);
+        if (!tmp.empty())
+            setXvaStressScenarioThreads(parseInteger(tmp));
+
         tmp = params_->get("xvaStress", "sensitivityConfigFile", false);
         if (tmp != "") {
             string file = (inputPath_ / tmp).generic_string();
@@ -3008,6 +3028,10 @@ void OREAppInputParameters::loadParameters() {
 	tmp = params_->get("xvaSensitivity", "outputPrecision", false);
         if (tmp != "")
             setXvaSensiOutputPrecision(parseInteger(tmp));
+
+        tmp = params_->get("xvaSensitivity", "scenarioThreads", false);
+        if (tmp != "")
+            setXvaSensiScenarioThreads(parseInteger(tmp));
     }
 
     /*************
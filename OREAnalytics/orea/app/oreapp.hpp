@@ -147,6 +147,10 @@ public:
 
     //! write out parameters
     virtual void writeOutParameters() override{};
+
+    QuantLib::ext::shared_ptr<InputParameters> clone() const override {
+        return QuantLib::ext::make_shared<OREAppInputParameters>(*this);
+    }
           
     std::string loadParameterString(const std::string& analytic, const std::string& param, bool mandatory) override;
     std::string loadParameterXMLString(const std::string& analytic, const std::string& param,
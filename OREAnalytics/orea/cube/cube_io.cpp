@@ -18,6 +18,7 @@
 
 #include <orea/cube/cube_io.hpp>
 #include <orea/cube/inmemorycube.hpp>
+#include <orea/cube/mappednpvcube.hpp>
 
 #include <ored/utilities/to_string.hpp>
 
@@ -28,8 +29,11 @@
 #endif
 #include <boost/iostreams/filtering_stream.hpp>
 
+#include <cstdint>
+#include <cstring>
 #include <iomanip>
 #include <regex>
+#include <sstream>
 
 namespace ore {
 namespace analytics {
@@ -47,6 +51,319 @@ bool use_compression(const std::string& filename) {
 #endif
 }
 
+bool use_binary_format(const std::string& filename) {
+    return boost::filesystem::path(filename).extension().string() == ".bin";
+}
+
+// binary cube file format, see saveCubeBinary() for the layout
+
+constexpr char binaryCubeMagic[8] = {'O', 'R', 'E', 'C', 'U', 'B', 'E', '\0'};
+constexpr std::uint32_t binaryCubeVersion = 1;
+constexpr std::uint32_t binaryCubeEndianness = 0x01020304;
+constexpr std::size_t binaryCubeAlignment = 64;
+
+std::size_t alignedOffset(const std::size_t offset) {
+    return (offset + binaryCubeAlignment - 1) / binaryCubeAlignment * binaryCubeAlignment;
+}
+
+// binary aggregation scenario data file format, see saveAggregationScenarioDataBinary() for the layout
+
+constexpr char binaryAsdMagic[8] = {'O', 'R', 'E', 'A', 'S', 'D', '\0', '\0'};
+constexpr std::uint32_t binaryAsdVersion = 1;
+
+bool hasMagic(const std::string& filename, const char (&expected)[8]) {
+    std::ifstream in(filename, std::ios::binary | std::ios::in);
+    char magic[sizeof(expected)];
+    if (!in.read(magic, sizeof(magic)))
+        return false;
+    return std::memcmp(magic, expected, sizeof(magic)) == 0;
+}
+
+bool isBinaryCubeFile(const std::string& filename) { return hasMagic(filename, binaryCubeMagic); }
+
+template <typename V> void writeBinary(std::ostream& out, const V& v) {
+    out.write(reinterpret_cast<const char*>(&v), sizeof(V));
+}
+
+void writeBinary(std::ostream& out, const std::string& s) {
+    writeBinary(out, static_cast<std::uint64_t>(s.size()));
+    out.write(s.data(), s.size());
+}
+
+void writePadding(std::ostream& out, std::size_t& offset) {
+    static const char zeros[binaryCubeAlignment] = {};
+    std::size_t newOffset = alignedOffset(offset);
+    out.write(zeros, newOffset - offset);
+    offset = newOffset;
+}
+
+class BinaryReader {
+public:
+    BinaryReader(const char* data, std::size_t size) : data_(data), size_(size), offset_(0) {}
+    template <typename V> V read() {
+        QL_REQUIRE(offset_ + sizeof(V) <= size_, "loadCube(): unexpected end of binary cube header");
+        V v;
+        std::memcpy(&v, data_ + offset_, sizeof(V));
+        offset_ += sizeof(V);
+        return v;
+    }
+    std::string readString() {
+        std::uint64_t n = read<std::uint64_t>();
+        QL_REQUIRE(offset_ + n <= size_, "loadCube(): unexpected end of binary cube header");
+        std::string s(data_ + offset_, n);
+        offset_ += n;
+        return s;
+    }
+    std::size_t offset() const { return offset_; }
+
+private:
+    const char* data_;
+    std::size_t size_;
+    std::size_t offset_;
+};
+
+template <typename T> void saveCubeBinary(const std::string& filename, const NPVCubeWithMetaData& cube) {
+
+    std::ofstream out(filename, std::ios::binary | std::ios::out);
+    QL_REQUIRE(out.is_open(), "saveCube(): could not open file '" << filename << "'");
+
+    const NPVCube& c = *cube.cube;
+    std::size_t offset = 0;
+
+    // header
+
+    std::ostringstream header;
+    header.write(binaryCubeMagic, sizeof(binaryCubeMagic));
+    writeBinary(header, binaryCubeVersion);
+    writeBinary(header, binaryCubeEndianness);
+    writeBinary(header, static_cast<std::uint32_t>(sizeof(T)));
+    writeBinary(header, static_cast<std::uint32_t>(0));
+    writeBinary(header, static_cast<std::uint64_t>(c.numIds()));
+    writeBinary(header, static_cast<std::uint64_t>(c.numDates()));
+    writeBinary(header, static_cast<std::uint64_t>(c.samples()));
+    writeBinary(header, static_cast<std::uint64_t>(c.depth()));
+    writeBinary(header, static_cast<std::int64_t>(c.asof().serialNumber()));
+    for (auto const& d : c.dates())
+        writeBinary(header, static_cast<std::int64_t>(d.serialNumber()));
+
+    // ids in index order
+
+    std::vector<std::string> ids(c.numIds());
+    for (auto const& [id, pos] : c.idsAndIndexes())
+        ids[pos] = id;
+    for (auto const& id : ids)
+        writeBinary(header, id);
+
+    // optional meta data
+
+    writeBinary(header, static_cast<std::uint8_t>(cube.scenarioGeneratorData ? 1 : 0));
+    if (cube.scenarioGeneratorData)
+        writeBinary(header, cube.scenarioGeneratorData->toXMLString());
+    writeBinary(header, static_cast<std::uint8_t>(cube.storeFlows ? 1 : 0));
+    if (cube.storeFlows)
+        writeBinary(header, static_cast<std::uint8_t>(*cube.storeFlows ? 1 : 0));
+    writeBinary(header, static_cast<std::uint8_t>(cube.storeCreditStateNPVs ? 1 : 0));
+    if (cube.storeCreditStateNPVs)
+        writeBinary(header, static_cast<std::uint64_t>(*cube.storeCreditStateNPVs));
+
+    std::string h = header.str();
+    out.write(h.data(), h.size());
+    offset += h.size();
+    writePadding(out, offset);
+
+    // t0 block, (depth, id) with ids running fastest
+
+    std::vector<T> buffer(c.numIds());
+    for (Size d = 0; d < c.depth(); ++d) {
+        for (Size i = 0; i < c.numIds(); ++i)
+            buffer[i] = static_cast<T>(c.getT0(i, d));
+        out.write(reinterpret_cast<const char*>(buffer.data()), sizeof(T) * buffer.size());
+        offset += sizeof(T) * buffer.size();
+    }
+    writePadding(out, offset);
+
+    // data block, (date, id, depth, sample) with samples running fastest
+
+    buffer.resize(c.samples());
+    for (Size j = 0; j < c.numDates(); ++j) {
+        for (Size i = 0; i < c.numIds(); ++i) {
+            for (Size d = 0; d < c.depth(); ++d) {
+                for (Size k = 0; k < c.samples(); ++k)
+                    buffer[k] = static_cast<T>(c.get(i, j, k, d));
+                out.write(reinterpret_cast<const char*>(buffer.data()), sizeof(T) * buffer.size());
+            }
+        }
+    }
+
+    QL_REQUIRE(out.good(), "saveCube(): error while writing binary cube to file '" << filename << "'");
+}
+
+NPVCubeWithMetaData loadCubeBinary(const std::string& filename) {
+
+    NPVCubeWithMetaData result;
+
+    boost::iostreams::mapped_file_params params(filename);
+    params.flags = boost::iostreams::mapped_file::priv;
+    auto file = QuantLib::ext::make_shared<boost::iostreams::mapped_file>(params);
+    QL_REQUIRE(file->is_open(), "loadCube(): could not map file '" << filename << "'");
+
+    BinaryReader in(file->const_data(), file->size());
+
+    for (Size i = 0; i < sizeof(binaryCubeMagic); ++i)
+        QL_REQUIRE(in.read<char>() == binaryCubeMagic[i], "loadCube(): file '" << filename
+                                                                               << "' is not a binary cube file");
+    auto version = in.read<std::uint32_t>();
+    QL_REQUIRE(version == binaryCubeVersion, "loadCube(): binary cube version " << version << " not supported, expected "
+                                                                                << binaryCubeVersion);
+    QL_REQUIRE(in.read<std::uint32_t>() == binaryCubeEndianness,
+               "loadCube(): binary cube file '" << filename << "' was written on a platform with different endianness");
+    auto precision = in.read<std::uint32_t>();
+    QL_REQUIRE(precision == sizeof(float) || precision == sizeof(double),
+               "loadCube(): invalid precision " << precision << " in binary cube file");
+    in.read<std::uint32_t>();
+
+    Size numIds = in.read<std::uint64_t>();
+    Size numDates = in.read<std::uint64_t>();
+    Size samples = in.read<std::uint64_t>();
+    Size depth = in.read<std::uint64_t>();
+    QuantLib::Date asof(static_cast<QuantLib::Date::serial_type>(in.read<std::int64_t>()));
+
+    std::vector<QuantLib::Date> dates;
+    for (Size i = 0; i < numDates; ++i)
+        dates.push_back(QuantLib::Date(static_cast<QuantLib::Date::serial_type>(in.read<std::int64_t>())));
+
+    std::map<std::string, Size> ids;
+    for (Size i = 0; i < numIds; ++i)
+        ids[in.readString()] = i;
+    QL_REQUIRE(ids.size() == numIds, "loadCube(): binary cube file contains duplicate ids");
+
+    if (in.read<std::uint8_t>()) {
+        std::string md = in.readString();
+        result.scenarioGeneratorData = QuantLib::ext::make_shared<ScenarioGeneratorData>();
+        result.scenarioGeneratorData->fromXMLString(md);
+        DLOG("overwrite scenario generator data with meta data from cube: " << md);
+    }
+    if (in.read<std::uint8_t>()) {
+        result.storeFlows = in.read<std::uint8_t>() != 0;
+        DLOG("overwrite storeFlows with meta data from cube: " << std::boolalpha << *result.storeFlows);
+    }
+    if (in.read<std::uint8_t>()) {
+        result.storeCreditStateNPVs = static_cast<Size>(in.read<std::uint64_t>());
+        DLOG("overwrite storeCreditStateNPVs with meta data from cube: " << *result.storeCreditStateNPVs);
+    }
+
+    std::size_t t0Offset = alignedOffset(in.offset());
+    std::size_t dataOffset = alignedOffset(t0Offset + precision * depth * numIds);
+
+    if (precision == sizeof(double)) {
+        result.cube = QuantLib::ext::make_shared<MappedNpvCube<double>>(file, t0Offset, dataOffset, asof, ids, dates,
+                                                                       samples, depth);
+    } else {
+        result.cube = QuantLib::ext::make_shared<MappedNpvCube<float>>(file, t0Offset, dataOffset, asof, ids, dates,
+                                                                      samples, depth);
+    }
+
+    LOG("mapped binary cube from " << filename << ": asof = " << asof << ", dim = " << numIds << " x " << numDates
+                                   << " x " << samples << " x " << depth);
+
+    return result;
+}
+
+void saveAggregationScenarioDataBinary(const std::string& filename, const AggregationScenarioData& data) {
+
+    std::ofstream out(filename, std::ios::binary | std::ios::out);
+    QL_REQUIRE(out.is_open(), "saveAggregationScenarioData(): could not open file '" << filename << "'");
+
+    // header: magic, version, endianness, dimensions and keys
+
+    out.write(binaryAsdMagic, sizeof(binaryAsdMagic));
+    writeBinary(out, binaryAsdVersion);
+    writeBinary(out, binaryCubeEndianness);
+    writeBinary(out, static_cast<std::uint64_t>(data.dimDates()));
+    writeBinary(out, static_cast<std::uint64_t>(data.dimSamples()));
+
+    auto keys = data.keys();
+    writeBinary(out, static_cast<std::uint64_t>(keys.size()));
+    for (auto const& [type, qualifier] : keys) {
+        writeBinary(out, static_cast<std::uint32_t>(type));
+        writeBinary(out, qualifier);
+    }
+
+    // data block, (key, date, sample) with samples running fastest
+
+    std::vector<double> buffer(data.dimSamples());
+    for (auto const& [type, qualifier] : keys) {
+        Size h = data.handle(type, qualifier);
+        for (Size d = 0; d < data.dimDates(); ++d) {
+            auto values = data.samples(d, h);
+            std::copy(values.begin(), values.end(), buffer.begin());
+            out.write(reinterpret_cast<const char*>(buffer.data()), sizeof(double) * buffer.size());
+        }
+    }
+
+    QL_REQUIRE(out.good(), "saveAggregationScenarioData(): error while writing to file '" << filename << "'");
+}
+
+QuantLib::ext::shared_ptr<AggregationScenarioData> loadAggregationScenarioDataBinary(const std::string& filename) {
+
+    std::ifstream in(filename, std::ios::binary | std::ios::in);
+    QL_REQUIRE(in.is_open(), "loadAggregationScenarioData(): could not open file '" << filename << "'");
+
+    auto read = [&in, &filename](char* target, const std::size_t n) {
+        QL_REQUIRE(in.read(target, n), "loadAggregationScenarioData(): unexpected end of file '" << filename << "'");
+    };
+    auto readUInt32 = [&read]() {
+        std::uint32_t v;
+        read(reinterpret_cast<char*>(&v), sizeof(v));
+        return v;
+    };
+    auto readUInt64 = [&read]() {
+        std::uint64_t v;
+        read(reinterpret_cast<char*>(&v), sizeof(v));
+        return v;
+    };
+
+    char magic[sizeof(binaryAsdMagic)];
+    read(magic, sizeof(magic));
+    QL_REQUIRE(std::memcmp(magic, binaryAsdMagic, sizeof(magic)) == 0,
+               "loadAggregationScenarioData(): file '" << filename
+                                                       << "' is not a binary aggregation scenario data file");
+    auto version = readUInt32();
+    QL_REQUIRE(version == binaryAsdVersion, "loadAggregationScenarioData(): binary format version "
+                                                << version << " not supported, expected " << binaryAsdVersion);
+    QL_REQUIRE(readUInt32() == binaryCubeEndianness, "loadAggregationScenarioData(): file '"
+                                                         << filename
+                                                         << "' was written on a platform with different endianness");
+
+    Size dimDates = readUInt64();
+    Size dimSamples = readUInt64();
+    Size numKeys = readUInt64();
+
+    auto result = QuantLib::ext::make_shared<InMemoryAggregationScenarioData>(dimDates, dimSamples);
+
+    std::vector<Size> handles;
+    for (Size i = 0; i < numKeys; ++i) {
+        auto type = AggregationScenarioDataType(readUInt32());
+        std::string qualifier(readUInt64(), '\0');
+        read(qualifier.data(), qualifier.size());
+        handles.push_back(result->registerKey(type, qualifier));
+    }
+
+    std::vector<double> buffer(dimSamples);
+    for (auto const h : handles) {
+        for (Size d = 0; d < dimDates; ++d) {
+            read(reinterpret_cast<char*>(buffer.data()), sizeof(double) * buffer.size());
+            for (Size k = 0; k < dimSamples; ++k)
+                result->set(d, k, buffer[k], h);
+        }
+    }
+
+    LOG("loaded binary aggregation scenario data from " << filename << ": dimDates = " << dimDates
+                                                        << ", dimSamples = " << dimSamples << ", keys = " << numKeys);
+
+    return result;
+}
+
 std::string getMetaData(const std::string& line, const std::string& tag, const bool mandatory = true) {
 
     // assuming a fixed width format "# tag        : <value>"
@@ -62,6 +379,9 @@ std::string getMetaData(const std::string& line, const std::string& tag, const b
 
 NPVCubeWithMetaData loadCube(const std::string& filename) {
 
+    if (isBinaryCubeFile(filename))
+        return loadCubeBinary(filename);
+
     NPVCubeWithMetaData result;
 
     // open file
@@ -164,6 +484,14 @@ NPVCubeWithMetaData loadCube(const std::string& filename) {
 
 void saveCube(const std::string& filename, const NPVCubeWithMetaData& cube) {
 
+    if (use_binary_format(filename)) {
+        if (cube.cube->usesDoublePrecision())
+            saveCubeBinary<double>(filename, cube);
+        else
+            saveCubeBinary<float>(filename, cube);
+        return;
+    }
+
     // open file
 
     bool gzip = use_compression(filename);
@@ -241,6 +569,9 @@ void saveCube(const std::string& filename, const NPVCubeWithMetaData& cube) {
 
 QuantLib::ext::shared_ptr<AggregationScenarioData> loadAggregationScenarioData(const std::string& filename) {
 
+    if (hasMagic(filename, binaryAsdMagic))
+        return loadAggregationScenarioDataBinary(filename);
+
     // open file
 
     bool gzip = use_compression(filename);
@@ -279,6 +610,10 @@ QuantLib::ext::shared_ptr<AggregationScenarioData> loadAggregationScenarioData(c
     QuantLib::ext::shared_ptr<InMemoryAggregationScenarioData> result =
         QuantLib::ext::make_shared<InMemoryAggregationScenarioData>(dimDates, dimSamples);
 
+    std::vector<Size> handles;
+    for (auto const& k : keys)
+        handles.push_back(result->registerKey(k.first, k.second));
+
     std::getline(in, line); // header line for data
 
     Size nData = 0;
@@ -296,7 +631,7 @@ QuantLib::ext::shared_ptr<AggregationScenarioData> loadAggregationScenarioData(c
         QL_REQUIRE(key < keys.size(), "loadAggregationScenarioData(): invalid data line '" << line << "', key (" << key
                                                                                            << ") is out of range 0..."
                                                                                            << (keys.size() - 1));
-        result->set(date - 1, sample, value, keys[key].first, keys[key].second);
+        result->set(date - 1, sample, value, handles[key]);
         ++nData;
     }
 
@@ -309,6 +644,11 @@ QuantLib::ext::shared_ptr<AggregationScenarioData> loadAggregationScenarioData(c
 
 void saveAggregationScenarioData(const std::string& filename, const AggregationScenarioData& cube) {
 
+    if (use_binary_format(filename)) {
+        saveAggregationScenarioDataBinary(filename, cube);
+        return;
+    }
+
     // open file
 
     bool gzip = use_compression(filename);
@@ -338,11 +678,15 @@ void saveAggregationScenarioData(const std::string& filename, const AggregationS
 
     // write data
 
+    std::vector<Size> handles;
+    for (auto const& k : keys)
+        handles.push_back(cube.handle(k.first, k.second));
+
     out << "#date,sample,key,value\n";
     for (Size i = 0; i < cube.dimDates(); ++i) {
         for (Size j = 0; j < cube.dimSamples(); ++j) {
             for (Size k = 0; k < keys.size(); ++k) {
-                out << (i + 1) << "," << j << "," << k << "," << cube.get(i, j, keys[k].first, keys[k].second) << "\n";
+                out << (i + 1) << "," << j << "," << k << "," << cube.get(i, j, handles[k]) << "\n";
             }
         }
     }
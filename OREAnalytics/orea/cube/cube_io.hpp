@@ -43,9 +43,16 @@ struct NPVCubeWithMetaData {
     QuantLib::ext::optional<Size> storeCreditStateNPVs;
 };
 
+/*! Files with extension .bin are written in a binary format: a versioned header holding the dimensions, dates, ids and
+    meta data, followed by a dense t0 block and a dense data block with samples running fastest. All other files are
+    written as text, compressed unless the extension is .csv or .txt. On load the binary format is detected from the
+    file header and the returned cube is a MappedNpvCube, i.e. the data is memory mapped and read on demand. */
 NPVCubeWithMetaData loadCube(const std::string& filename);
 void saveCube(const std::string& filename, const NPVCubeWithMetaData& cube);
 
+/*! Files with extension .bin are written in a binary format: a versioned header holding the dimensions and keys,
+    followed by a dense block of doubles per key with samples running fastest. All other files are written as text,
+    compressed unless the extension is .csv or .txt. On load the binary format is detected from the file header. */
 QuantLib::ext::shared_ptr<AggregationScenarioData> loadAggregationScenarioData(const std::string& filename);
 void saveAggregationScenarioData(const std::string& filename, const AggregationScenarioData& cube);
 
@@ -137,6 +137,60 @@ Real CubeInterpretation::getMporFlows(const QuantLib::ext::shared_ptr<NPVCube>&
     return getMporPositiveFlows(cube, tradeIdx, dateIdx, sampleIdx) + getMporNegativeFlows(cube, tradeIdx, dateIdx, sampleIdx) ;
 }
 
+void CubeInterpretation::getGenericValues(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size tradeIdx, Size dateIdx,
+                                          Size depth, std::vector<Real>& result) const {
+    cube->getSamples(tradeIdx, dateIdx, depth, result);
+    if (flipViewXVA_) {
+        for (auto& v : result)
+            v = -v;
+    }
+}
+
+void CubeInterpretation::getDefaultNpvs(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size tradeIdx, Size dateIdx,
+                                        std::vector<Real>& result) const {
+    getGenericValues(cube, tradeIdx, dateIdx, defaultDateNpvIndex_, result);
+}
+
+void CubeInterpretation::getCloseOutNpvs(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size tradeIdx, Size dateIdx,
+                                         const QuantLib::ext::shared_ptr<AggregationScenarioData>& data,
+                                         std::vector<Real>& result) const {
+    if (withCloseOutLag_) {
+        getGenericValues(cube, tradeIdx, dateIdx, closeOutDateNpvIndex_, result);
+        for (Size k = 0; k < result.size(); ++k)
+            result[k] /= getCloseOutAggregationScenarioData(data, AggregationScenarioDataType::Numeraire, dateIdx, k);
+    } else {
+        getGenericValues(cube, tradeIdx, dateIdx + 1, defaultDateNpvIndex_, result);
+    }
+}
+
+void CubeInterpretation::getMporPositiveFlows(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size tradeIdx,
+                                              Size dateIdx, std::vector<Real>& result) const {
+    if (mporFlowsIndex_ == QuantLib::Null<Size>()) {
+        result.assign(cube->samples(), 0.0);
+        return;
+    }
+    try {
+        getGenericValues(cube, tradeIdx, dateIdx, mporFlowsIndex_, result);
+    } catch (std::exception& e) {
+        DLOG("Unable to retrieve MPOR flows for trade " << tradeIdx << ", date " << dateIdx << "; " << e.what());
+        result.assign(cube->samples(), 0.0);
+    }
+}
+
+void CubeInterpretation::getMporNegativeFlows(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size tradeIdx,
+                                              Size dateIdx, std::vector<Real>& result) const {
+    if (mporFlowsIndex_ == QuantLib::Null<Size>()) {
+        result.assign(cube->samples(), 0.0);
+        return;
+    }
+    try {
+        getGenericValues(cube, tradeIdx, dateIdx, mporFlowsIndex_ + 1, result);
+    } catch (std::exception& e) {
+        DLOG("Unable to retrieve MPOR flows for trade " << tradeIdx << ", date " << dateIdx << "; " << e.what());
+        result.assign(cube->samples(), 0.0);
+    }
+}
+
 Real CubeInterpretation::getDefaultAggregationScenarioData(
     const QuantLib::ext::shared_ptr<AggregationScenarioData>& data, const AggregationScenarioDataType& dataType,
     Size dateIdx, Size sampleIdx, const std::string& qualifier) const {
@@ -156,6 +210,23 @@ Real CubeInterpretation::getCloseOutAggregationScenarioData(
     }
 }
 
+std::span<const Real> CubeInterpretation::getDefaultAggregationScenarioSamples(
+    const QuantLib::ext::shared_ptr<AggregationScenarioData>& data, Size handle, Size dateIdx) const {
+    return data->samples(dateIdx, handle);
+}
+
+std::span<const Real> CubeInterpretation::getCloseOutAggregationScenarioSamples(
+    const QuantLib::ext::shared_ptr<AggregationScenarioData>& data, Size handle, Size dateIdx) const {
+    if (withCloseOutLag_) {
+        QL_REQUIRE(handle == data->handle(AggregationScenarioDataType::Numeraire),
+                   "close out aggr scen data only available for numeraire");
+        // this is an approximation
+        return getDefaultAggregationScenarioSamples(data, handle, dateIdx);
+    } else {
+        return data->samples(dateIdx + 1, handle);
+    }
+}
+
 Size CubeInterpretation::getMporCalendarDays(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size dateIdx) const {
     if (withCloseOutLag_) {
         QuantLib::Date dd = dateGrid_->valuationDates()[dateIdx];
@@ -33,6 +33,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 namespace ore {
 using namespace data;
@@ -90,6 +91,22 @@ public:
     //! Retrieve the aggregate value of Margin Period of Risk cashflows from the Cube
     Real getMporFlows(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size tradeIdx, Size dateIdx, Size sampleIdx) const;
 
+    /*! Bulk versions of the above, retrieving the values for all samples at once, the result is resized to the number
+        of samples in the cube */
+    //@{
+    void getGenericValues(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size tradeIdx, Size dateIdx, Size depth,
+                          std::vector<Real>& result) const;
+    void getDefaultNpvs(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size tradeIdx, Size dateIdx,
+                        std::vector<Real>& result) const;
+    void getCloseOutNpvs(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size tradeIdx, Size dateIdx,
+                         const QuantLib::ext::shared_ptr<AggregationScenarioData>& data,
+                         std::vector<Real>& result) const;
+    void getMporPositiveFlows(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size tradeIdx, Size dateIdx,
+                              std::vector<Real>& result) const;
+    void getMporNegativeFlows(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size tradeIdx, Size dateIdx,
+                              std::vector<Real>& result) const;
+    //@}
+
     //! Retrieve a (default date) simulated risk factor value from AggregationScenarioData
     Real getDefaultAggregationScenarioData(const QuantLib::ext::shared_ptr<AggregationScenarioData>& data,
                                            const AggregationScenarioDataType& dataType, Size dateIdx, Size sampleIdx,
@@ -100,6 +117,16 @@ public:
                                             const AggregationScenarioDataType& dataType, Size dateIdx, Size sampleIdx,
                                             const std::string& qualifier = "") const;
 
+    //! Retrieve the (default date) simulated values of all samples for a key handle from AggregationScenarioData
+    std::span<const Real>
+    getDefaultAggregationScenarioSamples(const QuantLib::ext::shared_ptr<AggregationScenarioData>& data, Size handle,
+                                         Size dateIdx) const;
+
+    //! Retrieve the (close-out date) simulated values of all samples for a key handle from AggregationScenarioData
+    std::span<const Real>
+    getCloseOutAggregationScenarioSamples(const QuantLib::ext::shared_ptr<AggregationScenarioData>& data, Size handle,
+                                          Size dateIdx) const;
+
     //! Number of Calendar Days between a given default date and corresponding close-out date
     Size getMporCalendarDays(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size dateIdx) const;
 
@@ -75,10 +75,13 @@ public:
     Real get(Size id, Size date, Size sample, Size depth = 0) const override;
     void set(Real value, Size id, Size date, Size sample, Size depth = 0) override;
 
+    void getSamples(Size id, Size date, Size depth, std::vector<Real>& result) const override;
+    void setSamples(const std::vector<Real>& values, Size id, Size date, Size depth) override;
+
     bool usesDoublePrecision() const override;
 
 private:
-    std::set<std::pair<QuantLib::ext::shared_ptr<NPVCube>, Size>> cubeAndId(Size id) const;
+    const std::set<std::pair<QuantLib::ext::shared_ptr<NPVCube>, Size>>& cubeAndId(Size id) const;
 
     const std::vector<QuantLib::ext::shared_ptr<NPVCube>> cubes_;
     const std::function<Real(Real a, Real x)> accumulator_;
@@ -0,0 +1,131 @@
+/*
+ Copyright (C) 2025 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/cube/mappednpvcube.hpp
+    \brief cube backed by a memory mapped binary cube file
+    \ingroup cube
+*/
+
+#pragma once
+
+#include <orea/cube/npvcube.hpp>
+
+#include <ql/errors.hpp>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace ore {
+namespace analytics {
+
+using QuantLib::Date;
+using QuantLib::Size;
+
+//! Cube backed by a memory mapped binary cube file
+/*! The file is mapped privately (copy on write), i.e. only the pages that are actually read are loaded from disk and
+    values set on the cube are never written back to the file. See saveCube() for the file layout. The data block is
+    stored as (date, id, depth, sample) with samples running fastest, the t0 block as (depth, id) with ids running
+    fastest, both blocks start at an offset that is a multiple of 64 bytes.
+
+    \ingroup cube
+*/
+template <typename T> class MappedNpvCube : public NPVCube {
+public:
+    MappedNpvCube(const QuantLib::ext::shared_ptr<boost::iostreams::mapped_file>& file, std::size_t t0Offset,
+                  std::size_t dataOffset, const Date& asof, const std::map<std::string, Size>& idIdx,
+                  const std::vector<Date>& dates, Size samples, Size depth)
+        : file_(file), asof_(asof), dates_(dates), samples_(samples), depth_(depth), idIdx_(idIdx) {
+        QL_REQUIRE(file_ && file_->is_open(), "MappedNpvCube: file is not open");
+        QL_REQUIRE(dataOffset + sizeof(T) * dates_.size() * idIdx_.size() * depth_ * samples_ <= file_->size(),
+                   "MappedNpvCube: file size (" << file_->size() << ") is too small for cube dimensions "
+                                                << idIdx_.size() << " x " << dates_.size() << " x " << samples_
+                                                << " x " << depth_);
+        t0data_ = reinterpret_cast<T*>(file_->data() + t0Offset);
+        data_ = reinterpret_cast<T*>(file_->data() + dataOffset);
+    }
+
+    Size numIds() const override { return idIdx_.size(); }
+    Size numDates() const override { return dates_.size(); }
+    Size samples() const override { return samples_; }
+    Size depth() const override { return depth_; }
+    const std::map<std::string, Size>& idsAndIndexes() const override { return idIdx_; }
+    const std::vector<QuantLib::Date>& dates() const override { return dates_; }
+    QuantLib::Date asof() const override { return asof_; }
+
+    Real getT0(Size i, Size d) const override {
+        this->check(i, 0, 0, d);
+        return static_cast<Real>(t0data_[d * idIdx_.size() + i]);
+    }
+
+    void setT0(Real value, Size i, Size d) override {
+        this->check(i, 0, 0, d);
+        t0data_[d * idIdx_.size() + i] = static_cast<T>(value);
+    }
+
+    Real get(Size i, Size j, Size k, Size d) const override {
+        this->check(i, j, k, d);
+        return static_cast<Real>(data_[pos(i, j, d) + k]);
+    }
+
+    void set(Real value, Size i, Size j, Size k, Size d) override {
+        this->check(i, j, k, d);
+        data_[pos(i, j, d) + k] = static_cast<T>(value);
+    }
+
+    void getSamples(Size i, Size j, Size d, std::vector<Real>& result) const override {
+        this->check(i, j, 0, d);
+        result.resize(samples_);
+        std::copy(data_ + pos(i, j, d), data_ + pos(i, j, d) + samples_, result.begin());
+    }
+
+    void setSamples(const std::vector<Real>& values, Size i, Size j, Size d) override {
+        this->check(i, j, 0, d);
+        QL_REQUIRE(values.size() == samples_, "MappedNpvCube::setSamples(): values size ("
+                                                  << values.size() << ") does not match samples (" << samples_ << ")");
+        std::transform(values.begin(), values.end(), data_ + pos(i, j, d),
+                       [](const Real v) { return static_cast<T>(v); });
+    }
+
+    bool usesDoublePrecision() const override;
+
+private:
+    Size pos(Size i, Size j, Size d) const { return ((j * idIdx_.size() + i) * depth_ + d) * samples_; }
+
+    void check(Size i, Size j, Size k, Size d) const {
+        QL_REQUIRE(i < numIds(), "Out of bounds on ids (i=" << i << ", numIds=" << numIds() << ")");
+        QL_REQUIRE(j < numDates(), "Out of bounds on dates (j=" << j << ", numDates=" << numDates() << ")");
+        QL_REQUIRE(k < samples(), "Out of bounds on samples (k=" << k << ", samples=" << samples() << ")");
+        QL_REQUIRE(d < depth(), "Out of bounds on depth (d=" << d << ", depth=" << depth() << ")");
+    }
+
+    QuantLib::ext::shared_ptr<boost::iostreams::mapped_file> file_;
+    QuantLib::Date asof_;
+    std::vector<QuantLib::Date> dates_;
+    Size samples_;
+    Size depth_;
+    std::map<std::string, Size> idIdx_;
+
+    T* t0data_;
+    T* data_;
+};
+
+} // namespace analytics
+} // namespace ore
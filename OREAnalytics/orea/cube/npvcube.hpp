@@ -108,6 +108,13 @@ public:
         set(value, index(id), index(date), sample, depth);
     }
 
+    /*! Get the values for all samples for a given id, date and depth, the result is resized to samples(). Derived
+        classes storing the samples contiguously should override this to avoid one virtual call per sample. */
+    virtual void getSamples(Size id, Size date, Size depth, std::vector<Real>& result) const;
+
+    /*! Set the values for all samples for a given id, date and depth, values must have size samples() */
+    virtual void setSamples(const std::vector<Real>& values, Size id, Size date, Size depth);
+
     /*! Remove t0 values for a given id */
     virtual void removeT0(Size id);
 
@@ -136,6 +143,20 @@ protected:
 
 // impl
 
+inline void NPVCube::getSamples(Size id, Size date, Size depth, std::vector<Real>& result) const {
+    result.resize(samples());
+    for (Size sample = 0; sample < result.size(); ++sample)
+        result[sample] = get(id, date, sample, depth);
+}
+
+inline void NPVCube::setSamples(const std::vector<Real>& values, Size id, Size date, Size depth) {
+    QL_REQUIRE(values.size() == samples(),
+               "NPVCube::setSamples(): values size (" << values.size() << ") does not match samples (" << samples()
+                                                      << ")");
+    for (Size sample = 0; sample < values.size(); ++sample)
+        set(values[sample], id, date, sample, depth);
+}
+
 inline void NPVCube::removeT0(Size id) {
     for (Size depth = 0; depth < this->depth(); ++depth) {
         setT0(0.0, id, depth);
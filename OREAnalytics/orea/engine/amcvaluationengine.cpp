@@ -33,6 +33,7 @@
 #include <qle/indexes/fallbackiborindex.hpp>
 #include <qle/instruments/multiccycompositeinstrument.hpp>
 #include <qle/instruments/payment.hpp>
+#include <qle/methods/mcpathcache.hpp>
 #include <qle/methods/multipathgeneratorbase.hpp>
 #include <qle/methods/multipathvariategenerator.hpp>
 #include <qle/models/lgmimpliedyieldtermstructure.hpp>
@@ -288,6 +289,17 @@ void populateAsd(const QuantLib::ext::shared_ptr<QuantExt::CrossAssetModel>& mod
         asdIndexName.push_back(i);
     }
 
+    // register the keys once, the values are set by handle below
+
+    Size numeraireHandle = asd->registerKey(AggregationScenarioDataType::Numeraire);
+    std::vector<Size> fxSpotHandles, indexHandles, creditStateHandles;
+    for (auto const& c : asdCurrencyCode)
+        fxSpotHandles.push_back(asd->registerKey(AggregationScenarioDataType::FXSpot, c));
+    for (auto const& n : asdIndexName)
+        indexHandles.push_back(asd->registerKey(AggregationScenarioDataType::IndexFixing, n));
+    for (Size j = 0; j < aggDataNumberCreditStates; ++j)
+        creditStateHandles.push_back(asd->registerKey(AggregationScenarioDataType::CreditState, std::to_string(j)));
+
     // generate ASD
 
     LOG("Write ASD...");
@@ -303,11 +315,10 @@ void populateAsd(const QuantLib::ext::shared_ptr<QuantExt::CrossAssetModel>& mod
                 continue;
             // set numeraire
             asd->set(dateIndex, i, model->numeraire(0, sgd->getGrid()->timeGrid()[k], pathData.paths[k - 1][0][i]),
-                     AggregationScenarioDataType::Numeraire);
+                     numeraireHandle);
             // set fx spots
             for (Size j = 0; j < asdCurrencyIndex.size(); ++j) {
-                asd->set(dateIndex, i, fx(pathData.fxBuffer, asdCurrencyIndex[j], k, i),
-                         AggregationScenarioDataType::FXSpot, asdCurrencyCode[j]);
+                asd->set(dateIndex, i, fx(pathData.fxBuffer, asdCurrencyIndex[j], k, i), fxSpotHandles[j]);
             }
             // set index fixings
             Date d = sgd->getGrid()->dates()[k - 1];
@@ -318,13 +329,12 @@ void populateAsd(const QuantLib::ext::shared_ptr<QuantExt::CrossAssetModel>& mod
                     // proxy fallback ibor index by its rfr index's fixing
                     index = fb->rfrIndex();
                 }
-                asd->set(dateIndex, i, index->fixing(index->fixingCalendar().adjust(d)),
-                         AggregationScenarioDataType::IndexFixing, asdIndexName[j]);
+                asd->set(dateIndex, i, index->fixing(index->fixingCalendar().adjust(d)), indexHandles[j]);
             }
             // set credit states
             for (Size j = 0; j < aggDataNumberCreditStates; ++j) {
                 asd->set(dateIndex, i, pathData.paths[k - 1][model->pIdx(CrossAssetModel::AssetType::CrState, j)][i],
-                         AggregationScenarioDataType::CreditState, std::to_string(j));
+                         creditStateHandles[j]);
             }
             ++dateIndex;
         }
@@ -844,11 +854,14 @@ void AMCValuationEngine::buildCube(const QuantLib::ext::shared_ptr<Portfolio>& p
         populateAsd(model_, market_, scenarioGeneratorData_, outputCube->samples(), asd_, aggDataIndices_,
                     aggDataCurrencies_, aggDataNumberCreditStates_, pathData);
         // we can use the mt progress indicator here although we are running on a single thread
+        McPathCache::instance().enable(usePathCache_);
         runCoreEngine(
             portfolio, model_, market_, scenarioGeneratorData_, outputCube,
             QuantLib::ext::make_shared<ore::analytics::MultiThreadedProgressIndicator>(this->progressIndicators()),
             pathData, amcIndividualTrainingInput_, amcIndividualTrainingOutput_);
+        McPathCache::instance().enable(false);
     } catch (const std::exception& e) {
+        McPathCache::instance().enable(false);
         QL_FAIL("Error during amc val engine run: " << e.what());
     }
 
@@ -1003,6 +1016,7 @@ void AMCValuationEngine::buildCube(const QuantLib::ext::shared_ptr<ore::data::Po
             QuantLib::Settings::instance().includeTodaysCashFlows() = includeTodaysCashFlows;
             QuantLib::Settings::instance().includeReferenceDateEvents() = localIncRefDateEvents;
             ore::analytics::ObservationMode::instance().setMode(obsMode);
+            McPathCache::instance().enable(usePathCache_);
 
             LOG("Start thread " << id);
 
@@ -1051,6 +1065,10 @@ void AMCValuationEngine::buildCube(const QuantLib::ext::shared_ptr<ore::data::Po
                 rc = 1;
             }
 
+            // release the cached paths of this thread
+
+            McPathCache::instance().enable(false);
+
             // exit
 
             return rc;
@@ -94,6 +94,10 @@ public:
         return asd_;
     }
 
+    /*! Share the calibration paths between the amc engines of a thread, see QuantExt::McPathCache. This changes the
+        path realisations used for the calibration of the single trades and is therefore disabled by default. */
+    void setUsePathCache(const bool b) { usePathCache_ = b; }
+
 private:
     // set / get via additional methods
     QuantLib::ext::shared_ptr<ore::analytics::AggregationScenarioData> asd_;
@@ -107,6 +111,7 @@ private:
     QuantLib::ext::shared_ptr<ScenarioGeneratorData> scenarioGeneratorData_;
     std::string amcPathDataInput_, amcPathDataOutput_;
     bool amcIndividualTrainingInput_, amcIndividualTrainingOutput_;
+    bool usePathCache_ = false;
 
     // inputs for single-threaded run
     const QuantLib::ext::shared_ptr<QuantExt::CrossAssetModel> model_;
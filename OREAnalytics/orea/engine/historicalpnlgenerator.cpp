@@ -25,6 +25,8 @@
 #include <orea/cube/jointnpvcube.hpp>
 #include <orea/cube/inmemorycube.hpp>
 
+#include <ored/utilities/parallel.hpp>
+
 #include <boost/range/adaptor/indexed.hpp>
 
 using ore::data::EngineBuilder;
@@ -33,6 +35,7 @@ using ore::data::EngineFactory;
 using ore::data::MarketContext;
 using ore::data::Portfolio;
 using ore::data::TimePeriod;
+using QuantLib::Matrix;
 using QuantLib::Real;
 using QuantLib::io::iso_date;
 using std::map;
@@ -192,6 +195,56 @@ vector<Real> HistoricalPnlGenerator::pnl(const set<pair<string, Size>>& tradeIds
 
 vector<Real> HistoricalPnlGenerator::pnl() const { return pnl(timePeriod()); }
 
+Matrix HistoricalPnlGenerator::groupPnl(const vector<set<pair<string, Size>>>& tradeIdGroups, Size nThreads) const {
+
+    Size dateIdx = indexAsof();
+    Size samples = cube_->samples();
+    Matrix pnls(tradeIdGroups.size(), samples, 0.0);
+
+    // the groups each trade belongs to and the t0 npvs of these trades
+    vector<vector<Size>> groups(cube_->numIds());
+    for (Size g = 0; g < tradeIdGroups.size(); ++g) {
+        for (const auto& tradeId : tradeIdGroups[g])
+            groups.at(tradeId.second).push_back(g);
+    }
+    vector<Real> t0Npvs(cube_->numIds(), 0.0);
+    for (Size i = 0; i < groups.size(); ++i) {
+        if (!groups[i].empty())
+            t0Npvs[i] = cube_->getT0(i);
+    }
+
+    // each thread fills a block of columns, i.e. a range of scenarios
+    Size nBlocks = std::max<Size>(1, std::min(nThreads, samples));
+    ore::data::parallelFor(nBlocks, nBlocks, [&](Size b) {
+        for (Size s = b * samples / nBlocks; s < (b + 1) * samples / nBlocks; ++s) {
+            for (Size i = 0; i < groups.size(); ++i) {
+                if (groups[i].empty())
+                    continue;
+                Real pnl = cube_->get(i, dateIdx, s) - t0Npvs[i];
+                for (Size g : groups[i])
+                    pnls[g][s] += pnl;
+            }
+        }
+    });
+
+    return pnls;
+}
+
+vector<Real> HistoricalPnlGenerator::pnl(const TimePeriod& period, const Matrix& groupPnls, Size group) const {
+    QL_REQUIRE(group < groupPnls.rows(), "HistoricalPnlGenerator::pnl(): group " << group << " out of range, matrix has "
+                                                                                 << groupPnls.rows() << " rows");
+    QL_REQUIRE(groupPnls.columns() == cube_->samples(), "HistoricalPnlGenerator::pnl(): matrix has "
+                                                            << groupPnls.columns() << " columns, expected "
+                                                            << cube_->samples());
+    vector<Real> pnls;
+    pnls.reserve(groupPnls.columns());
+    for (Size s = 0; s < groupPnls.columns(); ++s) {
+        if (period.contains(hisScenGen_->startDates()[s]) && period.contains(hisScenGen_->endDates()[s]))
+            pnls.push_back(groupPnls[group][s]);
+    }
+    return pnls;
+}
+
 using TradePnlStore = HistoricalPnlGenerator::TradePnlStore;
 
 TradePnlStore HistoricalPnlGenerator::tradeLevelPnl(const TimePeriod& period,
@@ -29,6 +29,7 @@
 #include <ored/portfolio/portfolio.hpp>
 #include <ored/utilities/timeperiod.hpp>
 #include <orea/scenario/historicalscenariogenerator.hpp>
+#include <ql/math/matrix.hpp>
 #include <ql/types.hpp>
 #include <vector>
 
@@ -111,6 +112,20 @@ public:
     */
     std::vector<QuantLib::Real> pnl() const;
 
+    /*! Return a (group, scenario) matrix of historical P&L values for all scenarios generated by the historical
+        scenario generator, where row i holds the P&Ls of the trades in \p tradeIdGroups[i]. The P&Ls of all groups
+        are accumulated in a single pass over the last cube generated by generateCube, i.e. the P&L of each trade
+        and scenario is read once and added to each group containing the trade. The scenarios are split between up
+        to \p nThreads threads.
+    */
+    QuantLib::Matrix groupPnl(const std::vector<std::set<std::pair<std::string, QuantLib::Size>>>& tradeIdGroups,
+                              QuantLib::Size nThreads = 1) const;
+
+    /*! Return row \p group of a matrix returned by groupPnl() restricted to scenarios falling in \p period.
+     */
+    std::vector<QuantLib::Real> pnl(const ore::data::TimePeriod& period, const QuantLib::Matrix& groupPnls,
+                                    QuantLib::Size group) const;
+
     /*! Return a vector of historical trade level P&L values restricted to scenarios falling in \p period and
         restricted to the given \p tradeIds. The P&L values are calculated from the last cube generated by
         generateCube. The first dimension is time and the second dimension is tradeId.
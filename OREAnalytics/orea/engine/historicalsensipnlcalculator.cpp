@@ -19,122 +19,115 @@
 #include <orea/app/structuredanalyticserror.hpp>
 #include <orea/cube/inmemorycube.hpp>
 #include <orea/engine/historicalsensipnlcalculator.hpp>
+#include <ored/utilities/parallel.hpp>
 #include <ored/utilities/to_string.hpp>
 
-#include <boost/accumulators/statistics/tail_quantile.hpp>
-#include <boost/range/adaptor/indexed.hpp>
+#include <functional>
+#include <numeric>
+#include <unordered_map>
 
 using namespace std;
 using namespace QuantLib;
-using namespace boost::accumulators;
 
 namespace {
- 
-using TradeSensiCache = map<Size, map<Size, pair<Real, Real>>>;
-using ore::analytics::SensitivityRecord;
 
-void cacheTradeSensitivities(TradeSensiCache& cache, ore::analytics::SensitivityStream& ss,
-                             const set<SensitivityRecord>& srs,
-                             const vector<string>& tradeIds) {
+using ore::analytics::RiskFactorKey;
+using ore::analytics::SensitivityRecord;
 
-    // Reset the stream to ensure at start.
+// sensitivity of one trade to the risk factor(s) of a sensitivity record
+struct TradeSensitivity {
+    Size trade;
+    Real delta;
+    Real gamma;
+};
+
+/* One pass of the sensitivity stream to collect the trade level sensitivities for each record in srs. The trades are
+   given by their position in tradeIds, records of trades not in tradeIds or with keys not in srs are skipped. */
+vector<vector<TradeSensitivity>> tradeSensitivities(ore::analytics::SensitivityStream& ss,
+                                                    const set<SensitivityRecord>& srs, const vector<string>& tradeIds) {
+
+    unordered_map<string, Size> tradePos;
+    for (Size t = 0; t < tradeIds.size(); ++t)
+        tradePos.emplace(tradeIds[t], t);
+    map<pair<RiskFactorKey, RiskFactorKey>, Size> recordPos;
+    for (const auto& sr : srs)
+        recordPos.emplace(make_pair(sr.key_1, sr.key_2), recordPos.size());
+
+    vector<map<Size, pair<Real, Real>>> cache(srs.size());
     ss.reset();
-
-    // One pass of sensitivity records to populate the trade level cache.
     while (SensitivityRecord sr = ss.next()) {
-
-        // Sensitivity record is only relevant if it is in our set of trade IDs
-        auto itTrade = find(tradeIds.begin(), tradeIds.end(), sr.tradeId);
-        if (itTrade == tradeIds.end())
+        auto t = tradePos.find(sr.tradeId);
+        if (t == tradePos.end())
             continue;
-
-        // This sensitivity record should be in the set of passed in sensitivity records.
-        auto itSr = find_if(srs.begin(), srs.end(), [&sr](const SensitivityRecord& other) {
-            return sr.key_1 == other.key_1 && sr.key_2 == other.key_2;
-        });
-
-        // Positions for the cache keys.
-        auto posTrade = distance(tradeIds.begin(), itTrade);
-        auto posSr = distance(srs.begin(), itSr);
-
-        // Add the sensitivity record values to the cache.
-        auto itCacheSr = cache.find(posSr);
-        if (itCacheSr == cache.end()) {
-            cache[posSr][posTrade] = make_pair(sr.delta, sr.gamma);
-        } else {
-            auto itCacheTrade = itCacheSr->second.find(posTrade);
-            if (itCacheTrade == itCacheSr->second.end()) {
-                itCacheSr->second[posTrade] = make_pair(sr.delta, sr.gamma);
-            } else {
-                auto& p = itCacheTrade->second;
-                p.first += sr.delta;
-                p.second += sr.gamma;
-            }
-        }
+        auto r = recordPos.find(make_pair(sr.key_1, sr.key_2));
+        if (r == recordPos.end())
+            continue;
+        auto& p = cache[r->second][t->second];
+        p.first += sr.delta;
+        p.second += sr.gamma;
     }
-
-    // Reset the stream to ensure at start.
     ss.reset();
-}
 
+    vector<vector<TradeSensitivity>> result(srs.size());
+    for (Size r = 0; r < cache.size(); ++r) {
+        result[r].reserve(cache[r].size());
+        for (const auto& [t, dg] : cache[r])
+            result[r].push_back({t, dg.first, dg.second});
+    }
+    return result;
 }
 
+} // namespace
+
 namespace ore {
 namespace analytics {
 
-void CovarianceCalculator::initialise(const set<pair<RiskFactorKey, Size>>& keys) {
-    // Set up the boost accumulators that will calculate the covariance between the time series of historical shifts for
-    // each relevant risk factor key i.e. the risk factor keys in the set keys over the benchmark period
-    
-    for (auto ito = keys.begin(); ito != keys.end(); ito++) {
-        accCov_[make_pair(ito->second, ito->second)] = accumulator();
-        for (auto iti = keys.begin(); iti != ito; iti++) {
-            accCov_[make_pair(iti->second, ito->second)] = accumulator();
-        }
+void CovarianceCalculator::calculate(const Matrix& shifts, const vector<Size>& rows, const vector<Date>& startDates,
+                                     const vector<Date>& endDates, Size nThreads) {
+
+    // scenarios in the covariance period
+    vector<Size> scenarios;
+    for (Size s = 0; s < shifts.columns(); ++s) {
+        if (covariancePeriod_.contains(startDates[s]) && covariancePeriod_.contains(endDates[s]))
+            scenarios.push_back(s);
     }
-}
 
-void CovarianceCalculator::updateAccumulators(const ext::shared_ptr<NPVCube>& shiftCube, Date startDate, Date endDate, Size index) {
-    TLOG("Updating Covariance accumlators for sensitivity record " << index);
-    if (covariancePeriod_.contains(startDate) &&
-        covariancePeriod_.contains(endDate)) {
-        // Update the covariance accumulators if in benchmark period
-        for (auto it = accCov_.begin(); it != accCov_.end(); it++) {
-            Real oShift = shiftCube->get(it->first.first, 0, index);
-            if (it->first.first == it->first.second) {
-                it->second(oShift, covariate1 = oShift);
-            } else {
-                Real iShift = shiftCube->get(it->first.second, 0, index);
-                it->second(oShift, covariate1 = iShift);
-            }
-        }
+    Size n = scenarios.size();
+    Size nKeys = rows.size();
+    LOG("Calculate the covariance matrix of " << nKeys << " risk factors over " << n << " scenarios");
+    covariance_ = Matrix(nKeys, nKeys, 0.0);
+    correlation_ = Matrix(nKeys, nKeys, 0.0);
+    if (nKeys == 0)
+        return;
+
+    // centred shifts, one row per risk factor
+    Matrix x(nKeys, std::max<Size>(n, 1), 0.0);
+    if (n > 0) {
+        ore::data::parallelFor(nKeys, nThreads, [&](Size i) {
+            Real mean = 0.0;
+            for (Size j = 0; j < n; ++j)
+                mean += (x[i][j] = shifts[rows[i]][scenarios[j]]);
+            mean /= n;
+            for (Size j = 0; j < n; ++j)
+                x[i][j] -= mean;
+        });
+
+        // lower triangle of the (population) covariance matrix, the rows are handed out to the threads one at a time
+        ore::data::parallelFor(nKeys, nThreads, [&](Size i) {
+            for (Size j = 0; j <= i; ++j)
+                covariance_[i][j] = std::inner_product(x.row_begin(i), x.row_begin(i) + n, x.row_begin(j), 0.0) / n;
+        });
     }
-}
 
-void CovarianceCalculator::populateCovariance(const std::set<std::pair<RiskFactorKey, QuantLib::Size>>& keys) {
-    LOG("Populate the covariance matrix with the calculated covariances");
-    covariance_ = Matrix(keys.size(), keys.size());
-    correlation_ = Matrix(keys.size(), keys.size());
-    Size i = 0;
-    for (auto ito = keys.begin(); ito != keys.end(); ito++) {
-        covariance_[i][i] = boost::accumulators::covariance(accCov_.at(make_pair(ito->second, ito->second)));
+    for (Size i = 0; i < nKeys; ++i) {
         correlation_[i][i] = 1.0;
-        Real var_i = boost::accumulators::variance(accCov_.at(std::make_pair(ito->second, ito->second)));
-        Size j = 0;
-        for (auto iti = keys.begin(); iti != ito; iti++) {
-            Size key_j = iti->second;
-            covariance_[i][j] = covariance_[j][i] =
-                boost::accumulators::covariance(accCov_.at(make_pair(iti->second, ito->second)));
-            const auto& acc_jj = accCov_.at(std::make_pair(key_j, key_j));
-            Real var_j = boost::accumulators::variance(acc_jj);
+        for (Size j = 0; j < i; ++j) {
+            covariance_[j][i] = covariance_[i][j];
             Real corr_ij = 0.0;
-            if (var_i > 0.0 && var_j > 0.0) {
-                corr_ij = covariance_[i][j] / (std::sqrt(var_i) * std::sqrt(var_j));
-            }
+            if (covariance_[i][i] > 0.0 && covariance_[j][j] > 0.0)
+                corr_ij = covariance_[i][j] / (std::sqrt(covariance_[i][i]) * std::sqrt(covariance_[j][j]));
             correlation_[i][j] = correlation_[j][i] = corr_ij;
-            j++;
         }
-        i++;
     }
 }
 
@@ -214,240 +207,231 @@ void HistoricalSensiPnlCalculator::populateSensiShifts(QuantLib::ext::shared_ptr
 }
 
 void HistoricalSensiPnlCalculator::calculateSensiPnl(
-    const set<SensitivityRecord>& srs, const vector<RiskFactorKey>& rfKeys, ext::shared_ptr<NPVCube>& shiftCube, 
+    const set<SensitivityRecord>& srs, const vector<RiskFactorKey>& rfKeys, ext::shared_ptr<NPVCube>& shiftCube,
     const vector<ext::shared_ptr<PNLCalculator>>& pnlCalculators,
     const ext::shared_ptr<CovarianceCalculator>& covarianceCalculator,
-    const vector<string>& tradeIds, const bool includeGammaMargin, 
+    const vector<string>& tradeIds, const bool includeGammaMargin,
     const bool includeDeltaMargin, const bool tradeLevel, const bool riskFactorLevel) {
 
-    // Set of relevant keys from sensitivity records, needed for covariance matrix
-    // Add the index of the key location in sensi shift cube
+    hisScenGen_->reset();
+    const vector<Date>& startDates = hisScenGen_->startDates();
+    const vector<Date>& endDates = hisScenGen_->endDates();
+    Size nScenarios = hisScenGen_->numScenarios();
+    Size nTrades = tradeIds.size();
+    vector<const SensitivityRecord*> records;
+    for (const auto& sr : srs)
+        records.push_back(&sr);
+
+    // Assign a row of the dense shift matrix to each risk factor key needed for the covariance matrix or by a
+    // sensitivity record, cross gamma records use two rows.
+    map<Size, Size> rows;
+    auto row = [&shiftCube, &rows](const RiskFactorKey& key) {
+        auto it = shiftCube->idsAndIndexes().find(ore::data::to_string(key));
+        QL_REQUIRE(it != shiftCube->idsAndIndexes().end(), "Could not find key " << key << " in sensi shift cube keys");
+        Size r = rows.size();
+        return rows.insert(make_pair(it->second, r)).first->second;
+    };
     set<pair<RiskFactorKey, Size>> keys;
-    for (auto it = rfKeys.begin(); it != rfKeys.end(); it++) {
-        auto it1 = shiftCube->idsAndIndexes().find(ore::data::to_string(*it));
-        QL_REQUIRE(it1 != shiftCube->idsAndIndexes().end(),
-                   "Could not find key " << *it << " in sensi shift cube keys");
-        keys.insert(make_pair(*it, it1->second));
-    }
-    // Create an index pair for each sensitivity record. The first element holds the index position
-    // in the sensi shift cube of key_1. The second element holds the index of key_2 for cross
-    // gamma record.
-    vector<pair<Size, Size>> srsIndex;
-    for (auto it = srs.begin(); it != srs.end(); it++) {
-        auto it1 = shiftCube->idsAndIndexes().find(ore::data::to_string(it->key_1));
-        QL_REQUIRE(it1 != shiftCube->idsAndIndexes().end(),
-                   "Could not find key " << it->key_1 << " in sensi shift cube keys");
-        Size ind_1 = it1->second;
-        Size ind_2 = Size();
-        if (it->isCrossGamma()) {
-            auto it2 = shiftCube->idsAndIndexes().find(ore::data::to_string(it->key_2));
-            QL_REQUIRE(it2 != shiftCube->idsAndIndexes().end(),
-                       "Could not find key " << it->key_2 << " in sensi shift cube keys");
-            ind_2 = it2->second;
+    for (const auto& k : rfKeys)
+        keys.insert(make_pair(k, row(k)));
+    vector<pair<Size, Size>> srsRows;
+    for (const auto sr : records)
+        srsRows.push_back(make_pair(row(sr->key_1), sr->isCrossGamma() ? row(sr->key_2) : Null<Size>()));
+
+    // factor x scenario matrix of the historical shifts
+    Matrix shifts(rows.size(), nScenarios, 0.0);
+    vector<Size> cubeIndices(rows.size());
+    for (const auto& [c, r] : rows)
+        cubeIndices[r] = c;
+    ore::data::parallelFor(rows.size(), nThreads_, [&](Size r) {
+        for (Size s = 0; s < nScenarios; ++s)
+            shifts[r][s] = shiftCube->get(cubeIndices[r], 0, s);
+    });
+
+    // The kernels below split the scenarios into contiguous blocks, one per thread, so that each thread only writes
+    // the results of its own scenarios and reads the rows of the shift matrix sequentially.
+    Size nBlocks = std::max<Size>(1, std::min(nThreads_, nScenarios));
+    auto forEachBlock = [nBlocks, nScenarios](const std::function<void(Size, Size)>& f) {
+        ore::data::parallelFor(nBlocks, nBlocks,
+                               [&](Size b) { f(b * nScenarios / nBlocks, (b + 1) * nScenarios / nBlocks); });
+    };
+
+    // Portfolio level P&Ls
+    vector<Real> allPnls(nScenarios, 0.0);
+    vector<Real> allFoPnls(nScenarios, 0.0);
+    forEachBlock([&](Size s0, Size s1) {
+        for (Size j = 0; j < records.size(); ++j) {
+            const auto& sr = *records[j];
+            const Real* shift_1 = shifts.row_begin(srsRows[j].first);
+            if (!sr.isCrossGamma()) {
+                for (Size i = s0; i < s1; ++i) {
+                    Real deltaPnl = shift_1[i] * sr.delta;
+                    Real gammaPnl = 0.5 * shift_1[i] * shift_1[i] * sr.gamma;
+                    allFoPnls[i] += deltaPnl;
+                    // If backtesting curvature margin, we exclude deltas i.e. 1st order effects from the sensi P&L
+                    if (includeDeltaMargin)
+                        allPnls[i] += deltaPnl;
+                    // If backtesting delta margin, we exclude gammas i.e. second order effects from the sensi P&L
+                    if (includeGammaMargin)
+                        allPnls[i] += gammaPnl;
+                }
+            } else if (includeGammaMargin) {
+                const Real* shift_2 = shifts.row_begin(srsRows[j].second);
+                for (Size i = s0; i < s1; ++i)
+                    allPnls[i] += shift_1[i] * shift_2[i] * sr.gamma;
+            }
         }
-        srsIndex.push_back(make_pair(ind_1, ind_2));
-    }
-
-    if (covarianceCalculator)
-        covarianceCalculator->initialise(keys);
+    });
 
-    // we require a sensitivity stream to run at trade level
+    // we require a sensitivity stream to run at trade or risk factor level
     bool runTradeLevel = tradeLevel && sensitivityStream_;
-
-    // Local P&L vectors to hold _all_ historical P&Ls
-    Size nScenarios = hisScenGen_->numScenarios();
-    Size nCalculators = pnlCalculators.size();
-    vector<Real> allPnls(hisScenGen_->numScenarios(), 0.0);
-    vector<Real> allFoPnls(hisScenGen_->numScenarios(), 0.0);
-    
-    // calculators,scenarios, trades
-    using TradePnLStore = std::vector<std::vector<QuantLib::Real>>;
-    std::vector<TradePnLStore> tradePnls, foTradePnls;
-
-    // We may need to store trade level P&Ls.
-    if (runTradeLevel) {
-        tradePnls.clear();
-        tradePnls.reserve(nCalculators);
-        foTradePnls.clear();
-        foTradePnls.reserve(nCalculators);
-        for (Size i = 0; i < nCalculators; i++) {
-            tradePnls.push_back(std::vector<std::vector<QuantLib::Real>>());
-            tradePnls.at(i).reserve(nScenarios);
-            foTradePnls.push_back(std::vector<std::vector<QuantLib::Real>>());
-            foTradePnls.at(i).reserve(nScenarios);
-        }
-    }
-    using RiskFactorTradePnLStore = std::vector<std::map<std::string, std::vector<QuantLib::Real>>>;
-
-    //calculators, scenarios, map<risk factors,  trades>
-    std::vector<RiskFactorTradePnLStore> riskFactorTradePnls, riskFactorFoTradePnls;
-
     bool runRiskFactorLevel = riskFactorLevel && sensitivityStream_;
-    if (runRiskFactorLevel){
-        riskFactorTradePnls.clear();
-        riskFactorTradePnls.reserve(nCalculators);
-        riskFactorFoTradePnls.clear();
-        riskFactorFoTradePnls.reserve(nCalculators);
-        for (Size i = 0; i < nCalculators; i++) {
-            riskFactorTradePnls.push_back(std::vector<std::map<std::string, std::vector<QuantLib::Real>>>());
-            riskFactorTradePnls.at(i).reserve(nScenarios);
-            riskFactorFoTradePnls.push_back(std::vector<std::map<std::string, std::vector<QuantLib::Real>>>());
-            riskFactorFoTradePnls.at(i).reserve(nScenarios);
-        }
-    }
-
-    hisScenGen_->reset();
-    QuantLib::ext::shared_ptr<Scenario> baseScenario = hisScenGen_->baseScenario();
-
-    // If we have been asked for a trade level P&L contribution report or detail report, store the trade level
-    // sensitivities. We store them in a container here that is easily looked up in the loop below.
-    TradeSensiCache tradeSensiCache;
-    if (runTradeLevel || runRiskFactorLevel) {
-        cacheTradeSensitivities(tradeSensiCache, *sensitivityStream_, srs, tradeIds);
-    }
 
-    // Loop over each historical
-    for (Size i = 0; i < hisScenGen_->numScenarios(); i++) {
-
-        // Add trade level P&L vector if needed.
-        if (runTradeLevel) {
-            for (Size j = 0; j < pnlCalculators.size(); j++) {
-                bool inPeriod =
-                    pnlCalculators.at(j)->isInTimePeriod(hisScenGen_->startDates()[i], hisScenGen_->endDates()[i]);
-                if (inPeriod) {
-                    tradePnls.at(j).push_back(vector<Real>(tradeIds.size(), 0.0));
-                    foTradePnls.at(j).push_back(vector<Real>(tradeIds.size(), 0.0));
+    // If we have been asked for a trade level P&L contribution report or detail report, collect the trade level
+    // sensitivities per sensitivity record.
+    vector<vector<TradeSensitivity>> tradeSensis;
+    if (runTradeLevel || runRiskFactorLevel)
+        tradeSensis = tradeSensitivities(*sensitivityStream_, srs, tradeIds);
+
+    auto inPeriodOfAnyCalculator = [&pnlCalculators, &startDates, &endDates](Size i) {
+        return std::any_of(pnlCalculators.begin(), pnlCalculators.end(),
+                           [&](const ext::shared_ptr<PNLCalculator>& c) {
+                               return c->isInTimePeriod(startDates[i], endDates[i]);
+                           });
+    };
+
+    // Trade level P&Ls, scenarios x trades
+    using TradePnLStore = PNLCalculator::TradePnLStore;
+    TradePnLStore tradePnls, foTradePnls;
+    if (runTradeLevel) {
+        tradePnls.assign(nScenarios, vector<Real>(nTrades, 0.0));
+        foTradePnls.assign(nScenarios, vector<Real>(nTrades, 0.0));
+        forEachBlock([&](Size s0, Size s1) {
+            for (Size j = 0; j < records.size(); ++j) {
+                const Real* shift_1 = shifts.row_begin(srsRows[j].first);
+                if (!records[j]->isCrossGamma()) {
+                    for (const auto& ts : tradeSensis[j]) {
+                        for (Size i = s0; i < s1; ++i) {
+                            Real tradeDeltaPnl = shift_1[i] * ts.delta;
+                            foTradePnls[i][ts.trade] += tradeDeltaPnl;
+                            if (includeDeltaMargin)
+                                tradePnls[i][ts.trade] += tradeDeltaPnl;
+                            if (includeGammaMargin)
+                                tradePnls[i][ts.trade] += 0.5 * shift_1[i] * shift_1[i] * ts.gamma;
+                        }
+                    }
+                } else if (includeGammaMargin) {
+                    const Real* shift_2 = shifts.row_begin(srsRows[j].second);
+                    for (const auto& ts : tradeSensis[j]) {
+                        for (Size i = s0; i < s1; ++i)
+                            tradePnls[i][ts.trade] += shift_1[i] * shift_2[i] * ts.gamma;
+                    }
                 }
             }
-        }
+        });
+    }
 
-        std::map<std::string, std::vector<QuantLib::Real>> riskFactorTradeMap;
-        if (runRiskFactorLevel){
-            for (Size j = 0; j < pnlCalculators.size(); j++) {
-                bool inPeriod =
-                    pnlCalculators.at(j)->isInTimePeriod(hisScenGen_->startDates()[i], hisScenGen_->endDates()[i]);
-                if (inPeriod) {
-                    for (const auto elem : srs | boost::adaptors::indexed(0)) {
-                        const auto& sr = elem.value();
-                        std::string riskFactorKey = QuantExt::reconstructFactor(sr.key_1, sr.desc_1);
-                        riskFactorTradeMap[riskFactorKey] = vector<Real>(tradeIds.size(), 0.0);
+    // Risk factor level P&Ls per trade, for each scenario a map risk factor -> trade P&Ls
+    using RiskFactorTradePnLStore = PNLCalculator::RiskFactorTradePnLStore;
+    RiskFactorTradePnLStore riskFactorTradePnls, riskFactorFoTradePnls;
+    if (runRiskFactorLevel) {
+        vector<string> riskFactors;
+        for (const auto sr : records)
+            riskFactors.push_back(QuantExt::reconstructFactor(sr->key_1, sr->desc_1));
+        riskFactorTradePnls.resize(nScenarios);
+        riskFactorFoTradePnls.resize(nScenarios);
+        ore::data::parallelFor(nScenarios, nThreads_, [&](Size i) {
+            if (!inPeriodOfAnyCalculator(i))
+                return;
+            auto& rfPnls = riskFactorTradePnls[i];
+            auto& rfFoPnls = riskFactorFoTradePnls[i];
+            for (const auto& rf : riskFactors) {
+                rfPnls[rf] = vector<Real>(nTrades, 0.0);
+                rfFoPnls[rf] = vector<Real>(nTrades, 0.0);
+            }
+            for (Size j = 0; j < records.size(); ++j) {
+                Real shift_1 = shifts[srsRows[j].first][i];
+                auto& pnls = rfPnls[riskFactors[j]];
+                if (!records[j]->isCrossGamma()) {
+                    auto& foPnls = rfFoPnls[riskFactors[j]];
+                    for (const auto& ts : tradeSensis[j]) {
+                        Real tradeDeltaPnl = shift_1 * ts.delta;
+                        foPnls[ts.trade] = tradeDeltaPnl;
+                        if (includeDeltaMargin)
+                            pnls[ts.trade] = tradeDeltaPnl;
+                        if (includeGammaMargin)
+                            pnls[ts.trade] += 0.5 * shift_1 * shift_1 * ts.gamma;
                     }
-                    riskFactorTradePnls.at(j).push_back(riskFactorTradeMap);
-                    riskFactorFoTradePnls.at(j).push_back(riskFactorTradeMap);
+                } else if (includeGammaMargin) {
+                    Real shift_2 = shifts[srsRows[j].second][i];
+                    for (const auto& ts : tradeSensis[j])
+                        pnls[ts.trade] += shift_1 * shift_2 * ts.gamma;
                 }
             }
-        }
-
-        for (const auto elem : srs | boost::adaptors::indexed(0)) {
-
-            const auto& sr = elem.value();
-            auto j = elem.index();
-
-            if (!sr.isCrossGamma()) {
+        });
+    }
 
-                Real shift = shiftCube->get(srsIndex[j].first, 0, i);
-                Real deltaPnl = shift * sr.delta;
-                Real gammaPnl = 0.5 * shift * shift * sr.gamma;
-                // Update the first order P&L
-                allFoPnls[i] += deltaPnl;
-                // If backtesting curvature margin, we exclude deltas i.e. 1st order effects from the sensi P&L
-                if (includeDeltaMargin)
-                    allPnls[i] += deltaPnl;
-                // If backtesting delta margin, we exclude gammas i.e. second order effects from the sensi P&L
-                if (includeGammaMargin)
-                    allPnls[i] += gammaPnl;
-
-                for (Size k = 0; k < pnlCalculators.size(); k++) {
-                    if (pnlCalculators.at(k)->isInTimePeriod(hisScenGen_->startDates()[i],
-                                                             hisScenGen_->endDates()[i])) {
-                        pnlCalculators.at(k)->writePNL(i, true, sr.key_1, shift, sr.delta, sr.gamma, deltaPnl,
-                                                       gammaPnl);
-                        if (!tradeSensiCache.empty()) {
-                            auto itSr = tradeSensiCache.find(j);
-                            if (itSr != tradeSensiCache.end()) {
-                                for (const auto& kv : itSr->second) {
-                                    const auto& tradeId = tradeIds[kv.first];
-                                    Real tradeDelta = kv.second.first;
-                                    Real tradeDeltaPnl = shift * tradeDelta;
-                                    Real tradeGamma = kv.second.second;
-                                    Real tradeGammaPnl = 0.5 * shift * shift * tradeGamma;
-                                    // Attempt to write trade level P&L contribution row.
-                                    pnlCalculators.at(k)->writePNL(i, true, sr.key_1, shift, tradeDelta, tradeGamma,
-                                                                   tradeDeltaPnl, tradeGammaPnl, RiskFactorKey(), 0.0,
-                                                                   tradeId);
-                                    // Update the sensitivity based trade level P&Ls
-                                    if (runTradeLevel) {
-                                        foTradePnls.at(k).back()[kv.first] += tradeDeltaPnl;
-                                        if (includeDeltaMargin)
-                                            tradePnls.at(k).back()[kv.first] += tradeDeltaPnl;
-                                        if (includeGammaMargin)
-                                            tradePnls.at(k).back()[kv.first] += tradeGammaPnl;
-                                    }
-                                    if (runRiskFactorLevel) {        
-                                        std::string riskFactorKey = QuantExt::reconstructFactor(sr.key_1, sr.desc_1);
-                                        riskFactorFoTradePnls.at(k).back()[riskFactorKey][kv.first] = tradeDeltaPnl;
-                                        if (includeDeltaMargin)
-                                            riskFactorTradePnls.at(k).back()[riskFactorKey][kv.first] = tradeDeltaPnl;
-                                        if (includeGammaMargin)
-                                            riskFactorTradePnls.at(k).back()[riskFactorKey][kv.first] += tradeGammaPnl;
-                                    }
-                                }
-                            }
-                        }
+    // P&L contribution rows, per scenario and sensitivity record, and per trade if trade level sensitivities are given
+    const vector<TradeSensitivity> noTradeSensis;
+    for (const auto& c : pnlCalculators) {
+        if (!c->writePnlRows())
+            continue;
+        for (Size i = 0; i < nScenarios; ++i) {
+            if (!c->isInTimePeriod(startDates[i], endDates[i]))
+                continue;
+            for (Size j = 0; j < records.size(); ++j) {
+                const auto& sr = *records[j];
+                Real shift_1 = shifts[srsRows[j].first][i];
+                const auto& trades = tradeSensis.empty() ? noTradeSensis : tradeSensis[j];
+                if (!sr.isCrossGamma()) {
+                    c->writePNL(i, true, sr.key_1, shift_1, sr.delta, sr.gamma, shift_1 * sr.delta,
+                                0.5 * shift_1 * shift_1 * sr.gamma);
+                    for (const auto& ts : trades) {
+                        c->writePNL(i, true, sr.key_1, shift_1, ts.delta, ts.gamma, shift_1 * ts.delta,
+                                    0.5 * shift_1 * shift_1 * ts.gamma, RiskFactorKey(), 0.0, tradeIds[ts.trade]);
                     }
-                }
-            } else {
-                Real shift_1 = shiftCube->get(srsIndex[j].first, 0, i);
-                Real shift_2 = shiftCube->get(srsIndex[j].second, 0, i);
-                Real gammaPnl = shift_1 * shift_2 * sr.gamma;
-
-                // If backtesting delta margin, we exclude gammas i.e. second order effects from the sensi P&L
-                if (includeGammaMargin)
-                    allPnls[i] += gammaPnl;
-                                
-                for (Size j = 0; j < pnlCalculators.size(); j++) {
-                    const auto& c = pnlCalculators[j];
-                    if (c->isInTimePeriod(hisScenGen_->startDates()[i], hisScenGen_->endDates()[i])) {
-                        c->writePNL(i, true, sr.key_1, shift_1, sr.delta, sr.gamma, 0.0, gammaPnl, sr.key_2, shift_2);
-                        if (!tradeSensiCache.empty()) {
-                            auto itSr = tradeSensiCache.find(j);
-                            if (itSr != tradeSensiCache.end()) {
-                                for (const auto& kv : itSr->second) {
-                                    const auto& tradeId = tradeIds[kv.first];
-                                    Real tradeGamma = kv.second.second;
-                                    Real tradeGammaPnl = shift_1 * shift_2 * tradeGamma;
-                                    // Attempt to write trade level P&L contribution row.
-                                    c->writePNL(i, true, sr.key_1, shift_1, 0.0, tradeGamma, 0.0, tradeGammaPnl,
-                                                  sr.key_2, shift_2, tradeId);
-                                    // Update the sensitivity based trade level P&Ls
-                                    if (runTradeLevel && includeGammaMargin) {
-                                        tradePnls.at(j).back()[kv.first] += tradeGammaPnl;
-                                    }
-                                    if (runRiskFactorLevel && includeGammaMargin) {        
-                                        std::string riskFactorKey = QuantExt::reconstructFactor(sr.key_1, sr.desc_1);
-                                        riskFactorTradePnls.at(j).back()[riskFactorKey][kv.first] += tradeGammaPnl;
-                                    }
-                            }
-                        }
+                } else {
+                    Real shift_2 = shifts[srsRows[j].second][i];
+                    c->writePNL(i, true, sr.key_1, shift_1, sr.delta, sr.gamma, 0.0, shift_1 * shift_2 * sr.gamma,
+                                sr.key_2, shift_2);
+                    for (const auto& ts : trades) {
+                        c->writePNL(i, true, sr.key_1, shift_1, 0.0, ts.gamma, 0.0, shift_1 * shift_2 * ts.gamma,
+                                    sr.key_2, shift_2, tradeIds[ts.trade]);
                     }
-
                 }
             }
         }
-        }
-        if (covarianceCalculator)
-            covarianceCalculator->updateAccumulators(shiftCube, hisScenGen_->startDates()[i], hisScenGen_->endDates()[i], i);
     }
-    if (covarianceCalculator)
-        covarianceCalculator->populateCovariance(keys);
+
+    if (covarianceCalculator) {
+        vector<Size> covarianceRows;
+        for (const auto& k : keys)
+            covarianceRows.push_back(k.second);
+        covarianceCalculator->calculate(shifts, covarianceRows, startDates, endDates, nThreads_);
+    }
 
     LOG("Populate the sensitivity backtesting P&L vectors");
-    for (Size j = 0; j < pnlCalculators.size(); j++) {
-        pnlCalculators.at(j)->populatePNLs(allPnls, allFoPnls, hisScenGen_->startDates(), hisScenGen_->endDates());
-        if (runTradeLevel)
-            pnlCalculators.at(j)->populateTradePNLs(tradePnls.at(j), foTradePnls.at(j));
-        if (runRiskFactorLevel){
-            pnlCalculators.at(j)->populateRiskFactorTradePNLs(riskFactorTradePnls.at(j), riskFactorFoTradePnls.at(j));
+    for (const auto& c : pnlCalculators) {
+        c->populatePNLs(allPnls, allFoPnls, startDates, endDates);
+        if (runTradeLevel || runRiskFactorLevel) {
+            TradePnLStore cTradePnls, cFoTradePnls;
+            RiskFactorTradePnLStore cRiskFactorTradePnls, cRiskFactorFoTradePnls;
+            for (Size i = 0; i < nScenarios; ++i) {
+                if (!c->isInTimePeriod(startDates[i], endDates[i]))
+                    continue;
+                if (runTradeLevel) {
+                    cTradePnls.push_back(tradePnls[i]);
+                    cFoTradePnls.push_back(foTradePnls[i]);
+                }
+                if (runRiskFactorLevel) {
+                    cRiskFactorTradePnls.push_back(riskFactorTradePnls[i]);
+                    cRiskFactorFoTradePnls.push_back(riskFactorFoTradePnls[i]);
+                }
+            }
+            if (runTradeLevel)
+                c->populateTradePNLs(cTradePnls, cFoTradePnls);
+            if (runRiskFactorLevel)
+                c->populateRiskFactorTradePNLs(cRiskFactorTradePnls, cRiskFactorFoTradePnls);
         }
     }
 }
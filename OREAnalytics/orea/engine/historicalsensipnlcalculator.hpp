@@ -32,17 +32,6 @@
 #include <ql/math/matrix.hpp>
 #include <ql/shared_ptr.hpp>
 
-#include <boost/accumulators/accumulators.hpp>
-// Including <boost/accumulators/statistics.hpp> causes the following swig wrapper compiler errors
-//   explicit specialization of 'boost::accumulators::feature_of<boost::accumulators::tag::weighted_skewness>'
-//   explicit specialization of 'boost::accumulators::feature_of<boost::accumulators::tag::weighted_kurtosis>'
-// see https://github.com/boostorg/accumulators/issues/20
-// The following subset of includes is sufficient here and circumvents the swig errors
-#include <boost/accumulators/statistics/stats.hpp>
-#include <boost/accumulators/statistics/variance.hpp>
-#include <boost/accumulators/statistics/covariance.hpp>
-#include <boost/accumulators/statistics/variates/covariate.hpp>
-
 namespace ore {
 namespace analytics {
 
@@ -55,6 +44,8 @@ public:
                           QuantLib::Real gamma, QuantLib::Real deltaPnl, Real gammaPnl,
                           const RiskFactorKey& key_2 = RiskFactorKey(),
                           QuantLib::Real shift_2 = 0.0, const std::string& tradeId = "") {}
+    //! True if writePNL() should be called for each scenario and sensitivity record
+    virtual bool writePnlRows() const { return false; }
     const bool isInTimePeriod(QuantLib::Date startDate, QuantLib::Date endDate);
 
     void populatePNLs(const std::vector<QuantLib::Real>& allPnls, const std::vector<QuantLib::Real>& foPnls,
@@ -93,29 +84,33 @@ protected:
 class CovarianceCalculator {
 public:
     CovarianceCalculator(ore::data::TimePeriod covariancePeriod) : covariancePeriod_(covariancePeriod) {}
-    void initialise(const std::set<std::pair<RiskFactorKey, QuantLib::Size>>& keys);
-    void updateAccumulators(const QuantLib::ext::shared_ptr<NPVCube>& shiftCube, QuantLib::Date startDate, QuantLib::Date endDate, QuantLib::Size index);
-    void populateCovariance(const std::set<std::pair<RiskFactorKey, QuantLib::Size>>& keys);
+    /*! Calculates the covariance and correlation matrices of the historical shifts over the scenarios in the
+        covariance period. The shifts are given as a (risk factor, scenario) matrix, \p rows are the rows of the risk
+        factors in the order of the resulting matrices. The rows of the covariance matrix are split between up to
+        \p nThreads threads. */
+    void calculate(const QuantLib::Matrix& shifts, const std::vector<QuantLib::Size>& rows,
+                   const std::vector<QuantLib::Date>& startDates, const std::vector<QuantLib::Date>& endDates,
+                   QuantLib::Size nThreads = 1);
     const Matrix& covariance() const { return covariance_; }
     const Matrix& correlation() const { return correlation_; }
 
 private:
-    typedef boost::accumulators::accumulator_set<
-        QuantLib::Real,
-        boost::accumulators::stats<
-            boost::accumulators::tag::covariance<QuantLib::Real, boost::accumulators::tag::covariate1>,
-            boost::accumulators::tag::variance>>accumulator;
-    std::map<std::pair<QuantLib::Size, QuantLib::Size>, accumulator> accCov_;
     ore::data::TimePeriod covariancePeriod_;
     QuantLib::Matrix covariance_;
     QuantLib::Matrix correlation_;
 };
 
+//! Sensitivity based historical P&L
+/*! The historical shifts of the relevant risk factors are read from the shift cube into a dense (risk factor,
+    scenario) matrix once, the portfolio, trade and risk factor level P&Ls and the covariance matrix are then
+    computed from this matrix with kernels that split the scenarios (resp. risk factors) between up to nThreads
+    threads. */
 class HistoricalSensiPnlCalculator {
 public:
     HistoricalSensiPnlCalculator(const QuantLib::ext::shared_ptr<HistoricalScenarioGenerator>& hisScenGen,
-                                 const QuantLib::ext::shared_ptr<SensitivityStream>& ss)
-        : hisScenGen_(hisScenGen), sensitivityStream_(ss) {}
+                                 const QuantLib::ext::shared_ptr<SensitivityStream>& ss,
+                                 const QuantLib::Size nThreads = 1)
+        : hisScenGen_(hisScenGen), sensitivityStream_(ss), nThreads_(nThreads) {}
     
     void populateSensiShifts(QuantLib::ext::shared_ptr<NPVCube>& cube, const vector<RiskFactorKey>& keys,
                              QuantLib::ext::shared_ptr<ScenarioShiftCalculator> shiftCalculator,
@@ -137,6 +132,7 @@ private:
     QuantLib::ext::shared_ptr<HistoricalScenarioGenerator> hisScenGen_;
     //! Stream of sensitivity records used for the sensitivity based backtest
     QuantLib::ext::shared_ptr<SensitivityStream> sensitivityStream_;
+    QuantLib::Size nThreads_;
 };
 
 } // namespace analytics
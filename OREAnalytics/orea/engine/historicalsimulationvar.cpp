@@ -20,6 +20,7 @@
 #include <orea/engine/historicalpnlgenerator.hpp>
 #include <orea/cube/cube_io.hpp>
 #include <orea/cube/inmemorycube.hpp>
+#include <ored/utilities/parallel.hpp>
 #include <ored/utilities/to_string.hpp>
 
 #include <boost/accumulators/accumulators.hpp>
@@ -78,20 +79,19 @@ void HistoricalSimulationVarReport::createAdditionalReports(
 void HistoricalSimulationVarReport::handleFullRevalResults(const ext::shared_ptr<MarketRiskReport::Reports>& reports,
                                                            const ext::shared_ptr<MarketRiskGroupBase>& riskGroup,
                                                            const ext::shared_ptr<TradeGroupBase>& tradeGroup) {
-    if (!tradePnl_ && !riskFactorBreakdown_) {
-        pnls_ = histPnlGen_->pnl(period_.value(), tradeIdIdxPairs_);
-    }else if(riskFactorBreakdown_){
-        //Full PnL report
-        if(!tradePnl_){
-            pnls_ = histPnlGen_->pnl(period_.value(), tradeIdIdxPairs_);
-        }else{
-            tradePnls_ = histPnlGen_->tradeLevelPnl(period_.value(), tradeIdIdxPairs_);
-        }      
-        // The PnL breakdown per scenario on risk factors
-        riskFactorPnls_ = histPnlGen_->riskFactorLevelPnlSeries(period_.value());
+    groupVars_ = nullptr;
+    if (!tradePnl_) {
+        // portfolio P&L and quantiles from the aggregation of the trade groups
+        Size row = fullRevalPnlRows_.at(tradeGroupKey(tradeGroup));
+        pnls_ = histPnlGen_->pnl(period_.value(), fullRevalPnls_, row);
+        groupVars_ = &vars_.at(row);
     } else {
         tradePnls_ = histPnlGen_->tradeLevelPnl(period_.value(), tradeIdIdxPairs_);
     }
+    if (riskFactorBreakdown_) {
+        // The PnL breakdown per scenario on risk factors
+        riskFactorPnls_ = histPnlGen_->riskFactorLevelPnlSeries(period_.value());
+    }
 }
 
 void HistoricalSimulationVarReport::writeAdditionalReports(
@@ -160,19 +160,39 @@ void HistoricalSimulationVarReport::writeHeader(const ext::shared_ptr<Report>& r
 }
 
 std::vector<Real> HistoricalSimulationVarReport::calcVarsForQuantiles() const {
+    if (groupVars_)
+        return *groupVars_;
+
     auto histSimVarCalculator = QuantLib::ext::dynamic_pointer_cast<HistoricalSimulationVarCalculator>(varCalculator_);
     QL_REQUIRE(histSimVarCalculator, "Wrong VarCalculator provided");
+    return calcVarsForQuantiles(*histSimVarCalculator);
+}
 
+std::vector<Real>
+HistoricalSimulationVarReport::calcVarsForQuantiles(const HistoricalSimulationVarCalculator& calculator) const {
     std::vector<Real> varRecords;
     for (const auto p : p())
-        varRecords.push_back(histSimVarCalculator->var(p));
+        varRecords.push_back(calculator.var(p));
     if (includeExpectedShortfall_) {
         for (const auto p : p())
-            varRecords.push_back(histSimVarCalculator->expectedShortfall(p));
+            varRecords.push_back(calculator.expectedShortfall(p));
     }
     return varRecords;
 }
 
+void HistoricalSimulationVarReport::aggregateFullRevalPnls(const ext::shared_ptr<MarketRiskGroupBase>& riskGroup) {
+    MarketRiskReport::aggregateFullRevalPnls(riskGroup);
+    groupVars_ = nullptr;
+    vars_.assign(fullRevalPnls_.rows(), std::vector<Real>());
+    if (tradePnl_)
+        return;
+    // the quantiles of the trade groups are independent of each other
+    ore::data::parallelFor(fullRevalPnls_.rows(), aggregationThreads_, [this](Size row) {
+        std::vector<Real> pnls = histPnlGen_->pnl(period_.value(), fullRevalPnls_, row);
+        vars_[row] = calcVarsForQuantiles(HistoricalSimulationVarCalculator(pnls));
+    });
+}
+
 Real HistoricalSimulationVarCalculator::var(Real confidence, const bool isCall, 
     const set<pair<string, Size>>& tradeIds) const {
 
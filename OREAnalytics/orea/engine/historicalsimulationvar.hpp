@@ -89,6 +89,9 @@ protected:
     void createVarCalculator() override;
     void writeHeader(const QuantLib::ext::shared_ptr<Report>& report) const override;
     std::vector<Real> calcVarsForQuantiles() const override;
+    std::vector<Real> calcVarsForQuantiles(const HistoricalSimulationVarCalculator& calculator) const;
+    //! Aggregates the P&Ls of all trade groups and computes their quantiles on aggregationThreads_ threads
+    void aggregateFullRevalPnls(const QuantLib::ext::shared_ptr<MarketRiskGroupBase>& riskGroup) override;
     void handleFullRevalResults(const QuantLib::ext::shared_ptr<MarketRiskReport::Reports>& reports,
                                 const QuantLib::ext::shared_ptr<MarketRiskGroupBase>& riskGroup,
                                 const QuantLib::ext::shared_ptr<TradeGroupBase>& tradeGroup) override;
@@ -101,6 +104,9 @@ private:
     std::vector<QuantLib::Real> pnls_;
     ore::analytics::TradePnLStore tradePnls_;
     ore::analytics::HistoricalPnlGenerator::RiskFactorPnLSeries riskFactorPnls_;
+    //! quantiles per row of fullRevalPnls_ and the ones of the current trade group, if available
+    std::vector<std::vector<QuantLib::Real>> vars_;
+    const std::vector<QuantLib::Real>* groupVars_ = nullptr;
     bool includeExpectedShortfall_ = false;
     bool tradePnl_ = false;
     bool riskFactorBreakdown_ = false;
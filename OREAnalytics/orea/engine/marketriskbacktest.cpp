@@ -124,8 +124,8 @@ void MarketRiskBacktest::handleFullRevalResults(const ext::shared_ptr<MarketRisk
                                                 const ext::shared_ptr<ore::analytics::TradeGroupBase>& tradeGroup) {
 
     QL_REQUIRE(histPnlGen_, "Must have a Historical PNL Generator");
-    pnls_ = histPnlGen_->pnl(btArgs_->backtestPeriod_, tradeIdIdxPairs_);
-    bmPnls_ = histPnlGen_->pnl(btArgs_->benchmarkPeriod_, tradeIdIdxPairs_);
+    pnls_ = fullRevalPnl(btArgs_->backtestPeriod_, tradeGroup);
+    bmPnls_ = fullRevalPnl(btArgs_->benchmarkPeriod_, tradeGroup);
 
     if (runTradeDetail(reports))
         tradePnls_ = histPnlGen_->tradeLevelPnl(btArgs_->backtestPeriod_, tradeIdIdxPairs_);
@@ -251,6 +251,7 @@ public:
                   QuantLib::Real shift_1, QuantLib::Real delta, QuantLib::Real gamma, QuantLib::Real deltaPnl, 
                   QuantLib::Real gammaPnl, const RiskFactorKey& key_2 = RiskFactorKey(),
                   QuantLib::Real shift_2 = 0.0, const std::string& tradeId = "") override;
+    bool writePnlRows() const override { return writePnl_; }
 
     const TradePnLStore& tradePnls() { return tradePnls_; }
     const TradePnLStore& foTradePnls() { return foTradePnls_; }
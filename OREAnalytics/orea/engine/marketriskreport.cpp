@@ -139,7 +139,8 @@ void MarketRiskReport::initialise() {
 
     if (sensiArgs_ && hisScenGen_)
         sensiPnlCalculator_ =
-            ext::make_shared<HistoricalSensiPnlCalculator>(hisScenGen_, sensiArgs_->sensitivityStream_);
+            ext::make_shared<HistoricalSensiPnlCalculator>(hisScenGen_, sensiArgs_->sensitivityStream_,
+                                                           aggregationThreads_);
 
     if (fullRevalArgs_) {
         LOG("Build the portfolio for full reval bt.");
@@ -296,6 +297,7 @@ void MarketRiskReport::calculate(const ext::shared_ptr<MarketRiskReport::Reports
                 histPnlGen_->generateCube(filter, runRiskFactorBreakdown);
                 // Assume (All, All, All) case ois run first and only needs to be run once
                 runRiskFactorBreakdown = false;
+                aggregateFullRevalPnls(riskGroup);
                 if (fullRevalArgs_->writeCube_) {
                     CubeWriter writer(cubeFilePath(riskGroup));
                     writer.write(histPnlGen_->cube(), {});
@@ -463,6 +465,25 @@ void MarketRiskReport::reset(const ext::shared_ptr<MarketRiskGroupBase>& riskGro
         p->clear();
 }
 
+void MarketRiskReport::aggregateFullRevalPnls(const ext::shared_ptr<MarketRiskGroupBase>& riskGroup) {
+    DLOG("Aggregate full revaluation P&Ls of " << tradeIdGroups_.size() << " trade groups for RiskGroup " << riskGroup);
+    vector<set<pair<string, Size>>> groups;
+    fullRevalPnlRows_.clear();
+    for (const auto& [key, tradeIds] : tradeIdGroups_) {
+        fullRevalPnlRows_[key] = groups.size();
+        groups.push_back(tradeIds);
+    }
+    fullRevalPnls_ = histPnlGen_->groupPnl(groups, aggregationThreads_);
+}
+
+vector<Real> MarketRiskReport::fullRevalPnl(const TimePeriod& period,
+                                            const ext::shared_ptr<TradeGroupBase>& tradeGroup) const {
+    auto r = fullRevalPnlRows_.find(tradeGroupKey(tradeGroup));
+    QL_REQUIRE(r != fullRevalPnlRows_.end(),
+               "MarketRiskReport: no aggregated full revaluation P&Ls for trade group " << tradeGroup);
+    return histPnlGen_->pnl(period, fullRevalPnls_, r->second);
+}
+
 void MarketRiskReport::closeReports(const ext::shared_ptr<MarketRiskReport::Reports>& reports) {
     for (const auto& r : reports->reports())
         r->end();    
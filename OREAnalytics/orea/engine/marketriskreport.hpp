@@ -257,6 +257,9 @@ public:
     */
     void enableCubeWrite(const std::string& cubeDir, const std::string& cubeFilename);
 
+    //! Number of threads used to aggregate the full revaluation P&Ls and the quantiles of the trade groups
+    void setAggregationThreads(QuantLib::Size n) { aggregationThreads_ = n; }
+
 protected:
     //! Method for shared initialisation
     virtual void initialiseRiskGroups();
@@ -308,6 +311,19 @@ protected:
     QuantLib::ext::shared_ptr<ore::analytics::HistoricalPnlGenerator> histPnlGen_;
     QuantLib::ext::shared_ptr<HistoricalSensiPnlCalculator> sensiPnlCalculator_;
 
+    QuantLib::Size aggregationThreads_ = 1;
+    /*! (trade group, scenario) P&L matrix for the last cube generated by the historical P&L generator, the row of a
+        trade group is given by fullRevalPnlRows_ */
+    QuantLib::Matrix fullRevalPnls_;
+    std::map<std::string, QuantLib::Size> fullRevalPnlRows_;
+
+    /*! Aggregate the P&Ls of all trade groups in tradeIdGroups_ from the last generated cube in a single pass, called
+        once for each generated cube */
+    virtual void aggregateFullRevalPnls(const QuantLib::ext::shared_ptr<MarketRiskGroupBase>& riskGroup);
+    //! P&Ls of \p tradeGroup for scenarios in \p period from the aggregated full revaluation P&Ls
+    std::vector<QuantLib::Real> fullRevalPnl(const ore::data::TimePeriod& period,
+                                             const QuantLib::ext::shared_ptr<TradeGroupBase>& tradeGroup) const;
+
     virtual void registerProgressIndicators();
     virtual void createReports(const QuantLib::ext::shared_ptr<MarketRiskReport::Reports>& reports) = 0;
     virtual bool runTradeDetail(const QuantLib::ext::shared_ptr<MarketRiskReport::Reports>& reports) { return requireTradePnl_; };
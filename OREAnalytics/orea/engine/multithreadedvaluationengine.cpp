@@ -30,8 +30,12 @@
 
 #include <boost/timer/timer.hpp>
 
+#include <atomic>
 #include <future>
+#include <mutex>
+#include <numeric>
 #include <random>
+#include <tuple>
 
 #ifdef ORE_MULTITHREADING_CPU_AFFINITY
 #include <pthread.h>
@@ -74,6 +78,38 @@ std::vector<std::size_t> getCpuIds(std::size_t nThreads) {
 }
 #endif
 
+// consolidates the progress of the batches processed by the worker threads
+struct BatchProgress {
+    BatchProgress(const std::set<QuantLib::ext::shared_ptr<ore::data::ProgressIndicator>>& indicators,
+                  const std::size_t nBatches)
+        : indicators(indicators), progress(nBatches, 0), total(nBatches, 0) {}
+    std::mutex mutex;
+    std::set<QuantLib::ext::shared_ptr<ore::data::ProgressIndicator>> indicators;
+    std::vector<unsigned long> progress;
+    std::vector<unsigned long> total;
+};
+
+// reports the progress of a single batch to the consolidated batch progress
+class BatchProgressIndicator : public ore::data::ProgressIndicator {
+public:
+    BatchProgressIndicator(const QuantLib::ext::shared_ptr<BatchProgress>& batchProgress, const std::size_t batch)
+        : batchProgress_(batchProgress), batch_(batch) {}
+    void updateProgress(const unsigned long progress, const unsigned long total, const std::string& detail) override {
+        std::lock_guard<std::mutex> lock(batchProgress_->mutex);
+        batchProgress_->progress[batch_] = progress;
+        batchProgress_->total[batch_] = total;
+        unsigned long p = std::accumulate(batchProgress_->progress.begin(), batchProgress_->progress.end(), 0UL);
+        unsigned long t = std::accumulate(batchProgress_->total.begin(), batchProgress_->total.end(), 0UL);
+        for (auto const& i : batchProgress_->indicators)
+            i->updateProgress(p, t, detail);
+    }
+    void reset() override {}
+
+private:
+    QuantLib::ext::shared_ptr<BatchProgress> batchProgress_;
+    std::size_t batch_;
+};
+
 } // namespace
 
 using QuantLib::Size;
@@ -144,13 +180,18 @@ void MultiThreadedValuationEngine::setAggregationScenarioData(
     aggregationScenarioData_ = aggregationScenarioData;
 }
 
+void MultiThreadedValuationEngine::setBatchesPerThread(const Size nBatchesPerThread) {
+    QL_REQUIRE(nBatchesPerThread > 0, "MultiThreadedValuationEngine: nBatchesPerThread must be > 0");
+    nBatchesPerThread_ = nBatchesPerThread;
+}
+
 void MultiThreadedValuationEngine::buildCube(
     const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio,
     const std::function<std::vector<QuantLib::ext::shared_ptr<ore::analytics::ValuationCalculator>>()>& calculators,
     const ValuationEngine::ErrorPolicy errorPolicy,
     const std::function<std::vector<QuantLib::ext::shared_ptr<ore::analytics::CounterpartyCalculator>>()>&
         cptyCalculators,
-    bool mporStickyDate, bool dryRun) {
+    bool mporStickyDate, bool dryRun, const ValuationEngine::TradeAffectedBySample& tradeAffected) {
 
     boost::timer::cpu_timer timer;
 
@@ -186,20 +227,24 @@ void MultiThreadedValuationEngine::buildCube(
                             << t->npvCurrency());
     }
 
-    // split portfolio into nThreads parts such that each part has an approximately similar total avg pricing time
+    // split portfolio into batches such that each batch has an approximately similar total avg pricing time, the
+    // batches are handed out to the worker threads dynamically, so that a thread that finishes early picks up the
+    // next batch from the queue
 
     Size eff_nThreads = std::min(portfolio->size(), nThreads_);
+    Size nBatches = std::min(portfolio->size(), eff_nThreads * nBatchesPerThread_);
 
     LOG("Splitting portfolio.");
 
     LOG("portfolio size = " << portfolio->size());
     LOG("nThreads       = " << nThreads_);
     LOG("eff nThreads   = " << eff_nThreads);
+    LOG("nBatches       = " << nBatches);
 
     QL_REQUIRE(eff_nThreads > 0, "effective threads are zero, this is not allowed.");
 
     std::vector<QuantLib::ext::shared_ptr<ore::data::Portfolio>> portfolios;
-    for (Size i = 0; i < eff_nThreads; ++i)
+    for (Size i = 0; i < nBatches; ++i)
         portfolios.push_back(QuantLib::ext::make_shared<ore::data::Portfolio>());
 
     double totalAvgPricingTime = 0.0;
@@ -223,13 +268,19 @@ void MultiThreadedValuationEngine::buildCube(
                       return p1.second > p2.second;
               });
 
+    // assign the trades in order of decreasing pricing time to the batch with the smallest total pricing time so far,
+    // ties are broken by the number of trades in the batch and then the batch index
+
     std::vector<double> portfolioTotalAvgPricingTime(portfolios.size());
-    Size portfolioIndex = 0;
+    std::set<std::tuple<double, Size, Size>> batchQueue;
+    for (Size i = 0; i < nBatches; ++i)
+        batchQueue.insert(std::make_tuple(0.0, 0, i));
     for (auto const& t : timings) {
+        auto [time, size, portfolioIndex] = *batchQueue.begin();
+        batchQueue.erase(batchQueue.begin());
         portfolios[portfolioIndex]->add(portfolio->get(t.first));
         portfolioTotalAvgPricingTime[portfolioIndex] += t.second;
-        if (++portfolioIndex >= eff_nThreads)
-            portfolioIndex = 0;
+        batchQueue.insert(std::make_tuple(time + t.second, size + 1, portfolioIndex));
     }
 
     // output the portfolios into strings so that the worker threads can load them from there
@@ -242,7 +293,7 @@ void MultiThreadedValuationEngine::buildCube(
     // log info on the portfolio split
 
     LOG("Total avg pricing time     : " << totalAvgPricingTime / 1E6 << " ms");
-    for (Size i = 0; i < eff_nThreads; ++i) {
+    for (Size i = 0; i < nBatches; ++i) {
         LOG("Portfolio #" << i << " number of trades       : " << portfolios[i]->size());
         LOG("Portfolio #" << i << " total avg pricing time : " << portfolioTotalAvgPricingTime[i] / 1E6 << " ms");
     }
@@ -267,13 +318,14 @@ void MultiThreadedValuationEngine::buildCube(
     for (Size i = 0; i < eff_nThreads; ++i)
         loaders.push_back(QuantLib::ext::make_shared<ore::data::ClonedLoader>(today_, loader_));
 
-    // build nThreads mini-cubes to which each thread writes its results
+    // build one mini-cube per batch to which the thread processing the batch writes its results
 
-    LOG("Build " << eff_nThreads << " mini result cubes...");
+    LOG("Build " << nBatches << " mini result cubes...");
     miniCubes_.clear();
     miniNettingSetCubes_.clear();
     miniCptyCubes_.clear();
-    for (Size i = 0; i < eff_nThreads; ++i) {
+    miniErrors_ = std::vector<ValuationEngine::Errors>(nBatches);
+    for (Size i = 0; i < nBatches; ++i) {
         miniCubes_.push_back(cubeFactory_(today_, portfolios[i]->ids(), dateGrid_->valuationDates(), nSamples_));
         miniNettingSetCubes_.push_back(nettingSetCubeFactory_(today_, dateGrid_->valuationDates(), nSamples_));
         miniCptyCubes_.push_back(
@@ -282,8 +334,7 @@ void MultiThreadedValuationEngine::buildCube(
 
     // build progress indicator consolidating the results from the threads
 
-    auto progressIndicator =
-        QuantLib::ext::make_shared<ore::analytics::MultiThreadedProgressIndicator>(this->progressIndicators());
+    auto batchProgress = QuantLib::ext::make_shared<BatchProgress>(this->progressIndicators(), nBatches);
 
     // create the thread pool with eff_nThreads and queue size = eff_nThreads as well
 
@@ -299,7 +350,12 @@ void MultiThreadedValuationEngine::buildCube(
 
     // pricing stats accumulated in worker threads
     std::vector<std::map<std::string, std::pair<std::size_t, boost::timer::nanosecond_type>>> workerPricingStats(
-        eff_nThreads);
+        nBatches);
+
+    // the next batch to be processed and a flag indicating that a worker thread has failed
+
+    std::atomic<Size> nextBatch(0);
+    std::atomic<bool> failed(false);
 
     // get obs mode of main thread, so that we can set this mode in the worker threads below
     ore::analytics::ObservationMode::Mode obsMode = ore::analytics::ObservationMode::instance().mode();
@@ -320,8 +376,8 @@ void MultiThreadedValuationEngine::buildCube(
                     &cpuIds,
 #endif
                     obsMode, includeTodaysCashFlows, localIncRefDateEvents, dryRun, &calculators, errorPolicy,
-                    &cptyCalculators, mporStickyDate, &portfoliosAsString,
-                    &scenarioGenerators, &loaders, &workerPricingStats, &progressIndicator](int id) -> resultType {
+                    &cptyCalculators, mporStickyDate, &portfoliosAsString, &scenarioGenerators, &loaders,
+                    &workerPricingStats, &batchProgress, &nextBatch, &failed, nBatches](int id) -> resultType {
 
 #ifdef ORE_MULTITHREADING_CPU_AFFINITY
             pthread_t self = pthread_self();
@@ -365,11 +421,6 @@ void MultiThreadedValuationEngine::buildCube(
                         useSpreadedTermStructures_, cacheSimData_, false, iborFallbackConfig_,
                         handlePseudoCurrenciesSimMarket_, offsetScenario_);
 
-                // set aggregation scenario data, but only in one of the sim markets, that's sufficient to populate it
-
-                if (id == 0 && aggregationScenarioData_ != nullptr)
-                    simMarket->aggregationScenarioData() = aggregationScenarioData_;
-
                 // link scenario generator to sim market
 
                 simMarket->scenarioGenerator() = scenarioGenerators[id];
@@ -379,35 +430,54 @@ void MultiThreadedValuationEngine::buildCube(
                 if (scenarioFilter_)
                     simMarket->filter() = scenarioFilter_;
 
-                // build portfolio against sim market
+                // process batches until the queue is exhausted
+
+                Size batch;
+                while (!failed && (batch = nextBatch++) < nBatches) {
+
+                    DLOG("Thread " << id << " processes batch " << batch);
+
+                    // set aggregation scenario data, but only for one of the batches, that's sufficient to populate it
+
+                    simMarket->aggregationScenarioData() =
+                        batch == 0 ? aggregationScenarioData_ : QuantLib::ext::shared_ptr<AggregationScenarioData>();
+
+                    // start from the first scenario
+
+                    scenarioGenerators[id]->reset();
+
+                    // build portfolio against sim market
 
-                auto portfolio = QuantLib::ext::make_shared<ore::data::Portfolio>();
-                portfolio->fromXMLString(portfoliosAsString[id]);
-                auto engineFactory = QuantLib::ext::make_shared<ore::data::EngineFactory>(
-                    engineData_, simMarket, std::map<ore::data::MarketContext, string>(), referenceData_,
-                    iborFallbackConfig_);
+                    auto portfolio = QuantLib::ext::make_shared<ore::data::Portfolio>();
+                    portfolio->fromXMLString(portfoliosAsString[batch]);
+                    auto engineFactory = QuantLib::ext::make_shared<ore::data::EngineFactory>(
+                        engineData_, simMarket, std::map<ore::data::MarketContext, string>(), referenceData_,
+                        iborFallbackConfig_);
 
-                portfolio->build(engineFactory, context_, true, useAtParCouponsTrades_);
+                    portfolio->build(engineFactory, context_, true, useAtParCouponsTrades_);
 
-                // build valuation engine
+                    // build valuation engine
 
-                auto valEngine = QuantLib::ext::make_shared<ore::analytics::ValuationEngine>(
-                    today_, dateGrid_, simMarket, engineFactory->modelBuilders(), recalibrateModels_);
-                valEngine->registerProgressIndicator(progressIndicator);
+                    auto valEngine = QuantLib::ext::make_shared<ore::analytics::ValuationEngine>(
+                        today_, dateGrid_, simMarket, engineFactory->modelBuilders(), recalibrateModels_);
+                    valEngine->registerProgressIndicator(
+                        QuantLib::ext::make_shared<BatchProgressIndicator>(batchProgress, batch));
 
-                // build mini-cube
+                    // build mini-cube
 
-                valEngine->buildCube(portfolio, miniCubes_[id], calculators(), errorPolicy, mporStickyDate,
-                                     miniNettingSetCubes_[id], miniCptyCubes_[id],
-                                     cptyCalculators ? cptyCalculators()
-                                                     : std::vector<QuantLib::ext::shared_ptr<CounterpartyCalculator>>(),
-                                     dryRun);
+                    valEngine->buildCube(
+                        portfolio, miniCubes_[batch], calculators(), errorPolicy, mporStickyDate,
+                        miniNettingSetCubes_[batch], miniCptyCubes_[batch],
+                        cptyCalculators ? cptyCalculators()
+                                        : std::vector<QuantLib::ext::shared_ptr<CounterpartyCalculator>>(),
+                        dryRun, &miniErrors_[batch], tradeAffected);
 
-                // set pricing stats for val engine run
+                    // set pricing stats for val engine run
 
-                for (auto const& [tid, t] : portfolio->trades())
-                    workerPricingStats[id][tid] =
-                        std::make_pair(t->getNumberOfPricings(), t->getCumulativePricingTime());
+                    for (auto const& [tid, t] : portfolio->trades())
+                        workerPricingStats[batch][tid] =
+                            std::make_pair(t->getNumberOfPricings(), t->getCumulativePricingTime());
+                }
 
                 // return code 0 = ok
 
@@ -420,6 +490,7 @@ void MultiThreadedValuationEngine::buildCube(
                 // log error and return code 1 = not ok
 
                 ore::analytics::StructuredAnalyticsErrorMessage("Multithreaded Valuation Engine", "", e.what()).log();
+                failed = true;
                 rc = 1;
             }
 
@@ -74,20 +74,30 @@ public:
     // can be optionally called to set the agg scen data (which is done in the ssm for single-threaded runs)
     void setAggregationScenarioData(const QuantLib::ext::shared_ptr<AggregationScenarioData>& aggregationScenarioData);
 
+    /* can be optionally called to split the portfolio into nThreads x nBatchesPerThread batches (or less if the
+       portfolio is smaller) which are processed by the worker threads in the order they become free, the default is
+       one batch per thread. More batches balance the load better when pricing times are skewed or the historical
+       pricing stats are stale, at the cost of repeating the sim market updates for each batch. */
+    void setBatchesPerThread(const QuantLib::Size nBatchesPerThread);
+
     /* analoguous to buildCube() in the single-threaded engine, results are retrieved using below constructors
-       if no cptyCalculators is given a function returning an empty vector of calculators will be returned */
+       if no cptyCalculators is given a function returning an empty vector of calculators will be returned,
+       tradeAffected is called from the worker threads concurrently */
     void buildCube(
         const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio,
         const std::function<std::vector<QuantLib::ext::shared_ptr<ore::analytics::ValuationCalculator>>()>& calculators,
         const ValuationEngine::ErrorPolicy errorPolicy = ValuationEngine::ErrorPolicy::RemoveAll,
         const std::function<std::vector<QuantLib::ext::shared_ptr<ore::analytics::CounterpartyCalculator>>()>&
             cptyCalculators = {},
-        bool mporStickyDate = true, bool dryRun = false);
+        bool mporStickyDate = true, bool dryRun = false,
+        const ValuationEngine::TradeAffectedBySample& tradeAffected = {});
 
-    // result output cubes (mini-cubes, one per thread)
+    // result output cubes (mini-cubes, one per batch)
     std::vector<QuantLib::ext::shared_ptr<ore::analytics::NPVCube>> outputCubes() const { return miniCubes_; }
 
-    // TODO: add error reporting as in single-threaded engine
+    /* result errors (one per batch), the trade indices refer to the ids of the corresponding mini-cube, only
+       populated for trades and samples that failed under the chosen error policy */
+    const std::vector<ValuationEngine::Errors>& outputErrors() const { return miniErrors_; }
 
     // result netting cubes (might be null, if nettingSetCubeFactory is returning null)
     std::vector<QuantLib::ext::shared_ptr<ore::analytics::NPVCube>> outputNettingSetCubes() const {
@@ -130,12 +140,14 @@ private:
     QuantLib::ext::shared_ptr<ore::analytics::Scenario> offsetScenario_;
     bool useAtParCouponsCurves_ = true;
     bool useAtParCouponsTrades_ = true;
+    QuantLib::Size nBatchesPerThread_ = 1;
 
     QuantLib::ext::shared_ptr<AggregationScenarioData>
             aggregationScenarioData_;
     std::vector<QuantLib::ext::shared_ptr<ore::analytics::NPVCube>> miniCubes_;
     std::vector<QuantLib::ext::shared_ptr<ore::analytics::NPVCube>> miniNettingSetCubes_;
     std::vector<QuantLib::ext::shared_ptr<ore::analytics::NPVCube>> miniCptyCubes_;
+    std::vector<ValuationEngine::Errors> miniErrors_;
 };
 
 } // namespace analytics
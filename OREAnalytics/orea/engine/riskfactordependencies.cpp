@@ -0,0 +1,163 @@
+/*
+ Copyright (C) 2025 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/engine/dependencymarket.hpp>
+#include <orea/engine/riskfactordependencies.hpp>
+
+#include <ored/portfolio/enginefactory.hpp>
+#include <ored/utilities/log.hpp>
+
+#include <algorithm>
+
+namespace ore {
+namespace analytics {
+
+using RFType = RiskFactorKey::KeyType;
+
+namespace {
+
+// risk factor types that are matched by name
+bool isNameMatched(const RFType t) {
+    return t == RFType::DiscountCurve || t == RFType::YieldCurve || t == RFType::IndexCurve ||
+           t == RFType::SurvivalProbability || t == RFType::RecoveryRate || t == RFType::EquitySpot ||
+           t == RFType::DividendYield || t == RFType::CommodityCurve || t == RFType::ZeroInflationCurve ||
+           t == RFType::YoYInflationCurve || t == RFType::SecuritySpread || t == RFType::CPR;
+}
+
+bool isRates(const RFType t) {
+    return t == RFType::DiscountCurve || t == RFType::YieldCurve || t == RFType::IndexCurve;
+}
+
+// risk factor types for which the simulation market uses interest rate curves that are not recorded
+bool requiresAllRates(const RFType t) {
+    return t == RFType::EquitySpot || t == RFType::DividendYield || t == RFType::CommodityCurve ||
+           t == RFType::ZeroInflationCurve || t == RFType::YoYInflationCurve;
+}
+
+} // namespace
+
+RiskFactorDependencies::RiskFactorDependencies(
+    const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio,
+    const QuantLib::ext::shared_ptr<ore::data::EngineData>& engineData, const std::string& baseCcy,
+    const QuantLib::ext::shared_ptr<ore::data::CurveConfigurations>& curveConfigs,
+    const QuantLib::ext::shared_ptr<ore::data::ReferenceDataManager>& referenceData,
+    const QuantLib::ext::shared_ptr<ore::data::IborFallbackConfig>& iborFallbackConfig)
+    : baseCcy_(baseCcy) {
+
+    LOG("RiskFactorDependencies: analyse " << portfolio->size() << " trades");
+
+    // as in the PortfolioAnalyser, avoid calibrations on the dependency market
+    auto ed = QuantLib::ext::make_shared<ore::data::EngineData>(*engineData);
+    ed->globalParameters()["Calibrate"] = "false";
+    ed->globalParameters()["RunType"] = "PortfolioAnalyser";
+
+    // the trades are built on copies, so that the trades of the given portfolio are left untouched
+
+    auto copy = QuantLib::ext::make_shared<ore::data::Portfolio>();
+    copy->fromXMLString(portfolio->toXMLString());
+
+    for (auto const& [tradeId, trade] : copy->trades()) {
+
+        // each trade gets its own market and engine factory, since the engine builders cache engines and would not
+        // request the market data again for subsequent trades
+
+        auto market = QuantLib::ext::make_shared<DependencyMarket>(baseCcy, true, curveConfigs, iborFallbackConfig);
+        auto factory = QuantLib::ext::make_shared<ore::data::EngineFactory>(
+            ed, market, std::map<ore::data::MarketContext, std::string>(), referenceData, iborFallbackConfig);
+
+        Dependencies& d = dependencies_[tradeId];
+        try {
+            trade->build(factory);
+            if (!trade->npvCurrency().empty() && trade->npvCurrency() != baseCcy)
+                market->fxRate(trade->npvCurrency() + baseCcy, ore::data::Market::defaultConfiguration);
+            d.currencies.insert(trade->npvCurrency());
+            d.all = false;
+        } catch (const std::exception& e) {
+            DLOG("RiskFactorDependencies: trade '" << tradeId << "' could not be built against dependency market ("
+                                                  << e.what() << "), assume it depends on all risk factors.");
+            continue;
+        }
+
+        d.riskFactors = market->riskFactors();
+        for (auto const& [type, names] : d.riskFactors) {
+            if (type != RFType::FXSpot && !isNameMatched(type))
+                d.all = true;
+            if (requiresAllRates(type))
+                d.allRates = true;
+            for (auto const& n : names) {
+                if (type == RFType::DiscountCurve) {
+                    d.currencies.insert(n);
+                } else if (type == RFType::IndexCurve && n.size() > 3) {
+                    d.currencies.insert(n.substr(0, 3));
+                } else if (type == RFType::FXSpot && n.size() == 6) {
+                    d.currencies.insert(n.substr(0, 3));
+                    d.currencies.insert(n.substr(3));
+                }
+            }
+        }
+        TLOG("RiskFactorDependencies: trade '" << tradeId << "' depends on all risk factors = " << std::boolalpha
+                                               << d.all << ", all rates = " << d.allRates);
+    }
+
+    LOG("RiskFactorDependencies: " << numberOfFullyDependentTrades() << " out of " << dependencies_.size()
+                                   << " trades depend on all risk factors");
+}
+
+bool RiskFactorDependencies::affects(const std::string& tradeId, const RiskFactorKey& key) const {
+    auto t = dependencies_.find(tradeId);
+    if (t == dependencies_.end() || t->second.all)
+        return true;
+    const Dependencies& d = t->second;
+    if (key.keytype == RFType::FXSpot) {
+        if (d.allRates || key.name.size() != 6)
+            return true;
+        for (auto const& ccy : {key.name.substr(0, 3), key.name.substr(3)}) {
+            if (ccy != baseCcy_ && d.currencies.find(ccy) != d.currencies.end())
+                return true;
+        }
+        return false;
+    }
+    if (isRates(key.keytype) && d.allRates)
+        return true;
+    if (!isNameMatched(key.keytype))
+        return d.riskFactors.find(key.keytype) != d.riskFactors.end();
+    auto r = d.riskFactors.find(key.keytype);
+    return r != d.riskFactors.end() && r->second.find(key.name) != r->second.end();
+}
+
+bool RiskFactorDependencies::affects(const std::string& tradeId,
+                                     const ShiftScenarioGenerator::ScenarioDescription& description) const {
+    using Type = ShiftScenarioGenerator::ScenarioDescription::Type;
+    switch (description.type()) {
+    case Type::Up:
+    case Type::Down:
+        return affects(tradeId, description.key1());
+    case Type::Cross:
+        return affects(tradeId, description.key1()) || affects(tradeId, description.key2());
+    default:
+        return true;
+    }
+}
+
+QuantLib::Size RiskFactorDependencies::numberOfFullyDependentTrades() const {
+    return std::count_if(dependencies_.begin(), dependencies_.end(),
+                         [](const std::pair<const std::string, Dependencies>& d) { return d.second.all; });
+}
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,92 @@
+/*
+ Copyright (C) 2025 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/engine/riskfactordependencies.hpp
+    \brief risk factors the trades of a portfolio depend on
+    \ingroup engine
+*/
+
+#pragma once
+
+#include <orea/scenario/shiftscenariogenerator.hpp>
+
+#include <ored/configuration/curveconfigurations.hpp>
+#include <ored/configuration/iborfallbackconfig.hpp>
+#include <ored/portfolio/enginedata.hpp>
+#include <ored/portfolio/portfolio.hpp>
+#include <ored/portfolio/referencedata.hpp>
+
+#include <map>
+#include <set>
+#include <string>
+
+namespace ore {
+namespace analytics {
+
+//! Risk factors the trades of a portfolio depend on
+/*! A copy of each trade is built against its own DependencyMarket, which records the risk factors requested by the
+    trade and its pricing engine. From this we decide whether a shift of a risk factor can change the base currency npv
+    of a trade, so that a sensitivity run can skip the valuation of trades that are not affected by a scenario. The
+    trades of the given portfolio are not modified.
+
+    The decision is conservative:
+    - a trade that fails to build against the dependency market, or that depends on a risk factor type other than
+      curves, spots, survival probabilities, recovery rates, security spreads and cprs (e.g. volatilities or
+      correlations), is affected by all shifts
+    - curves, spots, survival probabilities, recovery rates, security spreads and cprs are matched by name
+    - trades depending on equity, commodity or inflation risk factors are affected by all interest rate curve shifts,
+      since the simulation market builds e.g. equity forecasting curves from yield curves
+    - an fx spot shift affects a trade if one of the non-base currencies of the pair is a currency of the trade,
+      i.e. its npv currency or the currency of a discount curve, index or fx risk factor it depends on, or if the
+      trade depends on equity, commodity or inflation risk factors
+
+    \ingroup engine
+*/
+class RiskFactorDependencies {
+public:
+    RiskFactorDependencies(
+        const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio,
+        const QuantLib::ext::shared_ptr<ore::data::EngineData>& engineData, const std::string& baseCcy,
+        const QuantLib::ext::shared_ptr<ore::data::CurveConfigurations>& curveConfigs = nullptr,
+        const QuantLib::ext::shared_ptr<ore::data::ReferenceDataManager>& referenceData = nullptr,
+        const QuantLib::ext::shared_ptr<ore::data::IborFallbackConfig>& iborFallbackConfig =
+            QuantLib::ext::make_shared<ore::data::IborFallbackConfig>(ore::data::IborFallbackConfig::defaultConfig()));
+
+    //! Returns true if a shift of \p key can change the npv of trade \p tradeId, true for unknown trades
+    bool affects(const std::string& tradeId, const RiskFactorKey& key) const;
+
+    //! Returns true if the npv of trade \p tradeId can change under the given sensitivity scenario
+    bool affects(const std::string& tradeId, const ShiftScenarioGenerator::ScenarioDescription& description) const;
+
+    //! Number of trades that are affected by all shifts
+    QuantLib::Size numberOfFullyDependentTrades() const;
+
+private:
+    struct Dependencies {
+        bool all = true;
+        bool allRates = false;
+        std::map<RiskFactorKey::KeyType, std::set<std::string>> riskFactors;
+        std::set<std::string> currencies;
+    };
+
+    std::string baseCcy_;
+    std::map<std::string, Dependencies> dependencies_;
+};
+
+} // namespace analytics
+} // namespace ore
@@ -19,6 +19,7 @@
 #include <orea/cube/jointnpvsensicube.hpp>
 #include <orea/cube/sensicube.hpp>
 #include <orea/engine/multithreadedvaluationengine.hpp>
+#include <orea/engine/riskfactordependencies.hpp>
 #include <orea/engine/sensitivityanalysis.hpp>
 #include <orea/engine/valuationcalculator.hpp>
 #include <orea/engine/valuationengine.hpp>
@@ -82,6 +83,17 @@ SensitivityAnalysis::SensitivityAnalysis(
       context_(context), useAtParCouponsCurves_(useAtParCouponsCurves), useAtParCouponsTrades_(useAtParCouponsTrades) {}
 
 namespace {
+ValuationEngine::TradeAffectedBySample
+tradeAffectedFilter(const QuantLib::ext::shared_ptr<RiskFactorDependencies>& dependencies,
+                    const QuantLib::ext::shared_ptr<SensitivityScenarioGenerator>& scenarioGenerator) {
+    if (!dependencies)
+        return {};
+    return [dependencies, descriptions = scenarioGenerator->scenarioDescriptions()](const std::string& tradeId,
+                                                                                   const Size sample) {
+        return sample >= descriptions.size() || dependencies->affects(tradeId, descriptions[sample]);
+    };
+}
+
 std::vector<std::pair<QuantLib::ext::shared_ptr<Portfolio>, QuantLib::ext::shared_ptr<SensitivityScenarioGenerator>>>
 splitPortfolioByScenarioGenerators(
     const QuantLib::ext::shared_ptr<Portfolio>& portfolio, std::vector<std::string> ids,
@@ -147,6 +159,14 @@ void SensitivityAnalysis::generateSensitivities() {
         << sensiTemplateIdsFromPortfolio.size()
         << " sensi templates in portfolio (including default config, if configured in pe config for a trade)");
 
+    // analyse the risk factors the trades depend on, so that trades not affected by a scenario are not revalued
+
+    QuantLib::ext::shared_ptr<RiskFactorDependencies> dependencies;
+    if (skipUnaffectedTrades_) {
+        dependencies = QuantLib::ext::make_shared<RiskFactorDependencies>(
+            portfolio_, engineData_, simMarketData_->baseCcy(), curveConfigs_, referenceData_, iborFallbackConfig_);
+    }
+
     if (useSingleThreadedEngine_) {
 
         // handle single threaded sensi analysis
@@ -210,7 +230,7 @@ void SensitivityAnalysis::generateSensitivities() {
             for (auto const& i : this->progressIndicators())
                 engine.registerProgressIndicator(i);
             engine.buildCube(pf, cube, calculators, ValuationEngine::ErrorPolicy::RemoveAll, true, nullptr, nullptr, {},
-                             dryRun_);
+                             dryRun_, nullptr, tradeAffectedFilter(dependencies, scenGen));
 
             sensiCubes_.push_back(QuantLib::ext::make_shared<SensitivityCube>(cube, scenGen->scenarioDescriptions(),
                                                                       scenarioGenerator_->shiftSizes(),
@@ -280,7 +300,8 @@ void SensitivityAnalysis::generateSensitivities() {
                 [&baseCcy, this]() -> std::vector<QuantLib::ext::shared_ptr<ValuationCalculator>> {
                     return {QuantLib::ext::make_shared<NPVCalculator>(baseCcy, 0, laxFxConversion_)};
                 },
-                ValuationEngine::ErrorPolicy::RemoveAll, {}, true, dryRun_);
+                ValuationEngine::ErrorPolicy::RemoveAll, {}, true, dryRun_,
+                tradeAffectedFilter(dependencies, scenGen));
             std::vector<QuantLib::ext::shared_ptr<NPVSensiCube>> miniCubes;
             for (auto const& c : engine.outputCubes()) {
                 miniCubes.push_back(QuantLib::ext::dynamic_pointer_cast<NPVSensiCube>(c));
@@ -125,6 +125,10 @@ public:
     //! override shift tenors with sim market tenors
     void overrideTenors(const bool b) { overrideTenors_ = b; }
 
+    /*! skip the valuation of trades that do not depend on the risk factors shifted in a scenario, see
+        RiskFactorDependencies, default is false */
+    void skipUnaffectedTrades(const bool b) { skipUnaffectedTrades_ = b; }
+
     //! the portfolio of trades
     QuantLib::ext::shared_ptr<Portfolio> portfolio() const { return portfolio_; }
 
@@ -164,6 +168,7 @@ private:
     //! Optional todays market parameters. Used in building the scenario sim market.
     QuantLib::ext::shared_ptr<ore::data::TodaysMarketParameters> todaysMarketParams_;
     bool overrideTenors_;
+    bool skipUnaffectedTrades_ = false;
 
     // if true, convert sensis to base currency using the original (non-shifted) FX rate
     bool nonShiftedBaseCurrencyConversion_;
@@ -17,6 +17,8 @@
 */
 
 #include <orea/cube/inmemorycube.hpp>
+#include <orea/cube/jointnpvcube.hpp>
+#include <orea/engine/multithreadedvaluationengine.hpp>
 #include <orea/engine/stresstest.hpp>
 #include <orea/engine/valuationcalculator.hpp>
 #include <orea/engine/valuationengine.hpp>
@@ -57,7 +59,8 @@ void runStressTest(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfo
                    const QuantLib::ext::shared_ptr<ReferenceDataManager>& referenceData,
                    const QuantLib::ext::shared_ptr<IborFallbackConfig>& iborFallbackConfig, bool continueOnError,
                    const QuantLib::ext::shared_ptr<ore::data::InMemoryReport>& scenarioReport,
-                   const bool useAtParCouponsTrades) {
+                   const bool useAtParCouponsTrades, const Size nThreads,
+                   const QuantLib::ext::shared_ptr<ore::data::Loader>& loader) {
 
     // run stress simulation
     LOG("Run Stress Test");
@@ -76,7 +79,7 @@ void runStressTest(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfo
     runStressTest(portfolio, market->asofDate(), simMarket, marketConfiguration, engineData, simMarketData->baseCcy(),
                   scenarioGenerator, report, cfReport, threshold, precision, includePastCashflows, curveConfigs,
                   todaysMarketParams, referenceData, iborFallbackConfig, continueOnError, scenarioReport,
-                  useAtParCouponsTrades);
+                  useAtParCouponsTrades, nThreads, loader, simMarketData);
 }
 
 void runStressTest(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio,
@@ -92,7 +95,8 @@ void runStressTest(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfo
                    const QuantLib::ext::shared_ptr<ReferenceDataManager>& referenceData,
                    const QuantLib::ext::shared_ptr<IborFallbackConfig>& iborFallbackConfig, bool continueOnError,
                    const QuantLib::ext::shared_ptr<ore::data::InMemoryReport>& scenarioReport,
-                   const bool useAtParCouponsTrades) {
+                   const bool useAtParCouponsTrades, const Size nThreads,
+                   const QuantLib::ext::shared_ptr<ore::data::Loader>& loader) {
 
     // run stress simulation
     LOG("Run Stress Test");
@@ -109,7 +113,7 @@ void runStressTest(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfo
     runStressTest(portfolio, market->asofDate(), simMarket, marketConfiguration, engineData, simMarketData->baseCcy(),
                   scenarioGenerator, report, cfReport, threshold, precision, includePastCashflows, curveConfigs,
                   todaysMarketParams, referenceData, iborFallbackConfig, continueOnError, scenarioReport,
-                  useAtParCouponsTrades);
+                  useAtParCouponsTrades, nThreads, loader, simMarketData);
 }
 
 void runStressTest(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio, const Date& asof,
@@ -123,7 +127,9 @@ void runStressTest(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfo
                    const QuantLib::ext::shared_ptr<ReferenceDataManager>& referenceData,
                    const QuantLib::ext::shared_ptr<IborFallbackConfig>& iborFallbackConfig, bool continueOnError,
                    const QuantLib::ext::shared_ptr<ore::data::InMemoryReport>& scenarioReport,
-                   const bool useAtParCouponsTrades) {
+                   const bool useAtParCouponsTrades, const Size nThreads,
+                   const QuantLib::ext::shared_ptr<ore::data::Loader>& loader,
+                   const QuantLib::ext::shared_ptr<ScenarioSimMarketParameters>& simMarketData) {
 
     QuantLib::ext::shared_ptr<ScenarioGenerator> scenarioGenerator = scenGenerator;
     if (scenarioReport) {
@@ -136,35 +142,98 @@ void runStressTest(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfo
     configurations[MarketContext::pricing] = marketConfiguration;
     auto ed = QuantLib::ext::make_shared<EngineData>(*engineData);
     ed->globalParameters()["RunType"] = "Stress";
-    QuantLib::ext::shared_ptr<EngineFactory> factory =
-        QuantLib::ext::make_shared<EngineFactory>(ed, simMarket, configurations, referenceData, iborFallbackConfig);
 
-    portfolio->reset();
-    portfolio->build(factory, "stress analysis", true, useAtParCouponsTrades);
-
-    QuantLib::ext::shared_ptr<NPVCube> cube = QuantLib::ext::make_shared<InMemoryCubeOpt<double>>(
-        asof, portfolio->ids(), vector<Date>(1, asof), scenGenerator->samples());
+    QuantLib::ext::shared_ptr<DateGrid> dg = QuantLib::ext::make_shared<DateGrid>("1,0W", NullCalendar());
 
+    QuantLib::ext::shared_ptr<NPVCube> cube;
     std::vector<std::vector<std::vector<TradeCashflowReportData>>> cfCube;
-    if (cfReport)
-        cfCube = std::vector<std::vector<std::vector<TradeCashflowReportData>>>(
-            portfolio->ids().size(),
-            std::vector<std::vector<TradeCashflowReportData>>(scenGenerator->samples() + 1));
+    ValuationEngine::Errors errors;
 
-    QuantLib::ext::shared_ptr<DateGrid> dg = QuantLib::ext::make_shared<DateGrid>("1,0W", NullCalendar());
-    vector<QuantLib::ext::shared_ptr<ValuationCalculator>> calculators;
-    calculators.push_back(QuantLib::ext::make_shared<NPVCalculator>(baseCcy));
-    if (cfReport) {
-        calculators.push_back(
-            QuantLib::ext::make_shared<CashflowReportCalculator>(baseCcy, includePastCashflows, cfCube));
-    }
-    ValuationEngine engine(asof, dg, simMarket, factory->modelBuilders());
+    if (nThreads > 1) {
+
+        QL_REQUIRE(loader, "runStressTest(): loader required for multi-threaded run (nThreads = " << nThreads << ")");
+        QL_REQUIRE(simMarketData, "runStressTest(): sim market parameters required for multi-threaded run (nThreads = "
+                                      << nThreads << ")");
+
+        LOG("Run stress test with multi-threaded valuation engine using " << nThreads << " threads");
+
+        // the worker threads price sub-portfolios, the cashflow calculators store their results by trade id
+
+        std::map<std::string, Size> tradeIndices;
+        for (auto const& id : portfolio->ids())
+            tradeIndices.emplace(id, tradeIndices.size());
+
+        if (cfReport)
+            cfCube = std::vector<std::vector<std::vector<TradeCashflowReportData>>>(
+                portfolio->ids().size(),
+                std::vector<std::vector<TradeCashflowReportData>>(scenGenerator->samples() + 1));
+
+        MultiThreadedValuationEngine engine(
+            nThreads, asof, dg, scenGenerator->samples(), loader, scenarioGenerator, ed,
+            QuantLib::ext::make_shared<CurveConfigurations>(curveConfigs),
+            QuantLib::ext::make_shared<TodaysMarketParameters>(todaysMarketParams), marketConfiguration, simMarketData,
+            simMarket->useSpreadedTermStructures(), false, QuantLib::ext::make_shared<ScenarioFilter>(), referenceData,
+            iborFallbackConfig, true, true, true, {}, {}, {}, "stress analysis", nullptr, true, useAtParCouponsTrades);
+
+        engine.registerProgressIndicator(
+            QuantLib::ext::make_shared<ProgressLog>("stress scenarios", 100, oreSeverity::notice));
+
+        engine.buildCube(
+            portfolio,
+            [&baseCcy, &cfReport, includePastCashflows, &cfCube,
+             &tradeIndices]() -> std::vector<QuantLib::ext::shared_ptr<ValuationCalculator>> {
+                std::vector<QuantLib::ext::shared_ptr<ValuationCalculator>> calculators;
+                calculators.push_back(QuantLib::ext::make_shared<NPVCalculator>(baseCcy));
+                if (cfReport)
+                    calculators.push_back(QuantLib::ext::make_shared<CashflowReportCalculator>(
+                        baseCcy, includePastCashflows, cfCube, tradeIndices));
+                return calculators;
+            },
+            ValuationEngine::ErrorPolicy::RemoveSample);
+
+        cube = QuantLib::ext::make_shared<JointNPVCube>(engine.outputCubes(), portfolio->ids());
+
+        // map the errors from the mini-cube trade indices to the joint cube trade indices
+
+        for (Size b = 0; b < engine.outputCubes().size(); ++b) {
+            std::vector<Size> index(engine.outputCubes()[b]->numIds());
+            for (auto const& [id, i] : engine.outputCubes()[b]->idsAndIndexes())
+                index[i] = tradeIndices.at(id);
+            for (auto const& i : engine.outputErrors()[b].t0)
+                errors.t0.insert(index[i]);
+            for (auto const& [i, j] : engine.outputErrors()[b].samples)
+                errors.samples.insert(std::make_pair(index[i], j));
+        }
 
-    engine.registerProgressIndicator(
-        QuantLib::ext::make_shared<ProgressLog>("stress scenarios", 100, oreSeverity::notice));
-    ValuationEngine::Errors errors;
-    engine.buildCube(portfolio, cube, calculators, ValuationEngine::ErrorPolicy::RemoveSample, true, nullptr, nullptr,
-                     {}, false, &errors);
+    } else {
+
+        QuantLib::ext::shared_ptr<EngineFactory> factory =
+            QuantLib::ext::make_shared<EngineFactory>(ed, simMarket, configurations, referenceData, iborFallbackConfig);
+
+        portfolio->reset();
+        portfolio->build(factory, "stress analysis", true, useAtParCouponsTrades);
+
+        cube = QuantLib::ext::make_shared<InMemoryCubeOpt<double>>(asof, portfolio->ids(), vector<Date>(1, asof),
+                                                                   scenGenerator->samples());
+
+        if (cfReport)
+            cfCube = std::vector<std::vector<std::vector<TradeCashflowReportData>>>(
+                portfolio->ids().size(),
+                std::vector<std::vector<TradeCashflowReportData>>(scenGenerator->samples() + 1));
+
+        vector<QuantLib::ext::shared_ptr<ValuationCalculator>> calculators;
+        calculators.push_back(QuantLib::ext::make_shared<NPVCalculator>(baseCcy));
+        if (cfReport) {
+            calculators.push_back(
+                QuantLib::ext::make_shared<CashflowReportCalculator>(baseCcy, includePastCashflows, cfCube));
+        }
+        ValuationEngine engine(asof, dg, simMarket, factory->modelBuilders());
+
+        engine.registerProgressIndicator(
+            QuantLib::ext::make_shared<ProgressLog>("stress scenarios", 100, oreSeverity::notice));
+        engine.buildCube(portfolio, cube, calculators, ValuationEngine::ErrorPolicy::RemoveSample, true, nullptr,
+                         nullptr, {}, false, &errors);
+    }
 
     // write stressed npv report
 
@@ -185,7 +254,7 @@ void runStressTest(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfo
                 npv0 != Null<Real>() && errors.samples.find(std::make_pair(index->second, j)) == errors.samples.end()
                     ? cube->get(index->second, 0, j, 0)
                     : Null<Real>();
-            Real sensi = npv0 == Null<Real>() || npv0 == Null<Real>() ? Null<Real>() : npv - npv0;
+            Real sensi = npv0 == Null<Real>() || npv == Null<Real>() ? Null<Real>() : npv - npv0;
             if (fabs(sensi) > threshold || QuantLib::close_enough(sensi, threshold)) {
                 report->next();
                 report->add(tradeId);
@@ -28,6 +28,7 @@
 #include <orea/scenario/scenariosimmarketparameters.hpp>
 #include <orea/scenario/stressscenariodata.hpp>
 #include <orea/scenario/stressscenariogenerator.hpp>
+#include <ored/marketdata/loader.hpp>
 #include <ored/marketdata/market.hpp>
 #include <ored/portfolio/portfolio.hpp>
 #include <ored/report/report.hpp>
@@ -49,6 +50,11 @@ namespace analytics {
   - generating sensitivity scenarios
   - running the scenario "engine" to apply these and compute the NPV (CF) impacts of all required shifts
   - write results to reports
+
+  If nThreads > 1, the scenarios are priced with a MultiThreadedValuationEngine, i.e. the portfolio is split into
+  batches which are priced on nThreads worker threads against their own todays and simulation markets built from the
+  given loader. This requires a build with QL_ENABLE_SESSIONS = ON, a loader and the simulation market parameters
+  (the latter are passed explicitly only to the overload taking a simulation market and scenario generator).
 */
 
 void runStressTest(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio,
@@ -67,7 +73,8 @@ void runStressTest(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfo
                        QuantLib::ext::make_shared<IborFallbackConfig>(IborFallbackConfig::defaultConfig()),
                    bool continueOnError = false,
                    const QuantLib::ext::shared_ptr<ore::data::InMemoryReport>& scenarioReport = nullptr,
-                   const bool useAtParCouponsTrades = true);
+                   const bool useAtParCouponsTrades = true, const Size nThreads = 1,
+                   const QuantLib::ext::shared_ptr<ore::data::Loader>& loader = nullptr);
 
 void runStressTest(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio,
                    const QuantLib::ext::shared_ptr<ore::data::Market>& market, const string& marketConfiguration,
@@ -84,7 +91,8 @@ void runStressTest(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfo
                        QuantLib::ext::make_shared<IborFallbackConfig>(IborFallbackConfig::defaultConfig()),
                    bool continueOnError = false,
                    const QuantLib::ext::shared_ptr<ore::data::InMemoryReport>& scenarioReport = nullptr,
-                   const bool useAtParCouponsTrades = true);
+                   const bool useAtParCouponsTrades = true, const Size nThreads = 1,
+                   const QuantLib::ext::shared_ptr<ore::data::Loader>& loader = nullptr);
 
 void runStressTest(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio, const Date& asof,
                    const QuantLib::ext::shared_ptr<ScenarioSimMarket> simMarket, const string& marketConfiguration,
@@ -100,7 +108,9 @@ void runStressTest(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfo
                        QuantLib::ext::make_shared<IborFallbackConfig>(IborFallbackConfig::defaultConfig()),
                    bool continueOnError = false,
                    const QuantLib::ext::shared_ptr<ore::data::InMemoryReport>& scenarioReport = nullptr,
-                   const bool useAtParCouponsTrades = true);
+                   const bool useAtParCouponsTrades = true, const Size nThreads = 1,
+                   const QuantLib::ext::shared_ptr<ore::data::Loader>& loader = nullptr,
+                   const QuantLib::ext::shared_ptr<ScenarioSimMarketParameters>& simMarketData = nullptr);
 
 } // namespace analytics
 } // namespace ore
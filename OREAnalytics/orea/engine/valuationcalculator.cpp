@@ -247,7 +247,7 @@ void CashflowReportCalculator::calculate(const QuantLib::ext::shared_ptr<Trade>&
                                          Size dateIndex, Size sample, bool isCloseOut) {
     QL_REQUIRE(dateIndex == 0, "CashflowReportCalculator::calculate(): date ("
                                    << dateIndex << ") not allowed for this calculator. Expected 0.");
-    cfCube_[tradeIndex][sample + 1] =
+    cfCube_[index(trade, tradeIndex)][sample + 1] =
         trade->cashflows(baseCcyCode_, simMarket, Market::defaultConfiguration, includePastCashflows_);
 }
 
@@ -255,9 +255,18 @@ void CashflowReportCalculator::calculateT0(const QuantLib::ext::shared_ptr<Trade
                                            const QuantLib::ext::shared_ptr<SimMarket>& simMarket,
                                            QuantLib::ext::shared_ptr<NPVCube>& outputCube,
                                            QuantLib::ext::shared_ptr<NPVCube>& outputCubeNettingSet) {
-    cfCube_[tradeIndex][0] =
+    cfCube_[index(trade, tradeIndex)][0] =
         trade->cashflows(baseCcyCode_, simMarket, Market::defaultConfiguration, includePastCashflows_);
 }
 
+Size CashflowReportCalculator::index(const QuantLib::ext::shared_ptr<Trade>& trade, Size tradeIndex) const {
+    if (tradeIndices_.empty())
+        return tradeIndex;
+    auto i = tradeIndices_.find(trade->id());
+    QL_REQUIRE(i != tradeIndices_.end(),
+               "CashflowReportCalculator: trade '" << trade->id() << "' not found in trade indices, internal error.");
+    return i->second;
+}
+
 } // namespace analytics
 } // namespace ore
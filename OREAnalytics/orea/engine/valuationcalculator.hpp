@@ -190,12 +190,19 @@ private:
 };
 
 //! CashflowReportCalculator
-/*! Calculates cashflow report data under stress or sensitivity scenarios. */
+/*! Calculates cashflow report data under stress or sensitivity scenarios.
+
+    If tradeIndices is given, the results for a trade are stored in cfCube at the index of the trade id in this map
+    instead of the trade index passed by the valuation engine. This allows to run the calculator on sub-portfolios,
+    e.g. in the MultiThreadedValuationEngine, and collect the results in one cube. In this case cfCube must be sized
+    for all trades upfront. */
 class CashflowReportCalculator : public ValuationCalculator {
 public:
     CashflowReportCalculator(const std::string& baseCcyCode, const bool includePastCashflows,
-                             std::vector<std::vector<std::vector<TradeCashflowReportData>>>& cfCube)
-        : baseCcyCode_(baseCcyCode), includePastCashflows_(includePastCashflows), cfCube_(cfCube) {}
+                             std::vector<std::vector<std::vector<TradeCashflowReportData>>>& cfCube,
+                             const std::map<std::string, Size>& tradeIndices = {})
+        : baseCcyCode_(baseCcyCode), includePastCashflows_(includePastCashflows), cfCube_(cfCube),
+          tradeIndices_(tradeIndices) {}
 
     void calculate(const QuantLib::ext::shared_ptr<Trade>& trade, Size tradeIndex,
                    const QuantLib::ext::shared_ptr<SimMarket>& simMarket,
@@ -216,6 +223,9 @@ private:
     std::string baseCcyCode_;
     bool includePastCashflows_;
     std::vector<std::vector<std::vector<TradeCashflowReportData>>>& cfCube_;
+    std::map<std::string, Size> tradeIndices_;
+
+    Size index(const QuantLib::ext::shared_ptr<Trade>& trade, Size tradeIndex) const;
 };
 
 //! ExerciseCalculator
@@ -78,7 +78,7 @@ void ValuationEngine::buildCube(const QuantLib::ext::shared_ptr<data::Portfolio>
                                 QuantLib::ext::shared_ptr<analytics::NPVCube> outputCubeNettingSet,
                                 QuantLib::ext::shared_ptr<analytics::NPVCube> outputCptyCube,
                                 vector<QuantLib::ext::shared_ptr<CounterpartyCalculator>> cptyCalculators, bool dryRun,
-                                Errors* errors) {
+                                Errors* errors, const TradeAffectedBySample& tradeAffected) {
 
     struct SimMarketResetter {
         SimMarketResetter(QuantLib::ext::shared_ptr<SimMarket> simMarket) : simMarket_(simMarket) {}
@@ -86,7 +86,11 @@ void ValuationEngine::buildCube(const QuantLib::ext::shared_ptr<data::Portfolio>
         QuantLib::ext::shared_ptr<SimMarket> simMarket_;
     } simMarketResetter(simMarket_);
 
-    LOG("Build cube with mporStickyDate=" << mporStickyDate << ", dryRun=" << std::boolalpha << dryRun);
+    LOG("Build cube with mporStickyDate=" << mporStickyDate << ", dryRun=" << std::boolalpha << dryRun
+                                          << ", tradeAffected filter=" << static_cast<bool>(tradeAffected));
+
+    tradeAffected_ = tradeAffected;
+    skippedValuations_ = 0;
 
     QL_REQUIRE(portfolio->size() > 0, "ValuationEngine: Error portfolio is empty");
 
@@ -304,6 +308,9 @@ void ValuationEngine::buildCube(const QuantLib::ext::shared_ptr<data::Portfolio>
                                            << "update " << updateTime << " sec, "
                                            << "calibration " << calibrationTime << " sec, "
                                            << "fixing " << fixingTime);
+    if (tradeAffected_)
+        LOG("ValuationEngine skipped " << skippedValuations_ << " trade valuations not affected by the scenario");
+    tradeAffected_ = TradeAffectedBySample();
 
     // for trades with errors set output cube values to zero depending on chosen error policy
     i = 0;
@@ -341,6 +348,11 @@ void ValuationEngine::runCalculators(bool isCloseOutDate,
             continue;
         }
 
+        if (tradeAffected_ && !tradeAffected_(tradeIt->first, sample)) {
+            ++skippedValuations_;
+            continue;
+        }
+
         // We can avoid checking mode here and always call updateQlInstruments()
         if (om == ObservationMode::Mode::Disable || om == ObservationMode::Mode::Unregister)
             trade->instrument()->updateQlInstruments();
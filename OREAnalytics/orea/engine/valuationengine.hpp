@@ -27,6 +27,7 @@
 
 #include <ql/time/date.hpp>
 
+#include <functional>
 #include <map>
 #include <set>
 
@@ -75,6 +76,11 @@ public:
         std::set<std::pair<QuantLib::Size, QuantLib::Size>> samples; // set of (trade index, sample) with errors
     };
 
+    /*! Returns false if the trade with the given id is not affected by the scenario with the given sample index. Such
+        trades are not valued in that sample and their cube entries are left untouched, i.e. they keep the values the
+        cube returns for entries that are not set (the T0 value for sensi cubes). */
+    using TradeAffectedBySample = std::function<bool(const std::string&, QuantLib::Size)>;
+
     //! Constructor
     ValuationEngine(
         //! Valuation date
@@ -110,8 +116,10 @@ public:
         //! Limit samples to one and fill the rest of the cube with random values
         bool dryRun = false,
         //! errors
-        Errors* errors = nullptr);
-        
+        Errors* errors = nullptr,
+        //! Optional filter to skip the valuation of trades that are not affected by a sample
+        const TradeAffectedBySample& tradeAffected = {});
+
 private:
     void recalibrateModels();
     std::tuple<double, double, double>
@@ -144,6 +152,8 @@ private:
     QuantLib::ext::shared_ptr<ore::analytics::SimMarket> simMarket_;
     set<std::pair<std::string, QuantLib::ext::shared_ptr<QuantExt::ModelBuilder>>> modelBuilders_;
     bool recalibrate_ = true;
+    TradeAffectedBySample tradeAffected_;
+    QuantLib::Size skippedValuations_ = 0;
 };
 } // namespace analytics
 } // namespace ore
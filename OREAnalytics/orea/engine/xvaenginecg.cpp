@@ -230,6 +230,8 @@ void XvaEngineCG::buildCam() {
         camBuilder_->model(), scenarioGeneratorData_->samples(), currencies, curves, fxSpots, irIndices, infIndices,
         indices, indexCurrencies, simulationDates_, iborFallbackConfig_, std::vector<Size>(),
         std::vector<std::string>(), stickyCloseOutDates_, timeStepsPerYear);
+    // share identical nodes built for the model and the trades, e.g. the same discount factor per leg
+    model_->computationGraph()->enableCommonSubexpressionElimination();
     // this is actually necessary, FIXME why? There is a calculate() missing in the model impl. then?
     model_->calculate();
 
@@ -751,8 +753,22 @@ void XvaEngineCG::doForwardEvaluation() {
         }
         finalizeExternalCalculation();
     } else {
-        forwardEvaluation(*g, values_, ops_, RandomVariable::deleter, keepValuesForDerivatives, opNodeRequirements_,
-                          keepNodes_);
+        // nodes that do not contribute to any kept node are not evaluated, dynamic im evaluates parts of the graph
+        // separately, so all nodes are evaluated in this case
+        requiredNodes_.clear();
+        if (!enableDynamicIM_) {
+            requiredNodes_ = requiredNodes(*g, keepNodes_);
+            numberOfSkippedNodes_ = 0;
+            for (std::size_t n = 0; n < g->size(); ++n) {
+                if (!requiredNodes_[n] && !g->predecessors(n).empty())
+                    ++numberOfSkippedNodes_;
+            }
+            DLOG("XvaEngineCG: " << numberOfSkippedNodes_ << " nodes of " << g->size()
+                                 << " are not required for the outputs and will not be evaluated.");
+        }
+        forwardEvaluation(ForwardEvaluationPlan(*g, true, keepValuesForDerivatives, opNodeRequirements_, keepNodes_,
+                                                0, ComputationGraph::nan, false, {}, requiredNodes_),
+                          values_, ops_, RandomVariable::deleter);
     }
 
     rvMemMax_ = std::max(rvMemMax_, numberOfStochasticRvs(values_) + numberOfStochasticRvs(xvaDerivatives_)) +
@@ -822,30 +838,35 @@ void XvaEngineCG::populateAsd() {
 
     boost::timer::cpu_timer timer;
 
+    // register the keys once, the values are set by handle below
+
+    Size numeraireHandle = asd_->registerKey(AggregationScenarioDataType::Numeraire);
+    std::vector<Size> fxSpotHandles, indexHandles;
+    for (auto const& ccy : simMarketData_->additionalScenarioDataCcys()) {
+        if (ccy != simMarketData_->baseCcy())
+            fxSpotHandles.push_back(asd_->registerKey(AggregationScenarioDataType::FXSpot, ccy));
+    }
+    for (auto const& ind : simMarketData_->additionalScenarioDataIndices())
+        indexHandles.push_back(asd_->registerKey(AggregationScenarioDataType::IndexFixing, ind));
+
     for (Size k = 0; k < valuationDates_.size(); ++k) {
         // set numeraire
         for (std::size_t i = 0; i < model_->size(); ++i) {
-            asd_->set(k, i, values_[asdNumeraire_[k]][i], AggregationScenarioDataType::Numeraire);
+            asd_->set(k, i, values_[asdNumeraire_[k]][i], numeraireHandle);
         }
 
         // set fx spots
-        std::size_t ccyIndex = 0;
-        for (auto const& ccy : simMarketData_->additionalScenarioDataCcys()) {
-            if (ccy != simMarketData_->baseCcy()) {
-                for (std::size_t i = 0; i < model_->size(); ++i) {
-                    asd_->set(k, i, values_[asdFx_[ccyIndex][k]][i], AggregationScenarioDataType::FXSpot, ccy);
-                }
-                ++ccyIndex;
+        for (std::size_t ccyIndex = 0; ccyIndex < fxSpotHandles.size(); ++ccyIndex) {
+            for (std::size_t i = 0; i < model_->size(); ++i) {
+                asd_->set(k, i, values_[asdFx_[ccyIndex][k]][i], fxSpotHandles[ccyIndex]);
             }
         }
 
         // set index fixings
-        std::size_t indIndex = 0;
-        for (auto const& ind : simMarketData_->additionalScenarioDataIndices()) {
+        for (std::size_t indIndex = 0; indIndex < indexHandles.size(); ++indIndex) {
             for (std::size_t i = 0; i < model_->size(); ++i) {
-                asd_->set(k, i, values_[asdIndex_[indIndex][k]][i], AggregationScenarioDataType::IndexFixing, ind);
+                asd_->set(k, i, values_[asdIndex_[indIndex][k]][i], indexHandles[indIndex]);
             }
-            ++indIndex;
         }
     }
 
@@ -1593,6 +1614,10 @@ void XvaEngineCG::calculateSensitivities() {
 
         model_->alwaysForwardNotifications();
 
+        // the forward evaluation plan for full recalculations is built once and reused for all scenarios
+
+        ForwardEvaluationPlan fwdPlan;
+
         Size activeScenarios = 0;
         for (Size sample = 0; sample < sensiResultCube_->samples(); ++sample) {
 
@@ -1652,8 +1677,10 @@ void XvaEngineCG::calculateSensitivities() {
                         finalizeExternalCalculation();
                     } else {
                         populateModelParameters(modelParameters, values_, valuesExternal_);
-                        forwardEvaluation(*g, values_, ops_, RandomVariable::deleter, true, opNodeRequirements_,
-                                          keepNodes_);
+                        if (fwdPlan.empty())
+                            fwdPlan = ForwardEvaluationPlan(*g, true, true, opNodeRequirements_, keepNodes_, 0,
+                                                            ComputationGraph::nan, false, {}, requiredNodes_);
+                        forwardEvaluation(fwdPlan, values_, ops_, RandomVariable::deleter);
                     }
                     sensi = expectation(values_[cvaNode_]).at(0) - cva;
                 }
@@ -1736,6 +1763,8 @@ void XvaEngineCG::outputGraphStats() {
     auto g = model_->computationGraph();
     LOG("XvaEngineCG: graph building complete, size is " << g->size());
     LOG("XvaEngineCG: got " << g->redBlockDependencies().size() << " red block dependencies.");
+    numberOfEliminatedNodes_ = g->numberOfEliminatedNodes();
+    LOG("XvaEngineCG: common subexpression elimination saved " << numberOfEliminatedNodes_ << " nodes.");
     numberOfRedNodes_ = 0;
     for (auto const& r : g->redBlockRanges()) {
         DLOG("XvaEngineCG: red block range " << r.first << " ... " << r.second);
@@ -1747,6 +1776,8 @@ void XvaEngineCG::outputTimings() {
     LOG("XvaEngineCG: graph size               : " << model_->computationGraph()->size());
     LOG("XvaEngineCG: red nodes                : " << numberOfRedNodes_);
     LOG("XvaEngineCG: red node dependendices   : " << model_->computationGraph()->redBlockDependencies().size());
+    LOG("XvaEngineCG: cse eliminated nodes     : " << numberOfEliminatedNodes_);
+    LOG("XvaEngineCG: not required nodes       : " << numberOfSkippedNodes_);
     LOG("XvaEngineCG: Peak mem usage           : " << ore::data::os::getPeakMemoryUsageBytes() / 1024 / 1024 << " MB");
     LOG("XvaEngineCG: Peak theoretical rv mem  : " << static_cast<double>(rvMemMax_) / 1024 / 1024 * 8 * model_->size()
                                                    << " MB");
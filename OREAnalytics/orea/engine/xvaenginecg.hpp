@@ -302,6 +302,7 @@ private:
 
     // nodes to keep in calculation graph algorightms
     std::vector<bool> keepNodes_;
+    std::vector<bool> requiredNodes_;
 
     // the cva node from the cg-pp
     std::size_t cvaNode_ = QuantExt::ComputationGraph::nan;
@@ -321,6 +322,7 @@ private:
                                   timing_fwd_ = 0, timing_dynamicIM_ = 0, timing_bwd_ = 0, timing_sensi_ = 0,
                                   timing_asd_ = 0, timing_outcube_ = 0, timing_imcube_ = 0, timing_total_ = 0;
     std::size_t numberOfRedNodes_, rvMemMax_;
+    std::size_t numberOfEliminatedNodes_ = 0, numberOfSkippedNodes_ = 0;
 
     // data to populate dynamicImRegressionReport_
 
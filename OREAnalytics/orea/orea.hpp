@@ -81,6 +81,7 @@
 #include <orea/cube/jaggedcube.hpp>
 #include <orea/cube/jointnpvcube.hpp>
 #include <orea/cube/jointnpvsensicube.hpp>
+#include <orea/cube/mappednpvcube.hpp>
 #include <orea/cube/npvcube.hpp>
 #include <orea/cube/npvsensicube.hpp>
 #include <orea/cube/overlaynpvcube.hpp>
@@ -117,6 +118,7 @@
 #include <orea/engine/parstressscenarioconverter.hpp>
 #include <orea/engine/pathdata.hpp>
 #include <orea/engine/pnlexplainreport.hpp>
+#include <orea/engine/riskfactordependencies.hpp>
 #include <orea/engine/riskfilter.hpp>
 #include <orea/engine/saccrcalculator.hpp>
 #include <orea/engine/saccrcrifgenerator.hpp>
@@ -158,6 +160,7 @@
 #include <orea/scenario/historicalscenarioreturn.hpp>
 #include <orea/scenario/lgmscenariogenerator.hpp>
 #include <orea/scenario/scenario.hpp>
+#include <orea/scenario/scenariobinaryreader.hpp>
 #include <orea/scenario/scenariofactory.hpp>
 #include <orea/scenario/scenariofilereader.hpp>
 #include <orea/scenario/scenariofilter.hpp>
@@ -29,6 +29,7 @@
 
 #include <fstream>
 #include <map>
+#include <span>
 #include <vector>
 
 namespace ore {
@@ -53,6 +54,9 @@ enum class AggregationScenarioDataType : unsigned int {
 /*! The indexes for dates and samples are (by convention) the
     same as in the npv cube
 
+    Besides the access by (type, qualifier) the data can be accessed by integer handles. A handle is obtained once
+    via registerKey() or handle() and avoids the key lookup in loops over dates and samples.
+
         \ingroup scenario
 */
 class AggregationScenarioData : public QuantLib::Observable {
@@ -82,10 +86,24 @@ public:
     // Get available keys (type, qualifier)
     virtual std::vector<std::pair<AggregationScenarioDataType, std::string>> keys() const = 0;
 
+    //! Register a key if it is not known yet and return its handle, handles are stable for the lifetime of the object
+    virtual Size registerKey(const AggregationScenarioDataType& type, const string& qualifier = "") = 0;
+    //! Return the handle of a registered key, throws if the key is not known
+    virtual Size handle(const AggregationScenarioDataType& type, const string& qualifier = "") const = 0;
+
+    //! Get a value from the cube by handle
+    virtual Real get(Size dateIndex, Size sampleIndex, Size handle) const = 0;
+    //! Set a value in the cube by handle
+    virtual void set(Size dateIndex, Size sampleIndex, Real value, Size handle) = 0;
+    //! Return the values of all samples for a date without copying them, valid for the lifetime of the object
+    virtual std::span<const Real> samples(Size dateIndex, Size handle) const = 0;
+
     //! Set a value in the cube, assumes normal traversal of the cube (dates then samples)
     virtual void set(Real value, const AggregationScenarioDataType& type, const string& qualifier = "") {
         set(dIndex_, sIndex_, value, type, qualifier);
     }
+    //! Set a value in the cube by handle, assumes normal traversal of the cube (dates then samples)
+    virtual void set(Real value, Size handle) { set(dIndex_, sIndex_, value, handle); }
     //! Go to the next point on the cube
     /*! Go to the next point on the cube, assumes we do date, then samples
      */
@@ -101,56 +119,94 @@ private:
 };
 
 //! A concrete in memory implementation of AggregationScenarioData
-/*! \ingroup scenario
+/*! The data of each key is stored in one contiguous block of dimDates x dimSamples values with samples running
+    fastest, the blocks are addressed by the handle of the key.
+
+    \ingroup scenario
  */
 class InMemoryAggregationScenarioData : public AggregationScenarioData {
 public:
     InMemoryAggregationScenarioData() : AggregationScenarioData(), dimDates_(0), dimSamples_(0) {}
     InMemoryAggregationScenarioData(Size dimDates, Size dimSamples)
         : AggregationScenarioData(), dimDates_(dimDates), dimSamples_(dimSamples) {}
+
+    using AggregationScenarioData::get;
+    using AggregationScenarioData::set;
+
     Size dimDates() const override { return dimDates_; }
     Size dimSamples() const override { return dimSamples_; }
 
     bool has(const AggregationScenarioDataType& type, const string& qualifier = "") const override {
-        return data_.find(std::make_pair(type, qualifier)) != data_.end();
+        return handles_.find(std::make_pair(type, qualifier)) != handles_.end();
     }
 
-    /*! might throw (the underlying's container exception),
-      if type is not known */
+    //! throws if type is not known
     Real get(Size dateIndex, Size sampleIndex, const AggregationScenarioDataType& type,
              const string& qualifier = "") const override {
-        check(dateIndex, sampleIndex, type, qualifier);
-        return data_.at(std::make_pair(type, qualifier))[dateIndex][sampleIndex];
+        check(dateIndex, sampleIndex);
+        return data_[handle(type, qualifier)][dateIndex * dimSamples_ + sampleIndex];
     }
 
     std::vector<std::pair<AggregationScenarioDataType, std::string>> keys() const override {
         std::vector<std::pair<AggregationScenarioDataType, std::string>> res;
-        for (auto const& k : data_)
+        for (auto const& k : handles_)
             res.push_back(k.first);
         return res;
     }
 
     void set(Size dateIndex, Size sampleIndex, Real value, const AggregationScenarioDataType& type,
              const string& qualifier = "") override {
-        check(dateIndex, sampleIndex, type, qualifier);
-        auto key = std::make_pair(type, qualifier);
-        auto it = data_.find(key);
-        if (it == data_.end()) {
-            data_.insert(make_pair(key, vector<vector<Real>>(dimDates_, vector<Real>(dimSamples_, 0.0))));
-        }
-        data_[key][dateIndex][sampleIndex] = value;
+        check(dateIndex, sampleIndex);
+        data_[registerKey(type, qualifier)][dateIndex * dimSamples_ + sampleIndex] = value;
+    }
+
+    Size registerKey(const AggregationScenarioDataType& type, const string& qualifier = "") override {
+        auto [it, inserted] = handles_.insert(std::make_pair(std::make_pair(type, qualifier), data_.size()));
+        if (inserted)
+            data_.push_back(vector<Real>(dimDates_ * dimSamples_, 0.0));
+        return it->second;
+    }
+
+    Size handle(const AggregationScenarioDataType& type, const string& qualifier = "") const override {
+        auto it = handles_.find(std::make_pair(type, qualifier));
+        QL_REQUIRE(it != handles_.end(), "InMemoryAggregationScenarioData: no data for type " << (unsigned int)type
+                                                                                              << ", qualifier '"
+                                                                                              << qualifier << "'");
+        return it->second;
+    }
+
+    Real get(Size dateIndex, Size sampleIndex, Size handle) const override {
+        check(dateIndex, sampleIndex);
+        checkHandle(handle);
+        return data_[handle][dateIndex * dimSamples_ + sampleIndex];
+    }
+
+    void set(Size dateIndex, Size sampleIndex, Real value, Size handle) override {
+        check(dateIndex, sampleIndex);
+        checkHandle(handle);
+        data_[handle][dateIndex * dimSamples_ + sampleIndex] = value;
+    }
+
+    std::span<const Real> samples(Size dateIndex, Size handle) const override {
+        QL_REQUIRE(dateIndex < dimDates_, "dateIndex (" << dateIndex << ") out of range 0..." << dimDates_ - 1);
+        checkHandle(handle);
+        return std::span<const Real>(data_[handle].data() + dateIndex * dimSamples_, dimSamples_);
     }
 
 private:
-    void check(Size dateIndex, Size sampleIndex, const AggregationScenarioDataType& type,
-               const string& qualifier) const {
+    void check(Size dateIndex, Size sampleIndex) const {
         QL_REQUIRE(dateIndex < dimDates_, "dateIndex (" << dateIndex << ") out of range 0..." << dimDates_ - 1);
         QL_REQUIRE(sampleIndex < dimSamples_,
                    "sampleIndex (" << sampleIndex << ") out of range 0..." << dimSamples_ - 1);
-        return;
+    }
+    void checkHandle(Size handle) const {
+        QL_REQUIRE(handle < data_.size(),
+                   "handle (" << handle << ") out of range, " << data_.size() << " keys registered");
     }
     Size dimDates_, dimSamples_;
-    map<std::pair<AggregationScenarioDataType, string>, vector<vector<Real>>> data_;
+    map<std::pair<AggregationScenarioDataType, string>, Size> handles_;
+    // data by handle, each (date, sample) block with samples running fastest
+    vector<vector<Real>> data_;
 };
 
 inline std::ostream& operator<<(std::ostream& out, const AggregationScenarioDataType& t) {
@@ -370,6 +370,103 @@ CrossAssetModelScenarioGenerator::CrossAssetModelScenarioGenerator(
         }
     }
 
+    // precompute the curve tenor times and pillar dates on each simulation date
+
+    auto tenorTimes = [this, &dc](const std::vector<std::vector<Period>>& tenors) {
+        std::vector<std::vector<std::vector<Time>>> result(dates_.size(), std::vector<std::vector<Time>>(tenors.size()));
+        for (Size i = 0; i < dates_.size(); ++i) {
+            for (Size j = 0; j < tenors.size(); ++j) {
+                for (auto const& p : tenors[j])
+                    result[i][j].push_back(dc.yearFraction(dates_[i], dates_[i] + p));
+            }
+        }
+        return result;
+    };
+
+    t_dsc_ = tenorTimes(ten_dsc_);
+    t_idx_ = tenorTimes(ten_idx_);
+    t_yc_ = tenorTimes(ten_yc_);
+    t_zinf_ = tenorTimes(ten_zinf_);
+    t_dfc_ = tenorTimes(ten_dfc_);
+    t_com_ = tenorTimes(ten_com_);
+
+    pillarDates_yinf_.resize(dates_.size(), std::vector<std::vector<Date>>(ten_yinf_.size()));
+    for (Size i = 0; i < dates_.size(); ++i) {
+        for (Size j = 0; j < ten_yinf_.size(); ++j) {
+            for (auto const& p : ten_yinf_[j])
+                pillarDates_yinf_[i][j].push_back(dates_[i] + p);
+        }
+    }
+
+    for (Size j = 0; j < n_indices_; ++j)
+        indexCcyIdx_.push_back(model_->ccyIndex(indices_[j]->currency()));
+
+    for (Size j = 0; j < n_curves_; ++j)
+        yieldCurveCcyIdx_.push_back(model_->ccyIndex(yieldCurveCurrency_[j]));
+
+    // for DK inflation components the cpi is computed relative to the base fixing of the inflation index
+
+    cpiDkBaseFixing_.resize(n_inf_, Null<Real>());
+    t_cpiDk_.resize(dates_.size(), std::vector<Time>(n_inf_, Null<Time>()));
+    for (Size j = 0; j < n_inf_; ++j) {
+        if (model_->modelType(CrossAssetModel::AssetType::INF, j) != CrossAssetModel::ModelType::DK)
+            continue;
+        auto index = *initMarket_->zeroInflationIndex(model_->inf(j)->name());
+        auto zts = index->zeroInflationTermStructure();
+        Date baseDate = zts->baseDate();
+        cpiDkBaseFixing_[j] = index->fixing(baseDate);
+        for (Size i = 0; i < dates_.size(); ++i) {
+            t_cpiDk_[i][j] = inflationYearFraction(zts->frequency(), false, zts->dayCounter(), baseDate,
+                                                   dates_[i] - zts->observationLag());
+        }
+    }
+
+    // the keys in the order in which generatePath() populates the values
+
+    keys_.insert(keys_.end(), discountCurveKeys_.begin(), discountCurveKeys_.end());
+    keys_.insert(keys_.end(), indexCurveKeys_.begin(), indexCurveKeys_.end());
+    keys_.insert(keys_.end(), yieldCurveKeys_.begin(), yieldCurveKeys_.end());
+    keys_.insert(keys_.end(), fxKeys_.begin(), fxKeys_.end());
+    if (simMarketConfig_->simulateFXVols()) {
+        for (auto const& ccyPair : simMarketConfig_->fxVolCcyPairs()) {
+            for (Size j = 0; j < simMarketConfig_->fxVolExpiries(ccyPair).size(); ++j)
+                keys_.emplace_back(RiskFactorKey::KeyType::FXVolatility, ccyPair, j);
+        }
+    }
+    keys_.insert(keys_.end(), eqKeys_.begin(), eqKeys_.end());
+    if (simMarketConfig_->simulateEquityVols()) {
+        for (auto const& equityName : simMarketConfig_->equityVolNames()) {
+            for (Size j = 0; j < simMarketConfig_->equityVolExpiries(equityName).size(); ++j)
+                keys_.emplace_back(RiskFactorKey::KeyType::EquityVolatility, equityName, j);
+        }
+    }
+    if (simMarketConfig_->simulateSwapVols()) {
+        for (auto const& key : simMarketConfig_->swapVolKeys()) {
+            Size n = simMarketConfig_->swapVolExpiries(key).size() * simMarketConfig_->swapVolTerms(key).size();
+            for (Size j = 0; j < n; ++j)
+                keys_.emplace_back(RiskFactorKey::KeyType::SwaptionVolatility, key, j);
+        }
+    }
+    keys_.insert(keys_.end(), cpiKeys_.begin(), cpiKeys_.end());
+    for (Size j = 0, offset = 0; j < zeroInfCurves_.size(); offset += ten_zinf_[j].size(), ++j)
+        keys_.insert(keys_.end(), std::next(zeroInflationKeys_.begin(), offset),
+                     std::next(zeroInflationKeys_.begin(), offset + ten_zinf_[j].size()));
+    for (Size j = 0, offset = 0; j < yoyInfCurves_.size(); offset += ten_yinf_[j].size(), ++j)
+        keys_.insert(keys_.end(), std::next(yoyInflationKeys_.begin(), offset),
+                     std::next(yoyInflationKeys_.begin(), offset + ten_yinf_[j].size()));
+    for (Size j = 0, offset = 0; j < n_cr_; offset += ten_dfc_[j].size(), ++j) {
+        auto mt = model_->modelType(CrossAssetModel::AssetType::CR, j);
+        if (mt == CrossAssetModel::ModelType::LGM1F || mt == CrossAssetModel::ModelType::CIRPP)
+            keys_.insert(keys_.end(), std::next(defaultCurveKeys_.begin(), offset),
+                         std::next(defaultCurveKeys_.begin(), offset + ten_dfc_[j].size()));
+    }
+    keys_.insert(keys_.end(), commodityCurveKeys_.begin(), commodityCurveKeys_.end());
+    keys_.insert(keys_.end(), crStateKeys_.begin(), crStateKeys_.end());
+    for (Size k = 0; k < n_survivalweights_; ++k) {
+        keys_.push_back(survivalWeightKeys_[k]);
+        keys_.push_back(recoveryRateKeys_[k]);
+    }
+
     LOG("CrossAssetModelScenarioGenerator ctor done");
 }
 
@@ -380,13 +477,11 @@ void copyPathToArray(const MultiPath& p, Size t, Size a, Array& target) {
 }
 } // namespace
 
-std::vector<QuantLib::ext::shared_ptr<Scenario>> CrossAssetModelScenarioGenerator::nextPath() {
+Sample<MultiPath> CrossAssetModelScenarioGenerator::nextSample() {
 
-    std::vector<QuantLib::ext::shared_ptr<Scenario>> scenarios(dates_.size());
     QL_REQUIRE(pathGenerator_ != nullptr, "CrossAssetModelScenarioGenerator::nextPath(): pathGenerator is null");
     Sample<MultiPath> sample = pathGenerator_->next();
     ++currentSample_;
-    DayCounter dc = model_->irModel(0)->termStructure()->dayCounter();
 
     if (!amcPathDataOutput_.empty()) {
         for (Size k = 0; k < n_fx_; ++k) {
@@ -408,7 +503,37 @@ std::vector<QuantLib::ext::shared_ptr<Scenario>> CrossAssetModelScenarioGenerato
                 pathData_.paths[j][k].set(currentSample_ - 1, sample.value[k][j + 1]);
             }
         }
+
+        if (totalSamples_ == currentSample_) {
+            LOG("Serialize paths, fx and irState buffers to'" << amcPathDataOutput_ << "'");
+            std::ofstream os(amcPathDataOutput_, std::ios::binary);
+            boost::archive::binary_oarchive oa(os, boost::archive::no_header);
+            oa << pathData_;
+            os.close();
+        }
+    }
+
+    return sample;
+}
+
+std::vector<QuantLib::ext::shared_ptr<Scenario>> CrossAssetModelScenarioGenerator::nextPath() {
+    Sample<MultiPath> sample = nextSample();
+    generatePath(sample.value, numeraireBuffer_, valueBuffer_);
+    std::vector<QuantLib::ext::shared_ptr<Scenario>> scenarios(dates_.size());
+    for (Size i = 0; i < dates_.size(); i++) {
+        scenarios[i] = scenarioFactory_->buildScenario(dates_[i], true);
+        scenarios[i]->setNumeraire(numeraireBuffer_[i]);
+        for (Size k = 0; k < keys_.size(); ++k)
+            scenarios[i]->add(keys_[k], valueBuffer_[i * keys_.size() + k]);
     }
+    return scenarios;
+}
+
+void CrossAssetModelScenarioGenerator::generatePath(const MultiPath& path, std::vector<Real>& numeraire,
+                                                    std::vector<Real>& values) {
+
+    numeraire.resize(dates_.size());
+    values.resize(dates_.size() * keys_.size());
 
     std::vector<Array> ir_state(n_ccy_);
     for (Size j = 0; j < n_ccy_; ++j) {
@@ -417,68 +542,48 @@ std::vector<QuantLib::ext::shared_ptr<Scenario>> CrossAssetModelScenarioGenerato
 
     Array ir_state_aux(model_->irModel(0)->n_aux());
 
-    std::vector<Size> indexCcyIdx(n_indices_);
-    for (Size j = 0; j < n_indices_; ++j)
-        indexCcyIdx[j] = model_->ccyIndex(indices_[j]->currency());
-
-    std::vector<Size> yieldCurveCcyIdx(n_curves_);
-    for (Size j = 0; j < n_curves_; ++j)
-        yieldCurveCcyIdx[j] = model_->ccyIndex(yieldCurveCurrency_[j]);
-
     for (Size i = 0; i < dates_.size(); i++) {
         Real t = timeGrid_[i + 1]; // recall: time grid has inserted t=0
+        Size pIdx = gridIndexInPath_[i + 1];
 
-        scenarios[i] = scenarioFactory_->buildScenario(dates_[i], true);
+        // the values are written in the order of keys_
+
+        Real* v = values.data() + i * keys_.size();
 
         // populate IR states
-        copyPathToArray(sample.value, gridIndexInPath_[i + 1], model_->pIdx(CrossAssetModel::AssetType::IR, 0),
-                        ir_state[0]);
-        copyPathToArray(sample.value, gridIndexInPath_[i + 1],
-                        model_->pIdx(CrossAssetModel::AssetType::IR, 0) + ir_state[0].size(), ir_state_aux);
+        copyPathToArray(path, pIdx, model_->pIdx(CrossAssetModel::AssetType::IR, 0), ir_state[0]);
+        copyPathToArray(path, pIdx, model_->pIdx(CrossAssetModel::AssetType::IR, 0) + ir_state[0].size(),
+                        ir_state_aux);
         for (Size j = 1; j < n_ccy_; ++j)
-            copyPathToArray(sample.value, gridIndexInPath_[i + 1], model_->pIdx(CrossAssetModel::AssetType::IR, j),
-                            ir_state[j]);
+            copyPathToArray(path, pIdx, model_->pIdx(CrossAssetModel::AssetType::IR, j), ir_state[j]);
 
         // Set numeraire from domestic ir process
-        scenarios[i]->setNumeraire(model_->numeraire(0, t, ir_state[0], Handle<YieldTermStructure>(), ir_state_aux));
+        numeraire[i] = model_->numeraire(0, t, ir_state[0], Handle<YieldTermStructure>(), ir_state_aux);
 
         // Discount curves
         for (Size j = 0; j < n_ccy_; j++) {
             curves_[j]->move(t, ir_state[j]);
-            for (Size k = 0; k < ten_dsc_[j].size(); k++) {
-                Date d = dates_[i] + ten_dsc_[j][k];
-                Time T = dc.yearFraction(dates_[i], d);
-                Real discount = std::max(curves_[j]->discount(T), 0.00001);
-                scenarios[i]->add(discountCurveKeys_[j * ten_dsc_[j].size() + k], discount);
-            }
+            for (auto const T : t_dsc_[i][j])
+                *v++ = std::max(curves_[j]->discount(T), 0.00001);
         }
 
         // Index curves and Index fixings
         for (Size j = 0; j < n_indices_; ++j) {
-            fwdCurves_[j]->move(dates_[i], ir_state[indexCcyIdx[j]]);
-            for (Size k = 0; k < ten_idx_[j].size(); ++k) {
-                Date d = dates_[i] + ten_idx_[j][k];
-                Time T = dc.yearFraction(dates_[i], d);
-                Real discount = std::max(fwdCurves_[j]->discount(T), 0.00001);
-                scenarios[i]->add(indexCurveKeys_[j * ten_idx_[j].size() + k], discount);
-            }
+            fwdCurves_[j]->move(dates_[i], ir_state[indexCcyIdx_[j]]);
+            for (auto const T : t_idx_[i][j])
+                *v++ = std::max(fwdCurves_[j]->discount(T), 0.00001);
         }
 
         // Yield curves
         for (Size j = 0; j < n_curves_; ++j) {
-            yieldCurves_[j]->move(dates_[i], ir_state[yieldCurveCcyIdx[j]]);
-            for (Size k = 0; k < ten_yc_[j].size(); ++k) {
-                Date d = dates_[i] + ten_yc_[j][k];
-                Time T = dc.yearFraction(dates_[i], d);
-                Real discount = std::max(yieldCurves_[j]->discount(T), 0.00001);
-                scenarios[i]->add(yieldCurveKeys_[j * ten_yc_[j].size() + k], discount);
-            }
+            yieldCurves_[j]->move(dates_[i], ir_state[yieldCurveCcyIdx_[j]]);
+            for (auto const T : t_yc_[i][j])
+                *v++ = std::max(yieldCurves_[j]->discount(T), 0.00001);
         }
 
         // FX rates
         for (Size k = 0; k < n_ccy_ - 1; k++) {
-            Real fx = std::exp(sample.value[model_->pIdx(CrossAssetModel::AssetType::FX, k)][gridIndexInPath_[i + 1]]);
-            scenarios[i]->add(fxKeys_[k], fx);
+            *v++ = std::exp(path[model_->pIdx(CrossAssetModel::AssetType::FX, k)][pIdx]);
         }
 
         // FX vols
@@ -488,23 +593,19 @@ std::vector<QuantLib::ext::shared_ptr<Scenario>> CrossAssetModelScenarioGenerato
                 const vector<Period>& expires = simMarketConfig_->fxVolExpiries(ccyPair);
 
                 Size fxIndex = fxVols_[k]->fxIndex();
-                Real zFor = sample.value[fxIndex + 1][gridIndexInPath_[i + 1]];
-                Real logFx =
-                    sample.value[n_ccy_ + fxIndex][gridIndexInPath_[i + 1]]; // multiplies USD amount to get EUR
+                Real zFor = path[fxIndex + 1][pIdx];
+                Real logFx = path[n_ccy_ + fxIndex][pIdx]; // multiplies USD amount to get EUR
                 fxVols_[k]->move(dates_[i], ir_state[0][0], zFor, logFx);
 
                 for (Size j = 0; j < expires.size(); j++) {
-                    Real vol = fxVols_[k]->blackVol(dates_[i] + expires[j], Null<Real>(), true);
-                    scenarios[i]->add(RiskFactorKey(RiskFactorKey::KeyType::FXVolatility, ccyPair, j), vol);
+                    *v++ = fxVols_[k]->blackVol(dates_[i] + expires[j], Null<Real>(), true);
                 }
             }
         }
 
         // Equity spots
         for (Size k = 0; k < n_eq_; k++) {
-            Real eqSpot =
-                std::exp(sample.value[model_->pIdx(CrossAssetModel::AssetType::EQ, k)][gridIndexInPath_[i + 1]]);
-            scenarios[i]->add(eqKeys_[k], eqSpot);
+            *v++ = std::exp(path[model_->pIdx(CrossAssetModel::AssetType::EQ, k)][pIdx]);
         }
 
         // Equity vols
@@ -516,13 +617,12 @@ std::vector<QuantLib::ext::shared_ptr<Scenario>> CrossAssetModelScenarioGenerato
 
                 Size eqIndex = eqVols_[k]->equityIndex();
                 Size eqCcyIdx = eqVols_[k]->eqCcyIndex();
-                Real z_eqIr = sample.value[eqCcyIdx][gridIndexInPath_[i + 1]];
-                Real logEq = sample.value[eqIndex][gridIndexInPath_[i + 1]];
+                Real z_eqIr = path[eqCcyIdx][pIdx];
+                Real logEq = path[eqIndex][pIdx];
                 eqVols_[k]->move(dates_[i], z_eqIr, logEq);
 
                 for (Size j = 0; j < expiries.size(); j++) {
-                    Real vol = eqVols_[k]->blackVol(dates_[i] + expiries[j], Null<Real>(), true);
-                    scenarios[i]->add(RiskFactorKey(RiskFactorKey::KeyType::EquityVolatility, equityName, j), vol);
+                    *v++ = eqVols_[k]->blackVol(dates_[i] + expiries[j], Null<Real>(), true);
                 }
             }
         }
@@ -534,16 +634,12 @@ std::vector<QuantLib::ext::shared_ptr<Scenario>> CrossAssetModelScenarioGenerato
                 const vector<Period>& expires = simMarketConfig_->swapVolExpiries(key);
                 const vector<Period>& terms = simMarketConfig_->swapVolTerms(key);
 
-                // ext::shared_ptr<YieldTermStructure> dts = curves_[swaptionVols_[k]->ccyIndex()];
-                // ext::shared_ptr<YieldTermStructure> fts = fwdCurves_[swaptionVols_[k]->indexIndex()];
                 // Update the implied swaption vols
                 swaptionVols_[k]->move(dates_[i], ir_state[0][0]);
 
                 for (Size j = 0; j < expires.size(); j++) {
                     for (Size jj = 0; jj < terms.size(); jj++) {
-                        Real vol = swaptionVols_[k]->volatility(dates_[i] + expires[j], terms[jj], Null<Real>(), true);
-                        Size idx = j * terms.size() + jj;
-                        scenarios[i]->add(RiskFactorKey(RiskFactorKey::KeyType::SwaptionVolatility, key, idx), vol);
+                        *v++ = swaptionVols_[k]->volatility(dates_[i] + expires[j], terms[jj], Null<Real>(), true);
                     }
                 }
             }
@@ -553,39 +649,33 @@ std::vector<QuantLib::ext::shared_ptr<Scenario>> CrossAssetModelScenarioGenerato
         for (Size j = 0; j < n_inf_; j++) {
 
             // Depending on type of model, i.e. DK or JY, z and y mean different things.
-            Real z = sample.value[model_->pIdx(CrossAssetModel::AssetType::INF, j, 0)][gridIndexInPath_[i + 1]];
-            Real y = sample.value[model_->pIdx(CrossAssetModel::AssetType::INF, j, 1)][gridIndexInPath_[i + 1]];
+            Real z = path[model_->pIdx(CrossAssetModel::AssetType::INF, j, 0)][pIdx];
+            Real y = path[model_->pIdx(CrossAssetModel::AssetType::INF, j, 1)][pIdx];
 
-            // Could possibly cache the model type outside the loop to improve performance.
             Real cpi = 0.0;
             if (model_->modelType(CrossAssetModel::AssetType::INF, j) == CrossAssetModel::ModelType::JY) {
-                cpi = std::exp(
-                    sample.value[model_->pIdx(CrossAssetModel::AssetType::INF, j, 1)][gridIndexInPath_[i + 1]]);
+                cpi = std::exp(y);
             } else if (model_->modelType(CrossAssetModel::AssetType::INF, j) == CrossAssetModel::ModelType::DK) {
-                auto index = *initMarket_->zeroInflationIndex(model_->inf(j)->name());
-                Date baseDate = index->zeroInflationTermStructure()->baseDate();
-                auto zts = index->zeroInflationTermStructure();
-                Time relativeTime = inflationYearFraction(zts->frequency(), false, zts->dayCounter(), baseDate,
-                                                          dates_[i] - zts->observationLag());
+                Time relativeTime = t_cpiDk_[i][j];
                 std::tie(cpi, std::ignore) = model_->infdkI(j, relativeTime, relativeTime, z, y);
-                cpi *= index->fixing(baseDate);
+                cpi *= cpiDkBaseFixing_[j];
             } else {
                 QL_FAIL("CrossAssetModelScenarioGenerator: expected inflation model to be JY or DK.");
             }
 
-            scenarios[i]->add(cpiKeys_[j], cpi);
+            *v++ = cpi;
         }
 
         // Zero inflation curves
         for (Size j = 0; j < zeroInfCurves_.size(); ++j) {
 
-            auto tup = zeroInfCurves_[j];
+            auto const& tup = zeroInfCurves_[j];
 
             // State variables needed depends on model, 3 for JY and 2 for DK.
             auto idx = std::get<0>(tup);
             Array state(3);
-            state[0] = sample.value[model_->pIdx(CrossAssetModel::AssetType::INF, idx, 0)][gridIndexInPath_[i + 1]];
-            state[1] = sample.value[model_->pIdx(CrossAssetModel::AssetType::INF, idx, 1)][gridIndexInPath_[i + 1]];
+            state[0] = path[model_->pIdx(CrossAssetModel::AssetType::INF, idx, 0)][pIdx];
+            state[1] = path[model_->pIdx(CrossAssetModel::AssetType::INF, idx, 1)][pIdx];
             if (std::get<2>(tup) == CrossAssetModel::ModelType::DK) {
                 state.resize(2);
             } else {
@@ -597,104 +687,77 @@ std::vector<QuantLib::ext::shared_ptr<Scenario>> CrossAssetModelScenarioGenerato
             ts->move(dates_[i], state);
 
             // Populate the zero inflation scenario values based on the current date and state.
-            for (Size k = 0; k < ten_zinf_[j].size(); k++) {
-                Time T = dc.yearFraction(dates_[i], dates_[i] + ten_zinf_[j][k]);
-                scenarios[i]->add(zeroInflationKeys_[j * ten_zinf_[j].size() + k], ts->zeroRate(T));
-            }
+            for (auto const T : t_zinf_[i][j])
+                *v++ = ts->zeroRate(T);
         }
 
         // YoY inflation curves
         for (Size j = 0; j < yoyInfCurves_.size(); ++j) {
 
-            auto tup = yoyInfCurves_[j];
+            auto const& tup = yoyInfCurves_[j];
 
             // For YoY model implied term structure, JY and DK both need 3 state variables.
             auto idx = std::get<0>(tup);
             Array state(3);
-            state[0] = sample.value[model_->pIdx(CrossAssetModel::AssetType::INF, idx, 0)][gridIndexInPath_[i + 1]];
-            state[1] = sample.value[model_->pIdx(CrossAssetModel::AssetType::INF, idx, 1)][gridIndexInPath_[i + 1]];
+            state[0] = path[model_->pIdx(CrossAssetModel::AssetType::INF, idx, 0)][pIdx];
+            state[1] = path[model_->pIdx(CrossAssetModel::AssetType::INF, idx, 1)][pIdx];
             state[2] = ir_state[std::get<1>(tup)][0];
 
             // Update the term structure's date and state.
             auto ts = std::get<3>(tup);
             ts->move(dates_[i], state);
 
-            // Create the YoY pillar dates from the tenors.
-            vector<Date> pillarDates(ten_yinf_[j].size());
-            for (Size k = 0; k < pillarDates.size(); ++k)
-                pillarDates[k] = dates_[i] + ten_yinf_[j][k];
-
             // Use the YoY term structure's YoY rates to populate the scenarios.
+            const vector<Date>& pillarDates = pillarDates_yinf_[i][j];
             auto yoyRates = ts->yoyRates(pillarDates);
-            for (Size k = 0; k < pillarDates.size(); ++k) {
-                scenarios[i]->add(yoyInflationKeys_[j * ten_yinf_[j].size() + k], yoyRates.at(pillarDates[k]));
-            }
+            for (Size k = 0; k < pillarDates.size(); ++k)
+                *v++ = yoyRates.at(pillarDates[k]);
         }
 
         // Credit curves
         for (Size j = 0; j < n_cr_; ++j) {
             if (model_->modelType(CrossAssetModel::AssetType::CR, j) == CrossAssetModel::ModelType::LGM1F) {
-                Real z = sample.value[model_->pIdx(CrossAssetModel::AssetType::CR, j, 0)][gridIndexInPath_[i + 1]];
-                Real y = sample.value[model_->pIdx(CrossAssetModel::AssetType::CR, j, 1)][gridIndexInPath_[i + 1]];
+                Real z = path[model_->pIdx(CrossAssetModel::AssetType::CR, j, 0)][pIdx];
+                Real y = path[model_->pIdx(CrossAssetModel::AssetType::CR, j, 1)][pIdx];
                 lgmDefaultCurves_[j]->move(dates_[i], z, y);
-                for (Size k = 0; k < ten_dfc_[j].size(); k++) {
-                    Date d = dates_[i] + ten_dfc_[j][k];
-                    Time T = dc.yearFraction(dates_[i], d);
-                    Real survProb = std::max(lgmDefaultCurves_[j]->survivalProbability(T), 0.00001);
-                    scenarios[i]->add(defaultCurveKeys_[j * ten_dfc_[j].size() + k], survProb);
-                }
+                for (auto const T : t_dfc_[i][j])
+                    *v++ = std::max(lgmDefaultCurves_[j]->survivalProbability(T), 0.00001);
             } else if (model_->modelType(CrossAssetModel::AssetType::CR, j) == CrossAssetModel::ModelType::CIRPP) {
-                Real y = sample.value[model_->pIdx(CrossAssetModel::AssetType::CR, j, 0)][gridIndexInPath_[i + 1]];
+                Real y = path[model_->pIdx(CrossAssetModel::AssetType::CR, j, 0)][pIdx];
                 cirppDefaultCurves_[j]->move(dates_[i], y);
-                for (Size k = 0; k < ten_dfc_[j].size(); k++) {
-                    Date d = dates_[i] + ten_dfc_[j][k];
-                    Time T = dc.yearFraction(dates_[i], d);
-                    Real survProb = std::max(cirppDefaultCurves_[j]->survivalProbability(T), 0.00001);
-                    scenarios[i]->add(defaultCurveKeys_[j * ten_dfc_[j].size() + k], survProb);
-                }
+                for (auto const T : t_dfc_[i][j])
+                    *v++ = std::max(cirppDefaultCurves_[j]->survivalProbability(T), 0.00001);
             }
         }
 
         // Commodity curves
         Array comState(1, 0.0); // FIXME: single-factor for now
         for (Size j = 0; j < n_com_; j++) {
-            comState[0] = sample.value[model_->pIdx(CrossAssetModel::AssetType::COM, j)][gridIndexInPath_[i + 1]];
+            comState[0] = path[model_->pIdx(CrossAssetModel::AssetType::COM, j)][pIdx];
             comCurves_[j]->move(t, comState);
-            for (Size k = 0; k < ten_com_[j].size(); k++) {
-                Date d = dates_[i] + ten_com_[j][k];
-                Time T = dc.yearFraction(dates_[i], d);
-                Real price = std::max(comCurves_[j]->price(T), 0.00001);
-                scenarios[i]->add(commodityCurveKeys_[j * ten_com_[j].size() + k], price);
-            }
+            for (auto const T : t_com_[i][j])
+                *v++ = std::max(comCurves_[j]->price(T), 0.00001);
         }
 
         // Credit States
         for (Size k = 0; k < n_crstates_; ++k) {
-            Real z = sample.value[model_->pIdx(CrossAssetModel::AssetType::CrState, k)][gridIndexInPath_[i + 1]];
-            scenarios[i]->add(crStateKeys_[k], z);
+            *v++ = path[model_->pIdx(CrossAssetModel::AssetType::CrState, k)][pIdx];
         }
 
         // Survival Weights, stochastic cumulative survival probability, Recovery Rates
         for (Size k = 0; k < n_survivalweights_; ++k) {
-            string name = simMarketConfig_->additionalScenarioDataSurvivalWeights()[k];
             Real rr = survivalWeightsDefaultCurves_[k]->recovery().empty()
                           ? 0.0
                           : survivalWeightsDefaultCurves_[k]->recovery()->value();
-            scenarios[i]->add(survivalWeightKeys_[k],
-                              survivalWeightsDefaultCurves_[k]->curve()->survivalProbability(dates_[i]));
-            scenarios[i]->add(recoveryRateKeys_[k], rr);
+            *v++ = survivalWeightsDefaultCurves_[k]->curve()->survivalProbability(dates_[i]);
+            *v++ = rr;
         }
-    }
 
-    if (totalSamples_ == currentSample_ && !amcPathDataOutput_.empty()) {
-        LOG("Serialize paths, fx and irState buffers to'" << amcPathDataOutput_ << "'");
-        std::ofstream os(amcPathDataOutput_, std::ios::binary);
-        boost::archive::binary_oarchive oa(os, boost::archive::no_header);
-        oa << pathData_;
-        os.close();
+        QL_REQUIRE(v == values.data() + (i + 1) * keys_.size(),
+                   "CrossAssetModelScenarioGenerator: internal error, number of generated values does not match "
+                   "number of keys ("
+                       << keys_.size() << ")");
     }
-
-    return scenarios;
 }
 
 void CrossAssetModelScenarioGenerator::reset() {
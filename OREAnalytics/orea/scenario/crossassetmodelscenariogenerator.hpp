@@ -81,6 +81,9 @@ public:
     void reset() override;
 
 private:
+    Sample<MultiPath> nextSample();
+    void generatePath(const MultiPath& path, std::vector<Real>& numeraire, std::vector<Real>& values);
+
     QuantLib::ext::shared_ptr<QuantExt::CrossAssetModel> model_;
     QuantLib::ext::shared_ptr<QuantExt::MultiPathGeneratorBase> pathGenerator_;
     QuantLib::ext::shared_ptr<ScenarioFactory> scenarioFactory_;
@@ -116,6 +119,17 @@ private:
     Size currentSample_ = 0;
     Size totalSamples_;
     std::vector<Size> gridIndexInPath_;
+
+    // keys in the order of the generated values, precomputed tenor times (date, curve, tenor)
+    std::vector<RiskFactorKey> keys_;
+    std::vector<std::vector<std::vector<Time>>> t_dsc_, t_idx_, t_yc_, t_zinf_, t_dfc_, t_com_;
+    std::vector<std::vector<std::vector<Date>>> pillarDates_yinf_;
+    std::vector<std::vector<Time>> t_cpiDk_;
+    std::vector<Real> cpiDkBaseFixing_;
+    std::vector<Size> indexCcyIdx_, yieldCurveCcyIdx_;
+
+    // buffers for generatePath(), values are stored as (date, key)
+    std::vector<Real> numeraireBuffer_, valueBuffer_;
 };
 
 } // namespace analytics
@@ -0,0 +1,321 @@
+/*
+ Copyright (C) 2025 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/scenario/scenariobinaryreader.hpp>
+
+#include <ored/utilities/log.hpp>
+#include <ored/utilities/to_string.hpp>
+
+#include <ql/errors.hpp>
+
+#include <boost/functional/hash.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+
+using namespace QuantLib;
+
+namespace ore {
+namespace analytics {
+
+namespace {
+
+/* binary scenario file layout
+
+   header : magic, version, endianness, number of keys, number of scenarios, offset of the scenario index,
+            absolute and par flags, keys as strings
+   data   : (scenario, key) matrix of doubles with keys running fastest, starting at a multiple of 64 bytes
+   index  : per scenario date serial number, numeraire and label
+
+   The number of scenarios and the offset of the index are patched after the data block is written, so that the
+   scenarios can be written while they are read from the source. */
+
+constexpr char binaryScenarioMagic[8] = {'O', 'R', 'E', 'S', 'C', 'E', 'N', '\0'};
+constexpr std::uint32_t binaryScenarioVersion = 1;
+constexpr std::uint32_t binaryScenarioEndianness = 0x01020304;
+constexpr std::size_t binaryScenarioAlignment = 64;
+constexpr std::size_t numScenariosOffset = 24;
+
+template <typename V> void writeBinary(std::ostream& out, const V& v) {
+    out.write(reinterpret_cast<const char*>(&v), sizeof(V));
+}
+
+void writeBinary(std::ostream& out, const std::string& s) {
+    writeBinary(out, static_cast<std::uint64_t>(s.size()));
+    out.write(s.data(), s.size());
+}
+
+class BinaryReader {
+public:
+    BinaryReader(const char* data, std::size_t size, std::size_t offset = 0)
+        : data_(data), size_(size), offset_(offset) {}
+    template <typename V> V read() {
+        QL_REQUIRE(offset_ + sizeof(V) <= size_, "ScenarioBinaryReader: unexpected end of file");
+        V v;
+        std::memcpy(&v, data_ + offset_, sizeof(V));
+        offset_ += sizeof(V);
+        return v;
+    }
+    std::string readString() {
+        std::uint64_t n = read<std::uint64_t>();
+        QL_REQUIRE(offset_ + n <= size_, "ScenarioBinaryReader: unexpected end of file");
+        std::string s(data_ + offset_, n);
+        offset_ += n;
+        return s;
+    }
+    std::size_t offset() const { return offset_; }
+
+private:
+    const char* data_;
+    std::size_t size_;
+    std::size_t offset_;
+};
+
+} // namespace
+
+ScenarioBinaryReader::ScenarioBinaryReader(const std::string& filename)
+    : sharedData_(QuantLib::ext::make_shared<SimpleScenario::SharedData>()), current_(0) {
+
+    file_ = QuantLib::ext::make_shared<boost::iostreams::mapped_file_source>(filename);
+    QL_REQUIRE(file_->is_open(), "ScenarioBinaryReader: could not map file '" << filename << "'");
+
+    BinaryReader in(file_->data(), file_->size());
+
+    for (Size i = 0; i < sizeof(binaryScenarioMagic); ++i)
+        QL_REQUIRE(in.read<char>() == binaryScenarioMagic[i],
+                   "ScenarioBinaryReader: file '" << filename << "' is not a binary scenario file");
+    auto version = in.read<std::uint32_t>();
+    QL_REQUIRE(version == binaryScenarioVersion, "ScenarioBinaryReader: binary scenario file version "
+                                                     << version << " not supported, expected "
+                                                     << binaryScenarioVersion);
+    QL_REQUIRE(in.read<std::uint32_t>() == binaryScenarioEndianness,
+               "ScenarioBinaryReader: file '" << filename << "' was written on a platform with different endianness");
+    Size numKeys = in.read<std::uint64_t>();
+    Size numScenarios = in.read<std::uint64_t>();
+    std::size_t indexOffset = in.read<std::uint64_t>();
+    isAbsolute_ = in.read<std::uint8_t>() != 0;
+    isPar_ = in.read<std::uint8_t>() != 0;
+
+    sharedData_->keys.reserve(numKeys);
+    for (Size k = 0; k < numKeys; ++k) {
+        RiskFactorKey key = QuantExt::parseRiskFactorKey(in.readString());
+        QL_REQUIRE(sharedData_->keyIndex.emplace(key, k).second,
+                   "ScenarioBinaryReader: duplicate key " << key << " in file '" << filename << "'");
+        sharedData_->keys.push_back(key);
+        boost::hash_combine(sharedData_->keysHash, key);
+    }
+
+    std::size_t dataOffset =
+        (in.offset() + binaryScenarioAlignment - 1) / binaryScenarioAlignment * binaryScenarioAlignment;
+    QL_REQUIRE(dataOffset + sizeof(double) * numKeys * numScenarios <= indexOffset && indexOffset <= file_->size(),
+               "ScenarioBinaryReader: file size (" << file_->size() << ") is too small for " << numScenarios
+                                                   << " scenarios with " << numKeys << " keys");
+    data_ = reinterpret_cast<const double*>(file_->data() + dataOffset);
+
+    BinaryReader index(file_->data(), file_->size(), indexOffset);
+    dates_.reserve(numScenarios);
+    numeraires_.reserve(numScenarios);
+    labels_.reserve(numScenarios);
+    for (Size i = 0; i < numScenarios; ++i) {
+        dates_.push_back(Date(static_cast<Date::serial_type>(index.read<std::int64_t>())));
+        numeraires_.push_back(index.read<double>());
+        labels_.push_back(index.readString());
+    }
+
+    LOG("ScenarioBinaryReader: mapped " << numScenarios << " scenarios with " << numKeys << " keys from "
+                                        << filename);
+}
+
+bool ScenarioBinaryReader::next() {
+    // current_ is one past the current scenario, 0 before the first call to next()
+    if (current_ <= dates_.size())
+        ++current_;
+    return current_ <= dates_.size();
+}
+
+Date ScenarioBinaryReader::date() const {
+    if (current_ == 0 || current_ > dates_.size())
+        return Null<Date>();
+    return dates_[current_ - 1];
+}
+
+QuantLib::ext::shared_ptr<Scenario> ScenarioBinaryReader::scenario() const {
+    if (current_ == 0 || current_ > dates_.size())
+        return nullptr;
+    return scenario(current_ - 1);
+}
+
+Real ScenarioBinaryReader::value(Size i, Size k) const {
+    QL_REQUIRE(i < dates_.size(), "ScenarioBinaryReader::value(): scenario index " << i << " out of range, have "
+                                                                                   << dates_.size() << " scenarios");
+    QL_REQUIRE(k < sharedData_->keys.size(), "ScenarioBinaryReader::value(): key index "
+                                                 << k << " out of range, have " << sharedData_->keys.size()
+                                                 << " keys");
+    return data_[i * sharedData_->keys.size() + k];
+}
+
+QuantLib::ext::shared_ptr<Scenario> ScenarioBinaryReader::scenario(Size i) const {
+    QL_REQUIRE(i < dates_.size(), "ScenarioBinaryReader::scenario(): scenario index "
+                                      << i << " out of range, have " << dates_.size() << " scenarios");
+    Size numKeys = sharedData_->keys.size();
+    const double* row = data_ + i * numKeys;
+    bool complete = std::none_of(row, row + numKeys, [](const double v) { return std::isnan(v); });
+
+    QuantLib::ext::shared_ptr<SimpleScenario> scenario;
+    if (complete) {
+        scenario = QuantLib::ext::make_shared<SimpleScenario>(dates_[i], labels_[i], numeraires_[i], sharedData_);
+        scenario->setData(std::vector<Real>(row, row + numKeys));
+    } else {
+        scenario = QuantLib::ext::make_shared<SimpleScenario>(dates_[i], labels_[i], numeraires_[i]);
+        for (Size k = 0; k < numKeys; ++k) {
+            if (!std::isnan(row[k]))
+                scenario->add(sharedData_->keys[k], row[k]);
+        }
+    }
+    scenario->setAbsolute(isAbsolute_);
+    scenario->setPar(isPar_);
+    return scenario;
+}
+
+bool isBinaryScenarioFile(const std::string& filename) {
+    std::ifstream in(filename, std::ios::binary | std::ios::in);
+    char magic[sizeof(binaryScenarioMagic)];
+    if (!in.read(magic, sizeof(magic)))
+        return false;
+    return std::memcmp(magic, binaryScenarioMagic, sizeof(magic)) == 0;
+}
+
+void saveScenariosBinary(const std::string& filename, ScenarioReader& reader, const std::vector<RiskFactorKey>& keys) {
+
+    std::ofstream out(filename, std::ios::binary | std::ios::out);
+    QL_REQUIRE(out.is_open(), "saveScenariosBinary(): could not open file '" << filename << "'");
+
+    std::vector<RiskFactorKey> columns = keys;
+    std::map<RiskFactorKey, Size> columnIndex;
+    std::vector<Date> dates;
+    std::vector<Real> numeraires;
+    std::vector<std::string> labels;
+    std::vector<double> row;
+    std::size_t offset = 0;
+    bool isAbsolute = true, isPar = false;
+
+    // position of the scenario keys in the columns, cached by the keys hash of the scenario; a zero hash means the
+    // scenario does not provide one, in this case the positions are recomputed for each scenario
+    std::size_t keysHash = 0;
+    std::vector<Size> positions;
+
+    const double missing = std::numeric_limits<double>::quiet_NaN();
+
+    while (reader.next()) {
+        auto s = reader.scenario();
+        QL_REQUIRE(s, "saveScenariosBinary(): reader returned null scenario");
+
+        if (dates.empty()) {
+
+            // write the header, using the flags of the first scenario
+
+            if (columns.empty())
+                columns = s->keys();
+            for (Size k = 0; k < columns.size(); ++k)
+                QL_REQUIRE(columnIndex.emplace(columns[k], k).second,
+                           "saveScenariosBinary(): duplicate key " << columns[k]);
+
+            out.write(binaryScenarioMagic, sizeof(binaryScenarioMagic));
+            writeBinary(out, binaryScenarioVersion);
+            writeBinary(out, binaryScenarioEndianness);
+            writeBinary(out, static_cast<std::uint64_t>(columns.size()));
+            writeBinary(out, static_cast<std::uint64_t>(0));
+            writeBinary(out, static_cast<std::uint64_t>(0));
+            writeBinary(out, static_cast<std::uint8_t>(s->isAbsolute() ? 1 : 0));
+            writeBinary(out, static_cast<std::uint8_t>(s->isPar() ? 1 : 0));
+            for (auto const& k : columns)
+                writeBinary(out, ore::data::to_string(k));
+            offset = static_cast<std::size_t>(out.tellp());
+            static const char zeros[binaryScenarioAlignment] = {};
+            std::size_t dataOffset =
+                (offset + binaryScenarioAlignment - 1) / binaryScenarioAlignment * binaryScenarioAlignment;
+            out.write(zeros, dataOffset - offset);
+            offset = dataOffset;
+        }
+
+        if (dates.empty()) {
+            isAbsolute = s->isAbsolute();
+            isPar = s->isPar();
+        }
+        QL_REQUIRE(s->isAbsolute() == isAbsolute && s->isPar() == isPar,
+                   "saveScenariosBinary(): scenarios must be all absolute or all relative and all par or all zero");
+
+        if (dates.empty() || s->keysHash() == 0 || s->keysHash() != keysHash ||
+            s->keys().size() != positions.size()) {
+            keysHash = s->keysHash();
+            positions.resize(s->keys().size());
+            for (Size k = 0; k < s->keys().size(); ++k) {
+                auto c = columnIndex.find(s->keys()[k]);
+                QL_REQUIRE(c != columnIndex.end(), "saveScenariosBinary(): key "
+                                                       << s->keys()[k] << " in scenario for " << s->asof()
+                                                       << " is not in the columns of the file");
+                positions[k] = c->second;
+            }
+        }
+
+        // for a SimpleScenario write the raw values, i.e. without the sanitization applied by SimpleScenario::get(),
+        // other scenario types do not expose their raw values, so we write the values returned by get()
+
+        row.assign(columns.size(), missing);
+        if (auto ss = QuantLib::ext::dynamic_pointer_cast<SimpleScenario>(s)) {
+            for (Size k = 0; k < positions.size() && k < ss->data().size(); ++k)
+                if (ss->data()[k] != Null<Real>())
+                    row[positions[k]] = ss->data()[k];
+        } else {
+            for (Size k = 0; k < positions.size(); ++k)
+                row[positions[k]] = s->get(s->keys()[k]);
+        }
+        out.write(reinterpret_cast<const char*>(row.data()), sizeof(double) * row.size());
+
+        dates.push_back(s->asof());
+        numeraires.push_back(s->getNumeraire());
+        labels.push_back(s->label());
+    }
+
+    QL_REQUIRE(!dates.empty(), "saveScenariosBinary(): no scenarios to write to file '" << filename << "'");
+
+    // write the index and patch the number of scenarios and the index offset in the header
+
+    std::uint64_t indexOffset = static_cast<std::uint64_t>(out.tellp());
+    for (Size i = 0; i < dates.size(); ++i) {
+        writeBinary(out, static_cast<std::int64_t>(dates[i].serialNumber()));
+        writeBinary(out, static_cast<double>(numeraires[i]));
+        writeBinary(out, labels[i]);
+    }
+    out.seekp(numScenariosOffset);
+    writeBinary(out, static_cast<std::uint64_t>(dates.size()));
+    writeBinary(out, indexOffset);
+
+    QL_REQUIRE(out.good(), "saveScenariosBinary(): error while writing scenarios to file '" << filename << "'");
+
+    LOG("saveScenariosBinary(): wrote " << dates.size() << " scenarios with " << columns.size() << " keys to "
+                                        << filename);
+}
+
+} // namespace analytics
+} // namespace ore
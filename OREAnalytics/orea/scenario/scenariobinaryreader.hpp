@@ -0,0 +1,92 @@
+/*
+ Copyright (C) 2025 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/scenario/scenariobinaryreader.hpp
+    \brief Class for reading historical scenarios from a memory mapped binary file
+    \ingroup scenario
+*/
+
+#pragma once
+
+#include <orea/scenario/scenarioreader.hpp>
+#include <orea/scenario/simplescenario.hpp>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <string>
+#include <vector>
+
+namespace ore {
+namespace analytics {
+
+//! Class for reading scenarios from a binary scenario file
+/*! The file is memory mapped, on construction only the header, i.e. the risk factor keys and the dates, numeraires
+    and labels of the scenarios are read. The values of a scenario are read from the mapped file when the scenario is
+    requested, so that the memory used is proportional to the scenarios that are actually used.
+
+    The values are stored as a dense (scenario, key) matrix with keys running fastest. Missing values are stored as
+    NaN. Scenarios without missing values share one SimpleScenario::SharedData block holding the keys of the file,
+    scenarios with missing values only contain the keys with a value, as the scenarios read by a ScenarioCSVReader.
+
+    Files in this format can be written with saveScenariosBinary().
+*/
+class ScenarioBinaryReader : public ScenarioReader {
+public:
+    explicit ScenarioBinaryReader(const std::string& filename);
+
+    //! Return true if there is another Scenario to read and move to it
+    bool next() override;
+    //! Return the current scenario's date if reader is still valid and `Null<Date>()` otherwise
+    QuantLib::Date date() const override;
+    //! Return the current scenario if reader is still valid and `nullptr` otherwise
+    QuantLib::ext::shared_ptr<Scenario> scenario() const override;
+
+    //! \name Random access to the scenarios in the file
+    //@{
+    QuantLib::Size numScenarios() const { return dates_.size(); }
+    const std::vector<RiskFactorKey>& keys() const { return sharedData_->keys; }
+    const std::vector<QuantLib::Date>& dates() const { return dates_; }
+    QuantLib::ext::shared_ptr<Scenario> scenario(QuantLib::Size i) const;
+    //! The value for scenario i and key k, NaN if the file does not contain a value
+    QuantLib::Real value(QuantLib::Size i, QuantLib::Size k) const;
+    //@}
+
+private:
+    QuantLib::ext::shared_ptr<boost::iostreams::mapped_file_source> file_;
+    QuantLib::ext::shared_ptr<SimpleScenario::SharedData> sharedData_;
+    bool isAbsolute_, isPar_;
+    std::vector<QuantLib::Date> dates_;
+    std::vector<QuantLib::Real> numeraires_;
+    std::vector<std::string> labels_;
+    const double* data_;
+    QuantLib::Size current_;
+};
+
+//! Returns true if the file is a binary scenario file as written by saveScenariosBinary()
+bool isBinaryScenarioFile(const std::string& filename);
+
+/*! Writes all scenarios provided by \p reader to \p filename in the format read by ScenarioBinaryReader. The columns
+    of the file are given by \p keys, if empty, they are taken from the first scenario. Scenarios must not contain keys
+    that are not in the columns of the file, keys without a value in a scenario are stored as missing values.
+
+    To convert a csv scenario file use a ScenarioFileReader and its keys(). */
+void saveScenariosBinary(const std::string& filename, ScenarioReader& reader,
+                         const std::vector<RiskFactorKey>& keys = {});
+
+} // namespace analytics
+} // namespace ore
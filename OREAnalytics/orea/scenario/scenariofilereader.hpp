@@ -49,6 +49,8 @@ public:
     QuantLib::Date date() const override;
     //! Return the current scenario if reader is still valid and `nullptr` otherwise
     QuantLib::ext::shared_ptr<Scenario> scenario() const override;
+    //! The risk factor keys of the scenarios in the file
+    const std::vector<RiskFactorKey>& keys() const { return keys_; }
 
 protected:
     //! Scenario factory
@@ -3561,48 +3561,112 @@ void ScenarioSimMarket::postUpdate(const Date& d, bool withFixings) {
         fixingManager_->update(d);
 }
 
+void ScenarioSimMarket::resolveAsdTargets() {
+    asdIndices_.clear();
+    asdFxSpots_.clear();
+    asdScenarioTargets_.clear();
+    asdScenarioPositions_.clear();
+    asdKeysHash_ = 0;
+
+    for (auto const& i : parameters_->additionalScenarioDataIndices()) {
+        QuantLib::ext::shared_ptr<QuantLib::Index> index;
+        try {
+            index = *iborIndex(i);
+        } catch (...) {
+        }
+        try {
+            index = *swapIndex(i);
+        } catch (...) {
+        }
+        QL_REQUIRE(index != nullptr, "ScenarioSimMarket::update() index " << i << " not found in sim market");
+        if (auto fb = QuantLib::ext::dynamic_pointer_cast<FallbackIborIndex>(index)) {
+            // proxy fallback ibor index by its rfr index's fixing
+            index = fb->rfrIndex();
+        }
+        asdIndices_.push_back(std::make_pair(i, index));
+    }
+
+    for (auto const& c : parameters_->additionalScenarioDataCcys()) {
+        if (c != parameters_->baseCcy())
+            asdFxSpots_.push_back(std::make_pair(c, fxSpot(c + parameters_->baseCcy())));
+    }
+
+    for (Size i = 0; i < parameters_->additionalScenarioDataNumberOfCreditStates(); ++i) {
+        asdScenarioTargets_.push_back({RiskFactorKey(RiskFactorKey::KeyType::CreditState, std::to_string(i)),
+                                       AggregationScenarioDataType::CreditState, std::to_string(i)});
+    }
+
+    for (const auto& n : parameters_->additionalScenarioDataSurvivalWeights()) {
+        asdScenarioTargets_.push_back(
+            {RiskFactorKey(RiskFactorKey::KeyType::SurvivalWeight, n), AggregationScenarioDataType::SurvivalWeight, n});
+        asdScenarioTargets_.push_back(
+            {RiskFactorKey(RiskFactorKey::KeyType::RecoveryRate, n), AggregationScenarioDataType::RecoveryRate, n});
+    }
+
+    asdTargetsResolved_ = true;
+}
+
 void ScenarioSimMarket::updateAsd(const Date& d) {
     if (asd_) {
+        if (!asdTargetsResolved_)
+            resolveAsdTargets();
+
+        // register the keys once per container, the values are then set by handle
+
+        if (asdHandlesData_.lock() != asd_) {
+            asdIndexHandles_.clear();
+            asdFxSpotHandles_.clear();
+            asdScenarioTargetHandles_.clear();
+            for (auto const& [name, index] : asdIndices_)
+                asdIndexHandles_.push_back(asd_->registerKey(AggregationScenarioDataType::IndexFixing, name));
+            for (auto const& [ccy, fx] : asdFxSpots_)
+                asdFxSpotHandles_.push_back(asd_->registerKey(AggregationScenarioDataType::FXSpot, ccy));
+            for (auto const& t : asdScenarioTargets_)
+                asdScenarioTargetHandles_.push_back(asd_->registerKey(t.type, t.name));
+            asdNumeraireHandle_ = asd_->registerKey(AggregationScenarioDataType::Numeraire);
+            asdHandlesData_ = asd_;
+        }
+
         // add additional scenario data to the given container, if required
-        for (auto i : parameters_->additionalScenarioDataIndices()) {
-            QuantLib::ext::shared_ptr<QuantLib::Index> index;
-            try {
-                index = *iborIndex(i);
-            } catch (...) {
-            }
-            try {
-                index = *swapIndex(i);
-            } catch (...) {
-            }
-            QL_REQUIRE(index != nullptr, "ScenarioSimMarket::update() index " << i << " not found in sim market");
-            if (auto fb = QuantLib::ext::dynamic_pointer_cast<FallbackIborIndex>(index)) {
-                // proxy fallback ibor index by its rfr index's fixing
-                index = fb->rfrIndex();
-            }
-            asd_->set(index->fixing(index->fixingCalendar().adjust(d)), AggregationScenarioDataType::IndexFixing, i);
+        for (Size i = 0; i < asdIndices_.size(); ++i) {
+            auto const& index = asdIndices_[i].second;
+            asd_->set(index->fixing(index->fixingCalendar().adjust(d)), asdIndexHandles_[i]);
         }
 
-        for (auto c : parameters_->additionalScenarioDataCcys()) {
-            if (c != parameters_->baseCcy())
-                asd_->set(fxSpot(c + parameters_->baseCcy())->value(), AggregationScenarioDataType::FXSpot, c);
+        for (Size i = 0; i < asdFxSpots_.size(); ++i) {
+            asd_->set(asdFxSpots_[i].second->value(), asdFxSpotHandles_[i]);
         }
 
-        for (Size i = 0; i < parameters_->additionalScenarioDataNumberOfCreditStates(); ++i) {
-            RiskFactorKey key(RiskFactorKey::KeyType::CreditState, std::to_string(i));
-            QL_REQUIRE(currentScenario_->has(key), "scenario does not have key " << key);
-            asd_->set(currentScenario_->get(key), AggregationScenarioDataType::CreditState, std::to_string(i));
+        // for a SimpleScenario the values are read by position, the positions are determined once per keys hash, see
+        // applyScenario(), for other scenarios or if the keys hash is zero we fall back to a lookup by key
+
+        auto s = QuantLib::ext::dynamic_pointer_cast<SimpleScenario>(currentScenario_);
+        bool usePositions = s != nullptr && s->keysHash() != 0;
+        if (usePositions && s->keysHash() != asdKeysHash_) {
+            asdScenarioPositions_.clear();
+            for (auto const& t : asdScenarioTargets_) {
+                auto k = s->sharedData()->keyIndex.find(t.key);
+                QL_REQUIRE(k != s->sharedData()->keyIndex.end(), "scenario does not have key " << t.key);
+                asdScenarioPositions_.push_back(k->second);
+            }
+            asdKeysHash_ = s->keysHash();
         }
 
-        for (const auto& n : parameters_->additionalScenarioDataSurvivalWeights()) {
-            RiskFactorKey key(RiskFactorKey::KeyType::SurvivalWeight, n);
-            QL_REQUIRE(currentScenario_->has(key), "scenario does not have key " << key);
-            asd_->set(currentScenario_->get(key), AggregationScenarioDataType::SurvivalWeight, n);
-            RiskFactorKey rrKey(RiskFactorKey::KeyType::RecoveryRate, n);
-            QL_REQUIRE(currentScenario_->has(rrKey), "scenario does not have key " << key);
-            asd_->set(currentScenario_->get(rrKey), AggregationScenarioDataType::RecoveryRate, n);
+        for (Size i = 0; i < asdScenarioTargets_.size(); ++i) {
+            auto const& t = asdScenarioTargets_[i];
+            Real value;
+            if (usePositions && asdScenarioPositions_[i] < s->data().size()) {
+                value = s->data()[asdScenarioPositions_[i]];
+                if (s->isAbsolute())
+                    value = sanitizeScenarioValue(t.key.keytype, s->isPar(), value);
+            } else {
+                QL_REQUIRE(currentScenario_->has(t.key), "scenario does not have key " << t.key);
+                value = currentScenario_->get(t.key);
+            }
+            asd_->set(value, asdScenarioTargetHandles_[i]);
         }
 
-        asd_->set(numeraire_, AggregationScenarioDataType::Numeraire);
+        asd_->set(numeraire_, asdNumeraireHandle_);
 
         asd_->next();
     }
@@ -179,6 +179,9 @@ protected:
     /*! add a single swap index to the market */
     void addSwapIndexToSsm(const std::string& indexName);
 
+    /*! resolve the additional scenario data indices and fx spots and the scenario keys to read in updateAsd() */
+    void resolveAsdTargets();
+
     const QuantLib::ext::shared_ptr<ScenarioSimMarketParameters> parameters_;
     QuantLib::ext::shared_ptr<ScenarioGenerator> scenarioGenerator_;
     QuantLib::ext::shared_ptr<AggregationScenarioData> asd_;
@@ -210,6 +213,24 @@ protected:
     // for delta scenario application
     std::set<ore::analytics::RiskFactorKey> diffToBaseKeys_;
 
+    // additional scenario data targets, resolved once by resolveAsdTargets()
+    struct AsdScenarioTarget {
+        RiskFactorKey key;
+        AggregationScenarioDataType type;
+        std::string name;
+    };
+    bool asdTargetsResolved_ = false;
+    std::vector<std::pair<std::string, QuantLib::ext::shared_ptr<QuantLib::Index>>> asdIndices_;
+    std::vector<std::pair<std::string, QuantLib::Handle<QuantLib::Quote>>> asdFxSpots_;
+    std::vector<AsdScenarioTarget> asdScenarioTargets_;
+    // positions of the asd scenario targets in SimpleScenario::data() for scenarios with keys hash asdKeysHash_
+    std::vector<Size> asdScenarioPositions_;
+    std::size_t asdKeysHash_ = 0;
+    // handles of the index fixings, fx spots, scenario targets and numeraire in asdHandlesData_
+    QuantLib::ext::weak_ptr<AggregationScenarioData> asdHandlesData_;
+    std::vector<Size> asdIndexHandles_, asdFxSpotHandles_, asdScenarioTargetHandles_;
+    Size asdNumeraireHandle_ = 0;
+
     mutable QuantLib::ext::shared_ptr<Scenario> currentScenario_;
     QuantLib::ext::shared_ptr<Scenario> offsetScenario_;
     QuantLib::ext::shared_ptr<QuantExt::ScenarioInformationSetter> scenarioInformationSetter_;
@@ -64,6 +64,13 @@ QuantLib::ext::shared_ptr<Scenario> SimpleScenario::clone() const {
     return QuantLib::ext::make_shared<SimpleScenario>(*this);
 }
 
+void SimpleScenario::setData(std::vector<QuantLib::Real>&& data) {
+    QL_REQUIRE(data.size() == sharedData_->keys.size(), "SimpleScenario::setData(): data size ("
+                                                            << data.size() << ") does not match number of keys ("
+                                                            << sharedData_->keys.size() << ")");
+    data_ = std::move(data);
+}
+
 void SimpleScenario::setAbsolute(const bool isAbsolute) { isAbsolute_ = isAbsolute; }
 
 void SimpleScenario::setCoordinates(const RiskFactorKey::KeyType type, const std::string& name,
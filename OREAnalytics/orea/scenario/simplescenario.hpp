@@ -83,6 +83,9 @@ public:
     //! get data, order is the same as in keys()
     const std::vector<QuantLib::Real>& data() const { return data_; }
 
+    //! set data for all keys at once, order is the same as in keys()
+    void setData(std::vector<QuantLib::Real>&& data);
+
 private:
     QuantLib::ext::shared_ptr<SharedData> sharedData_;
     bool isAbsolute_ = true;
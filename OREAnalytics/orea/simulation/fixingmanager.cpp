@@ -39,6 +39,8 @@
 #include <ql/experimental/coupons/cmsspreadcoupon.hpp>
 #include <ql/experimental/coupons/digitalcmsspreadcoupon.hpp>
 
+#include <algorithm>
+
 using namespace std;
 using namespace QuantLib;
 using namespace QuantExt;
@@ -111,11 +113,21 @@ void FixingManager::initialise(const QuantLib::ext::shared_ptr<Portfolio>& portf
         }
     }
 
-    // Now cache the original fixings so we can re-write on reset()
+    // Now set up the required fixing dates per index and cache the original fixings so we can re-write on reset()
+    indexFixings_.clear();
     for (auto const& m : fixingMap_) {
+        IndexFixings f;
+        f.index = m.first;
+        f.requiredDates.assign(m.second.begin(), m.second.end());
+        // Fixing dates include the valuation grid dates which might not be valid fixing dates (BMA/SIFMA)
+        for (auto const& d : m.second) {
+            if (m.first->isValidFixingDate(d))
+                f.fixingDates.push_back(d);
+        }
         QL_DEPRECATED_DISABLE_WARNING
-        fixingCache_[m.first] = IndexManager::instance().getHistory(m.first->name());
+        f.originalHistory = IndexManager::instance().getHistory(m.first->name());
         QL_DEPRECATED_ENABLE_WARNING
+        indexFixings_.push_back(f);
     }
 }
 
@@ -135,8 +147,12 @@ void FixingManager::update(Date d) {
 void FixingManager::reset() {
     QL_DEPRECATED_DISABLE_WARNING
     if (modifiedFixingHistory_) {
-        for (auto& kv : fixingCache_)
-            IndexManager::instance().setHistory(kv.first->name(), kv.second);
+        for (auto& f : indexFixings_) {
+            if (f.modified) {
+                IndexManager::instance().setHistory(f.index->name(), f.originalHistory);
+                f.modified = false;
+            }
+        }
         modifiedFixingHistory_ = false;
     }
     QL_DEPRECATED_ENABLE_WARNING
@@ -145,18 +161,19 @@ void FixingManager::reset() {
 
 void FixingManager::applyFixings(Date start, Date end) {
     // Loop over all indices
-    for (auto const& m : fixingMap_) {
+    for (auto& f : indexFixings_) {
+        auto const& index = f.index;
         Date fixStart = start;
         Date fixEnd = end;
         Date currentFixingDate;
-        if (auto zii = QuantLib::ext::dynamic_pointer_cast<ZeroInflationIndex>(m.first)) {
+        if (auto zii = QuantLib::ext::dynamic_pointer_cast<ZeroInflationIndex>(index)) {
             fixStart =
                 inflationPeriod(fixStart - zii->zeroInflationTermStructure()->observationLag(), zii->frequency()).first;
             fixEnd =
                 inflationPeriod(fixEnd - zii->zeroInflationTermStructure()->observationLag(), zii->frequency()).first +
                 1;
             currentFixingDate = fixEnd;
-        } else if (auto yii = QuantLib::ext::dynamic_pointer_cast<YoYInflationIndex>(m.first)) {
+        } else if (auto yii = QuantLib::ext::dynamic_pointer_cast<YoYInflationIndex>(index)) {
             fixStart =
                 inflationPeriod(fixStart - yii->yoyInflationTermStructure()->observationLag(), yii->frequency()).first;
             fixEnd =
@@ -164,45 +181,34 @@ void FixingManager::applyFixings(Date start, Date end) {
                 1;
             currentFixingDate = fixEnd;
         } else {
-            currentFixingDate = m.first->fixingCalendar().adjust(fixEnd, Following);
+            currentFixingDate = index->fixingCalendar().adjust(fixEnd, Following);
             // This date is a business day but may not be a valid fixing date in case of BMA/SIFMA
-            if (!m.first->isValidFixingDate(currentFixingDate))
-                currentFixingDate = nextValidFixingDate(currentFixingDate, m.first);
+            if (!index->isValidFixingDate(currentFixingDate))
+                currentFixingDate = nextValidFixingDate(currentFixingDate, index);
         }
 
         // Add we have a coupon between start and asof.
-        bool needFixings = false;
-        for (auto const& d : m.second) {
-            if (d >= fixStart && d < fixEnd) {
-                needFixings = true;
-                break;
-            }
+        auto r0 = std::lower_bound(f.requiredDates.begin(), f.requiredDates.end(), fixStart);
+        if (r0 == f.requiredDates.end() || *r0 >= fixEnd)
+            continue;
+
+        Rate currentFixing;
+        if (auto comm = QuantLib::ext::dynamic_pointer_cast<QuantExt::CommodityIndex>(index);
+            comm != nullptr && comm->expiryDate() < currentFixingDate) {
+            currentFixing = comm->priceCurve()->price(currentFixingDate);
+        } else {
+            currentFixing = index->fixing(currentFixingDate);
         }
 
-        if (needFixings) {
-            Rate currentFixing;
-            if (auto comm = QuantLib::ext::dynamic_pointer_cast<QuantExt::CommodityIndex>(m.first);
-                comm != nullptr && comm->expiryDate() < currentFixingDate) {
-                currentFixing = comm->priceCurve()->price(currentFixingDate);
-            } else {
-                currentFixing = m.first->fixing(currentFixingDate);
-            }
-            // if we read the fixing from an inverted FxIndex we have to undo the inversion
-            TimeSeries<Real> history;
-            for (auto const& d : m.second) {
-                if (d >= fixStart && d < fixEnd) {
-                    // Fixing dates include the valuation grid dates which might not be valid fixing dates (BMA/SIFMA)
-                    bool valid = m.first->isValidFixingDate(d);
-                    if (valid) {
-                        history[d] = currentFixing;
-                        modifiedFixingHistory_ = true;
-                    }
-                }
-                if (d >= fixEnd)
-                    break;
-            }
-            m.first->addFixings(history, true);
-        }
+        // backfill the valid fixing dates in [fixStart, fixEnd)
+        auto d0 = std::lower_bound(f.fixingDates.begin(), f.fixingDates.end(), fixStart);
+        auto d1 = std::lower_bound(d0, f.fixingDates.end(), fixEnd);
+        if (d0 == d1)
+            continue;
+        fixingValues_.assign(std::distance(d0, d1), currentFixing);
+        index->addFixings(d0, d1, fixingValues_.begin(), true);
+        f.modified = true;
+        modifiedFixingHistory_ = true;
     }
 }
 
@@ -52,6 +52,10 @@ struct IndexComparator {
   When stepping between simulation dated t_(n-1) and t_(n) and update a fixing t with t_(n-1) < t < t(n) than the fixing
   from t(n) will be backfilled. There is currently no interpolation of fixings.
 
+  The required fixing dates are held per index in a sorted vector, so that each update only touches the fixing dates
+  in the current step. On reset() only the histories of indices that received pseudo fixings since the last reset
+  are restored.
+
   \ingroup simulation
  */
 class FixingManager {
@@ -79,10 +83,18 @@ private:
     Date today_, fixingsEnd_;
     bool modifiedFixingHistory_;
 
-    using FixingCache = std::map<QuantLib::ext::shared_ptr<Index>, TimeSeries<Real>, detail::IndexComparator>;
+    // required fixings of one index, fixingDates contains the valid fixing dates only, in ascending order
+    struct IndexFixings {
+        QuantLib::ext::shared_ptr<Index> index;
+        std::vector<Date> fixingDates;
+        std::vector<Date> requiredDates;
+        TimeSeries<Real> originalHistory;
+        bool modified = false;
+    };
 
     FixingMap fixingMap_;
-    FixingCache fixingCache_;
+    std::vector<IndexFixings> indexFixings_;
+    std::vector<Real> fixingValues_;
 };
 
 } // namespace analytics
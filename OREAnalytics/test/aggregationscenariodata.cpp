@@ -16,7 +16,9 @@
  FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
 */
 
+#include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
+#include <orea/cube/cube_io.hpp>
 #include <orea/scenario/aggregationscenariodata.hpp>
 #include <oret/toplevelfixture.hpp>
 #include <test/oreatoplevelfixture.hpp>
@@ -65,6 +67,71 @@ BOOST_AUTO_TEST_CASE(testInMemoryAggregationScenarioData) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(testInMemoryAggregationScenarioDataHandles) {
+    InMemoryAggregationScenarioData data(3, 5);
+
+    Size h1 = data.registerKey(AggregationScenarioDataType::FXSpot, "EURUSD");
+    Size h2 = data.registerKey(AggregationScenarioDataType::Numeraire);
+    BOOST_CHECK_EQUAL(data.registerKey(AggregationScenarioDataType::FXSpot, "EURUSD"), h1);
+    BOOST_CHECK_EQUAL(data.handle(AggregationScenarioDataType::FXSpot, "EURUSD"), h1);
+    BOOST_CHECK_EQUAL(data.handle(AggregationScenarioDataType::Numeraire), h2);
+    BOOST_CHECK(data.has(AggregationScenarioDataType::Numeraire));
+    BOOST_CHECK_THROW(data.handle(AggregationScenarioDataType::FXSpot, "EURGBP"), std::exception);
+    BOOST_CHECK_THROW(data.get(0, 0, h2 + 1), std::exception);
+    BOOST_CHECK_THROW(data.samples(3, h1), std::exception);
+
+    for (Size i = 0; i < 3; ++i) {
+        for (Size j = 0; j < 5; ++j) {
+            data.set(i, j, i + 0.1 * j, h1);
+            data.set(i, j, 1.0 + i + 0.1 * j, AggregationScenarioDataType::Numeraire);
+        }
+    }
+
+    Real tol = 1.0E-12;
+
+    for (Size i = 0; i < 3; ++i) {
+        auto fx = data.samples(i, h1);
+        auto numeraire = data.samples(i, h2);
+        BOOST_REQUIRE_EQUAL(fx.size(), 5u);
+        BOOST_REQUIRE_EQUAL(numeraire.size(), 5u);
+        for (Size j = 0; j < 5; ++j) {
+            BOOST_CHECK_CLOSE(fx[j], i + 0.1 * j, tol);
+            BOOST_CHECK_CLOSE(numeraire[j], 1.0 + i + 0.1 * j, tol);
+            BOOST_CHECK_CLOSE(data.get(i, j, h2), 1.0 + i + 0.1 * j, tol);
+            BOOST_CHECK_CLOSE(data.get(i, j, AggregationScenarioDataType::FXSpot, "EURUSD"), i + 0.1 * j, tol);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testAggregationScenarioDataFileIO) {
+    InMemoryAggregationScenarioData data(3, 5);
+    for (Size i = 0; i < 3; ++i) {
+        for (Size j = 0; j < 5; ++j) {
+            data.set(i, j, 0.0001 * i + 0.01 * j, AggregationScenarioDataType::IndexFixing, "OIS_EUR");
+            data.set(i, j, i + 0.1 * j, AggregationScenarioDataType::FXSpot, "EURUSD");
+            data.set(i, j, 1.0 / 3.0 + i, AggregationScenarioDataType::Numeraire);
+        }
+    }
+
+    for (auto const& extension : {".csv", ".bin"}) {
+        std::string filename = boost::filesystem::unique_path().string() + extension;
+        BOOST_TEST_MESSAGE("Saving aggregation scenario data to file " << filename);
+        saveAggregationScenarioData(filename, data);
+        auto data2 = loadAggregationScenarioData(filename);
+        BOOST_CHECK_EQUAL(data2->dimDates(), 3u);
+        BOOST_CHECK_EQUAL(data2->dimSamples(), 5u);
+        BOOST_CHECK(data2->keys() == data.keys());
+        for (auto const& [type, qualifier] : data.keys()) {
+            for (Size i = 0; i < 3; ++i) {
+                for (Size j = 0; j < 5; ++j) {
+                    BOOST_CHECK_CLOSE(data2->get(i, j, type, qualifier), data.get(i, j, type, qualifier), 1.0E-12);
+                }
+            }
+        }
+        boost::filesystem::remove(filename);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,165 @@
+/*
+ Copyright (C) 2025 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/app/analytics/analyticfactory.hpp>
+#include <orea/app/analyticsmanager.hpp>
+#include <orea/app/initbuilders.hpp>
+#include <orea/app/inputparameters.hpp>
+#include <orea/app/marketdatainmemoryloader.hpp>
+#include <ored/configuration/conventions.hpp>
+#include <ored/portfolio/portfolio.hpp>
+#include <ored/report/inmemoryreport.hpp>
+#include <oret/datapaths.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <ql/math/comparison.hpp>
+#include <test/oreatoplevelfixture.hpp>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "testportfolio.hpp"
+
+using namespace std;
+using namespace QuantLib;
+using namespace ore::data;
+using namespace ore::analytics;
+using testsuite::buildFxOption;
+using testsuite::buildSwap;
+
+namespace {
+
+// the market setup is shared with the stress test, only the analytic configurations are specific to this test
+string marketInputFile(const string& fileName) { return (path(basePath) / "input" / "stresstest" / fileName).string(); }
+
+vector<string> readLines(const string& fileName) {
+    vector<string> lines;
+    std::ifstream file(fileName);
+    QL_REQUIRE(file.is_open(), "could not open " << fileName);
+    for (string line; std::getline(file, line);) {
+        if (!line.empty())
+            lines.push_back(line);
+    }
+    return lines;
+}
+
+QuantLib::ext::shared_ptr<AnalyticsManager> runAnalytics(const Size analyticsThreads) {
+    auto inputs = QuantLib::ext::make_shared<InputParameters>();
+    inputs->setAsOfDate("2016-04-14");
+    inputs->setBaseCurrency("EUR");
+    inputs->setConventionsFromFile(marketInputFile("conventions.xml"));
+    inputs->setCurveConfigsFromFile(marketInputFile("curveconfig.xml"));
+    inputs->setTodaysMarketParamsFromFile(marketInputFile("todaysmarket.xml"));
+    inputs->setPricingEngineFromFile(TEST_INPUT_FILE("pricingengine.xml"));
+    inputs->setStressSimMarketParamsFromFile(TEST_INPUT_FILE("simulation.xml"));
+    inputs->setStressScenarioDataFromFile(TEST_INPUT_FILE("stresstest.xml"));
+    inputs->setStressThreshold(0.0);
+
+    auto portfolio = QuantLib::ext::make_shared<Portfolio>();
+    portfolio->add(buildSwap("1_Swap_EUR", "EUR", true, 10000000.0, 1, 10, 0.015, 0.00, "1Y", "30/360", "6M", "A360",
+                             "EUR-EURIBOR-6M"));
+    portfolio->add(buildSwap("2_Swap_USD", "USD", false, 10000000.0, 1, 5, 0.025, 0.00, "6M", "30/360", "3M", "A360",
+                             "USD-LIBOR-3M"));
+    portfolio->add(buildFxOption("3_FxOption_EUR_USD", "Long", "Call", 3, "EUR", 10000000.0, "USD", 11000000.0));
+    inputs->setPortfolio(portfolio);
+
+    // NPV and CASHFLOW share the pricing analytic, STRESS is independent of it, so we have two chains
+    inputs->setAnalytics("NPV,CASHFLOW,STRESS");
+    inputs->setThreads(2);
+    inputs->setAnalyticsThreads(analyticsThreads);
+
+    Settings::instance().evaluationDate() = inputs->asof();
+    InstrumentConventions::instance().setConventions(inputs->conventions());
+
+    auto analyticsManager = QuantLib::ext::make_shared<AnalyticsManager>(
+        inputs,
+        QuantLib::ext::make_shared<MarketDataInMemoryLoader>(inputs, readLines(marketInputFile("market.txt")),
+                                                             vector<string>()));
+    analyticsManager->initialise();
+    analyticsManager->runAnalytics();
+    return analyticsManager;
+}
+
+void checkEqual(const InMemoryReport& r1, const InMemoryReport& r2, const string& name) {
+    BOOST_REQUIRE_EQUAL(r1.columns(), r2.columns());
+    BOOST_REQUIRE_EQUAL(r1.rows(), r2.rows());
+    for (Size c = 0; c < r1.columns(); ++c) {
+        BOOST_CHECK_EQUAL(r1.header(c), r2.header(c));
+        for (Size r = 0; r < r1.rows(); ++r) {
+            auto const& v1 = r1.data(c, r);
+            auto const& v2 = r2.data(c, r);
+            BOOST_REQUIRE_EQUAL(v1.which(), v2.which());
+            if (auto x1 = boost::get<Real>(&v1)) {
+                Real x2 = boost::get<Real>(v2);
+                BOOST_CHECK_MESSAGE((*x1 == Null<Real>() && x2 == Null<Real>()) ||
+                                        (*x1 != Null<Real>() && x2 != Null<Real>() && close_enough(*x1, x2)),
+                                    name << ", column " << r1.header(c) << ", row " << r << ": " << *x1 << " vs "
+                                         << x2);
+            } else {
+                BOOST_CHECK_MESSAGE(v1 == v2, name << ", column " << r1.header(c) << ", row " << r << " differs");
+            }
+        }
+    }
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(AnalyticsManagerTest)
+
+BOOST_AUTO_TEST_CASE(testConcurrentAnalyticChains) {
+
+    BOOST_TEST_MESSAGE("Testing concurrent against sequential runs of independent analytics...");
+
+    SavedSettings backup;
+
+    if (AnalyticFactory::instance().getBuilders().empty())
+        initBuilders();
+
+    auto sequential = runAnalytics(1);
+    auto concurrent = runAnalytics(2);
+
+    BOOST_CHECK(sequential->failedAnalytics().empty());
+    BOOST_CHECK(concurrent->failedAnalytics().empty());
+
+#ifdef QL_ENABLE_SESSIONS
+    // the concurrently run stress analytic works on its own copy of the inputs
+    BOOST_CHECK(concurrent->getAnalytic("STRESS")->inputs() != concurrent->getAnalytic("NPV")->inputs());
+    BOOST_CHECK(concurrent->getAnalytic("STRESS")->inputs()->portfolio() !=
+                concurrent->getAnalytic("NPV")->inputs()->portfolio());
+#endif
+
+    auto seqReports = sequential->reports();
+    auto conReports = concurrent->reports();
+    for (auto const& [analytic, report] : vector<pair<string, string>>{
+             {"NPV", "npv"}, {"CASHFLOW", "cashflow"}, {"STRESS", "stress"}}) {
+        auto r1 = getReport(seqReports, analytic, report);
+        auto r2 = getReport(conReports, analytic, report);
+        BOOST_CHECK_MESSAGE(r1->rows() > 0, "no rows in " << analytic << " report " << report);
+        checkEqual(*r1, *r2, report);
+    }
+
+    // 3 trades times 2 scenarios, all are reported with threshold 0
+    BOOST_CHECK_EQUAL(getReport(conReports, "STRESS", "stress")->rows(), 6);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,130 @@
+/*
+ Copyright (C) 2025 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/aggregation/creditmigrationhelper.hpp>
+#include <orea/aggregation/creditsimulationparameters.hpp>
+#include <orea/cube/inmemorycube.hpp>
+#include <orea/scenario/aggregationscenariodata.hpp>
+#include <ored/portfolio/trade.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <ql/math/distributions/normaldistribution.hpp>
+#include <ql/time/calendars/target.hpp>
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "testportfolio.hpp"
+
+using namespace std;
+using namespace QuantLib;
+using namespace ore::data;
+using namespace ore::analytics;
+
+namespace {
+
+// two entities with one global factor, the counterparty CP of netting set NS_1 and the entity B without any trades,
+// the latter only consumes random numbers in simulation mode
+string creditSimulationXml(const string& evaluation) {
+    return "<CreditSimulation>"
+           "<TransitionMatrices><TransitionMatrix><Name>Default</Name>"
+           "<Data>0.90,0.08,0.02,0.05,0.85,0.10,0.00,0.00,1.00</Data>"
+           "</TransitionMatrix></TransitionMatrices>"
+           "<Entities>"
+           "<Entity><Name>CP</Name><FactorLoadings>0.5</FactorLoadings><TransitionMatrix>Default</TransitionMatrix>"
+           "<InitialState>0</InitialState></Entity>"
+           "<Entity><Name>B</Name><FactorLoadings>0.3</FactorLoadings><TransitionMatrix>Default</TransitionMatrix>"
+           "<InitialState>1</InitialState></Entity>"
+           "</Entities>"
+           "<NettingSetIds>NS_1</NettingSetIds>"
+           "<Risk><Market>false</Market><Credit>true</Credit><ZeroMarketPnl>false</ZeroMarketPnl>"
+           "<Evaluation>" +
+           evaluation +
+           "</Evaluation><DoubleDefault>false</DoubleDefault><Seed>42</Seed><Paths>50</Paths>"
+           "<CreditMode>Default</CreditMode><LoanExposureMode>Value</LoanExposureMode></Risk>"
+           "</CreditSimulation>";
+}
+
+Array pnlDistribution(const string& evaluation, const Size nThreads) {
+    // more samples than fit into one block of paths, so that the paths are split across threads
+    constexpr Size samples = 300;
+    Date asof(14, April, 2016);
+    vector<Date> dates{TARGET().advance(asof, 1 * Years)};
+
+    auto parameters = QuantLib::ext::make_shared<CreditSimulationParameters>();
+    parameters->fromXMLString(creditSimulationXml(evaluation));
+
+    auto cube =
+        QuantLib::ext::make_shared<InMemoryCubeOpt<double>>(asof, set<string>{"FxOption_1"}, dates, samples);
+    auto nettedCube = QuantLib::ext::make_shared<InMemoryCubeOpt<double>>(asof, set<string>{"NS_1"}, dates, samples);
+    auto aggData = QuantLib::ext::make_shared<InMemoryAggregationScenarioData>(dates.size(), samples);
+    InverseCumulativeNormal icn;
+    for (Size j = 0; j < samples; ++j) {
+        aggData->set(0, j, icn((static_cast<Real>((7 * j) % samples) + 0.5) / static_cast<Real>(samples)),
+                     AggregationScenarioDataType::CreditState, "0");
+        nettedCube->set(1000.0 * static_cast<Real>(1 + j % 11), 0, 0, j);
+    }
+
+    CreditMigrationHelper helper(parameters, cube, nettedCube, aggData, Null<Size>(), 0, -12000.0, 0.0, 24,
+                                 Matrix(1, 1, 1.0), "EUR", nThreads);
+    map<string, QuantLib::ext::shared_ptr<Trade>> trades = {
+        {"FxOption_1", testsuite::buildFxOption("FxOption_1", "Long", "Call", 3, "EUR", 10000000.0, "USD", 11000000.0,
+                                                0.0, "", "", "NS_1")}};
+    helper.build(trades);
+    return helper.pnlDistribution(0);
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(CreditMigrationHelperTest)
+
+BOOST_AUTO_TEST_CASE(testPnlDistributionIndependentOfThreads) {
+
+    BOOST_TEST_MESSAGE("Testing credit migration pnl distribution for different numbers of threads...");
+
+    for (auto const& evaluation : {"TerminalSimulation", "Analytic"}) {
+        BOOST_TEST_MESSAGE("evaluation " << evaluation);
+        Array singleThreaded = pnlDistribution(evaluation, 1);
+        Real sum = 0.0, defaultProb = 0.0;
+        for (Size i = 0; i < singleThreaded.size(); ++i) {
+            sum += singleThreaded[i];
+            if (i + 1 < singleThreaded.size())
+                defaultProb += singleThreaded[i];
+        }
+        BOOST_CHECK_CLOSE(sum, 1.0, 1E-10);
+        // the counterparty defaults on some but not all paths, a zero pnl falls into the last bucket
+        BOOST_CHECK(defaultProb > 0.0 && defaultProb < 1.0);
+        for (Size nThreads : {2, 3, 8}) {
+            Array multiThreaded = pnlDistribution(evaluation, nThreads);
+            BOOST_REQUIRE_EQUAL(multiThreaded.size(), singleThreaded.size());
+            for (Size i = 0; i < singleThreaded.size(); ++i) {
+                BOOST_CHECK_MESSAGE(multiThreaded[i] == singleThreaded[i],
+                                    "bucket " << i << ", " << nThreads << " threads: " << multiThreaded[i]
+                                              << " vs single threaded " << singleThreaded[i]);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -22,6 +22,8 @@
 #include <orea/cube/cube_io.hpp>
 #include <orea/cube/npvcube.hpp>
 #include <orea/cube/jaggedcube.hpp>
+#include <orea/cube/jointnpvcube.hpp>
+#include <orea/cube/mappednpvcube.hpp>
 #include <orea/engine/filteredsensitivitystream.hpp>
 #include <orea/engine/observationmode.hpp>
 #include <orea/engine/parametricvar.hpp>
@@ -461,6 +463,60 @@ BOOST_AUTO_TEST_CASE(testDoublePrecisionInMemoryCubeFileNIO) {
     testCubeFileIO<DoublePrecisionInMemoryCubeN>(c, "DoublePrecisionInMemoryCubeN", 1e-14);
 }
 
+BOOST_AUTO_TEST_CASE(testBinaryCubeFileIO) {
+    std::set<string> ids{string("id1"), string("id2"), string("id3")};
+    Date d(1, QuantLib::Jan, 2016);
+    vector<Date> dates{Date(1, QuantLib::Feb, 2016), Date(1, QuantLib::Mar, 2016), Date(1, QuantLib::Apr, 2016)};
+    Size samples = 100;
+    Size depth = 3;
+    for (bool dblPrc : {true, false}) {
+        QuantLib::ext::shared_ptr<NPVCube> cube;
+        if (dblPrc)
+            cube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCube>(d, ids, dates, samples, depth);
+        else
+            cube = QuantLib::ext::make_shared<SinglePrecisionInMemoryCube>(d, ids, dates, samples, depth);
+        initCube(*cube);
+        for (Size i = 0; i < cube->numIds(); ++i)
+            for (Size dd = 0; dd < depth; ++dd)
+                cube->setT0(i * 10.0 + dd, i, dd);
+
+        string filename = boost::filesystem::unique_path().string() + ".bin";
+        BOOST_TEST_MESSAGE("Saving binary cube (double precision = " << std::boolalpha << dblPrc << ") to file "
+                                                                      << filename);
+        saveCube(filename, NPVCubeWithMetaData{cube, nullptr, true, QuantLib::ext::nullopt});
+
+        {
+            auto r = loadCube(filename);
+            auto cube2 = r.cube;
+            BOOST_CHECK(QuantLib::ext::dynamic_pointer_cast<MappedNpvCube<double>>(cube2) ||
+                        QuantLib::ext::dynamic_pointer_cast<MappedNpvCube<float>>(cube2));
+            BOOST_CHECK_EQUAL(cube2->usesDoublePrecision(), dblPrc);
+            BOOST_CHECK(r.storeFlows && *r.storeFlows);
+            BOOST_CHECK(!r.storeCreditStateNPVs);
+            BOOST_CHECK(!r.scenarioGeneratorData);
+            BOOST_CHECK_EQUAL(cube2->asof(), d);
+            BOOST_CHECK(cube2->idsAndIndexes() == cube->idsAndIndexes());
+            BOOST_CHECK(cube2->dates() == cube->dates());
+            BOOST_CHECK_EQUAL(cube2->samples(), samples);
+            BOOST_CHECK_EQUAL(cube2->depth(), depth);
+            for (Size i = 0; i < cube2->numIds(); ++i)
+                for (Size dd = 0; dd < depth; ++dd)
+                    BOOST_CHECK_CLOSE(cube2->getT0(i, dd), i * 10.0 + dd, 1e-5);
+            checkCube(*cube2, dblPrc ? 1e-14 : 1e-5);
+
+            // setting values on a mapped cube must not write back to the file
+            cube2->set(42.0, 0, 0, 0, 0);
+            BOOST_CHECK_EQUAL(cube2->get(0, 0, 0, 0), 42.0);
+        }
+
+        auto cube3 = loadCube(filename).cube;
+        checkCube(*cube3, dblPrc ? 1e-14 : 1e-5);
+        cube3.reset();
+
+        boost::filesystem::remove(filename);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(testInMemoryCubeGetSetbyDateID) {
     std::set<string> ids = {"id1", "id2", "id3"}; // the overlap doesn't matter
     Date today = Date::todaysDate();
@@ -471,6 +527,51 @@ BOOST_AUTO_TEST_CASE(testInMemoryCubeGetSetbyDateID) {
     testCubeGetSetbyDateID(cube, 1e-14);
 }
 
+BOOST_AUTO_TEST_CASE(testCubeGetSetSamples) {
+    BOOST_TEST_MESSAGE("Testing bulk sample accessors on npv cubes");
+
+    Date today = Date::todaysDate();
+    vector<Date> dates = {today + QuantLib::Period(1, QuantLib::Years), today + QuantLib::Period(2, QuantLib::Years)};
+    Size samples = 7, depth = 2;
+    std::set<string> ids1 = {"id1", "id2"}, ids2 = {"id2", "id3"};
+    auto cube1 = QuantLib::ext::make_shared<DoublePrecisionInMemoryCubeN>(today, ids1, dates, samples, depth);
+    auto cube2 = QuantLib::ext::make_shared<SinglePrecisionInMemoryCubeN>(today, ids2, dates, samples, depth);
+
+    vector<Real> values(samples), result;
+    for (Size k = 0; k < samples; ++k)
+        values[k] = 1.0 + k;
+
+    // a block that was never set is returned as zero
+    cube1->getSamples(0, 1, 1, result);
+    BOOST_REQUIRE_EQUAL(result.size(), samples);
+    for (Size k = 0; k < samples; ++k)
+        BOOST_CHECK_EQUAL(result[k], 0.0);
+
+    cube1->setSamples(values, 0, 1, 1);
+    cube1->setSamples(values, 1, 0, 0);
+    cube2->setSamples(values, 0, 0, 0);
+    for (Size k = 0; k < samples; ++k) {
+        BOOST_CHECK_EQUAL(cube1->get(0, 1, k, 1), values[k]);
+        BOOST_CHECK_EQUAL(cube1->get(0, 1, k, 0), 0.0);
+        BOOST_CHECK_EQUAL(cube2->get(0, 0, k, 0), values[k]);
+    }
+    BOOST_CHECK_THROW(cube1->setSamples(vector<Real>(samples + 1, 0.0), 0, 0, 0), std::exception);
+    BOOST_CHECK_THROW(cube1->getSamples(0, 2, 0, result), std::exception);
+
+    // the joint cube aggregates the samples over input cubes sharing an id
+    JointNPVCube joint(cube1, cube2, {}, false);
+    joint.getSamples(joint.getTradeIndex("id2"), 0, 0, result);
+    for (Size k = 0; k < samples; ++k)
+        BOOST_CHECK_EQUAL(result[k], 2.0 * values[k]);
+    joint.getSamples(joint.getTradeIndex("id1"), 1, 1, result);
+    for (Size k = 0; k < samples; ++k)
+        BOOST_CHECK_EQUAL(result[k], values[k]);
+    BOOST_CHECK_THROW(joint.setSamples(values, joint.getTradeIndex("id2"), 0, 0), std::exception);
+    joint.setSamples(values, joint.getTradeIndex("id3"), 1, 0);
+    for (Size k = 0; k < samples; ++k)
+        BOOST_CHECK_EQUAL(cube2->get(1, 1, k, 0), values[k]);
+}
+
 BOOST_AUTO_TEST_CASE(testSinglePrecisionJaggedCube) {
 
     SavedSettings backup;
@@ -0,0 +1,189 @@
+/*
+ Copyright (C) 2025 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/aggregation/dimregressioncalculator.hpp>
+#include <orea/app/inputparameters.hpp>
+#include <orea/cube/cubeinterpretation.hpp>
+#include <orea/cube/inmemorycube.hpp>
+#include <orea/scenario/aggregationscenariodata.hpp>
+#include <ored/portfolio/portfolio.hpp>
+#include <ored/report/inmemoryreport.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <ql/math/comparison.hpp>
+#include <ql/math/distributions/normaldistribution.hpp>
+#include <ql/math/randomnumbers/inversecumulativerng.hpp>
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+#include <ql/timeseries.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "testportfolio.hpp"
+
+using namespace std;
+using namespace QuantLib;
+using namespace ore::data;
+using namespace ore::analytics;
+
+namespace {
+
+constexpr Size samples = 200;
+constexpr Size horizonCalendarDays = 14;
+
+TimeSeries<Real> externalIm(const vector<Date>& dates) {
+    TimeSeries<Real> im;
+    for (Size j = 0; j < dates.size(); ++j)
+        im[dates[j]] = 1000000.0 - 10000.0 * static_cast<Real>(j);
+    return im;
+}
+
+// the netting set NS_A comes first in the dim cube and has an external IM evolution, the DIM of NS_B and NS_C is
+// estimated by regression
+QuantLib::ext::shared_ptr<RegressionDynamicInitialMarginCalculator> buildDimCalculator(const Size nThreads) {
+    Date asof(14, April, 2016);
+    vector<Date> dates;
+    for (Size j = 1; j <= 12; ++j)
+        dates.push_back(asof + j * horizonCalendarDays * Days);
+
+    auto portfolio = QuantLib::ext::make_shared<Portfolio>();
+    portfolio->add(testsuite::buildFxForward("T1", 1, "EUR", 10000000.0, "USD", 11000000.0, "NS_A"));
+    portfolio->add(testsuite::buildFxForward("T2", 1, "EUR", 10000000.0, "USD", 11000000.0, "NS_B"));
+    portfolio->add(testsuite::buildFxForward("T3", 1, "USD", 5000000.0, "EUR", 4500000.0, "NS_B"));
+    portfolio->add(testsuite::buildFxForward("T4", 1, "EUR", 20000000.0, "USD", 22000000.0, "NS_C"));
+
+    // random walks of the trade NPVs with a volatility depending on the NPV, so that the regression is not flat
+    auto cube = QuantLib::ext::make_shared<InMemoryCubeOpt<double>>(asof, portfolio->ids(), dates, samples);
+    InverseCumulativeRng<MersenneTwisterUniformRng, InverseCumulativeNormal> rng(MersenneTwisterUniformRng(42));
+    for (Size i = 0; i < cube->numIds(); ++i)
+        cube->setT0(100000.0 * static_cast<Real>(i), i);
+    for (Size i = 0; i < cube->numIds(); ++i) {
+        for (Size k = 0; k < samples; ++k) {
+            Real npv = cube->getT0(i);
+            for (Size j = 0; j < dates.size(); ++j) {
+                npv += (50000.0 + 0.1 * std::fabs(npv)) * rng.next().value;
+                cube->set(npv, i, j, k);
+            }
+        }
+    }
+
+    auto scenarioData = QuantLib::ext::make_shared<InMemoryAggregationScenarioData>(dates.size(), samples);
+    for (Size j = 0; j < dates.size(); ++j) {
+        for (Size k = 0; k < samples; ++k)
+            scenarioData->set(j, k, 1.0 + 0.001 * static_cast<Real>(j) * (1.0 + 0.1 * rng.next().value),
+                              AggregationScenarioDataType::Numeraire);
+    }
+
+    auto inputs = QuantLib::ext::make_shared<InputParameters>();
+    inputs->setThreads(static_cast<int>(nThreads));
+    inputs->setDeterministicInitialMargin("NS_A", externalIm(dates));
+
+    auto calculator = QuantLib::ext::make_shared<RegressionDynamicInitialMarginCalculator>(
+        inputs, portfolio, cube, QuantLib::ext::make_shared<CubeInterpretation>(false, false), scenarioData, 0.99,
+        horizonCalendarDays, 2, vector<string>(), 10, 0.25);
+    calculator->build();
+    return calculator;
+}
+
+void checkEqual(const InMemoryReport& r1, const InMemoryReport& r2, const string& name) {
+    BOOST_REQUIRE_EQUAL(r1.columns(), r2.columns());
+    BOOST_REQUIRE_EQUAL(r1.rows(), r2.rows());
+    for (Size c = 0; c < r1.columns(); ++c) {
+        BOOST_CHECK_EQUAL(r1.header(c), r2.header(c));
+        for (Size r = 0; r < r1.rows(); ++r) {
+            auto const& v1 = r1.data(c, r);
+            auto const& v2 = r2.data(c, r);
+            BOOST_REQUIRE_EQUAL(v1.which(), v2.which());
+            if (auto x1 = boost::get<Real>(&v1)) {
+                Real x2 = boost::get<Real>(v2);
+                BOOST_CHECK_MESSAGE((*x1 == Null<Real>() && x2 == Null<Real>()) ||
+                                        (*x1 != Null<Real>() && x2 != Null<Real>() && close_enough(*x1, x2)),
+                                    name << ", column " << r1.header(c) << ", row " << r << ": " << *x1 << " vs "
+                                         << x2);
+            } else {
+                BOOST_CHECK_MESSAGE(v1 == v2, name << ", column " << r1.header(c) << ", row " << r << " differs");
+            }
+        }
+    }
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(DimRegressionCalculatorTest)
+
+BOOST_AUTO_TEST_CASE(testDimCubeIndependentOfThreads) {
+
+    BOOST_TEST_MESSAGE("Testing regression DIM cube with an external IM evolution for different numbers of threads...");
+
+    SavedSettings backup;
+    Settings::instance().evaluationDate() = Date(14, April, 2016);
+
+    auto singleThreaded = buildDimCalculator(1);
+    auto const& dimCube = singleThreaded->dimCube();
+    BOOST_REQUIRE_EQUAL(dimCube->numIds(), 3);
+    Size nDates = dimCube->dates().size() - 1;
+
+    // each netting set is written to its own slot of the dim cube, the external IM evolution is not overwritten by
+    // the regression of the following netting sets
+    TimeSeries<Real> im = externalIm(dimCube->dates());
+    for (auto const& [nettingSet, index] : dimCube->idsAndIndexes()) {
+        auto const& dim = singleThreaded->dynamicIM(nettingSet);
+        Real maxDim = 0.0;
+        for (Size j = 0; j < nDates; ++j) {
+            for (Size k = 0; k < samples; ++k) {
+                Real expected = nettingSet == "NS_A" ? im[dimCube->dates()[j]] : dim[j][k];
+                BOOST_CHECK_MESSAGE(dimCube->get(index, j, k) == expected,
+                                    nettingSet << ", date " << j << ", sample " << k << ": dim cube has "
+                                               << dimCube->get(index, j, k) << ", expected " << expected);
+                maxDim = std::max(maxDim, dimCube->get(index, j, k));
+            }
+        }
+        BOOST_CHECK_MESSAGE(maxDim > 0.0, nettingSet << " has no DIM");
+    }
+
+    InMemoryReport singleThreadedEvolution, singleThreadedCube;
+    singleThreaded->exportDimEvolution(singleThreadedEvolution);
+    singleThreaded->exportDimCube(singleThreadedCube);
+
+    for (Size nThreads : {2, 4, 8}) {
+        auto multiThreaded = buildDimCalculator(nThreads);
+        for (auto const& [nettingSet, index] : dimCube->idsAndIndexes()) {
+            for (Size j = 0; j < nDates; ++j) {
+                for (Size k = 0; k < samples; ++k) {
+                    BOOST_CHECK_MESSAGE(multiThreaded->dimCube()->get(index, j, k) == dimCube->get(index, j, k),
+                                        nettingSet << ", date " << j << ", sample " << k << ", " << nThreads
+                                                   << " threads: " << multiThreaded->dimCube()->get(index, j, k)
+                                                   << " vs single threaded " << dimCube->get(index, j, k));
+                }
+            }
+        }
+        InMemoryReport dimEvolution, dimCubeReport;
+        multiThreaded->exportDimEvolution(dimEvolution);
+        multiThreaded->exportDimCube(dimCubeReport);
+        checkEqual(singleThreadedEvolution, dimEvolution, "dim evolution, " + std::to_string(nThreads) + " threads");
+        checkEqual(singleThreadedCube, dimCubeReport, "dim cube, " + std::to_string(nThreads) + " threads");
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,126 @@
+/*
+ Copyright (C) 2025 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/simulation/fixingmanager.hpp>
+#include <ored/portfolio/enginedata.hpp>
+#include <ored/portfolio/enginefactory.hpp>
+#include <ored/portfolio/portfolio.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <ql/time/calendars/target.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "testmarket.hpp"
+#include "testportfolio.hpp"
+
+using namespace std;
+using namespace QuantLib;
+using namespace ore::data;
+using namespace ore::analytics;
+using testsuite::buildSwap;
+using testsuite::TestMarket;
+
+namespace {
+
+void checkHistory(const TimeSeries<Real>& history, const TimeSeries<Real>& original, const string& name,
+                  const Size sample) {
+    BOOST_CHECK_MESSAGE(history.size() == original.size(), name << ", sample " << sample << ": history has "
+                                                                << history.size() << " fixings, expected "
+                                                                << original.size());
+    for (auto h = history.begin(), o = original.begin(); h != history.end() && o != original.end(); ++h, ++o) {
+        BOOST_CHECK_MESSAGE(h->first == o->first && h->second == o->second,
+                            name << ", sample " << sample << ": fixing " << h->second << " on "
+                                 << io::iso_date(h->first) << ", expected " << o->second << " on "
+                                 << io::iso_date(o->first));
+    }
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(FixingManagerTest)
+
+BOOST_AUTO_TEST_CASE(testResetRestoresFixingHistories) {
+
+    BOOST_TEST_MESSAGE("Testing that FixingManager::reset() restores the original fixing histories...");
+
+    SavedSettings backup;
+
+    Date today(14, April, 2016);
+    Settings::instance().evaluationDate() = today;
+
+    // the test market holds fixings for the past 400 days for all ibor indices
+    auto market = QuantLib::ext::make_shared<TestMarket>(today);
+
+    auto engineData = QuantLib::ext::make_shared<EngineData>();
+    engineData->model("Swap") = "DiscountedCashflows";
+    engineData->engine("Swap") = "DiscountingSwapEngine";
+    auto factory = QuantLib::ext::make_shared<EngineFactory>(engineData, market);
+
+    // the GBP swap starts after the last simulation date, so its index never receives pseudo fixings
+    auto portfolio = QuantLib::ext::make_shared<Portfolio>();
+    portfolio->add(buildSwap("1_Swap_EUR", "EUR", true, 10000000.0, 1, 5, 0.015, 0.00, "1Y", "30/360", "6M", "A360",
+                             "EUR-EURIBOR-6M"));
+    portfolio->add(buildSwap("2_Swap_USD", "USD", false, 10000000.0, 1, 5, 0.025, 0.00, "6M", "30/360", "3M", "A360",
+                             "USD-LIBOR-3M"));
+    portfolio->add(buildSwap("3_Swap_GBP", "GBP", true, 10000000.0, 4, 5, 0.03, 0.00, "6M", "30/360", "3M", "A360",
+                             "GBP-LIBOR-3M"));
+    portfolio->build(factory);
+    BOOST_REQUIRE_EQUAL(portfolio->size(), 3);
+
+    vector<string> indexNames = {"EUR-EURIBOR-6M", "USD-LIBOR-3M", "GBP-LIBOR-3M"};
+    map<string, TimeSeries<Real>> original;
+    for (auto const& name : indexNames) {
+        original[name] = market->iborIndex(name)->timeSeries();
+        BOOST_REQUIRE(!original[name].empty());
+    }
+
+    FixingManager fixingManager(today);
+    fixingManager.initialise(portfolio, market);
+
+    vector<Date> dates;
+    for (Size m = 3; m <= 36; m += 3)
+        dates.push_back(TARGET().advance(today, m * Months));
+
+    // the samples run over different numbers of dates, the first one stops before the first fixing of the swaps
+    for (Size sample = 0; sample < 4; ++sample) {
+        Size nDates = sample == 0 ? 2 : dates.size() - sample;
+        for (Size i = 0; i < nDates; ++i)
+            fixingManager.update(dates[i]);
+        for (auto const& name : indexNames) {
+            Size n = market->iborIndex(name)->timeSeries().size();
+            if (sample == 0 || name == "GBP-LIBOR-3M") {
+                BOOST_CHECK_MESSAGE(n == original[name].size(),
+                                    name << ", sample " << sample << ": unexpected pseudo fixings");
+            } else {
+                BOOST_CHECK_MESSAGE(n > original[name].size(), name << ", sample " << sample << ": no pseudo fixings");
+            }
+        }
+        fixingManager.reset();
+        for (auto const& name : indexNames)
+            checkHistory(market->iborIndex(name)->timeSeries(), original[name], name, sample);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,247 @@
+/*
+ Copyright (C) 2025 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/cube/inmemorycube.hpp>
+#include <orea/engine/historicalpnlgenerator.hpp>
+#include <orea/engine/historicalsimulationvar.hpp>
+#include <orea/engine/marketriskreport.hpp>
+#include <orea/scenario/historicalscenariogenerator.hpp>
+#include <orea/scenario/scenariosimmarket.hpp>
+#include <orea/scenario/simplescenariofactory.hpp>
+#include <ored/portfolio/enginedata.hpp>
+#include <ored/portfolio/enginefactory.hpp>
+#include <ored/portfolio/envelope.hpp>
+#include <ored/portfolio/portfolio.hpp>
+#include <ored/report/inmemoryreport.hpp>
+#include <ored/utilities/timeperiod.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <ql/math/comparison.hpp>
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "testmarket.hpp"
+#include "testportfolio.hpp"
+
+using namespace std;
+using namespace QuantLib;
+using namespace ore::data;
+using namespace ore::analytics;
+using testsuite::buildSwap;
+using testsuite::TestConfigurationObjects;
+using testsuite::TestMarket;
+
+namespace {
+
+constexpr Size nScenarios = 30;
+
+QuantLib::ext::shared_ptr<ScenarioSimMarket> buildSimMarket(const Date& asof) {
+    return QuantLib::ext::make_shared<ScenarioSimMarket>(QuantLib::ext::make_shared<TestMarket>(asof),
+                                                         TestConfigurationObjects::setupSimMarketData2());
+}
+
+// historical scenarios on consecutive days before the asof date, all simulated risk factors move by a small random
+// log return around their base values
+QuantLib::ext::shared_ptr<HistoricalScenarioGenerator>
+buildHistoricalScenarios(const QuantLib::ext::shared_ptr<Scenario>& baseScenario) {
+    MersenneTwisterUniformRng rng(42);
+    map<Date, QuantLib::ext::shared_ptr<Scenario>> scenarios;
+    for (Size i = 0; i <= nScenarios; ++i) {
+        Date d = baseScenario->asof() - (nScenarios + 1 - i) * Days;
+        auto scenario = baseScenario->clone();
+        scenario->setAsof(d);
+        for (auto const& key : baseScenario->keys())
+            scenario->add(key, baseScenario->get(key) * std::exp(0.01 * (rng.nextReal() - 0.5)));
+        scenarios[d] = scenario;
+    }
+    auto loader = QuantLib::ext::make_shared<HistoricalScenarioLoader>();
+    loader->scenarios().push_back(scenarios);
+    auto hisScenGen = QuantLib::ext::make_shared<HistoricalScenarioGenerator>(
+        loader, QuantLib::ext::make_shared<SimpleScenarioFactory>(true),
+        QuantLib::ext::make_shared<ReturnConfiguration>());
+    hisScenGen->baseScenario() = baseScenario;
+    return hisScenGen;
+}
+
+// the portfolios P1 and P2 share the GBP swap, the last swap belongs to no portfolio
+QuantLib::ext::shared_ptr<Portfolio> buildPortfolio() {
+    auto portfolio = QuantLib::ext::make_shared<Portfolio>();
+    auto addSwap = [&portfolio](const QuantLib::ext::shared_ptr<Trade>& trade, const set<string>& portfolioIds) {
+        trade->setEnvelope(Envelope("CP", "", portfolioIds));
+        portfolio->add(trade);
+    };
+    addSwap(buildSwap("T1", "EUR", true, 10000000.0, 0, 10, 0.02, 0.00, "1Y", "30/360", "6M", "A360",
+                      "EUR-EURIBOR-6M"),
+            {"P1"});
+    addSwap(buildSwap("T2", "GBP", false, 5000000.0, 0, 5, 0.03, 0.00, "1Y", "30/360", "6M", "A360", "GBP-LIBOR-6M"),
+            {"P1", "P2"});
+    addSwap(buildSwap("T3", "EUR", false, 20000000.0, 1, 4, 0.01, 0.00, "1Y", "30/360", "6M", "A360",
+                      "EUR-EURIBOR-6M"),
+            {"P2"});
+    addSwap(buildSwap("T4", "GBP", true, 8000000.0, 2, 15, 0.025, 0.00, "1Y", "30/360", "6M", "A360", "GBP-LIBOR-6M"),
+            {});
+    return portfolio;
+}
+
+QuantLib::ext::shared_ptr<EngineData> buildEngineData() {
+    auto engineData = QuantLib::ext::make_shared<EngineData>();
+    engineData->model("Swap") = "DiscountedCashflows";
+    engineData->engine("Swap") = "DiscountingSwapEngine";
+    return engineData;
+}
+
+// the var report and the historical P&L report for the given number of aggregation threads
+vector<QuantLib::ext::shared_ptr<InMemoryReport>> varReports(const Size aggregationThreads) {
+    Date asof(14, April, 2016);
+    auto simMarket = buildSimMarket(asof);
+    auto hisScenGen = buildHistoricalScenarios(simMarket->baseScenario());
+    TimePeriod period({hisScenGen->startDates().front(), hisScenGen->endDates().back()});
+
+    HistoricalSimulationVarReport varReport(
+        "EUR", buildPortfolio(), "", vector<Real>{0.9, 0.99}, period, hisScenGen,
+        std::make_unique<MarketRiskReport::FullRevalArgs>(simMarket, buildEngineData()), true, true);
+
+    auto reports = QuantLib::ext::make_shared<MarketRiskReport::Reports>();
+    vector<QuantLib::ext::shared_ptr<InMemoryReport>> result = {QuantLib::ext::make_shared<InMemoryReport>(),
+                                                                QuantLib::ext::make_shared<InMemoryReport>()};
+    for (auto const& r : result)
+        reports->add(r);
+    varReport.setAggregationThreads(aggregationThreads);
+    varReport.calculate(reports);
+    return result;
+}
+
+void checkEqual(const InMemoryReport& r1, const InMemoryReport& r2, const string& name) {
+    BOOST_REQUIRE_EQUAL(r1.columns(), r2.columns());
+    BOOST_REQUIRE_EQUAL(r1.rows(), r2.rows());
+    for (Size c = 0; c < r1.columns(); ++c) {
+        BOOST_CHECK_EQUAL(r1.header(c), r2.header(c));
+        for (Size r = 0; r < r1.rows(); ++r) {
+            auto const& v1 = r1.data(c, r);
+            auto const& v2 = r2.data(c, r);
+            BOOST_REQUIRE_EQUAL(v1.which(), v2.which());
+            if (auto x1 = boost::get<Real>(&v1)) {
+                Real x2 = boost::get<Real>(v2);
+                BOOST_CHECK_MESSAGE((*x1 == Null<Real>() && x2 == Null<Real>()) ||
+                                        (*x1 != Null<Real>() && x2 != Null<Real>() && close_enough(*x1, x2)),
+                                    name << ", column " << r1.header(c) << ", row " << r << ": " << *x1 << " vs "
+                                         << x2);
+            } else {
+                BOOST_CHECK_MESSAGE(v1 == v2, name << ", column " << r1.header(c) << ", row " << r << " differs");
+            }
+        }
+    }
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(HistoricalPnlGeneratorTest)
+
+BOOST_AUTO_TEST_CASE(testGroupPnl) {
+
+    BOOST_TEST_MESSAGE("Testing historical P&Ls of overlapping trade groups...");
+
+    SavedSettings backup;
+
+    Date asof(14, April, 2016);
+    Settings::instance().evaluationDate() = asof;
+
+    auto simMarket = buildSimMarket(asof);
+    auto hisScenGen = buildHistoricalScenarios(simMarket->baseScenario());
+    BOOST_REQUIRE_EQUAL(hisScenGen->numScenarios(), nScenarios);
+
+    auto portfolio = buildPortfolio();
+    portfolio->build(QuantLib::ext::make_shared<EngineFactory>(buildEngineData(), simMarket));
+    BOOST_REQUIRE_EQUAL(portfolio->size(), 4);
+
+    auto cube = QuantLib::ext::make_shared<InMemoryCubeOpt<double>>(asof, portfolio->ids(), vector<Date>(1, asof),
+                                                                    hisScenGen->numScenarios());
+    HistoricalPnlGenerator pnlGenerator("EUR", portfolio, simMarket, hisScenGen, cube);
+    pnlGenerator.generateCube(QuantLib::ext::make_shared<ScenarioFilter>());
+
+    // all trades, two groups sharing T2, a single trade and an empty group
+    vector<set<pair<string, Size>>> groups(5);
+    for (auto const& t : pnlGenerator.tradeIdIndexPairs()) {
+        groups[0].insert(t);
+        if (t.first == "T1" || t.first == "T2")
+            groups[1].insert(t);
+        if (t.first == "T2" || t.first == "T3")
+            groups[2].insert(t);
+        if (t.first == "T4")
+            groups[3].insert(t);
+    }
+    BOOST_REQUIRE_EQUAL(groups[0].size(), 4);
+
+    // the whole history and a period covering only part of the scenarios
+    vector<TimePeriod> periods = {pnlGenerator.timePeriod(),
+                                  TimePeriod({hisScenGen->startDates()[5], hisScenGen->endDates()[20]})};
+
+    for (Size nThreads : {1, 2, 3, 8}) {
+        Matrix groupPnls = pnlGenerator.groupPnl(groups, nThreads);
+        BOOST_REQUIRE_EQUAL(groupPnls.rows(), groups.size());
+        BOOST_REQUIRE_EQUAL(groupPnls.columns(), nScenarios);
+        for (Size p = 0; p < periods.size(); ++p) {
+            for (Size g = 0; g < groups.size(); ++g) {
+                vector<Real> expected = pnlGenerator.pnl(periods[p], groups[g]);
+                vector<Real> actual = pnlGenerator.pnl(periods[p], groupPnls, g);
+                BOOST_REQUIRE_EQUAL(actual.size(), expected.size());
+                BOOST_CHECK_EQUAL(expected.size(), p == 0 ? nScenarios : 16);
+                for (Size s = 0; s < expected.size(); ++s) {
+                    BOOST_CHECK_MESSAGE(std::fabs(actual[s] - expected[s]) < 1E-6,
+                                        nThreads << " threads, period " << p << ", group " << g << ", scenario " << s
+                                                 << ": " << actual[s] << " vs " << expected[s]);
+                }
+                if (g < 4 && p == 0) {
+                    BOOST_CHECK_MESSAGE(std::any_of(expected.begin(), expected.end(), [](Real x) { return x != 0.0; }),
+                                        "group " << g << " has no P&L");
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testVarReportAggregationThreads) {
+
+    BOOST_TEST_MESSAGE("Testing historical simulation var report for different numbers of aggregation threads...");
+
+    SavedSettings backup;
+
+    Settings::instance().evaluationDate() = Date(14, April, 2016);
+
+    auto singleThreaded = varReports(1);
+    // portfolios All, P1 and P2 for at least the (All, All) risk group
+    BOOST_CHECK(singleThreaded[0]->rows() >= 3);
+    for (Size nThreads : {2, 4}) {
+        auto multiThreaded = varReports(nThreads);
+        checkEqual(*singleThreaded[0], *multiThreaded[0], "var, " + std::to_string(nThreads) + " threads");
+        checkEqual(*singleThreaded[1], *multiThreaded[1], "historical P&L, " + std::to_string(nThreads) + " threads");
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,250 @@
+/*
+ Copyright (C) 2025 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/cube/inmemorycube.hpp>
+#include <orea/engine/historicalsensipnlcalculator.hpp>
+#include <orea/engine/sensitivityinmemorystream.hpp>
+#include <orea/scenario/historicalscenariogenerator.hpp>
+#include <orea/scenario/simplescenario.hpp>
+#include <orea/scenario/simplescenariofactory.hpp>
+#include <ored/utilities/to_string.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+
+#include <boost/accumulators/accumulators.hpp>
+#include <boost/accumulators/statistics/covariance.hpp>
+#include <boost/accumulators/statistics/stats.hpp>
+#include <boost/accumulators/statistics/variance.hpp>
+#include <boost/accumulators/statistics/variates/covariate.hpp>
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <tuple>
+#include <vector>
+
+using namespace std;
+using namespace QuantLib;
+using namespace ore::data;
+using namespace ore::analytics;
+
+namespace {
+
+// collects the trade level P&L contribution rows
+class TestPnlCalculator : public PNLCalculator {
+public:
+    explicit TestPnlCalculator(const TimePeriod& period) : PNLCalculator(period) {}
+    void writePNL(Size scenarioIdx, bool isCall, const RiskFactorKey& key_1, Real shift_1, Real delta, Real gamma,
+                  Real deltaPnl, Real gammaPnl, const RiskFactorKey& key_2, Real shift_2,
+                  const std::string& tradeId) override {
+        if (!tradeId.empty())
+            rows[std::make_tuple(scenarioIdx, tradeId, key_1, key_2)] = std::make_pair(deltaPnl, gammaPnl);
+    }
+    bool writePnlRows() const override { return true; }
+
+    std::map<std::tuple<Size, std::string, RiskFactorKey, RiskFactorKey>, std::pair<Real, Real>> rows;
+};
+
+SensitivityRecord record(const std::string& tradeId, const RiskFactorKey& key_1, const RiskFactorKey& key_2,
+                         Real delta, Real gamma) {
+    return SensitivityRecord(tradeId, false, key_1, "", 0.0001, key_2, "", key_2 == RiskFactorKey() ? 0.0 : 0.0001,
+                             "EUR", 0.0, delta, gamma);
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(HistoricalSensiPnlCalculatorTest)
+
+BOOST_AUTO_TEST_CASE(testTradeLevelCrossGammaPnl) {
+
+    BOOST_TEST_MESSAGE("Testing trade level sensitivity based P&L with cross gammas...");
+
+    Date asof(14, April, 2016);
+    Size nScenarios = 20;
+
+    RiskFactorKey k1(RiskFactorKey::KeyType::DiscountCurve, "EUR", 0);
+    RiskFactorKey k2(RiskFactorKey::KeyType::IndexCurve, "EUR-EURIBOR-6M", 0);
+    RiskFactorKey k3(RiskFactorKey::KeyType::FXSpot, "USDEUR", 0);
+    vector<RiskFactorKey> keys = {k1, k2, k3};
+
+    // historical scenarios on consecutive days, only their dates are used
+    auto loader = QuantLib::ext::make_shared<HistoricalScenarioLoader>();
+    map<Date, QuantLib::ext::shared_ptr<Scenario>> scenarioMap;
+    for (Size i = 0; i <= nScenarios; ++i) {
+        Date d = asof - (nScenarios - i) * Days;
+        scenarioMap[d] = QuantLib::ext::make_shared<SimpleScenario>(d);
+    }
+    loader->scenarios().push_back(scenarioMap);
+    auto hisScenGen = QuantLib::ext::make_shared<HistoricalScenarioGenerator>(
+        loader, QuantLib::ext::make_shared<SimpleScenarioFactory>(true),
+        QuantLib::ext::make_shared<ReturnConfiguration>());
+    BOOST_REQUIRE_EQUAL(hisScenGen->numScenarios(), nScenarios);
+
+    // historical shifts
+    set<string> ids;
+    for (const auto& k : keys)
+        ids.insert(ore::data::to_string(k));
+    QuantLib::ext::shared_ptr<NPVCube> shiftCube =
+        QuantLib::ext::make_shared<InMemoryCubeOpt<double>>(asof, ids, vector<Date>(1, asof), nScenarios);
+    MersenneTwisterUniformRng rng(42);
+    map<RiskFactorKey, vector<Real>> shifts;
+    for (const auto& k : keys) {
+        shifts[k].resize(nScenarios);
+        for (Size i = 0; i < nScenarios; ++i) {
+            shifts[k][i] = 0.01 * (rng.nextReal() - 0.5);
+            shiftCube->set(shifts[k][i], shiftCube->idsAndIndexes().at(ore::data::to_string(k)), 0, i);
+        }
+    }
+
+    // trade level sensitivities, the cross gamma records of T1 and T3 share the key pair (k1, k2)
+    vector<SensitivityRecord> tradeRecords = {
+        record("T1", k1, RiskFactorKey(), 100.0, 10.0), record("T1", k2, RiskFactorKey(), 50.0, 0.0),
+        record("T1", k1, k2, 0.0, 7.0),                 record("T2", k1, RiskFactorKey(), -30.0, 2.0),
+        record("T2", k3, RiskFactorKey(), 20.0, 0.0),   record("T2", k2, k3, 0.0, -4.0),
+        record("T3", k3, RiskFactorKey(), 5.0, 1.0),    record("T3", k1, k2, 0.0, 3.0)};
+    vector<string> tradeIds = {"T1", "T2", "T3"};
+
+    // portfolio level sensitivities
+    map<pair<RiskFactorKey, RiskFactorKey>, pair<Real, Real>> aggregated;
+    for (const auto& sr : tradeRecords) {
+        auto& dg = aggregated[make_pair(sr.key_1, sr.key_2)];
+        dg.first += sr.delta;
+        dg.second += sr.gamma;
+    }
+    set<SensitivityRecord> srs;
+    for (const auto& [k, dg] : aggregated)
+        srs.insert(record("", k.first, k.second, dg.first, dg.second));
+
+    // expected trade level P&Ls and first order P&Ls, scenarios x trades
+    vector<vector<Real>> expPnls(nScenarios, vector<Real>(tradeIds.size(), 0.0)), expFoPnls = expPnls;
+    for (const auto& sr : tradeRecords) {
+        Size t = std::distance(tradeIds.begin(), std::find(tradeIds.begin(), tradeIds.end(), sr.tradeId));
+        for (Size i = 0; i < nScenarios; ++i) {
+            Real s1 = shifts[sr.key_1][i];
+            if (sr.isCrossGamma()) {
+                expPnls[i][t] += s1 * shifts[sr.key_2][i] * sr.gamma;
+            } else {
+                expPnls[i][t] += s1 * sr.delta + 0.5 * s1 * s1 * sr.gamma;
+                expFoPnls[i][t] += s1 * sr.delta;
+            }
+        }
+    }
+
+    TimePeriod period({hisScenGen->startDates().front(), hisScenGen->endDates().back()});
+    for (Size nThreads : {1, 4}) {
+        auto calculator = QuantLib::ext::make_shared<TestPnlCalculator>(period);
+        auto ss = QuantLib::ext::make_shared<SensitivityInMemoryStream>(tradeRecords.begin(), tradeRecords.end());
+        HistoricalSensiPnlCalculator sensiPnlCalculator(hisScenGen, ss, nThreads);
+        sensiPnlCalculator.calculateSensiPnl(srs, keys, shiftCube, {calculator}, nullptr, tradeIds, true, true, true);
+
+        BOOST_REQUIRE_EQUAL(calculator->pnls().size(), nScenarios);
+        BOOST_REQUIRE_EQUAL(calculator->tradePnls().size(), nScenarios);
+        BOOST_REQUIRE_EQUAL(calculator->foTradePnls().size(), nScenarios);
+        Real tol = 1e-12;
+        for (Size i = 0; i < nScenarios; ++i) {
+            BOOST_REQUIRE_EQUAL(calculator->tradePnls()[i].size(), tradeIds.size());
+            Real sum = 0.0;
+            for (Size t = 0; t < tradeIds.size(); ++t) {
+                BOOST_CHECK_SMALL(calculator->tradePnls()[i][t] - expPnls[i][t], tol);
+                BOOST_CHECK_SMALL(calculator->foTradePnls()[i][t] - expFoPnls[i][t], tol);
+                sum += calculator->tradePnls()[i][t];
+            }
+            // the trade level P&Ls add up to the portfolio level P&L
+            BOOST_CHECK_SMALL(calculator->pnls()[i] - sum, tol);
+        }
+
+        // the cross gamma contribution rows are written for the trades that have the cross gamma
+        for (const auto& sr : tradeRecords) {
+            if (!sr.isCrossGamma())
+                continue;
+            for (Size i = 0; i < nScenarios; ++i) {
+                auto r = calculator->rows.find(std::make_tuple(i, sr.tradeId, sr.key_1, sr.key_2));
+                BOOST_REQUIRE_MESSAGE(r != calculator->rows.end(), "no cross gamma row for trade "
+                                                                       << sr.tradeId << " in scenario " << i);
+                BOOST_CHECK_SMALL(r->second.second - shifts[sr.key_1][i] * shifts[sr.key_2][i] * sr.gamma, tol);
+            }
+        }
+        Size crossGammaRows = 0;
+        for (const auto& [k, _] : calculator->rows) {
+            if (std::get<3>(k) != RiskFactorKey())
+                ++crossGammaRows;
+        }
+        BOOST_CHECK_EQUAL(crossGammaRows, 3 * nScenarios);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testCovarianceAgainstAccumulators) {
+
+    BOOST_TEST_MESSAGE("Testing the covariance of historical shifts against boost accumulators...");
+
+    namespace acc = boost::accumulators;
+    using accumulator =
+        acc::accumulator_set<Real, acc::stats<acc::tag::covariance<Real, acc::tag::covariate1>, acc::tag::variance>>;
+
+    Size nFactors = 5, nScenarios = 40;
+    Date today(14, April, 2016);
+    vector<Date> startDates, endDates;
+    for (Size s = 0; s < nScenarios; ++s) {
+        startDates.push_back(today - (nScenarios - s) * Days);
+        endDates.push_back(startDates.back() + 1 * Days);
+    }
+
+    MersenneTwisterUniformRng rng(42);
+    Matrix shifts(nFactors, nScenarios);
+    for (Size i = 0; i < nFactors; ++i) {
+        for (Size s = 0; s < nScenarios; ++s)
+            shifts[i][s] = 0.01 * (i + 1) * (rng.nextReal() - 0.5) + 0.001 * i;
+    }
+
+    // a subset of the factors in a different order and a covariance period covering part of the scenarios
+    vector<Size> rows = {3, 0, 4, 1};
+    TimePeriod period({startDates[5], endDates[30]});
+
+    vector<accumulator> accs(rows.size() * rows.size());
+    for (Size s = 0; s < nScenarios; ++s) {
+        if (!period.contains(startDates[s]) || !period.contains(endDates[s]))
+            continue;
+        for (Size i = 0; i < rows.size(); ++i) {
+            for (Size j = 0; j < rows.size(); ++j)
+                accs[i * rows.size() + j](shifts[rows[i]][s], acc::covariate1 = shifts[rows[j]][s]);
+        }
+    }
+
+    for (Size nThreads : {1, 3}) {
+        CovarianceCalculator calculator(period);
+        calculator.calculate(shifts, rows, startDates, endDates, nThreads);
+        BOOST_REQUIRE_EQUAL(calculator.covariance().rows(), rows.size());
+        BOOST_REQUIRE_EQUAL(calculator.covariance().columns(), rows.size());
+        for (Size i = 0; i < rows.size(); ++i) {
+            Real var_i = acc::variance(accs[i * rows.size() + i]);
+            for (Size j = 0; j < rows.size(); ++j) {
+                Real var_j = acc::variance(accs[j * rows.size() + j]);
+                Real cov = acc::covariance(accs[i * rows.size() + j]);
+                BOOST_CHECK_CLOSE(calculator.covariance()[i][j], cov, 1e-8);
+                BOOST_CHECK_CLOSE(calculator.correlation()[i][j], cov / std::sqrt(var_i * var_j), 1e-8);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,151 @@
+/*
+ Copyright (C) 2025 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/app/inputparameters.hpp>
+#include <ored/model/crossassetmodeldata.hpp>
+#include <ored/portfolio/nettingsetdefinition.hpp>
+#include <ored/portfolio/nettingsetmanager.hpp>
+#include <ored/portfolio/portfolio.hpp>
+#include <ored/utilities/correlationmatrix.hpp>
+#include <ored/utilities/parallel.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <ql/quotes/simplequote.hpp>
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "testportfolio.hpp"
+
+using namespace QuantLib;
+using namespace QuantExt;
+using namespace ore::data;
+using namespace ore::analytics;
+
+namespace {
+
+class TestInputParameters : public InputParameters {
+public:
+    QuantLib::ext::shared_ptr<InputParameters> clone() const override {
+        return QuantLib::ext::make_shared<TestInputParameters>(*this);
+    }
+    void setModelData(const QuantLib::ext::shared_ptr<CrossAssetModelData>& data) { crossAssetModelData_ = data; }
+};
+
+QuantLib::ext::shared_ptr<TestInputParameters> testInputs() {
+    auto inputs = QuantLib::ext::make_shared<TestInputParameters>();
+    auto portfolio = QuantLib::ext::make_shared<Portfolio>();
+    portfolio->add(testsuite::buildFxOption("FxOption_1", "Long", "Call", 3, "EUR", 10000000.0, "USD", 11000000.0,
+                                            0.0, "", "", "NS_1"));
+    portfolio->add(testsuite::buildFxOption("FxOption_2", "Long", "Put", 5, "EUR", 10000000.0, "USD", 11000000.0, 0.0,
+                                            "", "", "NS_2"));
+    inputs->setPortfolio(portfolio);
+    inputs->setNettingSetManager("<NettingSetDefinitions><NettingSet><NettingSetId>NS_1</NettingSetId>"
+                                 "<ActiveCSAFlag>false</ActiveCSAFlag></NettingSet></NettingSetDefinitions>");
+    inputs->setModelData(QuantLib::ext::make_shared<CrossAssetModelData>());
+    return inputs;
+}
+
+// does what the xva analytic does with the netting set manager and the model data of its inputs
+std::tuple<Size, Size, std::string, Real> runOnCopy(const InputParameters& inputs, const std::string& portfolioXml,
+                                                    const Size i) {
+    auto copy = inputs.copyWithPortfolio(portfolioXml);
+    for (auto const& [_, nettingSetId] : copy->portfolio()->nettingSetMap()) {
+        if (!copy->nettingSetManager()->has(nettingSetId))
+            copy->nettingSetManager()->add(QuantLib::ext::make_shared<NettingSetDefinition>(nettingSetId));
+    }
+    bool csa = copy->nettingSetManager()->get("NS_1")->activeCsaFlag();
+    CorrelationFactor f1{CrossAssetModel::AssetType::IR, "EUR", 0}, f2{CrossAssetModel::AssetType::FX, "USDEUR", 0};
+    std::map<CorrelationKey, Handle<Quote>> corr;
+    corr[std::make_pair(f1, f2)] = Handle<Quote>(QuantLib::ext::make_shared<SimpleQuote>(0.01 * i));
+    copy->crossAssetModelData()->setCorrelations(QuantLib::ext::make_shared<InstantaneousCorrelations>(corr));
+    std::string ids;
+    for (auto const& k : copy->nettingSetManager()->uniqueKeys())
+        ids += k.nettingSetId() + (csa ? "(CSA)" : "") + ",";
+    return std::make_tuple(copy->portfolio()->size(), copy->crossAssetModelData()->correlations().size(), ids,
+                           copy->crossAssetModelData()->correlations().begin()->second->value());
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(InputParametersTest)
+
+BOOST_AUTO_TEST_CASE(testCopyWithPortfolio) {
+
+    BOOST_TEST_MESSAGE("Testing copies of input parameters with their own portfolio...");
+
+    auto inputs = testInputs();
+    std::string portfolioXml = inputs->portfolio()->toXMLString();
+
+    auto copy = inputs->copyWithPortfolio(portfolioXml);
+
+    // the copy has the type of the original and its own portfolio, netting set manager and model data
+    BOOST_CHECK(QuantLib::ext::dynamic_pointer_cast<TestInputParameters>(copy) != nullptr);
+    BOOST_CHECK(copy->portfolio() != inputs->portfolio());
+    BOOST_CHECK_EQUAL(copy->portfolio()->size(), inputs->portfolio()->size());
+    BOOST_CHECK(copy->nettingSetManager() != inputs->nettingSetManager());
+    BOOST_CHECK(copy->crossAssetModelData() != inputs->crossAssetModelData());
+    BOOST_CHECK(copy->nettingSetManager()->has("NS_1"));
+
+    // changes to the copy do not affect the original
+    runOnCopy(*inputs, portfolioXml, 1);
+    BOOST_CHECK(!inputs->nettingSetManager()->has("NS_2"));
+    BOOST_CHECK(inputs->crossAssetModelData()->correlations().empty());
+}
+
+BOOST_AUTO_TEST_CASE(testCopyWithPortfolioConcurrently) {
+
+    BOOST_TEST_MESSAGE("Testing concurrent runs on copies of input parameters against sequential runs...");
+
+    auto inputs = testInputs();
+    std::string portfolioXml = inputs->portfolio()->toXMLString();
+
+    constexpr Size n = 16;
+#ifdef QL_ENABLE_SESSIONS
+    Size nThreads = 4;
+#else
+    Size nThreads = 1;
+#endif
+
+    std::vector<std::tuple<Size, Size, std::string, Real>> sequential(n), concurrent(n);
+    for (Size i = 0; i < n; ++i)
+        sequential[i] = runOnCopy(*inputs, portfolioXml, i);
+    parallelFor(n, nThreads, [&](Size i) { concurrent[i] = runOnCopy(*inputs, portfolioXml, i); });
+
+    for (Size i = 0; i < n; ++i) {
+        BOOST_CHECK_EQUAL(std::get<0>(concurrent[i]), 2);
+        BOOST_CHECK_EQUAL(std::get<1>(concurrent[i]), 1);
+        BOOST_CHECK_EQUAL(std::get<2>(concurrent[i]), "NS_2,NS_1,");
+        BOOST_CHECK_EQUAL(std::get<0>(concurrent[i]), std::get<0>(sequential[i]));
+        BOOST_CHECK_EQUAL(std::get<1>(concurrent[i]), std::get<1>(sequential[i]));
+        BOOST_CHECK_EQUAL(std::get<2>(concurrent[i]), std::get<2>(sequential[i]));
+        BOOST_CHECK_EQUAL(std::get<3>(concurrent[i]), std::get<3>(sequential[i]));
+    }
+
+    BOOST_CHECK_EQUAL(inputs->nettingSetManager()->uniqueKeys().size(), 0);
+    BOOST_CHECK(!inputs->nettingSetManager()->has("NS_2"));
+    BOOST_CHECK(inputs->crossAssetModelData()->correlations().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
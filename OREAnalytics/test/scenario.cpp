@@ -9,6 +9,14 @@ All rights reserved.
 #include <orea/scenario/simplescenario.hpp>
 #include <orea/scenario/simplescenariofactory.hpp>
 #include <orea/scenario/csvscenariogenerator.hpp>
+#include <orea/scenario/scenariobinaryreader.hpp>
+#include <orea/scenario/scenariofilereader.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 using namespace boost::unit_test_framework;
 using namespace QuantLib;
@@ -32,6 +40,52 @@ private:
     int current_position_;
 };
 
+// scenario that does not provide a keys hash, wraps a SimpleScenario
+class NoHashScenario : public Scenario {
+public:
+    explicit NoHashScenario(const QuantLib::ext::shared_ptr<SimpleScenario>& s) : s_(s) {}
+    const Date& asof() const override { return s_->asof(); }
+    void setAsof(const Date& d) override { s_->setAsof(d); }
+    const std::string& label() const override { return s_->label(); }
+    void label(const std::string& s) override { s_->label(s); }
+    Real getNumeraire() const override { return s_->getNumeraire(); }
+    void setNumeraire(Real n) override { s_->setNumeraire(n); }
+    bool has(const RiskFactorKey& key) const override { return s_->has(key); }
+    const std::vector<RiskFactorKey>& keys() const override { return s_->keys(); }
+    void add(const RiskFactorKey& key, Real value) override { s_->add(key, value); }
+    Real get(const RiskFactorKey& key) const override { return s_->get(key); }
+    const bool isAbsolute() const override { return s_->isAbsolute(); }
+    void setAbsolute(const bool b) override { s_->setAbsolute(b); }
+    const bool isPar() const override { return s_->isPar(); }
+    void setPar(const bool b) override { s_->setPar(b); }
+    const std::map<std::pair<RiskFactorKey::KeyType, std::string>, std::vector<std::vector<Real>>>&
+    coordinates() const override {
+        return s_->coordinates();
+    }
+    QuantLib::ext::shared_ptr<Scenario> clone() const override {
+        return QuantLib::ext::make_shared<NoHashScenario>(
+            QuantLib::ext::dynamic_pointer_cast<SimpleScenario>(s_->clone()));
+    }
+
+private:
+    QuantLib::ext::shared_ptr<SimpleScenario> s_;
+};
+
+class TestScenarioReader : public ScenarioReader {
+public:
+    explicit TestScenarioReader(const std::vector<QuantLib::ext::shared_ptr<Scenario>>& scenarios)
+        : scenarios_(scenarios) {}
+    bool next() override { return ++current_ < scenarios_.size(); }
+    Date date() const override { return current_ < scenarios_.size() ? scenarios_[current_]->asof() : Null<Date>(); }
+    QuantLib::ext::shared_ptr<Scenario> scenario() const override {
+        return current_ < scenarios_.size() ? scenarios_[current_] : nullptr;
+    }
+
+private:
+    std::vector<QuantLib::ext::shared_ptr<Scenario>> scenarios_;
+    Size current_ = std::numeric_limits<Size>::max();
+};
+
 BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::TopLevelFixture)
 
 BOOST_AUTO_TEST_SUITE(CSVScenarioGeneratorTest)
@@ -89,4 +143,114 @@ BOOST_AUTO_TEST_CASE(testCSVScenarioGenerator) {
 
 BOOST_AUTO_TEST_SUITE_END()
 
+BOOST_AUTO_TEST_SUITE(ScenarioBinaryReaderTest)
+
+BOOST_AUTO_TEST_CASE(testScenarioBinaryRoundtrip) {
+
+    BOOST_TEST_MESSAGE("Testing conversion of csv scenarios to binary scenarios...");
+
+    // the third scenario has a missing value
+    std::string csv = "Date,Scenario,Numeraire,DiscountCurve/EUR/0,DiscountCurve/EUR/1,FXSpot/USDEUR/0\n"
+                      "2020-01-02,1,1.0,0.99,0.95,0.9\n"
+                      "2020-01-03,1,1.0,0.98,0.94,0.91\n"
+                      "2020-01-06,1,1.0,0.97,,0.92\n";
+
+    auto factory = QuantLib::ext::make_shared<SimpleScenarioFactory>(false);
+    std::string filename = boost::filesystem::unique_path().string() + ".bin";
+    {
+        ScenarioBufferReader csvReader(csv, factory);
+        saveScenariosBinary(filename, csvReader, csvReader.keys());
+    }
+    BOOST_CHECK(isBinaryScenarioFile(filename));
+
+    {
+        ScenarioBufferReader csvReader(csv, factory);
+        ScenarioBinaryReader binReader(filename);
+        BOOST_CHECK_EQUAL(binReader.numScenarios(), 3);
+        BOOST_CHECK(binReader.keys() == csvReader.keys());
+        BOOST_CHECK(std::isnan(binReader.value(2, 1)));
+        BOOST_CHECK_EQUAL(binReader.value(1, 2), 0.91);
+
+        Size n = 0;
+        while (csvReader.next()) {
+            BOOST_REQUIRE(binReader.next());
+            auto s1 = csvReader.scenario();
+            auto s2 = binReader.scenario();
+            BOOST_CHECK_EQUAL(binReader.date(), s1->asof());
+            BOOST_CHECK_EQUAL(s2->asof(), s1->asof());
+            BOOST_CHECK_EQUAL(s2->label(), s1->label());
+            BOOST_CHECK_EQUAL(s2->getNumeraire(), s1->getNumeraire());
+            BOOST_CHECK_EQUAL(s2->isAbsolute(), s1->isAbsolute());
+            BOOST_CHECK(s2->keys() == s1->keys());
+            for (auto const& k : s1->keys())
+                BOOST_CHECK_EQUAL(s2->get(k), s1->get(k));
+            ++n;
+        }
+        BOOST_CHECK_EQUAL(n, 3);
+        BOOST_CHECK(!binReader.next());
+        BOOST_CHECK(binReader.scenario() == nullptr);
+
+        // complete scenarios share the key dictionary of the file
+        auto s0 = QuantLib::ext::dynamic_pointer_cast<SimpleScenario>(binReader.scenario(0));
+        auto s1 = QuantLib::ext::dynamic_pointer_cast<SimpleScenario>(binReader.scenario(1));
+        BOOST_REQUIRE(s0 && s1);
+        BOOST_CHECK(s0->sharedData() == s1->sharedData());
+    }
+
+    boost::filesystem::remove(filename);
+}
+
+BOOST_AUTO_TEST_CASE(testScenarioBinaryVaryingKeysWithoutHash) {
+
+    BOOST_TEST_MESSAGE("Testing binary scenarios from scenarios with varying keys and without keys hash...");
+
+    RiskFactorKey k0(RiskFactorKey::KeyType::DiscountCurve, "EUR", 0);
+    RiskFactorKey k1(RiskFactorKey::KeyType::DiscountCurve, "EUR", 1);
+    RiskFactorKey k2(RiskFactorKey::KeyType::FXSpot, "USDEUR", 0);
+
+    // same number of keys in different order, fewer keys, then all keys again
+    std::vector<std::vector<std::pair<RiskFactorKey, Real>>> data = {{{k0, 0.99}, {k1, 0.95}, {k2, 0.9}},
+                                                                     {{k2, 0.91}, {k0, 0.98}, {k1, 0.94}},
+                                                                     {{k1, 0.93}, {k0, 0.97}},
+                                                                     {{k0, 0.96}, {k1, 0.92}, {k2, 0.93}}};
+    std::vector<QuantLib::ext::shared_ptr<Scenario>> scenarios;
+    Date d(2, Jan, 2020);
+    for (Size i = 0; i < data.size(); ++i) {
+        auto s = QuantLib::ext::make_shared<SimpleScenario>(d + i, "1", 1.0);
+        for (auto const& [k, v] : data[i])
+            s->add(k, v);
+        scenarios.push_back(QuantLib::ext::make_shared<NoHashScenario>(s));
+        BOOST_REQUIRE_EQUAL(scenarios.back()->keysHash(), 0);
+    }
+
+    std::string filename = boost::filesystem::unique_path().string() + ".bin";
+    {
+        TestScenarioReader reader(scenarios);
+        saveScenariosBinary(filename, reader, {k0, k1, k2});
+    }
+
+    {
+        ScenarioBinaryReader binReader(filename);
+        BOOST_REQUIRE_EQUAL(binReader.numScenarios(), data.size());
+        std::vector<RiskFactorKey> columns = {k0, k1, k2};
+        BOOST_CHECK(binReader.keys() == columns);
+        for (Size i = 0; i < data.size(); ++i) {
+            for (Size c = 0; c < columns.size(); ++c) {
+                auto v = std::find_if(data[i].begin(), data[i].end(),
+                                      [&columns, c](const std::pair<RiskFactorKey, Real>& p) {
+                                          return p.first == columns[c];
+                                      });
+                if (v == data[i].end())
+                    BOOST_CHECK(std::isnan(binReader.value(i, c)));
+                else
+                    BOOST_CHECK_EQUAL(binReader.value(i, c), v->second);
+            }
+        }
+    }
+
+    boost::filesystem::remove(filename);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -765,6 +765,118 @@ BOOST_AUTO_TEST_CASE(testCrossAssetSimMarket2) {
     BOOST_TEST_MESSAGE("Simulation time " << timer.format(default_places, "%w") << ", update time " << updateTime);
 }
 
+BOOST_AUTO_TEST_CASE(testCrossAssetCurveTenorsPerCurve) {
+    BOOST_TEST_MESSAGE("Testing CrossAssetScenarioGenerator curve keys for different tenor grids per curve...");
+    setConventions();
+    TestData d;
+
+    Date today = d.referenceDate;
+    std::vector<Period> tenorGrid = {1 * Years, 2 * Years, 5 * Years};
+    QuantLib::ext::shared_ptr<DateGrid> grid = QuantLib::ext::make_shared<DateGrid>(tenorGrid);
+    QuantLib::ext::shared_ptr<QuantExt::CrossAssetModel> model = d.ccLgm;
+
+    // each curve has its own number of tenors, so that the keys of a curve do not start at a multiple of the
+    // number of tenors of the first curve
+    std::map<std::string, std::vector<Period>> tenors = {
+        {"EUR", {1 * Years, 5 * Years, 10 * Years}},
+        {"USD", {6 * Months, 1 * Years, 2 * Years, 5 * Years, 20 * Years}},
+        {"GBP", {2 * Years, 3 * Years, 10 * Years, 30 * Years}},
+        {"EUR-EURIBOR-6M", {1 * Years, 10 * Years}},
+        {"USD-LIBOR-3M", {3 * Months, 1 * Years, 3 * Years, 7 * Years, 15 * Years, 25 * Years}},
+        {"GBP-LIBOR-6M", {5 * Years}}};
+
+    QuantLib::ext::shared_ptr<ScenarioSimMarketParameters> simMarketConfig(new ScenarioSimMarketParameters);
+    simMarketConfig->setYieldCurveTenors("", {3 * Months, 6 * Months, 1 * Years, 2 * Years, 3 * Years, 4 * Years,
+                                              5 * Years, 7 * Years, 10 * Years, 12 * Years, 15 * Years, 20 * Years,
+                                              30 * Years, 40 * Years, 50 * Years});
+    for (auto const& [name, t] : tenors)
+        simMarketConfig->setYieldCurveTenors(name, t);
+    simMarketConfig->setSimulateFXVols(false);
+    simMarketConfig->setSimulateEquityVols(false);
+
+    simMarketConfig->baseCcy() = "EUR";
+    simMarketConfig->setDiscountCurveNames({"EUR", "USD", "GBP"});
+    simMarketConfig->setIndices({"EUR-EURIBOR-6M", "USD-LIBOR-3M", "GBP-LIBOR-6M"});
+    simMarketConfig->interpolation() = "LogLinear";
+    simMarketConfig->setSwapVolExpiries("", {6 * Months, 1 * Years, 2 * Years, 3 * Years, 5 * Years, 10 * Years});
+    simMarketConfig->setSwapVolTerms("", {1 * Years, 2 * Years, 3 * Years, 5 * Years, 7 * Years, 10 * Years});
+    simMarketConfig->setFxCcyPairs({"USDEUR", "GBPEUR"});
+    simMarketConfig->setCpiIndices({"UKRPI", "EUHICPXT"});
+
+    QuantLib::ext::shared_ptr<ScenarioGeneratorData> sgd(new ScenarioGeneratorData);
+    sgd->sequenceType() = Sobol;
+    sgd->directionIntegers() = SobolRsg::JoeKuoD7;
+    sgd->seed() = 42;
+    sgd->setGrid(grid);
+
+    ScenarioGeneratorBuilder sgb(sgd);
+    QuantLib::ext::shared_ptr<ScenarioFactory> sf = QuantLib::ext::make_shared<SimpleScenarioFactory>(true);
+    QuantLib::ext::shared_ptr<ScenarioGenerator> sg = sgb.build(model, sf, simMarketConfig, today, d.market);
+
+    // set up model based simulation (mimicking exactly the scenario generator builder above)
+    QuantLib::ext::shared_ptr<StochasticProcess> stateProcess = model->stateProcess();
+    if (auto tmp = QuantLib::ext::dynamic_pointer_cast<CrossAssetStateProcess>(stateProcess)) {
+        tmp->resetCache(grid->timeGrid().size() - 1);
+    }
+    MultiPathGeneratorSobol pathGen(stateProcess, grid->timeGrid(), 42);
+
+    // manual copy of the initial index curves with fixed reference date (in market, they have floating ref date)
+    std::map<std::string, std::pair<Size, Handle<YieldTermStructure>>> indexCurves = {
+        {"EUR-EURIBOR-6M",
+         {0, Handle<YieldTermStructure>(
+                 QuantLib::ext::make_shared<FlatForward>(d.referenceDate, 0.02, ActualActual(ActualActual::ISDA)))}},
+        {"USD-LIBOR-3M",
+         {1, Handle<YieldTermStructure>(
+                 QuantLib::ext::make_shared<FlatForward>(d.referenceDate, 0.03, ActualActual(ActualActual::ISDA)))}},
+        {"GBP-LIBOR-6M",
+         {2, Handle<YieldTermStructure>(
+                 QuantLib::ext::make_shared<FlatForward>(d.referenceDate, 0.04, ActualActual(ActualActual::ISDA)))}}};
+    std::vector<std::string> ccys = {"EUR", "USD", "GBP"};
+
+    DayCounter dc = model->irModel(0)->termStructure()->dayCounter();
+    Size samples = 10;
+    Real tol0 = 1.0E-8; // for discount curves
+    Real tol1 = 1.0E-4; // for index curves (initial curve copies, see testCrossAssetSimMarket2)
+
+    for (Size i = 0; i < samples; i++) {
+        Sample<MultiPath> path = pathGen.next();
+        Size idx = 0;
+        for (Date date : grid->dates()) {
+            auto scenario = sg->next(date);
+            idx++;
+            Real t = grid->timeGrid()[idx];
+            for (Size j = 0; j < ccys.size(); ++j) {
+                auto const& ten = tenors.at(ccys[j]);
+                BOOST_CHECK(
+                    !scenario->has(RiskFactorKey(RiskFactorKey::KeyType::DiscountCurve, ccys[j], ten.size())));
+                for (Size k = 0; k < ten.size(); ++k) {
+                    Real T = dc.yearFraction(date, date + ten[k]);
+                    Real value = scenario->get(RiskFactorKey(RiskFactorKey::KeyType::DiscountCurve, ccys[j], k));
+                    Real expected = model->discountBond(j, t, t + T, path.value[j][idx]);
+                    BOOST_CHECK_MESSAGE(fabs(value - expected) < tol0,
+                                        "discount curve " << ccys[j] << " tenor " << ten[k] << ", path " << i
+                                                          << ", grid point " << idx << ": scenario = " << value
+                                                          << ", model = " << expected);
+                }
+            }
+            for (auto const& [name, curve] : indexCurves) {
+                auto const& ten = tenors.at(name);
+                Size j = curve.first;
+                BOOST_CHECK(!scenario->has(RiskFactorKey(RiskFactorKey::KeyType::IndexCurve, name, ten.size())));
+                for (Size k = 0; k < ten.size(); ++k) {
+                    Real T = dc.yearFraction(date, date + ten[k]);
+                    Real value = scenario->get(RiskFactorKey(RiskFactorKey::KeyType::IndexCurve, name, k));
+                    Real expected = model->discountBond(j, t, t + T, path.value[j][idx], curve.second);
+                    BOOST_CHECK_MESSAGE(fabs(value - expected) < tol1,
+                                        "index curve " << name << " tenor " << ten[k] << ", path " << i
+                                                       << ", grid point " << idx << ": scenario = " << value
+                                                       << ", model = " << expected);
+                }
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(testVanillaSwapExposure) {
     BOOST_TEST_MESSAGE("Testing EUR and USD vanilla swap exposure profiles generated with CrossAssetScenarioGenerator");
     setConventions();
@@ -22,6 +22,7 @@
 #include <orea/engine/filteredsensitivitystream.hpp>
 #include <orea/engine/observationmode.hpp>
 #include <orea/engine/parametricvar.hpp>
+#include <orea/engine/riskfactordependencies.hpp>
 #include <orea/engine/riskfilter.hpp>
 #include <orea/engine/sensitivityaggregator.hpp>
 #include <orea/engine/sensitivityanalysis.hpp>
@@ -56,6 +57,7 @@
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/osutils.hpp>
 #include <ored/utilities/to_string.hpp>
+#include <ql/math/comparison.hpp>
 #include <oret/toplevelfixture.hpp>
 #include <test/oreatoplevelfixture.hpp>
 #include <test/testportfolio.hpp>
@@ -2010,6 +2012,141 @@ BOOST_AUTO_TEST_CASE(testCrossGamma) {
     IndexManager::instance().clearHistories();
 }
 
+BOOST_AUTO_TEST_CASE(testRiskFactorDependencies) {
+
+    BOOST_TEST_MESSAGE("Testing risk factor dependencies of trades...");
+
+    SavedSettings backup;
+    Settings::instance().evaluationDate() = Date(14, April, 2016);
+
+    QuantLib::ext::shared_ptr<EngineData> data = QuantLib::ext::make_shared<EngineData>();
+    data->model("Swap") = "DiscountedCashflows";
+    data->engine("Swap") = "DiscountingSwapEngine";
+    data->model("EuropeanSwaption") = "BlackBachelier";
+    data->engine("EuropeanSwaption") = "BlackBachelierSwaptionEngine";
+
+    QuantLib::ext::shared_ptr<Portfolio> portfolio(new Portfolio());
+    portfolio->add(buildSwap("Swap_EUR", "EUR", true, 10000000.0, 0, 10, 0.03, 0.00, "1Y", "30/360", "6M", "A360",
+                             "EUR-EURIBOR-6M"));
+    portfolio->add(buildSwap("Swap_USD", "USD", true, 10000000.0, 0, 15, 0.02, 0.00, "6M", "30/360", "3M", "A360",
+                             "USD-LIBOR-3M"));
+    portfolio->add(buildEuropeanSwaption("Swaption_EUR", "Long", "EUR", true, 1000000.0, 10, 10, 0.02, 0.00, "1Y",
+                                         "30/360", "6M", "A360", "EUR-EURIBOR-6M"));
+
+    RiskFactorDependencies deps(portfolio, data, "EUR");
+
+    // the dependencies are recorded on copies of the trades, the trades of the portfolio are not built
+    for (auto const& [id, t] : portfolio->trades())
+        BOOST_CHECK_MESSAGE(t->instrument() == nullptr, "trade " << id << " was built");
+
+    using KT = RiskFactorKey::KeyType;
+    BOOST_CHECK(deps.affects("Swap_EUR", RiskFactorKey(KT::DiscountCurve, "EUR", 0)));
+    BOOST_CHECK(deps.affects("Swap_EUR", RiskFactorKey(KT::IndexCurve, "EUR-EURIBOR-6M", 3)));
+    BOOST_CHECK(!deps.affects("Swap_EUR", RiskFactorKey(KT::DiscountCurve, "USD", 0)));
+    BOOST_CHECK(!deps.affects("Swap_EUR", RiskFactorKey(KT::IndexCurve, "USD-LIBOR-3M", 0)));
+    BOOST_CHECK(!deps.affects("Swap_EUR", RiskFactorKey(KT::FXSpot, "USDEUR", 0)));
+    BOOST_CHECK(!deps.affects("Swap_EUR", RiskFactorKey(KT::SwaptionVolatility, "EUR", 0)));
+
+    BOOST_CHECK(deps.affects("Swap_USD", RiskFactorKey(KT::DiscountCurve, "USD", 0)));
+    BOOST_CHECK(deps.affects("Swap_USD", RiskFactorKey(KT::IndexCurve, "USD-LIBOR-3M", 0)));
+    BOOST_CHECK(deps.affects("Swap_USD", RiskFactorKey(KT::FXSpot, "USDEUR", 0)));
+    BOOST_CHECK(!deps.affects("Swap_USD", RiskFactorKey(KT::FXSpot, "GBPEUR", 0)));
+    BOOST_CHECK(!deps.affects("Swap_USD", RiskFactorKey(KT::DiscountCurve, "EUR", 0)));
+
+    // the swaption depends on a volatility, so it is conservatively affected by all shifts
+    BOOST_CHECK(deps.affects("Swaption_EUR", RiskFactorKey(KT::DiscountCurve, "USD", 0)));
+    BOOST_CHECK_EQUAL(deps.numberOfFullyDependentTrades(), 1);
+
+    // unknown trades are affected by all shifts, the base scenario affects all trades
+    using SD = ShiftScenarioGenerator::ScenarioDescription;
+    BOOST_CHECK(deps.affects("Unknown", RiskFactorKey(KT::DiscountCurve, "USD", 0)));
+    BOOST_CHECK(deps.affects("Swap_EUR", SD(SD::Type::Base)));
+    BOOST_CHECK(!deps.affects("Swap_EUR", SD(SD::Type::Up, RiskFactorKey(KT::DiscountCurve, "USD", 0), "")));
+    BOOST_CHECK(deps.affects("Swap_EUR", SD(SD(SD::Type::Up, RiskFactorKey(KT::DiscountCurve, "USD", 0), ""),
+                                           SD(SD::Type::Up, RiskFactorKey(KT::DiscountCurve, "EUR", 0), ""))));
+}
+
+BOOST_AUTO_TEST_CASE(testSkipUnaffectedTrades) {
+
+    BOOST_TEST_MESSAGE("Testing that skipping unaffected trades does not change the sensitivities...");
+
+    SavedSettings backup;
+
+    ObservationMode::Mode backupMode = ObservationMode::instance().mode();
+    ObservationMode::instance().setMode(ObservationMode::Mode::None);
+
+    Date today = Date(14, April, 2016);
+    Settings::instance().evaluationDate() = today;
+
+    QuantLib::ext::shared_ptr<Market> initMarket = QuantLib::ext::make_shared<TestMarket>(today);
+    QuantLib::ext::shared_ptr<analytics::ScenarioSimMarketParameters> simMarketData =
+        TestConfigurationObjects::setupSimMarketData5();
+    QuantLib::ext::shared_ptr<SensitivityScenarioData> sensiData =
+        TestConfigurationObjects::setupSensitivityScenarioData5();
+    sensiData->crossGammaFilter().push_back(pair<string, string>("DiscountCurve/EUR", "DiscountCurve/USD"));
+    sensiData->crossGammaFilter().push_back(pair<string, string>("FXSpot/EURUSD", "DiscountCurve/EUR"));
+
+    QuantLib::ext::shared_ptr<EngineData> data = QuantLib::ext::make_shared<EngineData>();
+    data->model("Swap") = "DiscountedCashflows";
+    data->engine("Swap") = "DiscountingSwapEngine";
+    data->model("EuropeanSwaption") = "BlackBachelier";
+    data->engine("EuropeanSwaption") = "BlackBachelierSwaptionEngine";
+    data->model("FxOption") = "GarmanKohlhagen";
+    data->engine("FxOption") = "AnalyticEuropeanEngine";
+
+    auto buildPortfolio = []() {
+        QuantLib::ext::shared_ptr<Portfolio> portfolio(new Portfolio());
+        portfolio->add(buildSwap("Swap_EUR", "EUR", true, 10000000.0, 0, 10, 0.03, 0.00, "1Y", "30/360", "6M", "A360",
+                                 "EUR-EURIBOR-6M"));
+        portfolio->add(buildSwap("Swap_USD", "USD", true, 10000000.0, 0, 15, 0.02, 0.00, "6M", "30/360", "3M", "A360",
+                                 "USD-LIBOR-3M"));
+        portfolio->add(buildSwap("Swap_GBP", "GBP", true, 10000000.0, 0, 20, 0.04, 0.00, "6M", "30/360", "3M", "A360",
+                                 "GBP-LIBOR-6M"));
+        portfolio->add(buildEuropeanSwaption("Swaption_EUR", "Long", "EUR", true, 1000000.0, 10, 10, 0.02, 0.00, "1Y",
+                                             "30/360", "6M", "A360", "EUR-EURIBOR-6M", "Physical"));
+        portfolio->add(buildFxOption("FxOption_EUR_USD", "Long", "Call", 3, "EUR", 10000000.0, "USD", 11000000.0));
+        return portfolio;
+    };
+
+    std::vector<QuantLib::ext::shared_ptr<SensitivityAnalysis>> sa;
+    for (bool skip : {false, true}) {
+        sa.push_back(QuantLib::ext::make_shared<SensitivityAnalysis>(buildPortfolio(), initMarket,
+                                                                     Market::defaultConfiguration, data, simMarketData,
+                                                                     sensiData, false));
+        sa.back()->skipUnaffectedTrades(skip);
+        sa.back()->generateSensitivities();
+    }
+
+    auto cube = sa[0]->sensiCube();
+    auto cubeSkip = sa[1]->sensiCube();
+    BOOST_REQUIRE(cube->tradeIdx() == cubeSkip->tradeIdx());
+    BOOST_REQUIRE(cube->factors() == cubeSkip->factors());
+    BOOST_REQUIRE(!cube->crossFactors().empty());
+    Real tol = 1E-8;
+    for (auto const& t : cube->tradeIdx()) {
+        const string& tradeId = t.first;
+        BOOST_CHECK_CLOSE(cube->npv(tradeId), cubeSkip->npv(tradeId), tol);
+        for (auto const& f : cube->factors()) {
+            BOOST_CHECK_MESSAGE(close_enough(cube->delta(tradeId, f), cubeSkip->delta(tradeId, f)),
+                                "delta " << tradeId << " " << f << ": " << cube->delta(tradeId, f) << " vs "
+                                         << cubeSkip->delta(tradeId, f));
+            BOOST_CHECK_MESSAGE(close_enough(cube->gamma(tradeId, f), cubeSkip->gamma(tradeId, f)),
+                                "gamma " << tradeId << " " << f << ": " << cube->gamma(tradeId, f) << " vs "
+                                         << cubeSkip->gamma(tradeId, f));
+        }
+        for (auto const& cf : cube->crossFactors()) {
+            const SensitivityCube::crossPair& c = cf.first;
+            BOOST_CHECK_MESSAGE(close_enough(cube->crossGamma(tradeId, c), cubeSkip->crossGamma(tradeId, c)),
+                                "cross gamma " << tradeId << " " << c.first << " " << c.second << ": "
+                                               << cube->crossGamma(tradeId, c) << " vs "
+                                               << cubeSkip->crossGamma(tradeId, c));
+        }
+    }
+
+    ObservationMode::instance().setMode(backupMode);
+    IndexManager::instance().clearHistories();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -37,6 +37,11 @@
 #include <orea/scenario/scenariosimmarketparameters.hpp>
 #include <orea/scenario/stressscenariogenerator.hpp>
 
+#include <ored/configuration/conventions.hpp>
+#include <ored/configuration/curveconfigurations.hpp>
+#include <ored/marketdata/csvloader.hpp>
+#include <ored/marketdata/todaysmarket.hpp>
+#include <ored/marketdata/todaysmarketparameters.hpp>
 #include <ored/model/lgmdata.hpp>
 #include <ored/portfolio/builders/capfloor.hpp>
 #include <ored/portfolio/builders/fxforward.hpp>
@@ -50,8 +55,10 @@
 #include <ored/utilities/osutils.hpp>
 #include <ored/report/inmemoryreport.hpp>
 
+#include <oret/datapaths.hpp>
 #include <oret/toplevelfixture.hpp>
 
+#include <ql/math/comparison.hpp>
 #include <ql/math/randomnumbers/mt19937uniformrng.hpp>
 #include <ql/time/calendars/target.hpp>
 #include <ql/time/date.hpp>
@@ -379,6 +386,148 @@ BOOST_AUTO_TEST_CASE(regression) {
     IndexManager::instance().clearHistories();
 }
 
+BOOST_AUTO_TEST_CASE(testMultiThreadedStressTest) {
+
+    BOOST_TEST_MESSAGE("Testing multi-threaded against single-threaded stress test...");
+
+#ifndef QL_ENABLE_SESSIONS
+    BOOST_TEST_MESSAGE("Skipping test, it requires a build with QL_ENABLE_SESSIONS = ON");
+#else
+
+    SavedSettings backup;
+
+    Date today(14, April, 2016);
+    Settings::instance().evaluationDate() = today;
+
+    auto conventions = QuantLib::ext::make_shared<Conventions>();
+    conventions->fromFile(TEST_INPUT_FILE("conventions.xml"));
+    InstrumentConventions::instance().setConventions(conventions);
+    auto todaysMarketParams = QuantLib::ext::make_shared<TodaysMarketParameters>();
+    todaysMarketParams->fromFile(TEST_INPUT_FILE("todaysmarket.xml"));
+    auto curveConfigs = QuantLib::ext::make_shared<CurveConfigurations>();
+    curveConfigs->fromFile(TEST_INPUT_FILE("curveconfig.xml"));
+    auto loader =
+        QuantLib::ext::make_shared<CSVLoader>(TEST_INPUT_FILE("market.txt"), TEST_INPUT_FILE("fixings.txt"), false);
+    auto market = QuantLib::ext::make_shared<TodaysMarket>(today, todaysMarketParams, loader, curveConfigs, false);
+
+    auto simMarketData = QuantLib::ext::make_shared<ScenarioSimMarketParameters>();
+    simMarketData->baseCcy() = "EUR";
+    simMarketData->setDiscountCurveNames({"EUR", "USD"});
+    simMarketData->setYieldCurveTenors("", {6 * Months, 1 * Years, 2 * Years, 5 * Years, 10 * Years, 20 * Years});
+    simMarketData->setIndices({"EUR-EURIBOR-6M", "USD-LIBOR-3M"});
+    simMarketData->interpolation() = "LogLinear";
+    simMarketData->extrapolation() = "FlatFwd";
+    simMarketData->setFxCcyPairs({"EURUSD"});
+    simMarketData->setSimulateFXVols(true);
+    simMarketData->setFxVolIsSurface(false);
+    simMarketData->setFxVolExpiries("", {1 * Years, 2 * Years, 5 * Years});
+    simMarketData->setFxVolDecayMode(string("ConstantVariance"));
+    simMarketData->setFxVolMoneyness(vector<Real>{0.0});
+    simMarketData->setFxVolCcyPairs({"EURUSD"});
+
+    auto stressData = QuantLib::ext::make_shared<StressTestScenarioData>();
+    vector<StressTestScenarioData::StressTestData> scenarios(2);
+    scenarios[0].label = "rates_up";
+    for (auto const& ccy : {"EUR", "USD"}) {
+        auto shift = QuantLib::ext::make_shared<StressTestScenarioData::CurveShiftData>();
+        shift->shiftType = ShiftType::Absolute;
+        shift->shiftTenors = {1 * Years, 5 * Years, 10 * Years};
+        shift->shifts = {0.001, 0.002, 0.003};
+        scenarios[0].discountCurveShifts[ccy] = shift;
+    }
+    for (auto const& index : {"EUR-EURIBOR-6M", "USD-LIBOR-3M"}) {
+        auto shift = QuantLib::ext::make_shared<StressTestScenarioData::CurveShiftData>();
+        shift->shiftType = ShiftType::Absolute;
+        shift->shiftTenors = {1 * Years, 5 * Years, 10 * Years};
+        shift->shifts = {0.002, 0.003, 0.004};
+        scenarios[0].indexCurveShifts[index] = shift;
+    }
+    scenarios[1].label = "fx_down";
+    scenarios[1].fxShifts["EURUSD"] = QuantLib::ext::make_shared<StressTestScenarioData::SpotShiftData>();
+    scenarios[1].fxShifts["EURUSD"]->shiftType = ShiftType::Relative;
+    scenarios[1].fxShifts["EURUSD"]->shiftSize = -0.1;
+    scenarios[1].fxVolShifts["EURUSD"] = QuantLib::ext::make_shared<StressTestScenarioData::FXVolShiftData>();
+    scenarios[1].fxVolShifts["EURUSD"]->shiftType = ShiftType::Absolute;
+    scenarios[1].fxVolShifts["EURUSD"]->shiftExpiries = {1 * Years, 5 * Years};
+    scenarios[1].fxVolShifts["EURUSD"]->shifts = {0.02, 0.03};
+    stressData->setData(scenarios);
+
+    auto engineData = QuantLib::ext::make_shared<EngineData>();
+    engineData->model("Swap") = "DiscountedCashflows";
+    engineData->engine("Swap") = "DiscountingSwapEngine";
+    engineData->model("FxOption") = "GarmanKohlhagen";
+    engineData->engine("FxOption") = "AnalyticEuropeanEngine";
+
+    // the spot starting swap requires a historical fixing that is not available, so it fails to price
+
+    auto buildPortfolio = []() {
+        auto portfolio = QuantLib::ext::make_shared<Portfolio>();
+        portfolio->add(buildSwap("1_Swap_EUR", "EUR", true, 10000000.0, 1, 10, 0.015, 0.00, "1Y", "30/360", "6M",
+                                 "A360", "EUR-EURIBOR-6M"));
+        portfolio->add(buildSwap("2_Swap_USD", "USD", false, 10000000.0, 1, 5, 0.025, 0.00, "6M", "30/360", "3M",
+                                 "A360", "USD-LIBOR-3M"));
+        portfolio->add(buildFxOption("3_FxOption_EUR_USD", "Long", "Call", 3, "EUR", 10000000.0, "USD", 11000000.0));
+        portfolio->add(buildSwap("4_Swap_EUR_Failing", "EUR", true, 10000000.0, 0, 10, 0.015, 0.00, "1Y", "30/360",
+                                 "6M", "A360", "EUR-EURIBOR-6M"));
+        return portfolio;
+    };
+
+    std::vector<QuantLib::ext::shared_ptr<InMemoryReport>> reports, cfReports;
+    for (Size nThreads : {1, 2}) {
+        reports.push_back(QuantLib::ext::make_shared<InMemoryReport>());
+        cfReports.push_back(QuantLib::ext::make_shared<InMemoryReport>());
+        runStressTest(buildPortfolio(), market, Market::defaultConfiguration, engineData, simMarketData, stressData,
+                      reports.back(), cfReports.back(), 0.0, 2, false, *curveConfigs, *todaysMarketParams, nullptr,
+                      nullptr, QuantLib::ext::make_shared<IborFallbackConfig>(IborFallbackConfig::defaultConfig()),
+                      false, nullptr, true, nThreads, loader);
+    }
+
+    auto checkEqual = [](const InMemoryReport& r1, const InMemoryReport& r2) {
+        BOOST_REQUIRE_EQUAL(r1.columns(), r2.columns());
+        BOOST_REQUIRE_EQUAL(r1.rows(), r2.rows());
+        for (Size c = 0; c < r1.columns(); ++c) {
+            BOOST_CHECK_EQUAL(r1.header(c), r2.header(c));
+            for (Size r = 0; r < r1.rows(); ++r) {
+                auto const& v1 = r1.data(c, r);
+                auto const& v2 = r2.data(c, r);
+                BOOST_REQUIRE_EQUAL(v1.which(), v2.which());
+                if (auto x1 = boost::get<Real>(&v1)) {
+                    Real x2 = boost::get<Real>(v2);
+                    BOOST_CHECK_MESSAGE((*x1 == Null<Real>() && x2 == Null<Real>()) ||
+                                            (*x1 != Null<Real>() && x2 != Null<Real>() && close_enough(*x1, x2)),
+                                        "column " << r1.header(c) << ", row " << r << ": " << *x1 << " vs " << x2);
+                } else {
+                    BOOST_CHECK_MESSAGE(v1 == v2, "column " << r1.header(c) << ", row " << r << " differs");
+                }
+            }
+        }
+    };
+
+    // 4 trades times 2 scenarios, all are reported with threshold 0
+
+    BOOST_CHECK_EQUAL(reports[0]->rows(), 8);
+    checkEqual(*reports[0], *reports[1]);
+    checkEqual(*cfReports[0], *cfReports[1]);
+
+    // the failing trade has no base and scenario npvs in both runs
+
+    for (auto const& r : reports) {
+        Size failed = 0;
+        for (Size i = 0; i < r->rows(); ++i) {
+            if (boost::get<string>(r->data(0, i)) != "4_Swap_EUR_Failing")
+                continue;
+            BOOST_CHECK(boost::get<Real>(r->data(2, i)) == Null<Real>());
+            BOOST_CHECK(boost::get<Real>(r->data(3, i)) == Null<Real>());
+            BOOST_CHECK(boost::get<Real>(r->data(4, i)) == Null<Real>());
+            ++failed;
+        }
+        BOOST_CHECK_EQUAL(failed, 2);
+    }
+
+    IndexManager::instance().clearHistories();
+#endif
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
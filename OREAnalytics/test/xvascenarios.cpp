@@ -0,0 +1,184 @@
+/*
+ Copyright (C) 2025 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/app/analytics/analyticfactory.hpp>
+#include <orea/app/analyticsmanager.hpp>
+#include <orea/app/initbuilders.hpp>
+#include <orea/app/inputparameters.hpp>
+#include <orea/app/marketdatainmemoryloader.hpp>
+#include <ored/configuration/conventions.hpp>
+#include <ored/configuration/curveconfigurations.hpp>
+#include <ored/report/inmemoryreport.hpp>
+#include <oret/datapaths.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <ql/math/comparison.hpp>
+#include <test/oreatoplevelfixture.hpp>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace QuantLib;
+using namespace ore::data;
+using namespace ore::analytics;
+
+namespace {
+
+// the rates and fx market is shared with the stress test and the pricing engines with the analytics manager test,
+// this test only adds the credit curve of the counterparty and the xva configurations
+string sharedInputFile(const string& test, const string& fileName) {
+    return (path(basePath) / "input" / test / fileName).string();
+}
+
+vector<string> readLines(const string& fileName) {
+    vector<string> lines;
+    std::ifstream file(fileName);
+    QL_REQUIRE(file.is_open(), "could not open " << fileName);
+    for (string line; std::getline(file, line);) {
+        if (!line.empty())
+            lines.push_back(line);
+    }
+    return lines;
+}
+
+QuantLib::ext::shared_ptr<AnalyticsManager> runXvaScenarios(const Size scenarioThreads) {
+    auto inputs = QuantLib::ext::make_shared<InputParameters>();
+    inputs->setAsOfDate("2016-04-14");
+    inputs->setBaseCurrency("EUR");
+
+    auto conventions = QuantLib::ext::make_shared<Conventions>();
+    conventions->fromFile(sharedInputFile("stresstest", "conventions.xml"));
+    conventions->fromFile(TEST_INPUT_FILE("conventions.xml"));
+    inputs->setConventions(conventions);
+
+    auto curveConfigs = QuantLib::ext::make_shared<CurveConfigurations>();
+    curveConfigs->fromFile(sharedInputFile("stresstest", "curveconfig.xml"));
+    CurveConfigurations creditCurveConfigs;
+    creditCurveConfigs.fromFile(TEST_INPUT_FILE("curveconfig.xml"));
+    curveConfigs->addAdditionalCurveConfigs(creditCurveConfigs);
+    inputs->setCurveConfigs(curveConfigs);
+
+    inputs->setTodaysMarketParamsFromFile(TEST_INPUT_FILE("todaysmarket.xml"));
+    inputs->setPricingEngineFromFile(sharedInputFile("analyticsmanager", "pricingengine.xml"));
+    inputs->setPortfolioFromFile("portfolio.xml", TEST_INPUT);
+
+    // classic exposure simulation, the cross asset model is not calibrated
+    inputs->setExposureBaseCurrency("EUR");
+    inputs->setXvaBaseCurrency("EUR");
+    inputs->setExposureSimMarketParamsFromFile(TEST_INPUT_FILE("simulation.xml"));
+    inputs->setCrossAssetModelDataFromFile(TEST_INPUT_FILE("simulation.xml"));
+    inputs->setScenarioGeneratorDataFromFile(TEST_INPUT_FILE("simulation.xml"));
+    inputs->setSimulationPricingEngineFromFile(sharedInputFile("analyticsmanager", "pricingengine.xml"));
+    inputs->setNettingSetManagerFromFile(TEST_INPUT_FILE("netting.xml"));
+
+    inputs->setXvaSensiSimMarketParamsFromFile(TEST_INPUT_FILE("xvasimmarket.xml"));
+    inputs->setXvaSensiScenarioDataFromFile(TEST_INPUT_FILE("sensitivity.xml"));
+    inputs->setXvaSensiParSensi(false);
+    inputs->setXvaSensiThreshold(0.0);
+    inputs->setXvaSensiScenarioThreads(scenarioThreads);
+
+    inputs->setXvaStressSimMarketParamsFromFile(TEST_INPUT_FILE("xvasimmarket.xml"));
+    inputs->setXvaStressScenarioDataFromFile(TEST_INPUT_FILE("stresstest.xml"));
+    inputs->setXvaStressScenarioThreads(scenarioThreads);
+
+    inputs->setAnalytics("XVA_SENSITIVITY,XVA_STRESS");
+    inputs->setThreads(2);
+
+    Settings::instance().evaluationDate() = inputs->asof();
+    InstrumentConventions::instance().setConventions(inputs->conventions());
+
+    vector<string> marketData = readLines(sharedInputFile("stresstest", "market.txt"));
+    for (auto const& line : readLines(TEST_INPUT_FILE("market.txt")))
+        marketData.push_back(line);
+
+    auto analyticsManager = QuantLib::ext::make_shared<AnalyticsManager>(
+        inputs, QuantLib::ext::make_shared<MarketDataInMemoryLoader>(inputs, marketData, vector<string>()));
+    analyticsManager->initialise();
+    analyticsManager->runAnalytics();
+    return analyticsManager;
+}
+
+void checkEqual(const InMemoryReport& r1, const InMemoryReport& r2, const string& name) {
+    BOOST_REQUIRE_EQUAL(r1.columns(), r2.columns());
+    BOOST_REQUIRE_EQUAL(r1.rows(), r2.rows());
+    for (Size c = 0; c < r1.columns(); ++c) {
+        BOOST_CHECK_EQUAL(r1.header(c), r2.header(c));
+        for (Size r = 0; r < r1.rows(); ++r) {
+            auto const& v1 = r1.data(c, r);
+            auto const& v2 = r2.data(c, r);
+            BOOST_REQUIRE_EQUAL(v1.which(), v2.which());
+            if (auto x1 = boost::get<Real>(&v1)) {
+                Real x2 = boost::get<Real>(v2);
+                BOOST_CHECK_MESSAGE((*x1 == Null<Real>() && x2 == Null<Real>()) ||
+                                        (*x1 != Null<Real>() && x2 != Null<Real>() && close_enough(*x1, x2)),
+                                    name << ", column " << r1.header(c) << ", row " << r << ": " << *x1 << " vs "
+                                         << x2);
+            } else {
+                BOOST_CHECK_MESSAGE(v1 == v2, name << ", column " << r1.header(c) << ", row " << r << " differs");
+            }
+        }
+    }
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(XvaScenariosTest)
+
+BOOST_AUTO_TEST_CASE(testConcurrentXvaScenarioRuns) {
+
+    BOOST_TEST_MESSAGE("Testing concurrent against sequential xva runs under sensitivity and stress scenarios...");
+
+    SavedSettings backup;
+
+    if (AnalyticFactory::instance().getBuilders().empty())
+        initBuilders();
+
+    auto sequential = runXvaScenarios(1);
+    auto concurrent = runXvaScenarios(2);
+
+    BOOST_CHECK(sequential->failedAnalytics().empty());
+    BOOST_CHECK(concurrent->failedAnalytics().empty());
+
+    auto seqReports = sequential->reports();
+    auto conReports = concurrent->reports();
+    for (auto const& analytic : {"XVA_SENSITIVITY", "XVA_STRESS"}) {
+        auto const& seq = seqReports[analytic];
+        auto const& con = conReports[analytic];
+        BOOST_CHECK_EQUAL(seq.size(), con.size());
+        for (auto const& [name, report] : seq) {
+            BOOST_TEST_MESSAGE(analytic << " report " << name);
+            auto r = con.find(name);
+            BOOST_REQUIRE_MESSAGE(r != con.end(), analytic << " report " << name << " missing in concurrent run");
+            checkEqual(*report, *r->second, name);
+        }
+    }
+
+    // the xva under each scenario is reported for the netting set and both trades, a failed scenario run is skipped
+    auto xvaStress = getReport(seqReports, "XVA_STRESS", "xva");
+    BOOST_CHECK_EQUAL(xvaStress->rows(), 3 * 3);
+    auto cvaSensi = getReport(seqReports, "XVA_SENSITIVITY", "xva_zero_sensitivity_cva");
+    BOOST_CHECK(cvaSensi->rows() > 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -58,7 +58,8 @@ CamAmcBondEngineBuilder::buildMcEngine(const QuantLib::ext::shared_ptr<LGM>& lgm
         parseInteger(engineParameter("Regression.MaxSimTimesIR", {}, false, "0")),
         parseInteger(engineParameter("Regression.MaxSimTimesFX", {}, false, "0")),
         parseInteger(engineParameter("Regression.MaxSimTimesEQ", {}, false, "0")),
-        parseVarGroupMode(engineParameter("Regression.VarGroupMode", {}, false, "Global")));
+        parseVarGroupMode(engineParameter("Regression.VarGroupMode", {}, false, "Global")),
+        parseRandomVariableRegressionMethod(engineParameter("Regression.Method", {}, false, "QR")));
 }
 
 QuantLib::ext::shared_ptr<PricingEngine>
@@ -498,7 +498,8 @@ QuantLib::ext::shared_ptr<QuantExt::PricingEngine> CallableBondCamMcEngineBuilde
         parseInteger(engineParameter("Regression.MaxSimTimesIR", {}, false, "0")),
         parseInteger(engineParameter("Regression.MaxSimTimesFX", {}, false, "0")),
         parseInteger(engineParameter("Regression.MaxSimTimesEQ", {}, false, "0")),
-        parseVarGroupMode(engineParameter("Regression.VarGroupMode", {}, false, "Global")));
+        parseVarGroupMode(engineParameter("Regression.VarGroupMode", {}, false, "Global")),
+        parseRandomVariableRegressionMethod(engineParameter("Regression.Method", {}, false, "QR")));
 }
 
 QuantLib::ext::shared_ptr<QuantExt::PricingEngine> CallableBondCamAmcEngineBuilder::engineImpl(
@@ -581,7 +582,8 @@ QuantLib::ext::shared_ptr<QuantExt::PricingEngine> CallableBondCamAmcEngineBuild
         parseInteger(engineParameter("Regression.MaxSimTimesIR", {}, false, "0")),
         parseInteger(engineParameter("Regression.MaxSimTimesFX", {}, false, "0")),
         parseInteger(engineParameter("Regression.MaxSimTimesEQ", {}, false, "0")),
-        parseVarGroupMode(engineParameter("Regression.VarGroupMode", {}, false, "Global")));
+        parseVarGroupMode(engineParameter("Regression.VarGroupMode", {}, false, "Global")),
+        parseRandomVariableRegressionMethod(engineParameter("Regression.Method", {}, false, "QR")));
 }
 
 } // namespace data
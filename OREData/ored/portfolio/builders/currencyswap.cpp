@@ -105,7 +105,8 @@ CamAmcCurrencySwapEngineBuilder::engineImpl(const std::vector<Currency>& ccys, c
         parseInteger(engineParameter("Regression.MaxSimTimesIR", {}, false, "0")),
         parseInteger(engineParameter("Regression.MaxSimTimesFX", {}, false, "0")),
         parseInteger(engineParameter("Regression.MaxSimTimesEQ", {}, false, "0")),
-        parseVarGroupMode(engineParameter("Regression.VarGroupMode", {}, false, "Global")));
+        parseVarGroupMode(engineParameter("Regression.VarGroupMode", {}, false, "Global")),
+        parseRandomVariableRegressionMethod(engineParameter("Regression.Method", {}, false, "QR")));
 
     return engine;
 }
@@ -613,6 +613,8 @@ void ScriptedTradeEngineBuilder::populateModelParameters() {
         }
         params_.regressionVarianceCutoff = parseRealOrNull(
             engineParameter("RegressionVarianceCutoff", getModelEngineQualifiers(), false, std::string()));
+        params_.regressionMethod = parseRandomVariableRegressionMethod(
+            engineParameter("RegressionMethod", getModelEngineQualifiers(), false, "QR"));
         params_.externalDeviceCompatibilityMode = externalDeviceCompatibilityMode_;
     } else if (engineParam_ == "FD") {
         modelSize_ = parseInteger(engineParameter("StateGridPoints", getModelEngineQualifiers()));
@@ -468,7 +468,7 @@ RandomVariable AssetModel::npv(const RandomVariable& amount, const Date& obsdate
                 regressionCoefficients(amount, state,
                                        multiPathBasisSystem(state.size(), params_.regressionOrder, params_.polynomType,
                                                             {}, std::min(size(), trainingSamples())),
-                                       filter, RandomVariableRegressionMethod::QR);
+                                       filter, params_.regressionMethod);
             DLOG("AssetModel::npv(" << ore::data::to_string(obsdate) << "): regression coefficients are " << coeff
                                     << " (got model state size " << nModelStates << " and " << nAddReg
                                     << " additional regressors, coordinate transform " << coordinateTransform.columns()
@@ -668,7 +668,7 @@ RandomVariable GaussianCam::npv(const RandomVariable& amount, const Date& obsdat
         coeff = regressionCoefficients(amount, state,
                                        multiPathBasisSystem(state.size(), params_.regressionOrder, params_.polynomType,
                                                             {}, std::min(size(), trainingSamples())),
-                                       filter, RandomVariableRegressionMethod::QR);
+                                       filter, params_.regressionMethod);
         DLOG("GaussianCam::npv(" << ore::data::to_string(obsdate) << "): regression coefficients are " << coeff
                                  << " (got model state size " << nModelStates << " and " << nAddReg
                                  << " additional regressors, coordinate transform " << coordinateTransform.columns()
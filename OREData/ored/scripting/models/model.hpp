@@ -67,6 +67,7 @@ public:
         QuantLib::SobolBrownianGenerator::Ordering sobolOrdering = QuantLib::SobolBrownianGenerator::Steps;
         QuantLib::SobolRsg::DirectionIntegers sobolDirectionIntegers = QuantLib::SobolRsg::DirectionIntegers::JoeKuoD7;
         QuantLib::Real regressionVarianceCutoff = Null<QuantLib::Real>();
+        QuantExt::RandomVariableRegressionMethod regressionMethod = QuantExt::RandomVariableRegressionMethod::QR;
 
         // FD - related parameters
 
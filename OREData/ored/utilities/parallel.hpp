@@ -0,0 +1,86 @@
+/*
+ Copyright (C) 2025 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file ored/utilities/parallel.hpp
+    \brief Utilities for running independent tasks on several threads
+    \ingroup utilities
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ore {
+namespace data {
+
+/*! \addtogroup utilities
+    @{
+*/
+
+//! Calls f(i) for i = 0, ..., n - 1 on up to nThreads threads
+/*! The indices are handed out to the threads one at a time, so the tasks may differ in size. If nThreads is 0 or 1
+    or n is 1, all tasks are run on the calling thread. If a task throws, no further tasks are started and the first
+    exception is rethrown on the calling thread once all threads have finished.
+
+    The tasks run on threads other than the calling thread, so they must be independent of each other and must not
+    rely on thread local state of the calling thread. In particular, with QL_ENABLE_SESSIONS the QuantLib singletons
+    (Settings, IndexManager, ...) seen by the tasks are not the ones of the calling thread. */
+template <class F> void parallelFor(std::size_t n, std::size_t nThreads, const F& f) {
+    nThreads = std::min(nThreads, n);
+    if (nThreads <= 1) {
+        for (std::size_t i = 0; i < n; ++i)
+            f(i);
+        return;
+    }
+    std::atomic<std::size_t> next(0);
+    std::atomic<bool> failed(false);
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    std::vector<std::thread> workers;
+    workers.reserve(nThreads);
+    for (std::size_t t = 0; t < nThreads; ++t) {
+        workers.emplace_back([&]() {
+            std::size_t i;
+            while (!failed && (i = next++) < n) {
+                try {
+                    f(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error)
+                        error = std::current_exception();
+                    failed = true;
+                }
+            }
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+    if (error)
+        std::rethrow_exception(error);
+}
+
+//! @}
+
+} // namespace data
+} // namespace ore
@@ -1627,6 +1627,18 @@ QuantExt::McRegressionModel::VarGroupMode parseVarGroupMode(const std::string& s
     }
 }
 
+QuantExt::RandomVariableRegressionMethod parseRandomVariableRegressionMethod(const std::string& s) {
+    if (s == "QR")
+        return QuantExt::RandomVariableRegressionMethod::QR;
+    else if (s == "SVD")
+        return QuantExt::RandomVariableRegressionMethod::SVD;
+    else if (s == "NormalEquations")
+        return QuantExt::RandomVariableRegressionMethod::NormalEquations;
+    else {
+        QL_FAIL("RegressionMethod '" << s << "' not recognized, expected QR, SVD, NormalEquations");
+    }
+}
+
 MporCashFlowMode parseMporCashFlowMode(const string& s){
     static map<string, MporCashFlowMode> m = {{"Unspecified", MporCashFlowMode::Unspecified},
                                               {"NonePay", MporCashFlowMode::NonePay},
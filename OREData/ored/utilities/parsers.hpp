@@ -34,6 +34,7 @@
 #include <qle/currencies/configurablecurrency.hpp>
 #include <qle/indexes/bondindex.hpp>
 #include <qle/instruments/cdsoption.hpp>
+#include <qle/math/randomvariable.hpp>
 #include <qle/methods/multipathgeneratorbase.hpp>
 #include <qle/models/crossassetmodel.hpp>
 #include <qle/pricingengines/mcregressionmodel.hpp>
@@ -625,6 +626,12 @@ QuantExt::McRegressionModel::RegressorModel parseRegressorModel(const std::strin
 */
 QuantExt::McRegressionModel::VarGroupMode parseVarGroupMode(const std::string& s);
 
+//! Convert text to QuantExt::RandomVariableRegressionMethod
+/*!
+\ingroup utilities
+*/
+QuantExt::RandomVariableRegressionMethod parseRandomVariableRegressionMethod(const std::string& s);
+
 enum MporCashFlowMode { Unspecified, NonePay, BothPay, WePay, TheyPay };
 
 //! Convert text to MporCashFlowMode
@@ -26,6 +26,8 @@
 
 #include <boost/math/distributions/normal.hpp>
 
+#include <algorithm>
+
 namespace QuantExt {
 
 std::size_t ComputationGraph::nan = std::numeric_limits<std::size_t>::max();
@@ -41,6 +43,8 @@ void ComputationGraph::clear() {
     variables_.clear();
     variableVersion_.clear();
     labels_.clear();
+    cseNodes_.clear();
+    numberOfEliminatedNodes_ = 0;
 }
 
 std::size_t ComputationGraph::size() const { return predecessors_.size(); }
@@ -61,6 +65,21 @@ std::size_t ComputationGraph::insert(const std::string& label) {
 std::size_t ComputationGraph::insert(const std::vector<std::size_t>& predecessors, const std::size_t opId,
                                      const std::string& label) {
     std::size_t node = predecessors_.size();
+    if (enableCse_ && opId != RandomVariableOpCode::None && opId != RandomVariableOpCode::ConditionalExpectation) {
+        auto key = std::make_tuple(currentRedBlockId_, opId, predecessors);
+        if (predecessors.size() == 2 &&
+            (opId == RandomVariableOpCode::Add || opId == RandomVariableOpCode::Mult ||
+             opId == RandomVariableOpCode::Min || opId == RandomVariableOpCode::Max ||
+             opId == RandomVariableOpCode::IndicatorEq))
+            std::sort(std::get<2>(key).begin(), std::get<2>(key).end());
+        auto c = cseNodes_.insert(std::make_pair(std::move(key), node));
+        if (!c.second) {
+            ++numberOfEliminatedNodes_;
+            if (enableLabels_ && !label.empty())
+                labels_[c.first->second].insert(label);
+            return c.first->second;
+        }
+    }
     predecessors_.push_back(predecessors);
     opId_.push_back(opId);
     for (auto const& p : predecessors) {
@@ -158,6 +177,10 @@ void ComputationGraph::enableLabels(const bool b) { enableLabels_ = b; }
 
 const std::map<std::size_t, std::set<std::string>>& ComputationGraph::labels() const { return labels_; }
 
+void ComputationGraph::enableCommonSubexpressionElimination(const bool b) { enableCse_ = b; }
+
+std::size_t ComputationGraph::numberOfEliminatedNodes() const { return numberOfEliminatedNodes_; }
+
 void ComputationGraph::startRedBlock() {
     currentRedBlockId_ = ++nextRedBlockId_;
     if (!redBlockRange_.empty())
@@ -202,13 +225,27 @@ std::size_t cg_add(ComputationGraph& g, const std::size_t a, const std::size_t b
 }
 
 std::size_t cg_add(ComputationGraph& g, const std::vector<std::size_t>& a, const std::string& label) {
-    if (a.empty())
-        return cg_const(g, 0.0);
-    if (a.size() == 1)
-        return a[0];
-    if (a.size() == 2)
-        return cg_add(g, a[0], a[1], label);
-    return g.insert(a, RandomVariableOpCode::Add, label);
+    // fold the constant summands into one
+    std::vector<std::size_t> args;
+    double c = 0.0;
+    bool hasConstant = false;
+    for (auto const n : a) {
+        if (g.isConstant(n)) {
+            c += g.constantValue(n);
+            hasConstant = true;
+        } else {
+            args.push_back(n);
+        }
+    }
+    if (hasConstant && !QuantLib::close_enough(c, 0.0))
+        args.push_back(cg_const(g, c));
+    if (args.empty())
+        return cg_const(g, c);
+    if (args.size() == 1)
+        return args[0];
+    if (args.size() == 2)
+        return cg_add(g, args[0], args[1], label);
+    return g.insert(args, RandomVariableOpCode::Add, label);
 }
 
 std::size_t cg_subtract(ComputationGraph& g, const std::size_t a, const std::size_t b, const std::string& label) {
@@ -398,4 +435,18 @@ std::set<std::size_t> dependentNodes(const ComputationGraph& g, const std::size_
     return nodes;
 }
 
+std::vector<bool> requiredNodes(const ComputationGraph& g, const std::vector<bool>& targets) {
+    QL_REQUIRE(targets.size() == g.size(), "requiredNodes(): targets size (" << targets.size()
+                                                                            << ") does not match graph size ("
+                                                                            << g.size() << ")");
+    std::vector<bool> result(targets);
+    for (std::size_t n = g.size(); n > 0; --n) {
+        if (!result[n - 1])
+            continue;
+        for (auto const p : g.predecessors(n - 1))
+            result[p] = true;
+    }
+    return result;
+}
+
 } // namespace QuantExt
@@ -27,11 +27,15 @@
 #include <map>
 #include <set>
 #include <string>
+#include <tuple>
 #include <vector>
 
 namespace QuantExt {
 
-/*! - opId = 0 should refer to "no operation" */
+/*! - opId = 0 should refer to "no operation"
+    - if common subexpression elimination is enabled, insert() returns an existing node with the same op and
+      predecessors in the same red block instead of adding a new node; this is not done for "no operation" and
+      conditional expectation nodes, which the graph builders use as distinct target nodes */
 class ComputationGraph {
 public:
     enum class VarDoesntExist { Nan, Create, Throw };
@@ -60,6 +64,9 @@ public:
     void enableLabels(const bool b = true);
     const std::map<std::size_t, std::set<std::string>>& labels() const;
 
+    void enableCommonSubexpressionElimination(const bool b = true);
+    std::size_t numberOfEliminatedNodes() const;
+
     void startRedBlock();
     void endRedBlock();
     std::size_t redBlockId(const std::size_t node) const;
@@ -84,6 +91,10 @@ private:
     bool enableLabels_ = false;
     std::map<std::size_t, std::set<std::string>> labels_;
 
+    bool enableCse_ = false;
+    std::map<std::tuple<std::size_t, std::size_t, std::vector<std::size_t>>, std::size_t> cseNodes_;
+    std::size_t numberOfEliminatedNodes_ = 0;
+
     std::size_t currentRedBlockId_ = 0;
     std::size_t nextRedBlockId_ = 0;
     std::vector<std::pair<std::size_t, std::size_t>> redBlockRange_;
@@ -128,4 +139,8 @@ std::size_t cg_normalPdf(ComputationGraph& g, const std::size_t a, const std::st
 
 std::set<std::size_t> dependentNodes(const ComputationGraph& g, const std::size_t start, const std::size_t end);
 
+/*! returns a flag for each node indicating whether it is one of the given target nodes or a direct or indirect
+    predecessor of a target node, the other nodes do not need to be evaluated to compute the targets */
+std::vector<bool> requiredNodes(const ComputationGraph& g, const std::vector<bool>& targets);
+
 } // namespace QuantExt
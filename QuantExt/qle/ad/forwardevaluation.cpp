@@ -0,0 +1,117 @@
+/*
+ Copyright (C) 2025 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/ad/forwardevaluation.hpp>
+
+#include <algorithm>
+#include <set>
+
+namespace QuantExt {
+
+ForwardEvaluationPlan::ForwardEvaluationPlan(
+    const ComputationGraph& g, const bool releaseValues, const bool keepValuesForDerivatives,
+    const std::vector<std::function<std::pair<std::vector<bool>, bool>(const std::size_t)>>&
+        opRequiresNodesForDerivatives,
+    const std::vector<bool>& keepNodes, const std::size_t startNode, const std::size_t endNode,
+    const bool redBlockReconstruction, const std::vector<bool>& opAllowsPredeletion,
+    const std::vector<bool>& requiredNodes)
+    : graphSize_(g.size()) {
+
+    QL_REQUIRE(requiredNodes.empty() || requiredNodes.size() == g.size(),
+               "ForwardEvaluationPlan: required nodes size (" << requiredNodes.size() << ") does not match graph size ("
+                                                              << g.size() << ")");
+
+    // if only the required nodes are evaluated, a node can be released after its last required successor
+
+    std::vector<std::size_t> maxRequiredNodeRequiringArg;
+    if (!requiredNodes.empty()) {
+        maxRequiredNodeRequiringArg.resize(g.size(), 0);
+        for (std::size_t node = 0; node < g.size(); ++node) {
+            if (requiredNodes[node]) {
+                for (auto const p : g.predecessors(node))
+                    maxRequiredNodeRequiringArg[p] = node;
+            }
+        }
+    }
+
+    std::vector<bool> keepNodesDerivatives;
+    if (releaseValues && keepValuesForDerivatives)
+        keepNodesDerivatives = std::vector<bool>(g.size(), false);
+
+    // loop over the nodes in the graph in ascending order, this mirrors the logic in forwardEvaluation()
+
+    std::set<std::size_t> nodesToRelease;
+    for (std::size_t node = startNode; node < (endNode == ComputationGraph::nan ? g.size() : endNode); ++node) {
+
+        // only nodes computed by an op applied to predecessors are evaluated
+
+        const auto& pred = g.predecessors(node);
+        if (pred.empty() || (!requiredNodes.empty() && !requiredNodes[node]))
+            continue;
+
+        Instruction instr;
+        instr.node = node;
+        instr.opId = g.opId(node);
+        instr.argsBegin = args_.size();
+        args_.insert(args_.end(), pred.begin(), pred.end());
+        instr.argsEnd = args_.size();
+        maxNumberOfArgs_ = std::max(maxNumberOfArgs_, pred.size());
+
+        // determine the nodes that are no longer needed after the evaluation of this node
+
+        nodesToRelease.clear();
+        if (releaseValues) {
+            for (std::size_t arg = 0; arg < pred.size(); ++arg) {
+                std::size_t p = pred[arg];
+
+                if (!keepNodesDerivatives.empty()) {
+
+                    // is the node required to compute derivatives, then add it to the keep nodes vector
+
+                    if (opRequiresNodesForDerivatives[g.opId(p)](pred.size()).second ||
+                        opRequiresNodesForDerivatives[g.opId(node)](pred.size()).first[arg])
+                        keepNodesDerivatives[p] = true;
+                }
+
+                // is the node still needed for the forward evaluation?
+
+                if ((maxRequiredNodeRequiringArg.empty() ? g.maxNodeRequiringArg(p) : maxRequiredNodeRequiringArg[p]) >
+                    node)
+                    continue;
+
+                // is the node marked as to be kept ?
+
+                if ((!keepNodes.empty() && keepNodes[p]) ||
+                    (!keepNodesDerivatives.empty() && keepNodesDerivatives[p] &&
+                     (g.redBlockId(p) == 0 || redBlockReconstruction)))
+                    continue;
+
+                nodesToRelease.insert(p);
+            }
+        }
+
+        instr.releaseBegin = release_.size();
+        release_.insert(release_.end(), nodesToRelease.begin(), nodesToRelease.end());
+        instr.releaseEnd = release_.size();
+        instr.preRelease = !opAllowsPredeletion.empty() && opAllowsPredeletion[instr.opId];
+
+        instructions_.push_back(instr);
+    }
+}
+
+} // namespace QuantExt
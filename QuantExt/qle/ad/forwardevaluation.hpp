@@ -24,89 +24,106 @@
 
 #include <qle/ad/computationgraph.hpp>
 
+#include <ql/errors.hpp>
 #include <ql/shared_ptr.hpp>
 
+#include <functional>
+#include <vector>
+
 namespace QuantExt {
 
+//! Precompiled forward evaluation of a computation graph
+/*! Holds the nodes to evaluate in a flat list of instructions with their argument indices and the nodes whose values
+    can be released after (or, if the op allows it, before) the evaluation of the instruction. The plan only depends on
+    the graph and the keep / release settings, so it can be built once and then be used for repeated evaluations of the
+    same graph, e.g. one per sensitivity scenario, without any per-node allocations or bookkeeping. */
+class ForwardEvaluationPlan {
+public:
+    struct Instruction {
+        std::size_t node;
+        std::size_t opId;
+        std::size_t argsBegin, argsEnd;
+        std::size_t releaseBegin, releaseEnd;
+        bool preRelease;
+    };
+
+    ForwardEvaluationPlan() = default;
+    /*! The parameters have the same meaning as for forwardEvaluation() below. If releaseValues is false, no values are
+        released, this corresponds to calling forwardEvaluation() without a deleter. If requiredNodes is given, nodes
+        not marked as required are not evaluated, see requiredNodes() in computationgraph.hpp. */
+    ForwardEvaluationPlan(const ComputationGraph& g, const bool releaseValues, const bool keepValuesForDerivatives = true,
+                          const std::vector<std::function<std::pair<std::vector<bool>, bool>(const std::size_t)>>&
+                              opRequiresNodesForDerivatives = {},
+                          const std::vector<bool>& keepNodes = {}, const std::size_t startNode = 0,
+                          const std::size_t endNode = ComputationGraph::nan, const bool redBlockReconstruction = false,
+                          const std::vector<bool>& opAllowsPredeletion = {},
+                          const std::vector<bool>& requiredNodes = {});
+
+    bool empty() const { return graphSize_ == 0; }
+    std::size_t graphSize() const { return graphSize_; }
+    std::size_t maxNumberOfArgs() const { return maxNumberOfArgs_; }
+    const std::vector<Instruction>& instructions() const { return instructions_; }
+    const std::vector<std::size_t>& args() const { return args_; }
+    const std::vector<std::size_t>& release() const { return release_; }
+
+private:
+    std::size_t graphSize_ = 0;
+    std::size_t maxNumberOfArgs_ = 0;
+    std::vector<Instruction> instructions_;
+    std::vector<std::size_t> args_;
+    std::vector<std::size_t> release_;
+};
+
+//! Forward evaluation using a precompiled plan
 template <class T>
-void forwardEvaluation(const ComputationGraph& g, std::vector<T>& values,
+void forwardEvaluation(const ForwardEvaluationPlan& plan, std::vector<T>& values,
                        const std::vector<std::function<T(const std::vector<const T*>&, QuantLib::Size)>>& ops,
-                       std::function<void(T&)> deleter = {}, bool keepValuesForDerivatives = true,
-                       const std::vector<std::function<std::pair<std::vector<bool>, bool>(const std::size_t)>>&
-                           opRequiresNodesForDerivatives = {},
-                       const std::vector<bool>& keepNodes = {}, const std::size_t startNode = 0,
-                       const std::size_t endNode = ComputationGraph::nan, const bool redBlockReconstruction = false,
-                       std::function<void(T&)> preDeleter = {}, const std::vector<bool>& opAllowsPredeletion = {}) {
-
-    std::vector<bool> keepNodesDerivatives;
-    if (deleter && keepValuesForDerivatives)
-        keepNodesDerivatives = std::vector<bool>(g.size(), false);
-
-    // loop over the nodes in the graph in ascending order
-
-    for (std::size_t node = startNode; node < (endNode == ComputationGraph::nan ? g.size() : endNode); ++node) {
-
-        // if a node is computed by an op applied to predecessors ...
-
-        if (!g.predecessors(node).empty()) {
-
-            // evaluate the node
-
-            std::vector<const T*> args(g.predecessors(node).size());
-            for (std::size_t arg = 0; arg < g.predecessors(node).size(); ++arg) {
-                args[arg] = &values[g.predecessors(node)[arg]];
-            }
-
-            std::set<std::size_t> nodesToDelete;
-            if (deleter) {
-                for (std::size_t arg = 0; arg < g.predecessors(node).size(); ++arg) {
-                    std::size_t p = g.predecessors(node)[arg];
+                       std::function<void(T&)> deleter = {}, std::function<void(T&)> preDeleter = {}) {
 
-                    if (!keepNodesDerivatives.empty()) {
+    QL_REQUIRE(values.size() >= plan.graphSize(), "forwardEvaluation(): values size ("
+                                                      << values.size() << ") is smaller than graph size ("
+                                                      << plan.graphSize() << ") the plan was built for");
 
-                        // is the node required to compute derivatives, then add it to the keep nodes vector
+    std::vector<const T*> args;
+    args.reserve(plan.maxNumberOfArgs());
 
-                        if (opRequiresNodesForDerivatives[g.opId(p)](args.size()).second ||
-                            opRequiresNodesForDerivatives[g.opId(node)](args.size()).first[arg])
-                            keepNodesDerivatives[p] = true;
-                    }
+    for (auto const& instr : plan.instructions()) {
 
-                    // is the node no longer needed for the forward evaluation?
+        args.resize(instr.argsEnd - instr.argsBegin);
+        for (std::size_t arg = instr.argsBegin; arg < instr.argsEnd; ++arg)
+            args[arg - instr.argsBegin] = &values[plan.args()[arg]];
 
-                    if (g.maxNodeRequiringArg(p) > node)
-                        continue;
+        if (preDeleter && instr.preRelease) {
+            for (std::size_t r = instr.releaseBegin; r < instr.releaseEnd; ++r)
+                preDeleter(values[plan.release()[r]]);
+        }
 
-                    // is the node marked as to be kept ?
+        values[instr.node] = ops[instr.opId](args, instr.node);
 
-                    if ((!keepNodes.empty() && keepNodes[p]) ||
-                        (!keepNodesDerivatives.empty() && keepNodesDerivatives[p] &&
-                         (g.redBlockId(p) == 0 || redBlockReconstruction)))
-                        continue;
+        QL_REQUIRE(values[instr.node].initialised(), "forwardEvaluation(): value at active node "
+                                                         << instr.node << " is not initialized, opId = "
+                                                         << instr.opId);
 
-                    // add to nodes to delete
-
-                    nodesToDelete.insert(p);
-
-                } // for arg over g.predecessors
-            }
-
-            if (preDeleter && !opAllowsPredeletion.empty() && opAllowsPredeletion[g.opId(node)]) {
-                for(auto n: nodesToDelete)
-                    preDeleter(values[n]);
-            }
-
-            values[node] = ops[g.opId(node)](args, node);
-
-            QL_REQUIRE(values[node].initialised(), "forwardEvaluation(): value at active node "
-                                                       << node << " is not initialized, opId = " << g.opId(node));
-
-            if(deleter) {
-                for(auto n: nodesToDelete)
-                    deleter(values[n]);
-            }
+        if (deleter) {
+            for (std::size_t r = instr.releaseBegin; r < instr.releaseEnd; ++r)
+                deleter(values[plan.release()[r]]);
+        }
+    }
+}
 
-        }     // if !g.predecessors empty
-    }         // for node
+template <class T>
+void forwardEvaluation(const ComputationGraph& g, std::vector<T>& values,
+                       const std::vector<std::function<T(const std::vector<const T*>&, QuantLib::Size)>>& ops,
+                       std::function<void(T&)> deleter = {}, bool keepValuesForDerivatives = true,
+                       const std::vector<std::function<std::pair<std::vector<bool>, bool>(const std::size_t)>>&
+                           opRequiresNodesForDerivatives = {},
+                       const std::vector<bool>& keepNodes = {}, const std::size_t startNode = 0,
+                       const std::size_t endNode = ComputationGraph::nan, const bool redBlockReconstruction = false,
+                       std::function<void(T&)> preDeleter = {}, const std::vector<bool>& opAllowsPredeletion = {}) {
+    forwardEvaluation(ForwardEvaluationPlan(g, static_cast<bool>(deleter), keepValuesForDerivatives,
+                                            opRequiresNodesForDerivatives, keepNodes, startNode, endNode,
+                                            redBlockReconstruction, opAllowsPredeletion),
+                      values, ops, deleter, preDeleter);
 }
 
 } // namespace QuantExt
@@ -24,18 +24,27 @@
 #include <qle/methods/multipathgeneratorbase.hpp>
 
 #include <ql/errors.hpp>
+#include <ql/math/comparison.hpp>
 #include <ql/math/distributions/normaldistribution.hpp>
 #include <ql/math/randomnumbers/mt19937uniformrng.hpp>
 #include <ql/models/marketmodels/browniangenerators/mtbrowniangenerator.hpp>
 
 #include <boost/algorithm/string/join.hpp>
+#include <boost/math/distributions/normal.hpp>
 #include <boost/timer/timer.hpp>
 
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
 namespace QuantExt {
 
 class BasicCpuContext : public ComputeContext {
 public:
-    BasicCpuContext();
+    /*! If nThreads > 1, programs without conditional expectations are evaluated on chunks of the sample dimension
+        in parallel, otherwise the whole program is evaluated over the full sample dimension on the calling thread. */
+    explicit BasicCpuContext(const std::size_t nThreads = 1);
     ~BasicCpuContext() override final;
     void init() override final;
 
@@ -84,6 +93,33 @@ private:
         std::vector<std::size_t> resultId_;
     };
 
+    // evaluate the current program on the given values and variates, both are indexed as in values_ and variates_
+    void executeProgram(const std::vector<RandomVariableOp>& ops, std::vector<RandomVariable>& values,
+                        const std::vector<RandomVariable>& variates) const;
+
+    /* true if all operations of the current program can be evaluated by executeFused(), i.e. they act element-wise
+       on the samples and have a scalar implementation below */
+    bool fusible() const;
+
+    /* evaluate the current program on the samples [offset, offset + len) with all intermediate results held in the
+       given scratch buffer of size (number of variables) x len, ptr receives the location of each variable */
+    void executeFused(const std::size_t offset, const std::size_t len, std::vector<double>& scratch,
+                      std::vector<const double*>& ptr, std::vector<double*>& output);
+
+    /* evaluate the current program on chunks of the sample dimension in parallel and write the output, if fused is
+       true using executeFused(), otherwise using executeProgram() on slices of the input random variables */
+    void finalizeCalculationChunked(const std::vector<RandomVariableOp>& ops, std::vector<double*>& output,
+                                    const bool fused);
+
+    // number of samples processed at once per thread in finalizeCalculationChunked()
+    static constexpr std::size_t chunkSize_ = 1024;
+
+    // number of samples processed at once per thread in executeFused(), chosen such that the buffers used by one
+    // operation fit into the L1 cache
+    static constexpr std::size_t fusedChunkSize_ = 256;
+
+    std::size_t nThreads_;
+
     bool initialized_ = false;
 
     // will be accumulated over all calcs
@@ -118,7 +154,11 @@ private:
     std::vector<RandomVariable> variates_;
 };
 
-BasicCpuFramework::BasicCpuFramework() { contexts_["BasicCpu/Default/Default"] = new BasicCpuContext(); }
+BasicCpuFramework::BasicCpuFramework() {
+    contexts_["BasicCpu/Default/Default"] = new BasicCpuContext();
+    contexts_["BasicCpu/Default/MultiThreaded"] =
+        new BasicCpuContext(std::max<std::size_t>(1, std::thread::hardware_concurrency()));
+}
 
 BasicCpuFramework::~BasicCpuFramework() {
     for (auto& [_, c] : contexts_) {
@@ -126,7 +166,7 @@ BasicCpuFramework::~BasicCpuFramework() {
     }
 }
 
-BasicCpuContext::BasicCpuContext() : initialized_(false) {}
+BasicCpuContext::BasicCpuContext(const std::size_t nThreads) : nThreads_(nThreads), initialized_(false) {}
 
 BasicCpuContext::~BasicCpuContext() {}
 
@@ -351,29 +391,23 @@ void BasicCpuContext::finalizeCalculation(std::vector<double*>& output) {
 
     values_.resize(numberOfInputVars_[currentId_ - 1] + numberOfVars_[currentId_ - 1]);
 
-    // execute calculation
+    // chunked, parallel execution if possible, i.e. if all operations act element-wise on the samples
 
-    for (Size i = 0; i < program_[currentId_ - 1].size(); ++i) {
-        std::vector<const RandomVariable*> args(p.args(i).size());
-        for (Size j = 0; j < p.args(i).size(); ++j) {
-            if (p.args(i)[j] < numberOfInputVars_[currentId_ - 1])
-                args[j] = &values_[p.args(i)[j]];
-            else if (p.args(i)[j] < numberOfInputVars_[currentId_ - 1] + numberOfVariates_[currentId_ - 1])
-                args[j] = &variates_[p.args(i)[j] - numberOfInputVars_[currentId_ - 1]];
-            else
-                args[j] = &values_[p.args(i)[j] - numberOfVariates_[currentId_ - 1]];
-        }
-        if (p.resultId(i) < numberOfInputVars_[currentId_ - 1])
-            values_[p.resultId(i)] = ops[p.op(i)](args, p.resultId(i));
-        else if (p.resultId(i) >= numberOfInputVars_[currentId_ - 1] + numberOfVariates_[currentId_ - 1])
-            values_[p.resultId(i) - numberOfVariates_[currentId_ - 1]] =
-                ops[p.op(i)](args, p.resultId(i) - numberOfVariates_[currentId_ - 1]);
-        else {
-            QL_FAIL("BasiCpuContext::finalizeCalculation(): internal error, result id "
-                    << p.resultId(i) << " does not fall into values array.");
-        }
+    bool elementwise = true;
+    for (Size i = 0; i < p.size() && elementwise; ++i)
+        elementwise = p.op(i) != RandomVariableOpCode::ConditionalExpectation;
+
+    if (nThreads_ > 1 && elementwise && size_[currentId_ - 1] > fusedChunkSize_) {
+        finalizeCalculationChunked(ops, output, fusible());
+        if (settings_.debug)
+            debugInfo_.numberOfOperations += numberOfOperations_[currentId_ - 1];
+        return;
     }
 
+    // execute calculation
+
+    executeProgram(ops, values_, variates_);
+
     // fill output
 
     for (Size i = 0; i < outputVars_[currentId_ - 1].size(); ++i) {
@@ -396,15 +430,281 @@ void BasicCpuContext::finalizeCalculation(std::vector<double*>& output) {
         debugInfo_.numberOfOperations += numberOfOperations_[currentId_ - 1];
 }
 
+void BasicCpuContext::executeProgram(const std::vector<RandomVariableOp>& ops, std::vector<RandomVariable>& values,
+                                     const std::vector<RandomVariable>& variates) const {
+    const auto& p = program_[currentId_ - 1];
+    const std::size_t nInputs = numberOfInputVars_[currentId_ - 1];
+    const std::size_t nVariates = numberOfVariates_[currentId_ - 1];
+    for (Size i = 0; i < p.size(); ++i) {
+        std::vector<const RandomVariable*> args(p.args(i).size());
+        for (Size j = 0; j < p.args(i).size(); ++j) {
+            if (p.args(i)[j] < nInputs)
+                args[j] = &values[p.args(i)[j]];
+            else if (p.args(i)[j] < nInputs + nVariates)
+                args[j] = &variates[p.args(i)[j] - nInputs];
+            else
+                args[j] = &values[p.args(i)[j] - nVariates];
+        }
+        if (p.resultId(i) < nInputs)
+            values[p.resultId(i)] = ops[p.op(i)](args, p.resultId(i));
+        else if (p.resultId(i) >= nInputs + nVariates)
+            values[p.resultId(i) - nVariates] = ops[p.op(i)](args, p.resultId(i) - nVariates);
+        else {
+            QL_FAIL("BasiCpuContext::finalizeCalculation(): internal error, result id "
+                    << p.resultId(i) << " does not fall into values array.");
+        }
+    }
+}
+
+bool BasicCpuContext::fusible() const {
+    const auto& p = program_[currentId_ - 1];
+    for (Size i = 0; i < p.size(); ++i) {
+        switch (p.op(i)) {
+        case RandomVariableOpCode::None:
+            if (p.args(i).size() != 1)
+                return false;
+            break;
+        case RandomVariableOpCode::Add:
+        case RandomVariableOpCode::Subtract:
+        case RandomVariableOpCode::Negative:
+        case RandomVariableOpCode::Mult:
+        case RandomVariableOpCode::Div:
+        case RandomVariableOpCode::IndicatorEq:
+        case RandomVariableOpCode::IndicatorGt:
+        case RandomVariableOpCode::IndicatorGeq:
+        case RandomVariableOpCode::Min:
+        case RandomVariableOpCode::Max:
+        case RandomVariableOpCode::Abs:
+        case RandomVariableOpCode::Exp:
+        case RandomVariableOpCode::Sqrt:
+        case RandomVariableOpCode::Log:
+        case RandomVariableOpCode::Pow:
+        case RandomVariableOpCode::NormalCdf:
+        case RandomVariableOpCode::NormalPdf:
+        case RandomVariableOpCode::Frac:
+            break;
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+void BasicCpuContext::executeFused(const std::size_t offset, const std::size_t len, std::vector<double>& scratch,
+                                   std::vector<const double*>& ptr, std::vector<double*>& output) {
+    static const boost::math::normal_distribution<double> normal;
+
+    const auto& p = program_[currentId_ - 1];
+    const std::size_t nInputs = numberOfInputVars_[currentId_ - 1];
+    const std::size_t nVariates = numberOfVariates_[currentId_ - 1];
+
+    // scratch is laid out as (variable, sample), inputs and variates are read in place if they are stochastic
+
+    for (std::size_t i = 0; i < nInputs; ++i) {
+        if (!values_[i].deterministic()) {
+            ptr[i] = values_[i].data() + offset;
+        } else {
+            std::fill(&scratch[i * len], &scratch[i * len] + len, values_[i][0]);
+            ptr[i] = &scratch[i * len];
+        }
+    }
+    for (std::size_t i = 0; i < nVariates; ++i)
+        ptr[nInputs + i] = variates_[i].data() + offset;
+
+    for (Size i = 0; i < p.size(); ++i) {
+        const auto& args = p.args(i);
+        double* r = &scratch[p.resultId(i) * len];
+        const double* x = ptr[args[0]];
+        const double* y = args.size() > 1 ? ptr[args[1]] : nullptr;
+        switch (p.op(i)) {
+        case RandomVariableOpCode::None:
+            std::copy(x, x + len, r);
+            break;
+        case RandomVariableOpCode::Add:
+            for (std::size_t k = 0; k < len; ++k)
+                r[k] = x[k];
+            for (std::size_t a = 1; a < args.size(); ++a) {
+                const double* z = ptr[args[a]];
+                for (std::size_t k = 0; k < len; ++k)
+                    r[k] += z[k];
+            }
+            break;
+        case RandomVariableOpCode::Subtract:
+            for (std::size_t k = 0; k < len; ++k)
+                r[k] = x[k] - y[k];
+            break;
+        case RandomVariableOpCode::Negative:
+            for (std::size_t k = 0; k < len; ++k)
+                r[k] = -x[k];
+            break;
+        case RandomVariableOpCode::Mult:
+            for (std::size_t k = 0; k < len; ++k)
+                r[k] = x[k] * y[k];
+            break;
+        case RandomVariableOpCode::Div:
+            for (std::size_t k = 0; k < len; ++k)
+                r[k] = x[k] / y[k];
+            break;
+        case RandomVariableOpCode::IndicatorEq:
+            for (std::size_t k = 0; k < len; ++k)
+                r[k] = QuantLib::close_enough(x[k], y[k]) ? 1.0 : 0.0;
+            break;
+        case RandomVariableOpCode::IndicatorGt:
+            for (std::size_t k = 0; k < len; ++k)
+                r[k] = x[k] > y[k] && !QuantLib::close_enough(x[k], y[k]) ? 1.0 : 0.0;
+            break;
+        case RandomVariableOpCode::IndicatorGeq:
+            for (std::size_t k = 0; k < len; ++k)
+                r[k] = x[k] > y[k] || QuantLib::close_enough(x[k], y[k]) ? 1.0 : 0.0;
+            break;
+        case RandomVariableOpCode::Min:
+            for (std::size_t k = 0; k < len; ++k)
+                r[k] = std::min(x[k], y[k]);
+            break;
+        case RandomVariableOpCode::Max:
+            for (std::size_t k = 0; k < len; ++k)
+                r[k] = std::max(x[k], y[k]);
+            break;
+        case RandomVariableOpCode::Abs:
+            for (std::size_t k = 0; k < len; ++k)
+                r[k] = std::abs(x[k]);
+            break;
+        case RandomVariableOpCode::Exp:
+            for (std::size_t k = 0; k < len; ++k)
+                r[k] = std::exp(x[k]);
+            break;
+        case RandomVariableOpCode::Sqrt:
+            for (std::size_t k = 0; k < len; ++k)
+                r[k] = std::sqrt(x[k]);
+            break;
+        case RandomVariableOpCode::Log:
+            for (std::size_t k = 0; k < len; ++k)
+                r[k] = std::log(x[k]);
+            break;
+        case RandomVariableOpCode::Pow:
+            for (std::size_t k = 0; k < len; ++k)
+                r[k] = std::pow(x[k], y[k]);
+            break;
+        case RandomVariableOpCode::NormalCdf:
+            for (std::size_t k = 0; k < len; ++k)
+                r[k] = boost::math::cdf(normal, x[k]);
+            break;
+        case RandomVariableOpCode::NormalPdf:
+            for (std::size_t k = 0; k < len; ++k)
+                r[k] = boost::math::pdf(normal, x[k]);
+            break;
+        case RandomVariableOpCode::Frac: {
+            double iptr;
+            for (std::size_t k = 0; k < len; ++k)
+                r[k] = std::modf(x[k], &iptr);
+            break;
+        }
+        default:
+            QL_FAIL("BasicCpuContext::executeFused(): internal error, op " << p.op(i) << " is not supported.");
+        }
+        ptr[p.resultId(i)] = r;
+    }
+
+    for (Size i = 0; i < outputVars_[currentId_ - 1].size(); ++i) {
+        const double* v = ptr[outputVars_[currentId_ - 1][i]];
+        std::copy(v, v + len, output[i] + offset);
+    }
+}
+
+void BasicCpuContext::finalizeCalculationChunked(const std::vector<RandomVariableOp>& ops,
+                                                 std::vector<double*>& output, const bool fused) {
+    const std::size_t n = size_[currentId_ - 1];
+    const std::size_t nInputs = numberOfInputVars_[currentId_ - 1];
+    const std::size_t nVariates = numberOfVariates_[currentId_ - 1];
+    const std::size_t nVariables = nInputs + nVariates + numberOfVars_[currentId_ - 1];
+    const std::size_t chunkSize = fused ? fusedChunkSize_ : chunkSize_;
+    const std::size_t nChunks = (n + chunkSize - 1) / chunkSize;
+
+    // slice [offset, offset + len) of a random variable, deterministic variables stay deterministic
+
+    auto slice = [](const RandomVariable& v, const std::size_t offset, const std::size_t len) {
+        if (!v.initialised())
+            return RandomVariable();
+        if (v.deterministic())
+            return RandomVariable(len, v[0]);
+        RandomVariable result(len);
+        for (std::size_t k = 0; k < len; ++k)
+            result.set(k, v[offset + k]);
+        return result;
+    };
+
+    auto processChunk = [this, &ops, &output, &slice, n, nInputs, nVariates, chunkSize](const std::size_t c) {
+        const std::size_t offset = c * chunkSize;
+        const std::size_t len = std::min(chunkSize, n - offset);
+        std::vector<RandomVariable> values(values_.size());
+        std::vector<RandomVariable> variates(nVariates);
+        for (std::size_t i = 0; i < nInputs; ++i)
+            values[i] = slice(values_[i], offset, len);
+        for (std::size_t i = 0; i < nVariates; ++i)
+            variates[i] = slice(variates_[i], offset, len);
+        executeProgram(ops, values, variates);
+        for (Size i = 0; i < outputVars_[currentId_ - 1].size(); ++i) {
+            std::size_t id = outputVars_[currentId_ - 1][i];
+            const RandomVariable& v =
+                id < nInputs ? values[id] : (id < nInputs + nVariates ? variates[id - nInputs] : values[id - nVariates]);
+            for (Size k = 0; k < len; ++k)
+                output[i][offset + k] = v[k];
+        }
+    };
+
+    std::atomic<std::size_t> nextChunk(0);
+    std::atomic<bool> failed(false);
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t < std::min(nThreads_, nChunks); ++t) {
+        workers.emplace_back([&]() {
+            // the scratch buffers for the fused evaluation are allocated once per thread
+            std::vector<double> scratch;
+            std::vector<const double*> ptr;
+            if (fused) {
+                scratch.resize(nVariables * chunkSize);
+                ptr.resize(nVariables);
+            }
+            std::size_t c;
+            while (!failed && (c = nextChunk++) < nChunks) {
+                try {
+                    if (fused) {
+                        std::size_t offset = c * chunkSize;
+                        executeFused(offset, std::min(chunkSize, n - offset), scratch, ptr, output);
+                    } else {
+                        processChunk(c);
+                    }
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error)
+                        error = std::current_exception();
+                    failed = true;
+                }
+            }
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+    if (error)
+        std::rethrow_exception(error);
+}
+
 const ComputeContext::DebugInfo& BasicCpuContext::debugInfo() const { return debugInfo_; }
 
-std::set<std::string> BasicCpuFramework::getAvailableDevices() const { return {"BasicCpu/Default/Default"}; }
+std::set<std::string> BasicCpuFramework::getAvailableDevices() const {
+    std::set<std::string> result;
+    for (auto const& [name, _] : contexts_)
+        result.insert(name);
+    return result;
+}
 
 ComputeContext* BasicCpuFramework::getContext(const std::string& deviceName) {
-    QL_REQUIRE(deviceName == "BasicCpu/Default/Default",
-               "BasicCpuFramework::getContext(): device '"
-                   << deviceName << "' not supported. Available device is 'BasicCpu/Default/Default'.");
-    return contexts_[deviceName];
+    auto c = contexts_.find(deviceName);
+    QL_REQUIRE(c != contexts_.end(), "BasicCpuFramework::getContext(): device '"
+                                         << deviceName << "' not supported. Available devices are '"
+                                         << boost::algorithm::join(getAvailableDevices(), "', '") << "'.");
+    return c->second;
 }
 
 }; // namespace QuantExt
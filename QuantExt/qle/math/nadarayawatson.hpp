@@ -19,10 +19,16 @@
 #ifndef quantext_nadaraya_watson_regression_hpp
 #define quantext_nadaraya_watson_regression_hpp
 
+#include <ql/errors.hpp>
 #include <ql/math/comparison.hpp>
 
 #include <boost/make_shared.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
 /*! \file qle/math/nadarayawatson.hpp
     \brief Nadaraya-Watson regression
     \ingroup math
@@ -118,6 +124,110 @@ private:
     QuantLib::ext::shared_ptr<detail::RegressionImpl> impl_;
 };
 
+//! Binned Nadaraya Watson regression
+/*! Approximates the NadarayaWatson estimator by linear binning of the data on an equidistant grid of the given
+    number of points spanning the range of the \f$ x \f$ values, i.e. each data point is split between its two
+    neighbouring grid points. An evaluation then costs O(bins) instead of O(n), so that evaluating the estimator at
+    all data points is linear in the number of data points.
+
+    The binning is only accurate if the grid spacing is small compared to the kernel bandwidth. If the spacing of the
+    grid with the given number of points exceeds a quarter of the bandwidth, e.g. for a wide range of \f$ x \f$
+    values, the data points themselves are used as grid points, i.e. the estimator is evaluated exactly.
+
+    The \f$ x \f$ values do not need to be sorted, the data is copied on construction.
+
+    \ingroup math
+*/
+class BinnedNadarayaWatson {
+public:
+    /*! \pre kernel needs a Real operator()(Real x) implementation
+        \pre bandwidth is the bandwidth of the kernel
+    */
+    template <class I1, class I2, class Kernel>
+    BinnedNadarayaWatson(const I1& xBegin, const I1& xEnd, const I2& yBegin, const Kernel& kernel,
+                         const Real bandwidth, const Size bins = 1000)
+        : kernel_(kernel) {
+        QL_REQUIRE(bins > 0, "BinnedNadarayaWatson: bins must be positive");
+        QL_REQUIRE(bandwidth > 0.0, "BinnedNadarayaWatson: bandwidth (" << bandwidth << ") must be positive");
+        if (xBegin == xEnd)
+            return;
+        auto [xMin, xMax] = std::minmax_element(xBegin, xEnd);
+        Real x0 = *xMin, x1 = *xMax;
+        if (!QuantLib::close_enough(x0, x1) &&
+            (bins == 1 || (x1 - x0) / static_cast<Real>(bins - 1) > 0.25 * bandwidth)) {
+            // the grid would be too coarse, evaluate exactly with the data points as grid points
+            I2 y = yBegin;
+            for (I1 x = xBegin; x != xEnd; ++x, ++y) {
+                grid_.push_back(*x);
+                w0_.push_back(1.0);
+                w1_.push_back(*y);
+                w2_.push_back(*y * *y);
+            }
+            return;
+        }
+        Size n = QuantLib::close_enough(x0, x1) ? 1 : bins;
+        grid_.resize(n);
+        w0_.resize(n, 0.0);
+        w1_.resize(n, 0.0);
+        w2_.resize(n, 0.0);
+        Real dx = n == 1 ? 0.0 : (x1 - x0) / static_cast<Real>(n - 1);
+        for (Size j = 0; j < n; ++j)
+            grid_[j] = x0 + static_cast<Real>(j) * dx;
+        I2 y = yBegin;
+        for (I1 x = xBegin; x != xEnd; ++x, ++y) {
+            Real yv = *y;
+            if (n == 1) {
+                add(0, 1.0, yv);
+                continue;
+            }
+            Real t = (*x - x0) / dx;
+            Size j = std::min(static_cast<Size>(std::max(t, 0.0)), n - 2);
+            Real a = std::min(std::max(t - static_cast<Real>(j), 0.0), 1.0);
+            add(j, 1.0 - a, yv);
+            add(j + 1, a, yv);
+        }
+    }
+
+    Real operator()(Real x) const {
+        Real s0, s1, s2;
+        sums(x, s0, s1, s2);
+        return QuantLib::close_enough(s0, 0.0) ? 0.0 : s1 / s0;
+    }
+
+    Real standardDeviation(Real x) const {
+        Real s0, s1, s2;
+        sums(x, s0, s1, s2);
+        // the binning can produce slightly negative variances
+        return QuantLib::close_enough(s0, 0.0) ? 0.0 : std::sqrt(std::max(s2 / s0 - (s1 * s1) / (s0 * s0), 0.0));
+    }
+
+    /*! number of grid points, one if all x values coincide, zero without data and the number of data points if the
+        estimator is evaluated exactly */
+    Size bins() const { return grid_.size(); }
+
+private:
+    void add(const Size j, const Real w, const Real y) {
+        w0_[j] += w;
+        w1_[j] += w * y;
+        w2_[j] += w * y * y;
+    }
+
+    void sums(const Real x, Real& s0, Real& s1, Real& s2) const {
+        s0 = s1 = s2 = 0.0;
+        for (Size j = 0; j < grid_.size(); ++j) {
+            if (w0_[j] == 0.0)
+                continue;
+            Real k = kernel_(x - grid_[j]);
+            s0 += w0_[j] * k;
+            s1 += w1_[j] * k;
+            s2 += w2_[j] * k;
+        }
+    }
+
+    std::function<Real(Real)> kernel_;
+    std::vector<Real> grid_, w0_, w1_, w2_;
+};
+
 } // namespace QuantExt
 
 #endif
@@ -90,6 +90,112 @@ double getDelta(const RandomVariable& x, const Real eps) {
     return std::sqrt(sum / static_cast<Real>(x.size())) * eps / 2.0;
 }
 
+/* Solve the normal equations A^T A x = A^T b where the columns of A are given by a. The Gram matrix and the rhs are
+   accumulated in one pass over the samples, which are processed in chunks small enough to keep the data of all
+   columns in the cache. The system is solved by a Cholesky decomposition, if the Gram matrix is not numerically
+   positive definite we fall back on the pseudo inverse computed from its eigen decomposition. */
+Array normalEquationsSolve(std::vector<RandomVariable>& a, RandomVariable b) {
+    constexpr Size chunkSize = 1024;
+    const Size m = a.size();
+    const Size n = b.size();
+
+    std::vector<const double*> col(m);
+    for (Size i = 0; i < m; ++i) {
+        a[i].expand();
+        col[i] = a[i].data();
+    }
+    b.expand();
+    const double* rhs = b.data();
+
+    Matrix G(m, m, 0.0);
+    Array c(m, 0.0);
+    for (Size k0 = 0; k0 < n; k0 += chunkSize) {
+        Size k1 = std::min(n, k0 + chunkSize);
+        for (Size i = 0; i < m; ++i) {
+            const double* ai = col[i];
+            for (Size j = 0; j <= i; ++j) {
+                const double* aj = col[j];
+                double s = 0.0;
+                for (Size k = k0; k < k1; ++k)
+                    s += ai[k] * aj[k];
+                G[i][j] += s;
+            }
+            double s = 0.0;
+            for (Size k = k0; k < k1; ++k)
+                s += ai[k] * rhs[k];
+            c[i] += s;
+        }
+    }
+
+    Real maxDiag = 0.0;
+    for (Size i = 0; i < m; ++i) {
+        maxDiag = std::max(maxDiag, G[i][i]);
+        for (Size j = 0; j < i; ++j)
+            G[j][i] = G[i][j];
+    }
+
+    // Cholesky decomposition G = L L^T
+
+    // the accumulation over n samples limits the accuracy of the Gram matrix entries to about n * eps relative
+
+    Real tolerance = static_cast<Real>(n) * QL_EPSILON * maxDiag;
+    Matrix L(m, m, 0.0);
+    bool positiveDefinite = maxDiag > 0.0;
+    for (Size j = 0; j < m && positiveDefinite; ++j) {
+        Real d = G[j][j];
+        for (Size k = 0; k < j; ++k)
+            d -= L[j][k] * L[j][k];
+        if (d <= tolerance) {
+            positiveDefinite = false;
+            break;
+        }
+        L[j][j] = std::sqrt(d);
+        for (Size i = j + 1; i < m; ++i) {
+            Real s = G[i][j];
+            for (Size k = 0; k < j; ++k)
+                s -= L[i][k] * L[j][k];
+            L[i][j] = s / L[j][j];
+        }
+    }
+
+    Array x(m, 0.0);
+
+    if (positiveDefinite) {
+        // solve L y = c and then L^T x = y
+        for (Size i = 0; i < m; ++i) {
+            Real s = c[i];
+            for (Size k = 0; k < i; ++k)
+                s -= L[i][k] * x[k];
+            x[i] = s / L[i][i];
+        }
+        for (Size i = m; i > 0; --i) {
+            Real s = x[i - 1];
+            for (Size k = i; k < m; ++k)
+                s -= L[k][i - 1] * x[k];
+            x[i - 1] = s / L[i - 1][i - 1];
+        }
+        return x;
+    }
+
+    // rank deficient system, use the pseudo inverse
+
+    SymmetricSchurDecomposition schur(G);
+    const Array& lambda = schur.eigenvalues();
+    const Matrix& V = schur.eigenvectors();
+    Real threshold = static_cast<Real>(n) * QL_EPSILON * lambda[0];
+    for (Size i = 0; i < m; ++i) {
+        if (lambda[i] > threshold) {
+            Real u = 0.0;
+            for (Size j = 0; j < m; ++j)
+                u += V[j][i] * c[j];
+            u /= lambda[i];
+            for (Size j = 0; j < m; ++j)
+                x[j] += u * V[j][i];
+        }
+    }
+    return x;
+}
+
 } // namespace
 
 Filter::~Filter() { clear(); }
@@ -1235,48 +1341,64 @@ Array regressionCoefficients(
 
     resumeCalcStats();
 
-    Matrix A(r.size(), basisFn.size());
-    for (Size j = 0; j < basisFn.size(); ++j) {
-        RandomVariable a = basisFn[j](regressor);
-        if (filter.initialised()) {
-            a = applyFilter(a, filter);
-        }
-        if (a.deterministic())
-            std::fill(A.column_begin(j), A.column_end(j), a[0]);
-        else
-            a.copyToMatrixCol(A, j);
-    }
-
     if (filter.size() > 0) {
         r = applyFilter(r, filter);
     }
 
-    Array b(r.size());
-    if (r.deterministic())
-        std::fill(b.begin(), b.end(), r[0]);
-    else
-        r.copyToArray(b);
-
     Array res;
-    if (regressionMethod == RandomVariableRegressionMethod::SVD) {
-        SVD svd(A);
-        const Matrix& V = svd.V();
-        const Matrix& U = svd.U();
-        const Array& w = svd.singularValues();
-        Real threshold = r.size() * QL_EPSILON * svd.singularValues()[0];
-        res = Array(basisFn.size(), 0.0);
-        for (Size i = 0; i < basisFn.size(); ++i) {
-            if (w[i] > threshold) {
-                Real u = std::inner_product(U.column_begin(i), U.column_end(i), b.begin(), Real(0.0)) / w[i];
-                for (Size j = 0; j < basisFn.size(); ++j) {
-                    res[j] += u * V[j][i];
-                }
+    if (regressionMethod == RandomVariableRegressionMethod::NormalEquations) {
+        std::vector<RandomVariable> a(basisFn.size());
+        for (Size j = 0; j < basisFn.size(); ++j) {
+            a[j] = basisFn[j](regressor);
+            if (filter.initialised()) {
+                a[j] = applyFilter(a[j], filter);
             }
         }
-    } else if (regressionMethod == RandomVariableRegressionMethod::QR) {
-        res = qrSolve(A, b);
+        res = normalEquationsSolve(a, r);
+        // accumulating the Gram matrix is O(n m^2)
+        stopCalcStats(r.size() * basisFn.size() * basisFn.size());
     } else {
-        QL_FAIL("regressionCoefficients(): unknown regression method, expected SVD or QR");
+        Matrix A(r.size(), basisFn.size());
+        for (Size j = 0; j < basisFn.size(); ++j) {
+            RandomVariable a = basisFn[j](regressor);
+            if (filter.initialised()) {
+                a = applyFilter(a, filter);
+            }
+            if (a.deterministic())
+                std::fill(A.column_begin(j), A.column_end(j), a[0]);
+            else
+                a.copyToMatrixCol(A, j);
+        }
+
+        Array b(r.size());
+        if (r.deterministic())
+            std::fill(b.begin(), b.end(), r[0]);
+        else
+            r.copyToArray(b);
+
+        if (regressionMethod == RandomVariableRegressionMethod::SVD) {
+            SVD svd(A);
+            const Matrix& V = svd.V();
+            const Matrix& U = svd.U();
+            const Array& w = svd.singularValues();
+            Real threshold = r.size() * QL_EPSILON * svd.singularValues()[0];
+            res = Array(basisFn.size(), 0.0);
+            for (Size i = 0; i < basisFn.size(); ++i) {
+                if (w[i] > threshold) {
+                    Real u = std::inner_product(U.column_begin(i), U.column_end(i), b.begin(), Real(0.0)) / w[i];
+                    for (Size j = 0; j < basisFn.size(); ++j) {
+                        res[j] += u * V[j][i];
+                    }
+                }
+            }
+        } else if (regressionMethod == RandomVariableRegressionMethod::QR) {
+            res = qrSolve(A, b);
+        } else {
+            QL_FAIL("regressionCoefficients(): unknown regression method, expected SVD, QR or NormalEquations");
+        }
+
+        // rough estimate, SVD is O(mn min(m,n))
+        stopCalcStats(r.size() * basisFn.size() * std::min(r.size(), basisFn.size()));
     }
 
     if (!debugLabel.empty()) {
@@ -1292,8 +1414,6 @@ Array regressionCoefficients(
         std::cout << std::flush;
     }
 
-    // rough estimate, SVD is O(mn min(m,n))
-    stopCalcStats(r.size() * basisFn.size() * std::min(r.size(), basisFn.size()));
     return res;
 }
 
@@ -314,8 +314,14 @@ std::vector<RandomVariable> applyCoordinateTransform(const std::vector<const Ran
 /* Create vector of pointers to rvs from vector of rvs */
 std::vector<const RandomVariable*> vec2vecptr(const std::vector<RandomVariable>& values);
 
-// compute regression coefficients
-enum class RandomVariableRegressionMethod { QR, SVD };
+/* compute regression coefficients, the regression methods are
+   - QR: least squares solution using a QR decomposition of the full design matrix
+   - SVD: least squares solution using a SVD of the full design matrix, handles collinear basis functions
+   - NormalEquations: the Gram matrix of the basis functions and the rhs are accumulated in one pass over the samples
+     and the normal equations are solved by a Cholesky decomposition, falling back on a pseudo inverse if the Gram
+     matrix is numerically singular. This is the fastest method for many samples and few basis functions, but the
+     condition number of the problem is squared compared to QR / SVD. */
+enum class RandomVariableRegressionMethod { QR, SVD, NormalEquations };
 Array regressionCoefficients(
     RandomVariable r, std::vector<const RandomVariable*> regressor,
     const std::vector<std::function<RandomVariable(const std::vector<const RandomVariable*>&)>>& basisFn,
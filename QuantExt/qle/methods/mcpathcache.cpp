@@ -0,0 +1,179 @@
+/*
+ Copyright (C) 2025 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/methods/mcpathcache.hpp>
+#include <qle/processes/irlgm1fstateprocess.hpp>
+
+#include <ql/math/comparison.hpp>
+#include <ql/timegrid.hpp>
+
+#include <algorithm>
+#include <iterator>
+
+namespace QuantExt {
+
+namespace {
+
+// find the index of t in the sorted grid, return false if t is not in the grid
+bool findTime(const std::vector<Real>& grid, const Real t, Size& index) {
+    auto it = std::lower_bound(grid.begin(), grid.end(), t);
+    if (it != grid.end() && QuantLib::close_enough(*it, t)) {
+        index = std::distance(grid.begin(), it);
+        return true;
+    }
+    if (it != grid.begin() && QuantLib::close_enough(*std::prev(it), t)) {
+        index = std::distance(grid.begin(), it) - 1;
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+QuantLib::ext::shared_ptr<McPaths> generateMcPaths(const QuantLib::ext::shared_ptr<CrossAssetModel>& model,
+                                                   const SequenceType sequenceType, const Size samples,
+                                                   const Size seed, const SobolBrownianGenerator::Ordering ordering,
+                                                   const SobolRsg::DirectionIntegers directionIntegers,
+                                                   const std::vector<Real>& times) {
+
+    auto result = QuantLib::ext::make_shared<McPaths>();
+    result->times = times;
+
+    if (times.empty())
+        return result;
+
+    Size dim = model->stateProcess()->size();
+    result->values.resize(times.size(), std::vector<RandomVariable>(dim, RandomVariable(samples)));
+    for (auto& v : result->values)
+        for (auto& r : v)
+            r.expand();
+
+    TimeGrid timeGrid(times.begin(), times.end());
+
+    QuantLib::ext::shared_ptr<StochasticProcess> process = model->stateProcess();
+    if (model->dimension() == 1) {
+        // use lgm process if possible for better performance
+        auto tmp = QuantLib::ext::make_shared<IrLgm1fStateProcess>(model->irlgm1f(0));
+        tmp->resetCache(timeGrid.size() - 1);
+        process = tmp;
+    } else if (auto tmp = QuantLib::ext::dynamic_pointer_cast<CrossAssetStateProcess>(process)) {
+        // enable cache
+        tmp->resetCache(timeGrid.size() - 1);
+    }
+
+    auto pathGenerator = makeMultiPathGenerator(sequenceType, process, timeGrid, seed, ordering, directionIntegers);
+
+    // generated paths always contain t = 0 but times might or might not contain t = 0
+    Size offset = QuantLib::close_enough(times.front(), 0.0) ? 0 : 1;
+
+    for (Size i = 0; i < samples; ++i) {
+        const MultiPath& path = pathGenerator->next().value;
+        for (Size j = 0; j < times.size(); ++j) {
+            for (Size k = 0; k < dim; ++k) {
+                result->values[j][k].data()[i] = path[k][j + offset];
+            }
+        }
+    }
+
+    return result;
+}
+
+void McPathCache::enable(const bool b) {
+    enabled_ = b;
+    if (!enabled_)
+        clear();
+}
+
+void McPathCache::setMaxEntries(const Size n) {
+    QL_REQUIRE(n > 0, "McPathCache::setMaxEntries(): number of entries must be positive");
+    maxEntries_ = n;
+    while (entries_.size() > maxEntries_)
+        entries_.pop_back();
+}
+
+void McPathCache::clear() { entries_.clear(); }
+
+QuantLib::ext::shared_ptr<const McPaths>
+McPathCache::paths(const QuantLib::ext::shared_ptr<CrossAssetModel>& model, const SequenceType sequenceType,
+                   const Size samples, const Size seed, const SobolBrownianGenerator::Ordering ordering,
+                   const SobolRsg::DirectionIntegers directionIntegers, const std::vector<Real>& times,
+                   const std::vector<Real>& additionalTimes, std::vector<Size>& timeIndices) {
+
+    timeIndices.resize(times.size());
+
+    if (!enabled_) {
+        auto p = generateMcPaths(model, sequenceType, samples, seed, ordering, directionIntegers, times);
+        for (Size j = 0; j < times.size(); ++j)
+            timeIndices[j] = j;
+        return p;
+    }
+
+    // drop entries of models that changed or do not exist any more
+
+    entries_.remove_if([](const QuantLib::ext::shared_ptr<Entry>& e) { return e->stale || e->model.expired(); });
+
+    // look for an entry containing all requested times
+
+    for (auto e = entries_.begin(); e != entries_.end(); ++e) {
+        const Entry& entry = **e;
+        if (entry.modelPtr != model.get() || entry.sequenceType != sequenceType || entry.samples != samples ||
+            entry.seed != seed || entry.ordering != ordering || entry.directionIntegers != directionIntegers)
+            continue;
+        bool found = true;
+        for (Size j = 0; j < times.size() && found; ++j)
+            found = findTime(entry.paths->times, times[j], timeIndices[j]);
+        if (found) {
+            entries_.splice(entries_.begin(), entries_, e);
+            return entries_.front()->paths;
+        }
+    }
+
+    // simulate a new entry on the union of the requested and the additional times
+
+    std::vector<Real> grid(times);
+    std::copy_if(additionalTimes.begin(), additionalTimes.end(), std::back_inserter(grid),
+                 [](const Real t) { return t >= 0.0; });
+    std::sort(grid.begin(), grid.end());
+    grid.erase(std::unique(grid.begin(), grid.end(),
+                           [](const Real s, const Real t) { return QuantLib::close_enough(s, t); }),
+               grid.end());
+
+    auto entry = QuantLib::ext::make_shared<Entry>();
+    entry->model = model;
+    entry->modelPtr = model.get();
+    entry->sequenceType = sequenceType;
+    entry->samples = samples;
+    entry->seed = seed;
+    entry->ordering = ordering;
+    entry->directionIntegers = directionIntegers;
+    entry->paths = generateMcPaths(model, sequenceType, samples, seed, ordering, directionIntegers, grid);
+    entry->registerWith(model);
+
+    for (Size j = 0; j < times.size(); ++j) {
+        bool found = findTime(grid, times[j], timeIndices[j]);
+        QL_REQUIRE(found, "McPathCache::paths(): internal error, time " << times[j] << " not found in grid");
+    }
+
+    entries_.push_front(entry);
+    if (entries_.size() > maxEntries_)
+        entries_.pop_back();
+
+    return entry->paths;
+}
+
+} // namespace QuantExt
@@ -0,0 +1,118 @@
+/*
+ Copyright (C) 2025 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file mcpathcache.hpp
+    \brief cache for the calibration paths of mc engines sharing a cross asset model
+    \ingroup methods
+*/
+
+#pragma once
+
+#include <qle/math/randomvariable.hpp>
+#include <qle/methods/multipathgeneratorbase.hpp>
+#include <qle/models/crossassetmodel.hpp>
+
+#include <ql/patterns/observable.hpp>
+#include <ql/patterns/singleton.hpp>
+
+#include <list>
+#include <vector>
+
+namespace QuantExt {
+
+//! Paths of the state process of a cross asset model on a time grid
+/*! values[j][k] holds the samples of the state variable k at times[j] */
+struct McPaths {
+    std::vector<Real> times;
+    std::vector<std::vector<RandomVariable>> values;
+};
+
+//! Simulate the state process of the model on the given (sorted, unique) times
+/*! t = 0 may or may not be contained in the times. For a one dimensional model the IrLgm1fStateProcess is used. */
+QuantLib::ext::shared_ptr<McPaths> generateMcPaths(const QuantLib::ext::shared_ptr<CrossAssetModel>& model,
+                                                   const SequenceType sequenceType, const Size samples,
+                                                   const Size seed, const SobolBrownianGenerator::Ordering ordering,
+                                                   const SobolRsg::DirectionIntegers directionIntegers,
+                                                   const std::vector<Real>& times);
+
+//! Cache for the calibration paths of mc engines
+/*! The mc multileg engines simulate their calibration paths on the union of their cashflow, exercise and xva times.
+    In an amc run many engines share the same model, path generator settings and large parts of their time grids,
+    e.g. the xva times. If the cache is enabled, the paths are looked up by model, sequence type, samples, seed,
+    ordering and direction integers. An entry is reused if its time grid contains all requested times, otherwise a new
+    entry is simulated on the requested times plus the given additional times, which should be the times other engines
+    are likely to request, e.g. the xva simulation times.
+
+    The paths on a superset grid are a different realisation than the paths on the requested times only, i.e. the
+    calibration of an engine depends on the entries already in the cache and therefore on the order in which the
+    engines are calculated. For this reason the cache is disabled by default.
+
+    An entry is dropped once the model notifies its observers, e.g. after a recalibration or a change of the
+    evaluation date. The cache keeps at most maxEntries() entries and drops the least recently used one if this number
+    is exceeded.
+
+    With QL_ENABLE_SESSIONS the cache is thread local, i.e. engines calculated on different threads do not share
+    paths.
+
+    \ingroup methods
+*/
+class McPathCache : public QuantLib::Singleton<McPathCache> {
+    friend class QuantLib::Singleton<McPathCache>;
+    McPathCache() = default;
+
+public:
+    //! enable or disable the cache, disabling the cache clears it
+    void enable(const bool b);
+    bool enabled() const { return enabled_; }
+
+    void setMaxEntries(const Size n);
+    Size maxEntries() const { return maxEntries_; }
+
+    //! drop all entries
+    void clear();
+    Size size() const { return entries_.size(); }
+
+    /*! Return paths on a time grid containing the given sorted, unique times. On return timeIndices[j] is the index
+        of times[j] in the time grid of the returned paths. */
+    QuantLib::ext::shared_ptr<const McPaths>
+    paths(const QuantLib::ext::shared_ptr<CrossAssetModel>& model, const SequenceType sequenceType, const Size samples,
+          const Size seed, const SobolBrownianGenerator::Ordering ordering,
+          const SobolRsg::DirectionIntegers directionIntegers, const std::vector<Real>& times,
+          const std::vector<Real>& additionalTimes, std::vector<Size>& timeIndices);
+
+private:
+    class Entry : public QuantLib::Observer {
+    public:
+        void update() override { stale = true; }
+        QuantLib::ext::weak_ptr<CrossAssetModel> model;
+        const CrossAssetModel* modelPtr;
+        SequenceType sequenceType;
+        Size samples, seed;
+        SobolBrownianGenerator::Ordering ordering;
+        SobolRsg::DirectionIntegers directionIntegers;
+        QuantLib::ext::shared_ptr<const McPaths> paths;
+        bool stale = false;
+    };
+
+    bool enabled_ = false;
+    Size maxEntries_ = 8;
+    // most recently used entry first
+    std::list<QuantLib::ext::shared_ptr<Entry>> entries_;
+};
+
+} // namespace QuantExt
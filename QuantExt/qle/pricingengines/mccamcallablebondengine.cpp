@@ -94,7 +94,8 @@ McCamCallableBondBaseEngine::McCamCallableBondBaseEngine(
     const Real regressionVarianceCutoff, const bool recalibrateOnStickyCloseOutDates,
     const bool reevaluateExerciseInStickyRun, const Size cfOnCpnMaxSimTimes, const Period& cfOnCpnAddSimTimesCutoff,
     const Size regressionMaxSimTimesIr, const Size regressionMaxSimTimesFx, const Size regressionMaxSimTimesEq,
-    const McRegressionModel::VarGroupMode regressionVarGroupMode)
+    const McRegressionModel::VarGroupMode regressionVarGroupMode,
+    const RandomVariableRegressionMethod regressionMethod)
     : model_(model), calibrationPathGenerator_(calibrationPathGenerator), pricingPathGenerator_(pricingPathGenerator),
       calibrationSamples_(calibrationSamples), pricingSamples_(pricingSamples), calibrationSeed_(calibrationSeed),
       pricingSeed_(pricingSeed), polynomOrder_(polynomOrder), polynomType_(polynomType), ordering_(ordering),
@@ -108,7 +109,7 @@ McCamCallableBondBaseEngine::McCamCallableBondBaseEngine(
       reevaluateExerciseInStickyRun_(reevaluateExerciseInStickyRun), cfOnCpnMaxSimTimes_(cfOnCpnMaxSimTimes),
       cfOnCpnAddSimTimesCutoff_(cfOnCpnAddSimTimesCutoff), regressionMaxSimTimesIr_(regressionMaxSimTimesIr),
       regressionMaxSimTimesFx_(regressionMaxSimTimesFx), regressionMaxSimTimesEq_(regressionMaxSimTimesEq),
-      regressionVarGroupMode_(regressionVarGroupMode) {
+      regressionVarGroupMode_(regressionVarGroupMode), regressionMethod_(regressionMethod) {
 
     QL_REQUIRE(cfOnCpnMaxSimTimes >= 0, "McCamCallableBondBaseEngine: cfOnCpnMaxSimTimes must be non-negative");
     QL_REQUIRE(cfOnCpnAddSimTimesCutoff.length() >= 0,
@@ -237,7 +238,7 @@ void McCamCallableBondBaseEngine::calculateModels(
         regModelUndDirty[counter] = McRegressionModel(
             *t, cashflowInfo, [&cfStatus](std::size_t i) { return cfStatus[i] == CfStatus::done; }, **model_,
             regressorModel_, regressionVarianceCutoff_, regressionMaxSimTimesIr_, regressionMaxSimTimesFx_,
-            regressionMaxSimTimesEq_, regressionVarGroupMode_);
+            regressionMaxSimTimesEq_, regressionVarGroupMode_, regressionMethod_);
         regModelUndDirty[counter].train(polynomOrder_, polynomType_, pathValueUndDirty / survivalProb, pathValuesRef,
                                         simulationTimes);
         if (isExerciseTime) {
@@ -264,7 +265,7 @@ void McCamCallableBondBaseEngine::calculateModels(
                 regModelCallExerciseValue[counter] = McRegressionModel(
                     *t, cashflowInfo, [&cfStatus](std::size_t i) { return cfStatus[i] == CfStatus::done; }, **model_,
                     regressorModel_, regressionVarianceCutoff_, regressionMaxSimTimesIr_, regressionMaxSimTimesFx_,
-                    regressionMaxSimTimesEq_, regressionVarGroupMode_);
+                    regressionMaxSimTimesEq_, regressionVarGroupMode_, regressionMethod_);
 
                 regModelCallExerciseValue[counter].train(polynomOrder_, polynomType_, callExerciseValue, pathValuesRef,
                                                          simulationTimes);
@@ -275,7 +276,7 @@ void McCamCallableBondBaseEngine::calculateModels(
                 regModelContinuationValueCall[counter] = McRegressionModel(
                     *t, cashflowInfo, [&cfStatus](std::size_t i) { return cfStatus[i] == CfStatus::done; }, **model_,
                     regressorModel_, regressionVarianceCutoff_, regressionMaxSimTimesIr_, regressionMaxSimTimesFx_,
-                    regressionMaxSimTimesEq_, regressionVarGroupMode_);
+                    regressionMaxSimTimesEq_, regressionVarGroupMode_, regressionMethod_);
                 regModelContinuationValueCall[counter].train(polynomOrder_, polynomType_,
                                                              pathValueOption / survivalProb, pathValuesRef,
                                                              simulationTimes, exerciseValueCall < zero);
@@ -304,7 +305,7 @@ void McCamCallableBondBaseEngine::calculateModels(
                 regModelPutExerciseValue[counter] = McRegressionModel(
                     *t, cashflowInfo, [&cfStatus](std::size_t i) { return cfStatus[i] == CfStatus::done; }, **model_,
                     regressorModel_, regressionVarianceCutoff_, regressionMaxSimTimesIr_, regressionMaxSimTimesFx_,
-                    regressionMaxSimTimesEq_, regressionVarGroupMode_);
+                    regressionMaxSimTimesEq_, regressionVarGroupMode_, regressionMethod_);
 
                 regModelPutExerciseValue[counter].train(polynomOrder_, polynomType_, putExerciseValue, pathValuesRef,
                                                         simulationTimes);
@@ -314,7 +315,7 @@ void McCamCallableBondBaseEngine::calculateModels(
                 regModelContinuationValuePut[counter] = McRegressionModel(
                     *t, cashflowInfo, [&cfStatus](std::size_t i) { return cfStatus[i] == CfStatus::done; }, **model_,
                     regressorModel_, regressionVarianceCutoff_, regressionMaxSimTimesIr_, regressionMaxSimTimesFx_,
-                    regressionMaxSimTimesEq_, regressionVarGroupMode_);
+                    regressionMaxSimTimesEq_, regressionVarGroupMode_, regressionMethod_);
                 regModelContinuationValuePut[counter].train(polynomOrder_, polynomType_, pathValueOption / survivalProb,
                                                             pathValuesRef, simulationTimes, exerciseValuePut > zero);
                 auto continuationValue = regModelContinuationValuePut[counter].apply(
@@ -332,7 +333,7 @@ void McCamCallableBondBaseEngine::calculateModels(
         regModelOption[counter] = McRegressionModel(
             *t, cashflowInfo, [&cfStatus](std::size_t i) { return cfStatus[i] == CfStatus::done; }, **model_,
             regressorModel_, regressionVarianceCutoff_, regressionMaxSimTimesIr_, regressionMaxSimTimesFx_,
-            regressionMaxSimTimesEq_, regressionVarGroupMode_);
+            regressionMaxSimTimesEq_, regressionVarGroupMode_, regressionMethod_);
         regModelOption[counter].train(polynomOrder_, polynomType_, pathValueOption / survivalProb, pathValuesRef,
                                       simulationTimes);
 
@@ -68,7 +68,8 @@ public:
         const bool reevaluateExerciseInStickyRun = false, const Size cfOnCpnMaxSimTimes = 1,
         const Period& cfOnCpnAddSimTimesCutoff = Period(), const Size regressionMaxSimTimesIr = 0,
         const Size regressionMaxSimTimesFx = 0, const Size regressionMaxSimTimesEq = 0,
-        const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global);
+        const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global,
+        const RandomVariableRegressionMethod regressionMethod = RandomVariableRegressionMethod::QR);
 
     //! Destructor
     virtual ~McCamCallableBondBaseEngine() {}
@@ -178,6 +179,7 @@ public:
     Size regressionMaxSimTimesFx_;
     Size regressionMaxSimTimesEq_;
     McRegressionModel::VarGroupMode regressionVarGroupMode_;
+    RandomVariableRegressionMethod regressionMethod_;
 
     // set from global settings
     mutable bool includeTodaysCashflows_;
@@ -259,7 +261,8 @@ public:
         const bool reevaluateExerciseInStickyRun = false, const Size cfOnCpnMaxSimTimes = 1,
         const Period& cfOnCpnAddSimTimesCutoff = Period(), const Size regressionMaxSimTimesIr = 0,
         const Size regressionMaxSimTimesFx = 0, const Size regressionMaxSimTimesEq = 0,
-        const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global)
+        const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global,
+        const RandomVariableRegressionMethod regressionMethod = RandomVariableRegressionMethod::QR)
         : McCamCallableBondEngine(
               Handle<CrossAssetModel>(QuantLib::ext::make_shared<CrossAssetModel>(
                   std::vector<QuantLib::ext::shared_ptr<IrModel>>(1, model),
@@ -270,7 +273,7 @@ public:
               generateAdditionalResults, simulationDates, stickyCloseOutDates, externalModelIndices, minimalObsDate,
               regressorModel, regressionVarianceCutoff, recalibrateOnStickyCloseOutDates, reevaluateExerciseInStickyRun,
               cfOnCpnMaxSimTimes, cfOnCpnAddSimTimesCutoff, regressionMaxSimTimesIr, regressionMaxSimTimesFx,
-              regressionMaxSimTimesEq, regressionVarGroupMode) {};
+              regressionMaxSimTimesEq, regressionVarGroupMode, regressionMethod) {};
 
     McCamCallableBondEngine(
         const Handle<CrossAssetModel>& model, const SequenceType calibrationPathGenerator,
@@ -293,7 +296,8 @@ public:
         const bool reevaluateExerciseInStickyRun = false, const Size cfOnCpnMaxSimTimes = 1,
         const Period& cfOnCpnAddSimTimesCutoff = Period(), const Size regressionMaxSimTimesIr = 0,
         const Size regressionMaxSimTimesFx = 0, const Size regressionMaxSimTimesEq = 0,
-        const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global)
+        const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global,
+        const RandomVariableRegressionMethod regressionMethod = RandomVariableRegressionMethod::QR)
         : McCamCallableBondBaseEngine(model, calibrationPathGenerator, pricingPathGenerator, calibrationSamples,
                                       pricingSamples, calibrationSeed, pricingSeed, polynomOrder, polynomType, ordering,
                                       directionIntegers, referenceCurve, discountingSpread, creditCurve, incomeCurve,
@@ -302,7 +306,8 @@ public:
                                       externalModelIndices, minimalObsDate, regressorModel, regressionVarianceCutoff,
                                       recalibrateOnStickyCloseOutDates, reevaluateExerciseInStickyRun,
                                       cfOnCpnMaxSimTimes, cfOnCpnAddSimTimesCutoff, regressionMaxSimTimesIr,
-                                      regressionMaxSimTimesFx, regressionMaxSimTimesEq, regressionVarGroupMode) {
+                                      regressionMaxSimTimesFx, regressionMaxSimTimesEq, regressionVarGroupMode,
+                                      regressionMethod) {
         registerWith(model);
         registerWith(referenceCurve);
         registerWith(discountingSpread);
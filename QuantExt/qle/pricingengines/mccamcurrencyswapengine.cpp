@@ -33,14 +33,15 @@ McCamCurrencySwapEngine::McCamCurrencySwapEngine(
     const Real regressionVarianceCutoff, const bool recalibrateOnStickyCloseOutDates,
     const bool reevaluateExerciseInStickyRun, const Size cfOnCpnMaxSimTimes, const Period& cfOnCpnAddSimTimesCutoff,
     const Size regressionMaxSimTimesIr, const Size regressionMaxSimTimesFx, const Size regressionMaxSimTimesEq,
-    const McRegressionModel::VarGroupMode regressionVarGroupMode)
+    const McRegressionModel::VarGroupMode regressionVarGroupMode,
+    const RandomVariableRegressionMethod regressionMethod)
     : McMultiLegBaseEngine(model, calibrationPathGenerator, pricingPathGenerator, calibrationSamples, pricingSamples,
                            calibrationSeed, pricingSeed, polynomOrder, polynomType, ordering, directionIntegers,
                            discountCurves, simulationDates, stickyCloseOutDates, externalModelIndices, minimalObsDate,
                            regressorModel, regressionVarianceCutoff, recalibrateOnStickyCloseOutDates,
                            reevaluateExerciseInStickyRun, cfOnCpnMaxSimTimes, cfOnCpnAddSimTimesCutoff,
                            regressionMaxSimTimesIr, regressionMaxSimTimesFx, regressionMaxSimTimesEq,
-                           regressionVarGroupMode),
+                           regressionVarGroupMode, regressionMethod),
       currencies_(currencies), npvCcy_(npvCcy) {
     registerWith(model_);
     for (auto const& h : discountCurves)
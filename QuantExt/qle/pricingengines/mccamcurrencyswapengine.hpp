@@ -51,7 +51,8 @@ public:
         const Size regressionMaxSimTimesIr = 0,
         const Size regressionMaxSimTimesFx = 0,
         const Size regressionMaxSimTimesEq = 0,
-        const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global);
+        const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global,
+        const RandomVariableRegressionMethod regressionMethod = RandomVariableRegressionMethod::QR);
 
     void calculate() const override;
     const Handle<CrossAssetModel>& model() const { return model_; }
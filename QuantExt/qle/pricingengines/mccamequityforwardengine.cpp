@@ -35,14 +35,15 @@ McCamEquityForwardEngine::McCamEquityForwardEngine(
     const bool recalibrateOnStickyCloseOutDates, const bool reevaluateExerciseInStickyRun,
     const Size cfOnCpnMaxSimTimes, const Period& cfOnCpnAddSimTimesCutoff,
     const Size regressionMaxSimTimesIr, const Size regressionMaxSimTimesFx, const Size regressionMaxSimTimesEq,
-    const McRegressionModel::VarGroupMode regressionVarGroupMode)
+    const McRegressionModel::VarGroupMode regressionVarGroupMode,
+    const RandomVariableRegressionMethod regressionMethod)
     : McMultiLegBaseEngine(model, calibrationPathGenerator, pricingPathGenerator, calibrationSamples, pricingSamples,
                            calibrationSeed, pricingSeed, polynomOrder, polynomType, ordering, directionIntegers, {},
                            simulationDates, stickyCloseOutDates, externalModelIndices, minimalObsDate, regressorModel,
                            regressionVarianceCutoff, recalibrateOnStickyCloseOutDates, reevaluateExerciseInStickyRun,
                            cfOnCpnMaxSimTimes, cfOnCpnAddSimTimesCutoff,
                            regressionMaxSimTimesIr, regressionMaxSimTimesFx, regressionMaxSimTimesEq,
-                           regressionVarGroupMode),
+                           regressionVarGroupMode, regressionMethod),
       equityIndex_(equityIndex) {}
 
 void McCamEquityForwardEngine::calculate() const {
@@ -36,14 +36,15 @@ McCamFxForwardEngine::McCamFxForwardEngine(
     const bool recalibrateOnStickyCloseOutDates, const bool reevaluateExerciseInStickyRun,
     const Size cfOnCpnMaxSimTimes, const Period& cfOnCpnAddSimTimesCutoff, const Size regressionMaxSimTimesIr,
     const Size regressionMaxSimTimesFx, const Size regressionMaxSimTimesEq,
-    const McRegressionModel::VarGroupMode regressionVarGroupMode)
+    const McRegressionModel::VarGroupMode regressionVarGroupMode,
+    const RandomVariableRegressionMethod regressionMethod)
     : McMultiLegBaseEngine(model, calibrationPathGenerator, pricingPathGenerator, calibrationSamples, pricingSamples,
                            calibrationSeed, pricingSeed, polynomOrder, polynomType, ordering, directionIntegers,
                            discountCurves, simulationDates, stickyCloseOutDates, externalModelIndices, minimalObsDate,
                            regressorModel, regressionVarianceCutoff, recalibrateOnStickyCloseOutDates,
                            reevaluateExerciseInStickyRun, cfOnCpnMaxSimTimes, cfOnCpnAddSimTimesCutoff,
                            regressionMaxSimTimesIr, regressionMaxSimTimesFx, regressionMaxSimTimesEq,
-                           regressionVarGroupMode),
+                           regressionVarGroupMode, regressionMethod),
       domesticCcy_(domesticCcy), foreignCcy_(foreignCcy), npvCcy_(npvCcy) {
     registerWith(model_);
     for (auto const& h : discountCurves)
@@ -51,7 +51,8 @@ public:
         const bool reevaluateExerciseInStickyRun = false, const Size cfOnCpnMaxSimTimes = 1,
         const Period& cfOnCpnAddSimTimesCutoff = Period(), const Size regressionMaxSimTimesIr = 0,
         const Size regressionMaxSimTimesFx = 0, const Size regressionMaxSimTimesEq = 0,
-        const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global);
+        const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global,
+        const RandomVariableRegressionMethod regressionMethod = RandomVariableRegressionMethod::QR);
 
     void setupLegs() const;
     void calculateFxOptionBase() const;
@@ -85,7 +86,8 @@ public:
         const bool reevaluateExerciseInStickyRun = false, const Size cfOnCpnMaxSimTimes = 1,
         const Period& cfOnCpnAddSimTimesCutoff = Period(), const Size regressionMaxSimTimesIr = 0,
         const Size regressionMaxSimTimesFx = 0, const Size regressionMaxSimTimesEq = 0,
-        const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global)
+        const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global,
+        const RandomVariableRegressionMethod regressionMethod = RandomVariableRegressionMethod::QR)
         : McCamFxOptionEngineBase(model, domesticCcy, foreignCcy, npvCcy, calibrationPathGenerator,
                                   pricingPathGenerator, calibrationSamples, pricingSamples, calibrationSeed,
                                   pricingSeed, polynomOrder, polynomType, ordering, directionIntegers, discountCurves,
@@ -93,7 +95,7 @@ public:
                                   regressorModel, regressionVarianceCutoff, recalibrateOnStickyCloseOutDates,
                                   reevaluateExerciseInStickyRun, cfOnCpnMaxSimTimes, cfOnCpnAddSimTimesCutoff,
                                   regressionMaxSimTimesIr, regressionMaxSimTimesFx, regressionMaxSimTimesEq,
-                                  regressionVarGroupMode) {
+                                  regressionVarGroupMode, regressionMethod) {
         registerWith(model_);
         for (auto const& h : discountCurves_)
             registerWith(h);
@@ -119,7 +121,8 @@ public:
         const bool reevaluateExerciseInStickyRun = false, const Size cfOnCpnMaxSimTimes = 1,
         const Period& cfOnCpnAddSimTimesCutoff = Period(), const Size regressionMaxSimTimesIr = 0,
         const Size regressionMaxSimTimesFx = 0, const Size regressionMaxSimTimesEq = 0,
-        const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global)
+        const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global,
+        const RandomVariableRegressionMethod regressionMethod = RandomVariableRegressionMethod::QR)
         : McCamFxOptionEngineBase(model, domesticCcy, foreignCcy, npvCcy, calibrationPathGenerator,
                                   pricingPathGenerator, calibrationSamples, pricingSamples, calibrationSeed,
                                   pricingSeed, polynomOrder, polynomType, ordering, directionIntegers, discountCurves,
@@ -127,7 +130,7 @@ public:
                                   regressorModel, regressionVarianceCutoff, recalibrateOnStickyCloseOutDates,
                                   reevaluateExerciseInStickyRun, cfOnCpnMaxSimTimes, cfOnCpnAddSimTimesCutoff,
                                   regressionMaxSimTimesIr, regressionMaxSimTimesFx, regressionMaxSimTimesEq,
-                                  regressionVarGroupMode) {
+                                  regressionVarGroupMode, regressionMethod) {
         registerWith(model_);
         for (auto const& h : discountCurves_)
             registerWith(h);
@@ -153,7 +156,8 @@ public:
         const bool reevaluateExerciseInStickyRun = false, const Size cfOnCpnMaxSimTimes = 1,
         const Period& cfOnCpnAddSimTimesCutoff = Period(), const Size regressionMaxSimTimesIr = 0,
         const Size regressionMaxSimTimesFx = 0, const Size regressionMaxSimTimesEq = 0,
-        const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global)
+        const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global,
+        const RandomVariableRegressionMethod regressionMethod = RandomVariableRegressionMethod::QR)
         : McCamFxOptionEngineBase(model, domesticCcy, foreignCcy, npvCcy, calibrationPathGenerator,
                                   pricingPathGenerator, calibrationSamples, pricingSamples, calibrationSeed,
                                   pricingSeed, polynomOrder, polynomType, ordering, directionIntegers, discountCurves,
@@ -161,7 +165,7 @@ public:
                                   regressorModel, regressionVarianceCutoff, recalibrateOnStickyCloseOutDates,
                                   reevaluateExerciseInStickyRun, cfOnCpnMaxSimTimes, cfOnCpnAddSimTimesCutoff,
                                   regressionMaxSimTimesIr, regressionMaxSimTimesFx, regressionMaxSimTimesEq,
-                                  regressionVarGroupMode) {
+                                  regressionVarGroupMode, regressionMethod) {
         registerWith(model_);
         for (auto const& h : discountCurves_)
             registerWith(h);
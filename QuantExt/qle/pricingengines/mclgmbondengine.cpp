@@ -44,16 +44,16 @@ void McLgmBondEngine::calculate() const {
 RandomVariable
 McLgmBondEngine::overwritePathValueUndDirty(double t, const RandomVariable& pathValueUndDirty,
                                             const std::set<Real>& exerciseXvaTimes,
-                                            const std::vector<std::vector<QuantExt::RandomVariable>>& paths) const {
+                                            const std::vector<std::vector<const RandomVariable*>>& paths) const {
 
     Size ind = std::distance(exerciseXvaTimes.begin(), exerciseXvaTimes.find(t));
 
     // numeraire adjustment {ref + spread} (t) / ois (t) ... ois below with return ...
-    auto numeraire_bonddiscount =
-        lgmVectorised_[0].numeraire(t, paths[ind][model_->pIdx(CrossAssetModel::AssetType::IR, 0)], discountCurves_[0]);
+    auto numeraire_bonddiscount = lgmVectorised_[0].numeraire(
+        t, *paths[ind][model_->pIdx(CrossAssetModel::AssetType::IR, 0)], discountCurves_[0]);
 
     auto numeraire_ccyDiscount =
-        lgmVectorised_[0].numeraire(t, paths[ind][model_->pIdx(CrossAssetModel::AssetType::IR, 0)], ccyDiscount_);
+        lgmVectorised_[0].numeraire(t, *paths[ind][model_->pIdx(CrossAssetModel::AssetType::IR, 0)], ccyDiscount_);
 
     return pathValueUndDirty * numeraire_bonddiscount / numeraire_ccyDiscount;
 }
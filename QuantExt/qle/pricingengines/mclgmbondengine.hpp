@@ -52,7 +52,8 @@ public:
                     const Size regressionMaxSimTimesIr = 0,
                     const Size regressionMaxSimTimesFx = 0,
                     const Size regressionMaxSimTimesEq = 0,
-                    const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global)
+                    const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global,
+                    const RandomVariableRegressionMethod regressionMethod = RandomVariableRegressionMethod::QR)
         : GenericEngine<QuantLib::Bond::arguments, QuantLib::Bond::results>(),
           McMultiLegBaseEngine(Handle<CrossAssetModel>(QuantLib::ext::make_shared<CrossAssetModel>(
                                    std::vector<QuantLib::ext::shared_ptr<IrModel>>(1, model),
@@ -63,7 +64,8 @@ public:
                                minimalObsDate, regressorModel, regressionVarianceCutoff,
                                recalibrateOnStickyCloseOutDates, reevaluateExerciseInStickyRun,
                                cfOnCpnMaxSimTimes, cfOnCpnAddSimTimesCutoff, regressionMaxSimTimesIr,
-                               regressionMaxSimTimesFx, regressionMaxSimTimesEq, regressionVarGroupMode) {
+                               regressionMaxSimTimesFx, regressionMaxSimTimesEq, regressionVarGroupMode,
+                               regressionMethod) {
         registerWith(model);
         for (auto& h : discountCurves_)
             registerWith(h);
@@ -76,7 +78,7 @@ public:
     RandomVariable
     overwritePathValueUndDirty(double t, const RandomVariable& pathValueUndDirty,
                                const std::set<Real>& exerciseXvaTimes,
-                               const std::vector<std::vector<QuantExt::RandomVariable>>& paths) const override;
+                               const std::vector<std::vector<const RandomVariable*>>& paths) const override;
 
     bool useOverwritePathValueUndDirty() const override { return true; };
 
@@ -117,25 +117,25 @@ void McLgmFwdBondEngine::calculate() const {
 RandomVariable
 McLgmFwdBondEngine::overwritePathValueUndDirty(double t, const RandomVariable& pathValueUndDirty,
                                                const std::set<Real>& exerciseXvaTimes,
-                                               const std::vector<std::vector<QuantExt::RandomVariable>>& paths) const {
+                                               const std::vector<std::vector<const RandomVariable*>>& paths) const {
 
     double fwdMaturity = time(arguments_.fwdMaturityDate);
     if (t < fwdMaturity) {
 
         Size ind = std::distance(exerciseXvaTimes.begin(), exerciseXvaTimes.find(t));
-        Size samples = paths.front().front().size();
+        Size samples = paths.front().front()->size();
 
         // numeraire adjustment {ref + spread} (t) / ois (t) ... ois below with return ...
         auto numeraire_bonddiscount = lgmVectorised_[0].numeraire(
-            t, paths[ind][model_->pIdx(CrossAssetModel::AssetType::IR, 0)], discountCurves_[0]);
+            t, *paths[ind][model_->pIdx(CrossAssetModel::AssetType::IR, 0)], discountCurves_[0]);
 
         auto numeraire_contract = lgmVectorised_[0].numeraire(
-            t, paths[ind][model_->pIdx(CrossAssetModel::AssetType::IR, 0)], contractCurve_);
+            t, *paths[ind][model_->pIdx(CrossAssetModel::AssetType::IR, 0)], contractCurve_);
 
         // compounding with income curve from t to fwd_maturity T
         double compoundingTime = time(incomeCurveDate_);
         auto incomeCompounding = lgmVectorised_[0].discountBond(
-            t, compoundingTime, paths[ind][model_->pIdx(CrossAssetModel::AssetType::IR, 0)], incomeCurve_);
+            t, compoundingTime, *paths[ind][model_->pIdx(CrossAssetModel::AssetType::IR, 0)], incomeCurve_);
 
         RandomVariable forwardBondValue = pathValueUndDirty * numeraire_bonddiscount / incomeCompounding;
 
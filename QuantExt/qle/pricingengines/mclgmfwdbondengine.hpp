@@ -54,7 +54,8 @@ public:
                        const Size regressionMaxSimTimesIr = 0,
                        const Size regressionMaxSimTimesFx = 0,
                        const Size regressionMaxSimTimesEq = 0,
-                       const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global)
+                       const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global,
+                       const RandomVariableRegressionMethod regressionMethod = RandomVariableRegressionMethod::QR)
         : GenericEngine<QuantExt::ForwardBond::arguments, QuantExt::ForwardBond::results>(),
           McMultiLegBaseEngine(Handle<CrossAssetModel>(QuantLib::ext::make_shared<CrossAssetModel>(
                                    std::vector<QuantLib::ext::shared_ptr<IrModel>>(1, model),
@@ -65,7 +66,7 @@ public:
                                minimalObsDate, regressorModel, regressionVarianceCutoff, recalibrateOnStickyCloseOutDates,
                                reevaluateExerciseInStickyRun, cfOnCpnMaxSimTimes, cfOnCpnAddSimTimesCutoff,
                                regressionMaxSimTimesIr, regressionMaxSimTimesFx, regressionMaxSimTimesEq,
-                               regressionVarGroupMode) {
+                               regressionVarGroupMode, regressionMethod) {
 
         incomeCurve_ = incomeCurve;
         contractCurve_ = contractCurve;
@@ -86,7 +87,7 @@ public:
     RandomVariable
     overwritePathValueUndDirty(double t, const RandomVariable& pathValueUndDirty,
                                const std::set<Real>& exerciseXvaTimes,
-                               const std::vector<std::vector<QuantExt::RandomVariable>>& paths) const override;
+                               const std::vector<std::vector<const RandomVariable*>>& paths) const override;
 
     bool useOverwritePathValueUndDirty() const override { return true; };
 
@@ -51,7 +51,8 @@ public:
                     const Size regressionMaxSimTimesIr = 0,
                     const Size regressionMaxSimTimesFx = 0,
                     const Size regressionMaxSimTimesEq = 0,
-                    const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global)
+                    const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global,
+                    const RandomVariableRegressionMethod regressionMethod = RandomVariableRegressionMethod::QR)
         : McLgmSwapEngine(Handle<CrossAssetModel>(QuantLib::ext::make_shared<CrossAssetModel>(
                               std::vector<QuantLib::ext::shared_ptr<IrModel>>(1, model),
                               std::vector<QuantLib::ext::shared_ptr<FxBsParametrization>>())),
@@ -61,7 +62,7 @@ public:
                           regressorModel, regressionVarianceCutoff, recalibrateOnStickyCloseOutDates,
                           reevaluateExerciseInStickyRun, cfOnCpnMaxSimTimes, cfOnCpnAddSimTimesCutoff,
                           regressionMaxSimTimesIr, regressionMaxSimTimesFx, regressionMaxSimTimesEq,
-                          regressionVarGroupMode) {}
+                          regressionVarGroupMode, regressionMethod) {}
 
     McLgmSwapEngine(const QuantLib::Handle<CrossAssetModel>& model, const SequenceType calibrationPathGenerator,
                     const SequenceType pricingPathGenerator, const Size calibrationSamples, const Size pricingSamples,
@@ -82,7 +83,8 @@ public:
                     const Size regressionMaxSimTimesIr = 0,
                     const Size regressionMaxSimTimesFx = 0,
                     const Size regressionMaxSimTimesEq = 0,
-                    const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global)
+                    const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global,
+                    const RandomVariableRegressionMethod regressionMethod = RandomVariableRegressionMethod::QR)
         : GenericEngine<QuantLib::Swap::arguments, QuantLib::Swap::results>(),
           McMultiLegBaseEngine(model, calibrationPathGenerator, pricingPathGenerator, calibrationSamples,
                                pricingSamples, calibrationSeed, pricingSeed, polynomOrder, polynomType, ordering,
@@ -90,7 +92,8 @@ public:
                                externalModelIndices, minimalObsDate, regressorModel, regressionVarianceCutoff,
                                recalibrateOnStickyCloseOutDates, reevaluateExerciseInStickyRun,
                                cfOnCpnMaxSimTimes, cfOnCpnAddSimTimesCutoff, regressionMaxSimTimesIr,
-                               regressionMaxSimTimesFx, regressionMaxSimTimesEq, regressionVarGroupMode) {
+                               regressionMaxSimTimesFx, regressionMaxSimTimesEq, regressionVarGroupMode,
+                               regressionMethod) {
         registerWith(model);
     }
 
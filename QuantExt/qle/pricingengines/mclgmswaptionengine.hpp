@@ -53,7 +53,8 @@ public:
                         const Size regressionMaxSimTimesIr = 0,
                         const Size regressionMaxSimTimesFx = 0,
                         const Size regressionMaxSimTimesEq = 0,
-                        const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global)
+                        const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global,
+                        const RandomVariableRegressionMethod regressionMethod = RandomVariableRegressionMethod::QR)
         : GenericEngine<QuantLib::Swaption::arguments, QuantLib::Swaption::results>(),
           McMultiLegBaseEngine(Handle<CrossAssetModel>(QuantLib::ext::make_shared<CrossAssetModel>(
                                    std::vector<QuantLib::ext::shared_ptr<IrModel>>(1, model),
@@ -64,7 +65,7 @@ public:
                                minimalObsDate, regressorModel, regressionVarianceCutoff, recalibrateOnStickyCloseOutDates,
                                reevaluateExerciseInStickyRun, cfOnCpnMaxSimTimes, cfOnCpnAddSimTimesCutoff,
                                regressionMaxSimTimesIr, regressionMaxSimTimesFx, regressionMaxSimTimesEq,
-                               regressionVarGroupMode) {
+                               regressionVarGroupMode, regressionMethod) {
         registerWith(model);
     }
 
@@ -96,7 +97,8 @@ public:
                                    const Size regressionMaxSimTimesIr = 0,
                                    const Size regressionMaxSimTimesFx = 0,
                                    const Size regressionMaxSimTimesEq = 0,
-                                   const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global)
+                                   const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global,
+                                   const RandomVariableRegressionMethod regressionMethod = RandomVariableRegressionMethod::QR)
         : GenericEngine<QuantLib::NonstandardSwaption::arguments, QuantLib::NonstandardSwaption::results>(),
           McMultiLegBaseEngine(Handle<CrossAssetModel>(QuantLib::ext::make_shared<CrossAssetModel>(
                                    std::vector<QuantLib::ext::shared_ptr<IrModel>>(1, model),
@@ -107,7 +109,8 @@ public:
                                minimalObsDate, regressorModel, regressionVarianceCutoff,
                                recalibrateOnStickyCloseOutDates, reevaluateExerciseInStickyRun,
                                cfOnCpnMaxSimTimes, cfOnCpnAddSimTimesCutoff, regressionMaxSimTimesIr,
-                               regressionMaxSimTimesFx, regressionMaxSimTimesEq, regressionVarGroupMode) {
+                               regressionMaxSimTimesFx, regressionMaxSimTimesEq, regressionVarGroupMode,
+                               regressionMethod) {
         registerWith(model);
     }
 
@@ -20,7 +20,6 @@
 #include <qle/instruments/rebatedexercise.hpp>
 #include <qle/math/randomvariablelsmbasissystem.hpp>
 #include <qle/pricingengines/mcmultilegbaseengine.hpp>
-#include <qle/processes/irlgm1fstateprocess.hpp>
 
 
 #include <ql/math/interpolations/linearinterpolation.hpp>
@@ -42,7 +41,8 @@ McMultiLegBaseEngine::McMultiLegBaseEngine(
     const Real regressionVarianceCutoff, const bool recalibrateOnStickyCloseOutDates,
     const bool reevaluateExerciseInStickyRun, const Size cfOnCpnMaxSimTimes,
     const Period& cfOnCpnAddSimTimesCutoff, const Size regressionMaxSimTimesIr, const Size regressionMaxSimTimesFx,
-    const Size regressionMaxSimTimesEq, const McRegressionModel::VarGroupMode regressionVarGroupMode)
+    const Size regressionMaxSimTimesEq, const McRegressionModel::VarGroupMode regressionVarGroupMode,
+    const RandomVariableRegressionMethod regressionMethod)
     : model_(model), calibrationPathGenerator_(calibrationPathGenerator), pricingPathGenerator_(pricingPathGenerator),
       calibrationSamples_(calibrationSamples), pricingSamples_(pricingSamples), calibrationSeed_(calibrationSeed),
       pricingSeed_(pricingSeed), polynomOrder_(polynomOrder), polynomType_(polynomType), ordering_(ordering),
@@ -57,7 +57,7 @@ McMultiLegBaseEngine::McMultiLegBaseEngine(
       regressionMaxSimTimesIr_(regressionMaxSimTimesIr),
       regressionMaxSimTimesFx_(regressionMaxSimTimesFx),
       regressionMaxSimTimesEq_(regressionMaxSimTimesEq),
-      regressionVarGroupMode_(regressionVarGroupMode) {
+      regressionVarGroupMode_(regressionVarGroupMode), regressionMethod_(regressionMethod) {
 
     if (discountCurves_.empty())
         discountCurves_.resize(model_->components(CrossAssetModel::AssetType::IR));
@@ -90,40 +90,77 @@ Size McMultiLegBaseEngine::timeIndex(const Time t, const std::set<Real>& times)
     return std::distance(times.begin(), it);
 }
 
-RandomVariable McMultiLegBaseEngine::cashflowPathValue(const McCashflowInfo& cf,
-                                                       const std::vector<std::vector<RandomVariable>>& pathValues,
-                                                       const std::set<Real>& simulationTimes) const {
-
-    Size n = pathValues[0][0].size();
-    auto simTimesPayIdx = timeIndex(cf.payTime, simulationTimes);
-
-    std::vector<RandomVariable> initialValues(model_->stateProcess()->initialValues().size());
-    for (Size i = 0; i < model_->stateProcess()->initialValues().size(); ++i)
-        initialValues[i] = RandomVariable(n, model_->stateProcess()->initialValues()[i]);
-
-    std::vector<std::vector<const RandomVariable*>> states(cf.simulationTimes.size());
-    for (Size i = 0; i < cf.simulationTimes.size(); ++i) {
-        std::vector<const RandomVariable*> tmp(cf.modelIndices[i].size());
-        if (cf.simulationTimes[i] == 0.0) {
-            for (Size j = 0; j < cf.modelIndices[i].size(); ++j) {
-                tmp[j] = &initialValues[cf.modelIndices[i][j]];
+void McMultiLegBaseEngine::initCashflowPathData(CashflowPathData& data,
+                                                const std::vector<McCashflowInfo>& cashflowInfo,
+                                                const std::vector<std::vector<const RandomVariable*>>& pathValues,
+                                                const std::set<Real>& simulationTimes) const {
+
+    Size n = pathValues[0][0]->size();
+
+    data.initialValues.clear();
+    for (auto const& v : model_->stateProcess()->initialValues())
+        data.initialValues.push_back(RandomVariable(n, v));
+
+    data.states.resize(cashflowInfo.size());
+    data.payTimeIndex.resize(cashflowInfo.size());
+    data.fxGroup.resize(cashflowInfo.size());
+    data.numeraire.assign(simulationTimes.size(), RandomVariable());
+    data.fxConversion.clear();
+
+    std::map<std::pair<Size, Size>, Size> fxGroups;
+
+    for (Size c = 0; c < cashflowInfo.size(); ++c) {
+        const McCashflowInfo& cf = cashflowInfo[c];
+        data.states[c].resize(cf.simulationTimes.size());
+        for (Size i = 0; i < cf.simulationTimes.size(); ++i) {
+            std::vector<const RandomVariable*>& tmp = data.states[c][i];
+            tmp.resize(cf.modelIndices[i].size());
+            if (cf.simulationTimes[i] == 0.0) {
+                for (Size j = 0; j < cf.modelIndices[i].size(); ++j) {
+                    tmp[j] = &data.initialValues[cf.modelIndices[i][j]];
+                }
+            } else {
+                auto simTimesIdx = timeIndex(cf.simulationTimes[i], simulationTimes);
+                for (Size j = 0; j < cf.modelIndices[i].size(); ++j) {
+                    tmp[j] = pathValues[simTimesIdx][cf.modelIndices[i][j]];
+                }
             }
+        }
+        data.payTimeIndex[c] = timeIndex(cf.payTime, simulationTimes);
+        if (cf.payCcyIndex > 0) {
+            auto g = fxGroups.insert(std::make_pair(std::make_pair(data.payTimeIndex[c], cf.payCcyIndex),
+                                                    fxGroups.size()));
+            data.fxGroup[c] = g.first->second;
         } else {
-            auto simTimesIdx = timeIndex(cf.simulationTimes[i], simulationTimes);
-            for (Size j = 0; j < cf.modelIndices[i].size(); ++j) {
-                tmp[j] = &pathValues[simTimesIdx][cf.modelIndices[i][j]];
-            }
+            data.fxGroup[c] = Null<Size>();
         }
-        states[i] = tmp;
     }
 
-    auto amount = cf.amountCalculator(n, states) /
-                  lgmVectorised_[0].numeraire(
-                      cf.payTime, pathValues[simTimesPayIdx][model_->pIdx(CrossAssetModel::AssetType::IR, 0)],
-                      discountCurves_[0]);
+    data.fxConversion.resize(fxGroups.size());
+}
+
+RandomVariable
+McMultiLegBaseEngine::cashflowPathValue(const McCashflowInfo& cf, const Size i, CashflowPathData& data,
+                                        const std::vector<std::vector<const RandomVariable*>>& pathValues) const {
 
-    if (cf.payCcyIndex > 0) {
-        amount *= exp(pathValues[simTimesPayIdx][model_->pIdx(CrossAssetModel::AssetType::FX, cf.payCcyIndex - 1)]);
+    Size n = pathValues[0][0]->size();
+    Size simTimesPayIdx = data.payTimeIndex[i];
+
+    RandomVariable& numeraire = data.numeraire[simTimesPayIdx];
+    if (!numeraire.initialised()) {
+        numeraire = lgmVectorised_[0].numeraire(
+            cf.payTime, *pathValues[simTimesPayIdx][model_->pIdx(CrossAssetModel::AssetType::IR, 0)],
+            discountCurves_[0]);
+    }
+
+    auto amount = cf.amountCalculator(n, data.states[i]) / numeraire;
+
+    if (data.fxGroup[i] != Null<Size>()) {
+        RandomVariable& fx = data.fxConversion[data.fxGroup[i]];
+        if (!fx.initialised()) {
+            fx = exp(*pathValues[simTimesPayIdx][model_->pIdx(CrossAssetModel::AssetType::FX, cf.payCcyIndex - 1)]);
+        }
+        amount *= fx;
     }
 
     return amount * RandomVariable(n, cf.payer ? -1.0 : 1.0);
@@ -132,8 +169,7 @@ RandomVariable McMultiLegBaseEngine::cashflowPathValue(const McCashflowInfo& cf,
 void McMultiLegBaseEngine::calculateModels(
     const std::set<Real>& simulationTimes, const std::set<Real>& exerciseXvaTimes, const std::set<Real>& exerciseTimes,
     const std::set<Real>& xvaTimes, const std::vector<McCashflowInfo>& cashflowInfo,
-    const std::vector<std::vector<RandomVariable>>& pathValues,
-    const std::vector<std::vector<const RandomVariable*>>& pathValuesRef,
+    const std::vector<std::vector<const RandomVariable*>>& pathValues,
     std::vector<McRegressionModel>& regModelUndDirty, std::vector<McRegressionModel>& regModelUndExInto,
     std::vector<McRegressionModel>& regModelRebate, std::vector<McRegressionModel>& regModelContinuationValue,
     std::vector<McRegressionModel>& regModelOption, RandomVariable& pathValueUndDirty, RandomVariable& pathValueUndExInto,
@@ -146,6 +182,9 @@ void McMultiLegBaseEngine::calculateModels(
 
     std::vector<RandomVariable> amountCache(cashflowInfo.size());
 
+    CashflowPathData cfPathData;
+    initCashflowPathData(cfPathData, cashflowInfo, pathValues, simulationTimes);
+
     Size counter = exerciseXvaTimes.size() - 1;
     auto previousExerciseTime = exerciseTimes.rbegin();
 
@@ -182,12 +221,12 @@ void McMultiLegBaseEngine::calculateModels(
 
             if (cfStatus[i] == CfStatus::open) {
                 if (isPartOfExercise) {
-                    auto tmp = cashflowPathValue(cashflowInfo[i], pathValues, simulationTimes);
+                    auto tmp = cashflowPathValue(cashflowInfo[i], i, cfPathData, pathValues);
                     pathValueUndDirty += tmp;
                     pathValueUndExInto += tmp;
                     cfStatus[i] = CfStatus::done;
                 } else if (isPartOfUnderlying) {
-                    auto tmp = cashflowPathValue(cashflowInfo[i], pathValues, simulationTimes);
+                    auto tmp = cashflowPathValue(cashflowInfo[i], i, cfPathData, pathValues);
                     pathValueUndDirty += tmp;
                     amountCache[i] = tmp;
                     cfStatus[i] = CfStatus::cached;
@@ -209,7 +248,7 @@ void McMultiLegBaseEngine::calculateModels(
                 Real payTime = time(rebatedExercise->rebatePaymentDate(rebateIndex));
                 if (payTime >= 0.0) {
                     pathValueRebate = lgmVectorised_[0].reducedDiscountBond(
-                                          *t, payTime, pathValues[simulationTimes_idx][0], discountCurves_[0]) *
+                                          *t, payTime, *pathValues[simulationTimes_idx][0], discountCurves_[0]) *
                                       RandomVariable(calibrationSamples_, rebatedExercise->rebate(rebateIndex));
                 } else {
                     pathValueRebate = RandomVariable(calibrationSamples_, 0.0);
@@ -225,16 +264,16 @@ void McMultiLegBaseEngine::calculateModels(
             regModelUndExInto[counter] = McRegressionModel(
                 *t, cashflowInfo, [&cfStatus](std::size_t i) { return cfStatus[i] == CfStatus::done; }, **model_,
                 regressorModel_, regressionVarianceCutoff_, regressionMaxSimTimesIr_, regressionMaxSimTimesFx_,
-                regressionMaxSimTimesEq_, regressionVarGroupMode_);
-            regModelUndExInto[counter].train(polynomOrder_, polynomType_, pathValueUndExInto, pathValuesRef,
+                regressionMaxSimTimesEq_, regressionVarGroupMode_, regressionMethod_);
+            regModelUndExInto[counter].train(polynomOrder_, polynomType_, pathValueUndExInto, pathValues,
                                              simulationTimes);
 
             if (pathValueRebate.initialised()) {
                 regModelRebate[counter] = McRegressionModel(
                     *t, cashflowInfo, [&cfStatus](std::size_t i) { return cfStatus[i] == CfStatus::done; }, **model_,
                     regressorModel_, regressionVarianceCutoff_, regressionMaxSimTimesIr_, regressionMaxSimTimesFx_,
-                    regressionMaxSimTimesEq_, regressionVarGroupMode_);
-                regModelRebate[counter].train(polynomOrder_, polynomType_, pathValueRebate, pathValuesRef,
+                    regressionMaxSimTimesEq_, regressionVarGroupMode_, regressionMethod_);
+                regModelRebate[counter].train(polynomOrder_, polynomType_, pathValueRebate, pathValues,
                                               simulationTimes);
             }
         }
@@ -245,12 +284,12 @@ void McMultiLegBaseEngine::calculateModels(
 
             RandomVariable rebate(calibrationSamples_, 0.0);
             if (regModelRebate[counter].isTrained()) {
-                rebate = regModelRebate[counter].apply(model_->stateProcess()->initialValues(), pathValuesRef,
+                rebate = regModelRebate[counter].apply(model_->stateProcess()->initialValues(), pathValues,
                                                        simulationTimes);
             }
 
             auto exerciseValue = regModelUndExInto[counter].apply(model_->stateProcess()->initialValues(),
-                                                                  pathValuesRef, simulationTimes) +rebate;
+                                                                  pathValues, simulationTimes) +rebate;
 
 
             // calculate continuation value, take exercise decition and update option path value
@@ -258,12 +297,12 @@ void McMultiLegBaseEngine::calculateModels(
             regModelContinuationValue[counter] = McRegressionModel(
                 *t, cashflowInfo, [&cfStatus](std::size_t i) { return cfStatus[i] == CfStatus::done; }, **model_,
                 regressorModel_, regressionVarianceCutoff_, regressionMaxSimTimesIr_, regressionMaxSimTimesFx_,
-                regressionMaxSimTimesEq_, regressionVarGroupMode_);
-            regModelContinuationValue[counter].train(polynomOrder_, polynomType_, pathValueOption, pathValuesRef,
+                regressionMaxSimTimesEq_, regressionVarGroupMode_, regressionMethod_);
+            regModelContinuationValue[counter].train(polynomOrder_, polynomType_, pathValueOption, pathValues,
                                                      simulationTimes,
                                                      exerciseValue > RandomVariable(calibrationSamples_, 0.0));
             auto continuationValue = regModelContinuationValue[counter].apply(model_->stateProcess()->initialValues(),
-                                                                              pathValuesRef, simulationTimes);
+                                                                              pathValues, simulationTimes);
             pathValueOption = conditionalResult(exerciseValue > continuationValue &&
                                                     exerciseValue > RandomVariable(calibrationSamples_, 0.0),
                                                 pathValueUndExInto + rebate, pathValueOption);
@@ -274,21 +313,21 @@ void McMultiLegBaseEngine::calculateModels(
             regModelUndDirty[counter] = McRegressionModel(
                 *t, cashflowInfo, [&cfStatus](std::size_t i) { return cfStatus[i] != CfStatus::open; }, **model_,
                 regressorModel_, regressionVarianceCutoff_, regressionMaxSimTimesIr_, regressionMaxSimTimesFx_,
-                regressionMaxSimTimesEq_, regressionVarGroupMode_);
+                regressionMaxSimTimesEq_, regressionVarGroupMode_, regressionMethod_);
             regModelUndDirty[counter].train(
                 polynomOrder_, polynomType_,
                 useOverwritePathValueUndDirty()
                     ? overwritePathValueUndDirty(*t, pathValueUndDirty, exerciseXvaTimes, pathValues)
                     : pathValueUndDirty,
-                pathValuesRef, simulationTimes);
+                pathValues, simulationTimes);
         }
 
         if (exercise_ != nullptr) {
             regModelOption[counter] = McRegressionModel(
                 *t, cashflowInfo, [&cfStatus](std::size_t i) { return cfStatus[i] == CfStatus::done; }, **model_,
                 regressorModel_, regressionVarianceCutoff_, regressionMaxSimTimesIr_, regressionMaxSimTimesFx_,
-                regressionMaxSimTimesEq_, regressionVarGroupMode_);
-            regModelOption[counter].train(polynomOrder_, polynomType_, pathValueOption, pathValuesRef, simulationTimes);
+                regressionMaxSimTimesEq_, regressionVarGroupMode_, regressionMethod_);
+            regModelOption[counter].train(polynomOrder_, polynomType_, pathValueOption, pathValues, simulationTimes);
         }
 
         if (isExerciseTime && previousExerciseTime != exerciseTimes.rend())
@@ -301,45 +340,40 @@ void McMultiLegBaseEngine::calculateModels(
 
     for (Size i = 0; i < cashflowInfo.size(); ++i) {
         if (cfStatus[i] == CfStatus::open)
-            pathValueUndDirty += cashflowPathValue(cashflowInfo[i], pathValues, simulationTimes);
+            pathValueUndDirty += cashflowPathValue(cashflowInfo[i], i, cfPathData, pathValues);
     }
 }
 
-void McMultiLegBaseEngine::generatePathValues(const std::vector<Real>& simulationTimes,
-                                              std::vector<std::vector<RandomVariable>>& pathValues) const {
+QuantLib::ext::shared_ptr<const McPaths>
+McMultiLegBaseEngine::generatePathValues(const std::vector<Real>& simulationTimes,
+                                         std::vector<std::vector<const RandomVariable*>>& pathValues) const {
 
-    if (simulationTimes.empty())
-        return;
+    pathValues.clear();
 
-    std::set<Real> times(simulationTimes.begin(), simulationTimes.end());
+    if (simulationTimes.empty())
+        return nullptr;
 
-    TimeGrid timeGrid(times.begin(), times.end());
+    // the xva times are requested by most engines sharing the model, we add them to the grid of new cache entries
 
-    QuantLib::ext::shared_ptr<StochasticProcess> process = model_->stateProcess();
-    if (model_->dimension() == 1) {
-        // use lgm process if possible for better performance
-        auto tmp = QuantLib::ext::make_shared<IrLgm1fStateProcess>(model_->irlgm1f(0));
-        tmp->resetCache(timeGrid.size() - 1);
-        process = tmp;
-    } else if (auto tmp = QuantLib::ext::dynamic_pointer_cast<CrossAssetStateProcess>(process)) {
-        // enable cache
-        tmp->resetCache(timeGrid.size() - 1);
+    std::vector<Real> xvaTimes;
+    for (auto const& d : simulationDates_) {
+        if (auto t = time(d); t > 0.0)
+            xvaTimes.push_back(t);
     }
 
-    auto pathGenerator = makeMultiPathGenerator(calibrationPathGenerator_, process, timeGrid, calibrationSeed_,
-                                                ordering_, directionIntegers_);
+    std::vector<Size> timeIndices;
+    auto paths = McPathCache::instance().paths(model_.currentLink(), calibrationPathGenerator_, calibrationSamples_,
+                                               calibrationSeed_, ordering_, directionIntegers_, simulationTimes,
+                                               xvaTimes, timeIndices);
 
-    // generated paths always contain t = 0 but simulationTimes might or might not contain t = 0
-    Size offset = QuantLib::close_enough(simulationTimes.front(), 0.0) ? 0 : 1;
-
-    for (Size i = 0; i < calibrationSamples_; ++i) {
-        const MultiPath& path = pathGenerator->next().value;
-        for (Size j = 0; j < simulationTimes.size(); ++j) {
-            for (Size k = 0; k < model_->stateProcess()->size(); ++k) {
-                pathValues[j][k].data()[i] = path[k][j + offset];
-            }
+    pathValues.resize(simulationTimes.size(), std::vector<const RandomVariable*>(model_->stateProcess()->size()));
+    for (Size j = 0; j < simulationTimes.size(); ++j) {
+        for (Size k = 0; k < model_->stateProcess()->size(); ++k) {
+            pathValues[j][k] = &paths->values[timeIndices[j]][k];
         }
     }
+
+    return paths;
 }
 
 void McMultiLegBaseEngine::calculate() const {
@@ -486,34 +520,11 @@ void McMultiLegBaseEngine::calculate() const {
     QL_REQUIRE(!simulationTimes.empty(),
                "McMultiLegBaseEngine::calculate(): no simulation times, this is not expected.");
 
-    std::vector<std::vector<RandomVariable>> pathValues(
-        simulationTimes.size(),
-        std::vector<RandomVariable>(model_->stateProcess()->size(), RandomVariable(calibrationSamples_)));
-    std::vector<std::vector<const RandomVariable*>> pathValuesRef(
-        simulationTimes.size(), std::vector<const RandomVariable*>(model_->stateProcess()->size()));
-
-    for (Size i = 0; i < pathValues.size(); ++i) {
-        for (Size j = 0; j < pathValues[i].size(); ++j) {
-            pathValues[i][j].expand();
-            pathValuesRef[i][j] = &pathValues[i][j];
-        }
-    }
-
-    std::vector<std::vector<RandomVariable>> closeOutPathValues(
-        simulationTimesWithCloseOutLag.size(),
-        std::vector<RandomVariable>(model_->stateProcess()->size(), RandomVariable(calibrationSamples_)));
-    std::vector<std::vector<const RandomVariable*>> closeOutPathValuesRef(
-        simulationTimesWithCloseOutLag.size(), std::vector<const RandomVariable*>(model_->stateProcess()->size()));
-
-    for (Size i = 0; i < closeOutPathValues.size(); ++i) {
-        for (Size j = 0; j < closeOutPathValues[i].size(); ++j) {
-            closeOutPathValues[i][j].expand();
-            closeOutPathValuesRef[i][j] = &closeOutPathValues[i][j];
-        }
-    }
+    // the paths are owned by the path cache (if enabled) or by the returned pointers, the path values point into them
 
-    generatePathValues(std::vector<Real>(simulationTimes.begin(), simulationTimes.end()), pathValues);
-    generatePathValues(simulationTimesWithCloseOutLag, closeOutPathValues);
+    std::vector<std::vector<const RandomVariable*>> pathValues, closeOutPathValues;
+    auto paths = generatePathValues(std::vector<Real>(simulationTimes.begin(), simulationTimes.end()), pathValues);
+    auto closeOutPaths = generatePathValues(simulationTimesWithCloseOutLag, closeOutPathValues);
 
     McEngineStats::instance().path_timer.stop();
 
@@ -530,7 +541,7 @@ void McMultiLegBaseEngine::calculate() const {
     RandomVariable pathValueUndExInto(calibrationSamples_);
     RandomVariable pathValueOption(calibrationSamples_);
 
-    calculateModels(simulationTimes, exerciseXvaTimes, exerciseTimes, xvaTimes, cashflowInfo, pathValues, pathValuesRef,
+    calculateModels(simulationTimes, exerciseXvaTimes, exerciseTimes, xvaTimes, cashflowInfo, pathValues,
                     regModelUndDirty, regModelUndExInto, regModelRebate, regModelContinuationValue, regModelOption,
                     pathValueUndDirty, pathValueUndExInto, pathValueOption);
 
@@ -548,7 +559,7 @@ void McMultiLegBaseEngine::calculate() const {
         RandomVariable pathValueOptionCloseOut(calibrationSamples_);
         // everything stays the same, we just use the lagged path values
         calculateModels(simulationTimes, exerciseXvaTimes, exerciseTimes, xvaTimes, cashflowInfo, closeOutPathValues,
-                        closeOutPathValuesRef, regModelUndDirtyCloseOut, regModelUndExIntoCloseOut,
+                        regModelUndDirtyCloseOut, regModelUndExIntoCloseOut,
                         regModelRebateCloseOut, regModelContinuationValueCloseOut, regModelOptionCloseOut,
                         pathValueUndDirtyCloseOut, pathValueUndExIntoCloseOut, pathValueOptionCloseOut);
     }
@@ -24,6 +24,7 @@
 
 #include <qle/indexes/fxindex.hpp>
 #include <qle/instruments/multilegoption.hpp>
+#include <qle/methods/mcpathcache.hpp>
 #include <qle/methods/multipathgeneratorbase.hpp>
 #include <qle/models/crossassetmodel.hpp>
 #include <qle/models/lgmvectorised.hpp>
@@ -76,7 +77,8 @@ public:
         const bool reevaluateExerciseInStickyRun = false, const Size cfOnCpnMaxSimTimes = 1,
         const Period& cfOnCpnAddSimTimesCutoff = Period(), const Size regressionMaxSimTimesIr = 0,
         const Size regressionMaxSimTimesFx = 0, const Size regressionMaxSimTimesEq = 0,
-        const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global);
+        const McRegressionModel::VarGroupMode regressionVarGroupMode = McRegressionModel::VarGroupMode::Global,
+        const RandomVariableRegressionMethod regressionMethod = RandomVariableRegressionMethod::QR);
 
     //! Destructor
     virtual ~McMultiLegBaseEngine() {}
@@ -119,6 +121,7 @@ public:
     Size regressionMaxSimTimesFx_;
     Size regressionMaxSimTimesEq_;
     McRegressionModel::VarGroupMode regressionVarGroupMode_;
+    RandomVariableRegressionMethod regressionMethod_;
 
     // set from global settings
     mutable bool includeTodaysCashflows_;
@@ -138,7 +141,7 @@ public:
     // current usage in the fwd bond case
     virtual RandomVariable overwritePathValueUndDirty(double t, const RandomVariable& pathValueUndDirty,
                                                       const std::set<Real>& exerciseXvaTimes,
-                                                      const std::vector<std::vector<QuantExt::RandomVariable>>& paths) const {
+                                                      const std::vector<std::vector<const RandomVariable*>>& paths) const {
         return pathValueUndDirty;
     };
 
@@ -199,16 +202,17 @@ public:
 
     };
 
-    // generate the mc path values of the model process
-    void generatePathValues(const std::vector<Real>& simulationTimes,
-                            std::vector<std::vector<RandomVariable>>& pathValues) const;
+    /* generate the mc path values of the model process, pathValues[j][k] points to the values of state variable k
+       at simulationTimes[j] in the returned paths, which are taken from the McPathCache if this is enabled */
+    QuantLib::ext::shared_ptr<const McPaths>
+    generatePathValues(const std::vector<Real>& simulationTimes,
+                       std::vector<std::vector<const RandomVariable*>>& pathValues) const;
 
     // the model training logic
     void calculateModels(const std::set<Real>& simulationTimes, const std::set<Real>& exerciseXvaTimes,
                          const std::set<Real>& exerciseTimes, const std::set<Real>& xvaTimes,
                          const std::vector<McCashflowInfo>& cashflowInfo,
-                         const std::vector<std::vector<RandomVariable>>& pathValues,
-                         const std::vector<std::vector<const RandomVariable*>>& pathValuesRef,
+                         const std::vector<std::vector<const RandomVariable*>>& pathValues,
                          std::vector<McRegressionModel>& regModelUndDirty,
                          std::vector<McRegressionModel>& regModelUndExInto, std::vector<McRegressionModel>& regModelRebate,
                          std::vector<McRegressionModel>& regModelContinuationValue,
@@ -222,9 +226,26 @@ public:
     // get the index of a time in the given simulation times set
     Size timeIndex(const Time t, const std::set<Real>& simulationTimes) const;
 
-    // compute a cashflow path value (in model base ccy)
-    RandomVariable cashflowPathValue(const McCashflowInfo& cf, const std::vector<std::vector<RandomVariable>>& pathValues,
-                                     const std::set<Real>& simulationTimes) const;
+    /* the cashflows of the trade mapped to the path values: the states for the amount calculators are set up once
+       per cashflow, the numeraire is computed once per pay time and the fx conversion once per pay time and currency,
+       both on first use */
+    struct CashflowPathData {
+        std::vector<RandomVariable> initialValues;
+        std::vector<std::vector<std::vector<const RandomVariable*>>> states; // per cashflow
+        std::vector<Size> payTimeIndex;                                      // per cashflow
+        std::vector<Size> fxGroup;                                           // per cashflow, null for base ccy flows
+        std::vector<RandomVariable> numeraire;                               // per simulation time
+        std::vector<RandomVariable> fxConversion;                            // per fx group
+    };
+
+    // set up the cashflow path data, data must not be copied afterwards, since the states point into it
+    void initCashflowPathData(CashflowPathData& data, const std::vector<McCashflowInfo>& cashflowInfo,
+                              const std::vector<std::vector<const RandomVariable*>>& pathValues,
+                              const std::set<Real>& simulationTimes) const;
+
+    // compute the path value of the i-th cashflow (in model base ccy)
+    RandomVariable cashflowPathValue(const McCashflowInfo& cf, const Size i, CashflowPathData& data,
+                                     const std::vector<std::vector<const RandomVariable*>>& pathValues) const;
 
     // valuation date
     mutable Date today_;
@@ -32,8 +32,10 @@ McRegressionModel::McRegressionModel(const Real observationTime,
                                                        const Size regressionMaxSimTimesIr,
                                                        const Size regressionMaxSimTimesFx,
                                                        const Size regressionMaxSimTimesEq,
-                                                       const McRegressionModel::VarGroupMode regressionVarGroupMode)
-    : observationTime_(observationTime), regressionVarianceCutoff_(regressionVarianceCutoff) {
+                                                       const McRegressionModel::VarGroupMode regressionVarGroupMode,
+                                                       const RandomVariableRegressionMethod regressionMethod)
+    : observationTime_(observationTime), regressionVarianceCutoff_(regressionVarianceCutoff),
+      regressionMethod_(regressionMethod) {
 
     // we always include the full model state as of the observation time
 
@@ -171,8 +173,7 @@ void McRegressionModel::train(const Size polynomOrder,
 
         // compute the regression coefficients
 
-        regressionCoeffs_ =
-            regressionCoefficients(regressand, regressor, basisFns_, filter, RandomVariableRegressionMethod::QR);
+        regressionCoeffs_ = regressionCoefficients(regressand, regressor, basisFns_, filter, regressionMethod_);
 
     } else {
 
@@ -51,7 +51,8 @@ public:
                     const RegressorModel regressorModel, const Real regressionVarianceCutoff = Null<Real>(),
                     const Size regressionMaxSimTimesIr = 0, const Size regressionMaxSimTimesFx = 0,
                     const Size regressionMaxSimTimesEq = 0,
-                    const VarGroupMode regressionVarGroupMode = VarGroupMode::Global);
+                    const VarGroupMode regressionVarGroupMode = VarGroupMode::Global,
+                    const RandomVariableRegressionMethod regressionMethod = RandomVariableRegressionMethod::QR);
     // pathTimes must contain the observation time and the relevant cashflow simulation times
     void train(const Size polynomOrder, const LsmBasisSystem::PolynomialType polynomType,
                const RandomVariable& regressand, const std::vector<std::vector<const RandomVariable*>>& paths,
@@ -65,6 +66,7 @@ public:
 private:
     Real observationTime_ = Null<Real>();
     Real regressionVarianceCutoff_ = Null<Real>();
+    RandomVariableRegressionMethod regressionMethod_ = RandomVariableRegressionMethod::QR;
     bool isTrained_ = false;
     std::set<std::pair<Real, Size>> regressorTimesModelIndices_;
     Matrix coordinateTransform_;
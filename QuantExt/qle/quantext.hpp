@@ -271,6 +271,7 @@
 #include <qle/methods/fdmquantohelper.hpp>
 #include <qle/methods/irdeltaparconverter.hpp>
 #include <qle/methods/lgmswaptionvegaparconverter.hpp>
+#include <qle/methods/mcpathcache.hpp>
 #include <qle/methods/multipathgeneratorbase.hpp>
 #include <qle/methods/multipathvariategenerator.hpp>
 #include <qle/methods/pathgeneratorfactory.hpp>
@@ -61,6 +61,101 @@ BOOST_AUTO_TEST_CASE(testForwardEvaluation) {
     BOOST_CHECK_CLOSE(values[z][0], 10.0, tol);
 }
 
+BOOST_AUTO_TEST_CASE(testForwardEvaluationPlan) {
+
+    constexpr Real tol = 1E-14;
+
+    // u = x+y, z = ux = (x+y)x, w = exp(u)y
+    ComputationGraph g;
+    auto x = cg_var(g, "x", ComputationGraph::VarDoesntExist::Create);
+    auto y = cg_var(g, "y", ComputationGraph::VarDoesntExist::Create);
+    auto u = cg_add(g, x, y, "u");
+    auto z = cg_mult(g, u, x, "z");
+    auto w = cg_mult(g, cg_exp(g, u), y, "w");
+
+    std::vector<bool> keepNodes(g.size(), false);
+    keepNodes[x] = true;
+    keepNodes[y] = true;
+
+    ForwardEvaluationPlan plan(g, true, false, {}, keepNodes);
+    BOOST_CHECK_EQUAL(plan.graphSize(), g.size());
+    BOOST_CHECK_EQUAL(plan.maxNumberOfArgs(), 2);
+
+    // evaluate the same plan repeatedly with different inputs
+
+    for (Size i = 0; i < 3; ++i) {
+        std::vector<RandomVariable> values(g.size(), RandomVariable(1, 0.0));
+        std::vector<RandomVariable> valuesRef(g.size(), RandomVariable(1, 0.0));
+        values[x] = valuesRef[x] = RandomVariable(1, 2.0 + i);
+        values[y] = valuesRef[y] = RandomVariable(1, 3.0 - i);
+
+        forwardEvaluation(plan, values, getRandomVariableOps(1), RandomVariable::deleter);
+        forwardEvaluation(g, valuesRef, getRandomVariableOps(1), RandomVariable::deleter, false, {}, keepNodes);
+
+        Real xv = 2.0 + i, yv = 3.0 - i;
+        BOOST_CHECK_CLOSE(values[z][0], (xv + yv) * xv, tol);
+        BOOST_CHECK_CLOSE(values[w][0], std::exp(xv + yv) * yv, tol);
+        for (Size n = 0; n < g.size(); ++n) {
+            BOOST_CHECK_EQUAL(values[n].initialised(), valuesRef[n].initialised());
+            if (values[n].initialised())
+                BOOST_CHECK_CLOSE(values[n][0], valuesRef[n][0], tol);
+        }
+
+        // x, y are kept, u is released after its last use
+        BOOST_CHECK(values[x].initialised());
+        BOOST_CHECK(values[y].initialised());
+        BOOST_CHECK(!values[u].initialised());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testGraphOptimisation) {
+
+    constexpr Real tol = 1E-12;
+
+    ComputationGraph g;
+    g.enableCommonSubexpressionElimination();
+    auto x = cg_var(g, "x", ComputationGraph::VarDoesntExist::Create);
+    auto y = cg_var(g, "y", ComputationGraph::VarDoesntExist::Create);
+
+    // common subexpressions, commutative ops are recognised with swapped arguments
+
+    auto u = cg_exp(g, x);
+    BOOST_CHECK_EQUAL(cg_exp(g, x), u);
+    auto v = cg_mult(g, u, y);
+    BOOST_CHECK_EQUAL(cg_mult(g, y, u), v);
+    auto w = cg_subtract(g, u, y);
+    BOOST_CHECK(cg_subtract(g, y, u) != w);
+    BOOST_CHECK_EQUAL(g.numberOfEliminatedNodes(), 2);
+
+    // constant summands are folded
+
+    std::size_t size = g.size();
+    auto s = cg_add(g, {cg_const(g, 1.0), v, cg_const(g, 2.0), w});
+    BOOST_CHECK_EQUAL(g.predecessors(s).size(), 3);
+    BOOST_CHECK(g.isConstant(g.predecessors(s)[2]));
+    BOOST_CHECK_CLOSE(g.constantValue(g.predecessors(s)[2]), 3.0, tol);
+    BOOST_CHECK_EQUAL(g.size(), size + 4);
+
+    // nodes not contributing to s are not required and not evaluated
+
+    auto dead = cg_log(g, v);
+    std::vector<bool> targets(g.size(), false);
+    targets[s] = true;
+    auto required = requiredNodes(g, targets);
+    BOOST_CHECK(required[x] && required[y] && required[u] && required[v] && required[w] && required[s]);
+    BOOST_CHECK(!required[dead]);
+
+    std::vector<RandomVariable> values(g.size());
+    values[x] = RandomVariable(1, 0.5);
+    values[y] = RandomVariable(1, 2.0);
+    for (auto const& c : g.constants())
+        values[c.second] = RandomVariable(1, c.first);
+    forwardEvaluation(ForwardEvaluationPlan(g, false, false, {}, {}, 0, ComputationGraph::nan, false, {}, required),
+                      values, getRandomVariableOps(1));
+    BOOST_CHECK_CLOSE(values[s][0], 3.0 + std::exp(0.5) * 2.0 + std::exp(0.5) - 2.0, tol);
+    BOOST_CHECK(!values[dead].initialised());
+}
+
 BOOST_AUTO_TEST_CASE(testBackwardDerivatives) {
 
     constexpr Real tol = 1E-14;
@@ -563,6 +563,89 @@ BOOST_AUTO_TEST_CASE(testConditionalExpectation2) {
     BOOST_CHECK(true);
 }
 
+BOOST_AUTO_TEST_CASE(testMultiThreadedBasicCpuDevice) {
+    ComputeEnvironmentFixture fixture;
+    const std::size_t n = 10007;
+
+    const std::string defaultDevice = "BasicCpu/Default/Default", mtDevice = "BasicCpu/Default/MultiThreaded";
+    auto devices = ComputeEnvironment::instance().getAvailableDevices();
+    BOOST_REQUIRE(devices.find(defaultDevice) != devices.end());
+    BOOST_REQUIRE(devices.find(mtDevice) != devices.end());
+
+    std::vector<double> rx(n);
+    for (std::size_t i = 0; i < n; ++i)
+        rx[i] = 0.5 + 2.0 * static_cast<double>((i * 7919) % n) / static_cast<double>(n);
+
+    // variant 0 can be evaluated by the fused interpreter, variant 1 contains Round and is evaluated chunk-wise with
+    // the random variable ops, variant 2 contains a conditional expectation and is evaluated on the full samples
+
+    auto calc = [&rx, n](const std::size_t variant) {
+        auto& c = ComputeEnvironment::instance().context();
+        ComputeContext::Settings settings;
+        settings.useDoublePrecision = true;
+        c.initiateCalculation(n, 0, 0, settings);
+        auto x = c.createInputVariable(&rx[0]);
+        auto a = c.createInputVariable(0.3);
+        auto one = c.createInputVariable(1.0);
+        auto two = c.createInputVariable(2.0);
+        auto vs = c.createInputVariates(1, 2);
+        auto v0 = vs[0][0], v1 = vs[0][1];
+        auto op = [&c](const std::size_t code, const std::vector<std::size_t>& args) {
+            return c.applyOperation(code, args);
+        };
+        auto t1 = op(RandomVariableOpCode::Add, {x, v0});
+        auto t2 = op(RandomVariableOpCode::Mult, {t1, a});
+        auto t3 = op(RandomVariableOpCode::Exp, {t2});
+        std::vector<std::size_t> out;
+        out.push_back(op(RandomVariableOpCode::Div, {t3, x}));
+        auto logx = op(RandomVariableOpCode::Log, {x});
+        auto sqrtx = op(RandomVariableOpCode::Sqrt, {x});
+        out.push_back(op(RandomVariableOpCode::Subtract, {logx, sqrtx}));
+        out.push_back(op(RandomVariableOpCode::Pow, {x, a}));
+        out.push_back(op(RandomVariableOpCode::Max, {t1, a}));
+        out.push_back(op(RandomVariableOpCode::Min, {op(RandomVariableOpCode::Negative, {t1}), a}));
+        out.push_back(op(RandomVariableOpCode::Abs, {t2}));
+        out.push_back(op(RandomVariableOpCode::NormalCdf, {v1}));
+        out.push_back(op(RandomVariableOpCode::NormalPdf, {v1}));
+        out.push_back(op(RandomVariableOpCode::Mult, {op(RandomVariableOpCode::IndicatorGt, {v0, a}), t3}));
+        out.push_back(op(RandomVariableOpCode::IndicatorGeq, {v1, a}));
+        out.push_back(op(RandomVariableOpCode::Frac, {t2}));
+        if (variant == 1)
+            out.push_back(op(RandomVariableOpCode::Round, {t2, two}));
+        if (variant == 2)
+            out.push_back(op(RandomVariableOpCode::ConditionalExpectation, {t3, one, v1}));
+        for (auto const& o : out)
+            c.declareOutputVariable(o);
+        std::vector<std::vector<double>> output(out.size(), std::vector<double>(n));
+        c.finalizeCalculation(output);
+        return output;
+    };
+
+    for (std::size_t variant = 0; variant < 3; ++variant) {
+        BOOST_TEST_MESSAGE("testing multi-threaded basic cpu device against default device, program variant "
+                           << variant);
+        ComputeEnvironment::instance().reset();
+        ComputeEnvironment::instance().selectContext(defaultDevice);
+        auto ref = calc(variant);
+        ComputeEnvironment::instance().reset();
+        ComputeEnvironment::instance().selectContext(mtDevice);
+        auto res = calc(variant);
+        BOOST_REQUIRE_EQUAL(ref.size(), res.size());
+        Size noErrors = 0, errorThreshold = 10;
+        for (Size j = 0; j < ref.size(); ++j) {
+            for (Size i = 0; i < n; ++i) {
+                Real err = std::abs(res[j][i] - ref[j][i]) / std::max(1.0, std::abs(ref[j][i]));
+                if (err > 1E-12 && noErrors < errorThreshold) {
+                    BOOST_ERROR("multi-threaded device value (" << res[j][i] << ") for output " << j << " at i=" << i
+                                                                << " does not match default device value ("
+                                                                << ref[j][i] << "), error " << err);
+                    noErrors++;
+                }
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
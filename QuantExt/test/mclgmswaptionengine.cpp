@@ -25,6 +25,7 @@
 
 #include <qle/models/gaussian1dcrossassetadaptor.hpp>
 #include <qle/models/irlgm1fpiecewiseconstanthullwhiteadaptor.hpp>
+#include <qle/methods/mcpathcache.hpp>
 #include <qle/models/lgm.hpp>
 #include <qle/pricingengines/numericlgmmultilegoptionengine.hpp>
 
@@ -164,6 +165,73 @@ BOOST_AUTO_TEST_CASE(testAgainstSwaptionEngines) {
     BOOST_CHECK_SMALL(std::fabs(npvGsr - npvLgmMc), tol);
 } // testAgainstSwaptionEngines
 
+BOOST_AUTO_TEST_CASE(testPathCache) {
+
+    BOOST_TEST_MESSAGE("Testing MC LGM swaption engine with calibration path cache...");
+
+    Calendar cal = TARGET();
+    Date evalDate(5, February, 2016);
+    Date startDate(cal.advance(cal.advance(evalDate, 2 * Days), 1 * Years));
+    Date maturityDate(cal.advance(startDate, 9 * Years));
+
+    Settings::instance().evaluationDate() = evalDate;
+
+    Handle<YieldTermStructure> yts(QuantLib::ext::make_shared<FlatForward>(evalDate, 0.02, Actual365Fixed()));
+    QuantLib::ext::shared_ptr<IborIndex> euribor6m(QuantLib::ext::make_shared<Euribor>(6 * Months, yts));
+    Schedule fixedSchedule(startDate, maturityDate, 1 * Years, cal, ModifiedFollowing, ModifiedFollowing,
+                           DateGeneration::Forward, false);
+    Schedule floatingSchedule(startDate, maturityDate, 6 * Months, cal, ModifiedFollowing, ModifiedFollowing,
+                              DateGeneration::Forward, false);
+    QuantLib::ext::shared_ptr<VanillaSwap> undlSwap = QuantLib::ext::make_shared<VanillaSwap>(
+        VanillaSwap::Payer, 1.0, fixedSchedule, 0.02, Thirty360(Thirty360::BondBasis), floatingSchedule, euribor6m,
+        0.0, Actual360());
+
+    // a bermudan swaption and a european swaption on the first exercise date, the latter requires a subset of the
+    // simulation times of the former
+
+    std::vector<Date> exerciseDates;
+    for (Size i = 0; i < 9; ++i) {
+        exerciseDates.push_back(cal.advance(fixedSchedule[i], -2 * Days));
+    }
+    auto bermudan = QuantLib::ext::make_shared<Swaption>(
+        undlSwap, QuantLib::ext::make_shared<BermudanExercise>(exerciseDates, false));
+    auto european =
+        QuantLib::ext::make_shared<Swaption>(undlSwap, QuantLib::ext::make_shared<EuropeanExercise>(exerciseDates[0]));
+
+    QuantLib::ext::shared_ptr<IrLgm1fParametrization> lgmParam =
+        QuantLib::ext::make_shared<IrLgm1fPiecewiseConstantHullWhiteAdaptor>(EURCurrency(), yts, Array(),
+                                                                             Array(1, 0.0060), Array(), Array(1, 0.03));
+    QuantLib::ext::shared_ptr<LinearGaussMarkovModel> lgm = QuantLib::ext::make_shared<LinearGaussMarkovModel>(lgmParam);
+
+    auto engine = QuantLib::ext::make_shared<McLgmSwaptionEngine>(lgm, MersenneTwisterAntithetic,
+                                                                  SobolBrownianBridge, 10000, 10000, 42, 43, 4,
+                                                                  LsmBasisSystem::Monomial);
+    bermudan->setPricingEngine(engine);
+    european->setPricingEngine(engine);
+
+    Real npvBermudan = bermudan->NPV();
+    Real npvEuropean = european->NPV();
+
+    McPathCache::instance().enable(true);
+    bermudan->recalculate();
+    european->recalculate();
+    Real npvBermudanCached = bermudan->NPV();
+    Real npvEuropeanCached = european->NPV();
+    Size cacheSize = McPathCache::instance().size();
+    McPathCache::instance().enable(false);
+
+    BOOST_TEST_MESSAGE("bermudan npv " << npvBermudan << " cached " << npvBermudanCached << ", european npv "
+                                       << npvEuropean << " cached " << npvEuropeanCached);
+
+    // the bermudan swaption is priced on a new cache entry covering exactly its simulation times, the european
+    // swaption reuses this entry, i.e. it is priced on a different realisation of the paths
+
+    BOOST_CHECK_EQUAL(cacheSize, 1);
+    BOOST_CHECK_CLOSE(npvBermudanCached, npvBermudan, 1E-10);
+    BOOST_CHECK_SMALL(std::fabs(npvEuropeanCached - npvEuropean), 2E-4);
+    BOOST_CHECK_EQUAL(McPathCache::instance().size(), 0);
+} // testPathCache
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
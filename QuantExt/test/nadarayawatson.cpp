@@ -0,0 +1,120 @@
+/*
+ Copyright (C) 2025 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "toplevelfixture.hpp"
+#include <boost/test/unit_test.hpp>
+#include <ql/math/distributions/normaldistribution.hpp>
+#include <ql/math/kernelfunctions.hpp>
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+#include <qle/math/nadarayawatson.hpp>
+
+#include <vector>
+
+using namespace boost::unit_test_framework;
+using namespace QuantLib;
+using namespace QuantExt;
+
+BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(NadarayaWatsonTest)
+
+BOOST_AUTO_TEST_CASE(testBinnedNadarayaWatson) {
+
+    BOOST_TEST_MESSAGE("Testing binned Nadaraya Watson regression against exact evaluation...");
+
+    Size n = 5000;
+    MersenneTwisterUniformRng mt(42);
+    InverseCumulativeNormal icn;
+    std::vector<Real> x(n), y(n);
+    for (Size i = 0; i < n; ++i) {
+        x[i] = icn(mt.nextReal());
+        y[i] = x[i] * x[i] + 0.5 * icn(mt.nextReal());
+    }
+
+    GaussianKernel kernel(0.0, 0.2);
+    NadarayaWatson exact(x.begin(), x.end(), y.begin(), kernel);
+    BinnedNadarayaWatson binned(x.begin(), x.end(), y.begin(), kernel, 0.2, 1000);
+    BOOST_CHECK_EQUAL(binned.bins(), 1000u);
+
+    Real tol = 1.0E-3;
+    for (Real t = -2.0; t <= 2.0 + 1.0E-10; t += 0.25) {
+        BOOST_TEST_MESSAGE("x = " << t << " exact = " << exact(t) << " binned = " << binned(t)
+                                  << " exact std dev = " << exact.standardDeviation(t)
+                                  << " binned std dev = " << binned.standardDeviation(t));
+        BOOST_CHECK_SMALL(binned(t) - exact(t), tol);
+        BOOST_CHECK_SMALL(binned.standardDeviation(t) - exact.standardDeviation(t), tol);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testBinnedNadarayaWatsonWideRange) {
+
+    BOOST_TEST_MESSAGE("Testing binned Nadaraya Watson regression for a wide range of regressor values...");
+
+    // npvs in the millions with a bandwidth of 0.25, a grid of 1000 points would be far too coarse
+    Size n = 2000;
+    MersenneTwisterUniformRng mt(42);
+    InverseCumulativeNormal icn;
+    std::vector<Real> x(n), y(n);
+    for (Size i = 0; i < n; ++i) {
+        x[i] = 1.0E6 * icn(mt.nextReal());
+        y[i] = 1.0E-6 * x[i] * x[i] + icn(mt.nextReal());
+    }
+
+    GaussianKernel kernel(0.0, 0.25);
+    NadarayaWatson exact(x.begin(), x.end(), y.begin(), kernel);
+    BinnedNadarayaWatson binned(x.begin(), x.end(), y.begin(), kernel, 0.25, 1000);
+    BOOST_CHECK_EQUAL(binned.bins(), n);
+
+    for (Size i = 0; i < n; i += 50) {
+        BOOST_TEST_MESSAGE("x = " << x[i] << " exact = " << exact(x[i]) << " binned = " << binned(x[i]));
+        BOOST_CHECK_CLOSE(binned(x[i]), exact(x[i]), 1.0E-10);
+    }
+
+    // with a bandwidth matching the range of the data the grid is used
+    GaussianKernel wideKernel(0.0, 2.0E5);
+    NadarayaWatson wideExact(x.begin(), x.end(), y.begin(), wideKernel);
+    BinnedNadarayaWatson wideBinned(x.begin(), x.end(), y.begin(), wideKernel, 2.0E5, 1000);
+    BOOST_CHECK_EQUAL(wideBinned.bins(), 1000u);
+    for (Real t = -2.0E6; t <= 2.0E6 + 1.0; t += 2.5E5) {
+        BOOST_TEST_MESSAGE("x = " << t << " exact = " << wideExact(t) << " binned = " << wideBinned(t));
+        BOOST_CHECK_CLOSE(wideBinned(t), wideExact(t), 0.1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testBinnedNadarayaWatsonDegenerate) {
+
+    BOOST_TEST_MESSAGE("Testing binned Nadaraya Watson regression for degenerate data...");
+
+    GaussianKernel kernel(0.0, 1.0);
+
+    std::vector<Real> empty;
+    BinnedNadarayaWatson e(empty.begin(), empty.end(), empty.begin(), kernel, 1.0);
+    BOOST_CHECK_EQUAL(e.bins(), 0u);
+    BOOST_CHECK_EQUAL(e(1.0), 0.0);
+    BOOST_CHECK_EQUAL(e.standardDeviation(1.0), 0.0);
+
+    std::vector<Real> x(3, 1.0), y = {1.0, 2.0, 3.0};
+    BinnedNadarayaWatson c(x.begin(), x.end(), y.begin(), kernel, 1.0);
+    BOOST_CHECK_EQUAL(c.bins(), 1u);
+    BOOST_CHECK_CLOSE(c(0.5), 2.0, 1.0E-10);
+    BOOST_CHECK_CLOSE(c.standardDeviation(0.5), std::sqrt(2.0 / 3.0), 1.0E-10);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -25,6 +25,7 @@
 
 #include <qle/math/randomvariable.hpp>
 
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
 #include <ql/time/date.hpp>
 #include <ql/pricingengines/blackformula.hpp>
 
@@ -192,6 +193,44 @@ BOOST_AUTO_TEST_CASE(testBlack) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(testRegressionMethods) {
+    BOOST_TEST_MESSAGE("Testing regression methods...");
+
+    Size n = 5000;
+    MersenneTwisterUniformRng rng(42);
+    RandomVariable x(n), y(n), z(n);
+    for (Size i = 0; i < n; ++i) {
+        x.set(i, 2.0 * rng.nextReal() - 1.0);
+        y.set(i, 2.0 * rng.nextReal() - 1.0);
+        z.set(i, 1.0 + 0.5 * x[i] - 2.0 * x[i] * x[i] + 0.3 * y[i] + 0.1 * (rng.nextReal() - 0.5));
+    }
+    Filter filter(n, true);
+    for (Size i = 0; i < n; i += 7)
+        filter.set(i, false);
+
+    auto basisFn = multiPathBasisSystem(2, 2, QuantLib::LsmBasisSystem::Monomial);
+    std::vector<const RandomVariable*> regressor = {&x, &y};
+
+    for (auto const& f : {Filter(), filter}) {
+        Array qr = regressionCoefficients(z, regressor, basisFn, f, RandomVariableRegressionMethod::QR);
+        Array ne = regressionCoefficients(z, regressor, basisFn, f, RandomVariableRegressionMethod::NormalEquations);
+        BOOST_REQUIRE_EQUAL(qr.size(), ne.size());
+        for (Size i = 0; i < qr.size(); ++i)
+            BOOST_CHECK_SMALL(qr[i] - ne[i], 1E-10);
+    }
+
+    // collinear basis functions, the coefficients are not unique, but the fitted values are
+    auto collinearBasisFn = basisFn;
+    collinearBasisFn.push_back(basisFn[1]);
+    Array svd = regressionCoefficients(z, regressor, collinearBasisFn, Filter(), RandomVariableRegressionMethod::SVD);
+    Array ne = regressionCoefficients(z, regressor, collinearBasisFn, Filter(),
+                                      RandomVariableRegressionMethod::NormalEquations);
+    RandomVariable fittedSvd = conditionalExpectation(regressor, collinearBasisFn, svd);
+    RandomVariable fittedNe = conditionalExpectation(regressor, collinearBasisFn, ne);
+    for (Size i = 0; i < n; ++i)
+        BOOST_CHECK_SMALL(fittedSvd[i] - fittedNe[i], 1E-8);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()